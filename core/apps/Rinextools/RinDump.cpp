@@ -67,6 +67,7 @@
 #include "Rinex3ObsStream.hpp"
 #include "Rinex3ObsHeader.hpp"
 #include "Rinex3ObsData.hpp"
+#include "Rinex3ObsPlan.hpp"
 
 #include "Rinex3NavBase.hpp"
 #include "Rinex3NavHeader.hpp"
@@ -272,8 +273,6 @@ const string Configuration::longfmt = calfmt + " = " + gpsfmt;
 // prototypes
 int Initialize(string& errors) throw(Exception);
 int ProcessFiles(void) throw(Exception);
-double getObsData(string tag, RinexSatID sat, Rinex3ObsHeader& Rhead,
-                  const vector<RinexDatum>& vrdata) throw(Exception);
 double getNonObsData(string tag, RinexSatID sat, const CommonTime& time)
    throw(Exception);
 
@@ -1572,6 +1571,19 @@ try {
          continue;
       }
 
+      // resolve the obs tags to header indexes, once for the file;
+      // planIndex[i] is the index in plan of InputTags[i], or -1
+      vector<string> obsTags;
+      vector<int> planIndex(C.InputTags.size(),-1);
+      for(i=0; i<C.InputTags.size(); i++) {
+         tag = C.InputTags[i];
+         if(isValidRinexObsID(tag)) {
+            planIndex[i] = obsTags.size();
+            obsTags.push_back(tag);
+         }
+      }
+      Rinex3ObsPlan plan(Rhead, obsTags);
+
       // loop over epochs ---------------------------------------------
       while(1) {
          try { istrm >> Rdata; }
@@ -1745,8 +1757,8 @@ try {
                      if(find(C.AuxTags.begin(),C.AuxTags.end(),tag)!=C.AuxTags.end())
                         continue;
 
-                     else if(isValidRinexObsID(tag))     // tag = RINEX Obs ID
-                        data = getObsData(tag, sat, Rhead, vrdata);
+                     else if(planIndex[i] > -1)          // tag = RINEX Obs ID
+                        data = plan.getData(sat, vrdata, planIndex[i]);
 
                      else if(find(C.NonObsTags.begin(),  // tag = Sat-dep non-obs type
                                  C.NonObsTags.end(), tag) != C.NonObsTags.end())
@@ -1805,37 +1817,6 @@ try {
 catch(Exception& e) { GPSTK_RETHROW(e); }
 }  // end ProcessFiles()
 
-//------------------------------------------------------------------------------------
-double getObsData(string tag, RinexSatID sat, Rinex3ObsHeader& Rhead,
-                   const vector<RinexDatum>& vrdata) throw(Exception)
-{
-   try {
-      double data(0);
-      string sys(1,sat.systemChar());              // system of this sat
-
-      if(tag.size() == 4 && tag[0] != sys[0])
-         return 0;                                 // system does not match
-      if(tag.size() == 3) {
-         tag = sys + tag;                          // add system char to tag
-         if(!isValidRinexObsID(tag))
-            return 0;                              // system+tag is not valid
-      }
-
-      RinexObsID obsid(tag);                       // ObsID for this tag
-
-      // find it in the header
-      vector<RinexObsID>::const_iterator jt(
-         find(Rhead.mapObsTypes[sys].begin(),Rhead.mapObsTypes[sys].end(),obsid));
-      if(jt != Rhead.mapObsTypes[sys].end()) {     // its in the header
-         int j = jt - Rhead.mapObsTypes[sys].begin();
-         data = vrdata[j].data;
-      }
-
-      return data;
-   }
-   catch(Exception& e) { GPSTK_RETHROW(e); }
-}  // end getObsData()
-
 //------------------------------------------------------------------------------------
 double getNonObsData(string tag, RinexSatID sat, const CommonTime& time)
    throw(Exception)
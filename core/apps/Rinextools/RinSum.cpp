@@ -668,10 +668,11 @@ int ProcessFiles(void) throw(Exception)
       const size_t ndtmax=15;
       double dt, bestdt[ndtmax];
       int ndt[ndtmax];
-         // cache the out-of-time-order records
+         // cache the times of the out-of-time-order records; only these
+         // are reported, so the records themselves are not kept
       bool cacheon;
       vector<CommonTime> cachetime;
-      vector<vector<Rinex3ObsData> > cache;
+      vector<vector<CommonTime> > cache;
 
       for(nfiles=0,nfile=0; nfile<C.InputObsFiles.size(); nfile++)
       {
@@ -948,10 +949,9 @@ int ProcessFiles(void) throw(Exception)
                      // new block
                   cachetime.push_back(prevObsTime);
                   cacheon = true;
-                  vector<Rinex3ObsData> v;
-                  cache.push_back(v);
+                  cache.push_back(vector<CommonTime>());
                }
-               cache[cache.size()-1].push_back(Rdata);
+               cache[cache.size()-1].push_back(Rdata.time);
                continue;
             }
             cacheon = false;
@@ -1583,8 +1583,8 @@ int ProcessFiles(void) throw(Exception)
                LOG(INFO) << " Warning: " << setw(4) << cache[i].size()
                          << " data records following epoch "
                          << printTime(cachetime[i],C.calfmt) << " are out of time order,"
-                         << "\n         with epochs " << printTime(cache[i][0].time,C.calfmt)
-                         << " to " << printTime(cache[i][cache[i].size()-1].time,C.calfmt)
+                         << "\n         with epochs " << printTime(cache[i][0],C.calfmt)
+                         << " to " << printTime(cache[i][cache[i].size()-1],C.calfmt)
                          << endl;
          }
 
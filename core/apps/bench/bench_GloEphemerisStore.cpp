@@ -0,0 +1,129 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/// @file bench_GloEphemerisStore.cpp Time a second by second track of every
+/// GLONASS satellite in a RINEX navigation file, with orbits integrated at every
+/// epoch and with the trajectory cache of class GloEphemerisStore.
+/// Usage: bench_GloEphemerisStore <RINEX nav file> [seconds (default 3600)]
+
+// system includes
+#include <string>
+#include <set>
+#include <ctime>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+// gpstk
+#include "Exception.hpp"
+#include "GloEphemerisStore.hpp"
+#include "Rinex3NavStream.hpp"
+#include "Rinex3NavHeader.hpp"
+#include "Rinex3NavData.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+//------------------------------------------------------------------------------------
+static const string benchVersion("1.0 10/17/26");
+
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+try {
+   double span(3600.0);
+   if(argc > 2) span = atof(argv[2]);
+   if(argc < 2 || span <= 0.0) {
+      cerr << "Usage: bench_GloEphemerisStore <RINEX nav file> [seconds]" << endl;
+      return 1;
+   }
+
+   GloEphemerisStore plain, cached;
+   cached.setTrajectoryCache(true);
+   Rinex3NavStream ns(argv[1]);
+   if(!ns) {
+      cerr << "Could not open " << argv[1] << endl;
+      return 1;
+   }
+   Rinex3NavHeader nh;
+   Rinex3NavData nd;
+   ns >> nh;
+   while(ns >> nd) {
+      if(nd.sat.system != SatID::systemGlonass) continue;
+      plain.addEphemeris(nd);
+      cached.addEphemeris(nd);
+   }
+
+   set<SatID> sats(plain.getIndexSet());
+   cout << "bench_GloEphemerisStore version " << benchVersion << ", "
+        << sats.size() << " satellites, " << span << " s each" << endl;
+   if(sats.empty()) {
+      cerr << "No GLONASS ephemerides in " << argv[1] << endl;
+      return 1;
+   }
+
+   GloEphemerisStore *stores[2] = { &plain, &cached };
+   const char *names[2] = { "integrated", "cached" };
+   for(int s=0; s<2; s++) {
+      unsigned long n(0);
+      clock_t start = clock();
+      for(set<SatID>::const_iterator si=sats.begin(); si!=sats.end(); ++si) {
+         CommonTime tbeg(plain.getInitialTime(*si));
+         for(double dt=0.0; dt<span; dt+=1.0, n++)
+            stores[s]->computeXvt(*si, tbeg + dt);
+      }
+      double secs = double(clock() - start) / CLOCKS_PER_SEC;
+      cout << setw(10) << names[s] << ": " << n << " positions in " << fixed
+           << setprecision(3) << secs << " s" << endl;
+   }
+
+   // agreement of the cache, outside the timing
+   double maxdiff(0.0);
+   for(set<SatID>::const_iterator si=sats.begin(); si!=sats.end(); ++si) {
+      CommonTime tbeg(plain.getInitialTime(*si));
+      for(double dt=0.0; dt<span; dt+=1.0) {
+         Xvt x0(plain.computeXvt(*si, tbeg + dt));
+         Xvt x1(cached.computeXvt(*si, tbeg + dt));
+         maxdiff = max(maxdiff, (x0.x - x1.x).mag());
+      }
+   }
+   cout << "max position difference " << scientific << setprecision(2)
+        << maxdiff << " m" << endl;
+
+   return 0;
+}
+catch(Exception& e) { cerr << "Exception: " << e; }
+catch (...) { cerr << "Unknown exception.  Abort." << endl; }
+   return 1;
+}   // end main()
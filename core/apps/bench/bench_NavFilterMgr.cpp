@@ -0,0 +1,159 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/// @file bench_NavFilterMgr.cpp Time a stream of LNAV subframes through a typical
+/// NavFilterMgr filter chain: parity, empty subframe, TLM/HOW and cross source.
+/// Usage: bench_NavFilterMgr <subframe file> [number of repetitions (default 20)]
+/// The subframe file has the format of data/test_input_NavFilterMgr.txt; the
+/// subframes are cooked before the timing starts.
+
+// system includes
+#include <string>
+#include <vector>
+#include <ctime>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+// gpstk
+#include "Exception.hpp"
+#include "CommonTime.hpp"
+#include "TimeString.hpp"
+#include "StringUtils.hpp"
+#include "NavFilterMgr.hpp"
+#include "LNavFilterData.hpp"
+#include "LNavCookFilter.hpp"
+#include "LNavParityFilter.hpp"
+#include "LNavEmptyFilter.hpp"
+#include "LNavTLMHOWFilter.hpp"
+#include "LNavCrossSourceFilter.hpp"
+
+using namespace std;
+using namespace gpstk;
+using namespace gpstk::StringUtils;
+
+//------------------------------------------------------------------------------------
+static const string benchVersion("1.0 10/17/26");
+
+//------------------------------------------------------------------------------------
+// Read the subframes of file name into data, with their ten words in words.
+// Return false if the file cannot be read.
+static bool loadData(const string& name, vector<LNavFilterData>& data,
+                     vector<uint32_t>& words)
+{
+   ifstream inf(name.c_str());
+   if(!inf) return false;
+
+   vector<string> lines;
+   string line;
+   while(getline(inf, line)) {
+      if(line.empty() || line[0] == '#') continue;
+      lines.push_back(line);
+   }
+
+   // size words first, so the subframe pointers stay valid
+   words.resize(10*lines.size());
+   data.resize(lines.size());
+   for(size_t i=0; i<lines.size(); i++) {
+      const string& l(lines[i]);
+      LNavFilterData& fd(data[i]);
+      scanTime(fd.timeStamp, firstWord(l, ','), "%4Y %3j %02H:%02M:%04.1f");
+      fd.sf = &words[10*i];
+      for(unsigned w=6; w<=15; w++)
+         words[10*i+w-6] = x2uint(word(l, w, ','));
+      fd.prn = asUnsigned(word(l, 2, ','));
+      fd.carrier = (ObsID::CarrierBand)asInt(word(l, 3, ','));
+      fd.code = (ObsID::TrackingCode)asInt(word(l, 4, ','));
+   }
+   return true;
+}
+
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+try {
+   unsigned reps(20);
+   if(argc > 2) reps = atoi(argv[2]);
+   if(argc < 2 || reps < 1) {
+      cerr << "Usage: bench_NavFilterMgr <subframe file> [number of repetitions]"
+           << endl;
+      return 1;
+   }
+
+   vector<LNavFilterData> data;
+   vector<uint32_t> words;
+   if(!loadData(argv[1], data, words)) {
+      cerr << "Could not read subframe file " << argv[1] << endl;
+      return 1;
+   }
+   cout << "bench_NavFilterMgr version " << benchVersion << ", " << data.size()
+        << " subframes, " << reps << " repetitions" << endl;
+
+   // upright the subframes once, outside the timing
+   NavFilterMgr cookMgr;
+   LNavCookFilter filtCook;
+   cookMgr.addFilter(&filtCook);
+   for(size_t i=0; i<data.size(); i++)
+      cookMgr.validate(&data[i]);
+
+   NavFilterMgr mgr;
+   LNavParityFilter filtParity;
+   LNavEmptyFilter filtEmpty;
+   LNavTLMHOWFilter filtTLMHOW;
+   LNavCrossSourceFilter filtXSrc;
+   mgr.addFilter(&filtParity);
+   mgr.addFilter(&filtEmpty);
+   mgr.addFilter(&filtTLMHOW);
+   mgr.addFilter(&filtXSrc);
+
+   unsigned long count(0), passed(0);
+   clock_t start = clock();
+   for(unsigned rep=0; rep<reps; rep++) {
+      for(size_t i=0; i<data.size(); i++, count++)
+         passed += mgr.validate(&data[i]).size();
+      passed += mgr.finalize().size();
+   }
+   double secs = double(clock() - start) / CLOCKS_PER_SEC;
+   cout << "NavFilterMgr: " << count << " subframes in " << fixed
+        << setprecision(3) << secs << " s, "
+        << setprecision(0) << (secs > 0 ? count / secs : 0)
+        << " subframes/s, " << passed << " accepted" << endl;
+
+   return (passed > 0 && passed <= count ? 0 : 1);
+}
+catch(Exception& e) { cerr << "Exception: " << e; }
+catch (...) { cerr << "Unknown exception.  Abort." << endl; }
+   return 1;
+}   // end main()
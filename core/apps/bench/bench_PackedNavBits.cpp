@@ -0,0 +1,171 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/// @file bench_PackedNavBits.cpp Time field extraction and packing of class
+/// PackedNavBits against the bit-by-bit std::vector<bool> packing it used
+/// before it stored 64-bit words.
+/// Usage: bench_PackedNavBits [number of repetitions (default 20000)]
+
+// system includes
+#include <string>
+#include <vector>
+#include <ctime>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+// gpstk
+#include "Exception.hpp"
+#include "PackedNavBits.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+//------------------------------------------------------------------------------------
+static const string benchVersion("1.0 10/17/26");
+
+//------------------------------------------------------------------------------------
+// The original bit-by-bit packing, the reference for the timing.
+class BitVectorRef
+{
+public:
+   BitVectorRef() : bits(900), bits_used(0) {}
+   void add(uint64_t value, int numBits)
+   {
+      uint64_t mask = uint64_t(1) << (numBits-1);
+      for(int i=0; i<numBits; ++i, mask >>= 1)
+         bits[bits_used++] = (value & mask) != 0;
+   }
+   uint64_t get(int startBit, int numBits) const
+   {
+      uint64_t temp = 0;
+      for(int i=startBit; i<startBit+numBits; ++i) {
+         temp <<= 1;
+         if(bits[i]) temp++;
+      }
+      return temp;
+   }
+   vector<bool> bits;
+   int bits_used;
+};
+
+//------------------------------------------------------------------------------------
+// Fill a reference and a PackedNavBits with the same random fields of 1 to 32
+// bits, totalling at least numBits bits.
+static void fillRandom(BitVectorRef& ref, PackedNavBits& pnb,
+                       vector<int>& widths, int numBits)
+{
+   widths.clear();
+   int total(0);
+   while(total < numBits) {
+      int n = 1 + rand() % 32;
+      unsigned long value = ((unsigned long)rand() << 16) ^ rand();
+      value &= (n == 32) ? 0xFFFFFFFFUL : ((1UL << n) - 1);
+      ref.add(value, n);
+      pnb.addUnsignedLong(value, n, 1);
+      widths.push_back(n);
+      total += n;
+   }
+}
+
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+try {
+   int reps(20000);
+   if(argc > 1) reps = atoi(argv[1]);
+   if(reps < 1) {
+      cerr << "Usage: bench_PackedNavBits [number of repetitions]" << endl;
+      return 1;
+   }
+   cout << "bench_PackedNavBits version " << benchVersion << ", " << reps
+        << " repetitions" << endl;
+
+   srand(20190102);
+   BitVectorRef ref;
+   PackedNavBits pnb;
+   vector<int> widths;
+   fillRandom(ref, pnb, widths, 300);
+   const char *names[] = { "vector<bool>", "uint64_t" };
+
+   // extract every field
+   uint64_t sums[2] = { 0, 0 };
+   for(int mode=0; mode<2; mode++) {
+      clock_t start = clock();
+      for(int rep=0; rep<reps; rep++) {
+         int first(0);
+         for(size_t i=0; i<widths.size(); i++) {
+            sums[mode] += (mode==0 ? ref.get(first, widths[i])
+                                   : pnb.asUnsignedLong(first, widths[i], 1));
+            first += widths[i];
+         }
+      }
+      double secs = double(clock() - start) / CLOCKS_PER_SEC;
+      cout << "extract " << setw(12) << names[mode] << ": " << reps << " x "
+           << ref.bits_used << " bits in " << fixed << setprecision(3)
+           << secs << " s" << endl;
+   }
+
+   // pack every field into a new message
+   size_t sizes[2] = { 0, 0 };
+   for(int mode=0; mode<2; mode++) {
+      clock_t start = clock();
+      for(int rep=0; rep<reps; rep++) {
+         BitVectorRef r;
+         PackedNavBits p;
+         int first(0);
+         for(size_t i=0; i<widths.size(); i++) {
+            if(mode==0)
+               r.add(ref.get(first, widths[i]), widths[i]);
+            else
+               p.addUnsignedLong(ref.get(first, widths[i]), widths[i], 1);
+            first += widths[i];
+         }
+         sizes[mode] += (mode==0 ? r.bits_used : p.getNumBits());
+      }
+      double secs = double(clock() - start) / CLOCKS_PER_SEC;
+      cout << "pack    " << setw(12) << names[mode] << ": " << reps << " x "
+           << ref.bits_used << " bits in " << fixed << setprecision(3)
+           << secs << " s" << endl;
+   }
+
+   // the two must agree, or the timing means nothing
+   bool ok(sums[0] == sums[1] && sizes[0] == sizes[1]);
+   if(!ok) cout << "FAILED: the packings disagree" << endl;
+   return (ok ? 0 : 1);
+}
+catch(Exception& e) { cerr << "Exception: " << e; }
+catch (...) { cerr << "Unknown exception.  Abort." << endl; }
+   return 1;
+}   // end main()
@@ -67,27 +67,28 @@ void MergeRinMet::process()
 {
    std::vector<std::string> files = inputFileOption.getValue();
 
-      // FFF will sort and merge the data using
-      // a simple time check
+      // FFF will sort and merge the data from the files using a simple
+      // time check, without reading all of it into memory
    FileFilterFrameWithHeader<RinexMetStream, RinexMetData, RinexMetHeader> 
-      fff(files);
+      fff;
+   fff.setStreaming(true);
+   fff.newSource(files);
 
       // get the header data
    RinexMetHeaderTouchHeaderMerge merged;
    fff.touchHeader(merged);
 
-      // sort and filter the data
-   fff.sort(RinexMetDataOperatorLessThanFull(merged.obsSet));
-   fff.unique(RinexMetDataOperatorEqualsSimple());
-   
       // set the pgm/runby/date field
    merged.theHeader.fileProgram = std::string("mergeRinMet");
    merged.theHeader.fileAgency = std::string("gpstk");
    merged.theHeader.date = CivilTime(SystemTime()).asString();
 
-      // write the header
+      // sort and filter the data using the obs set from the merged
+      // header, and write the file
    std::string outputFile = outputFileOption.getValue().front();
-   fff.writeFile(outputFile, merged.theHeader);
+   fff.mergeFile(outputFile, merged.theHeader,
+                 RinexMetDataOperatorLessThanFull(merged.obsSet),
+                 RinexMetDataOperatorEqualsSimple());
 }
 
 int main(int argc, char* argv[])
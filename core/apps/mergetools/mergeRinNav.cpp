@@ -65,19 +65,17 @@ void MergeRinNav::process()
 {
    std::vector<std::string> files = inputFileOption.getValue();
 
-      // FFF will sort and merge the obs data using
-      // a simple time check
-   FileFilterFrameWithHeader<Rinex3NavStream, Rinex3NavData, Rinex3NavHeader> fff(files);
+      // FFF will sort and merge the nav data from the files without
+      // reading all of it into memory
+   FileFilterFrameWithHeader<Rinex3NavStream, Rinex3NavData, Rinex3NavHeader> fff;
+   fff.setStreaming(true);
+   fff.newSource(files);
 
       // get the header data
    Rinex3NavHeaderTouchHeaderMerge merged;
 
    fff.touchHeader(merged);
 
-      // sort and filter the data
-   fff.sort(Rinex3NavDataOperatorLessThanFull());
-   fff.unique(Rinex3NavDataOperatorEqualsFull());
-   
       // set the pgm/runby/date field
    merged.theHeader.fileType = string("NAVIGATION");
    merged.theHeader.fileProgram = std::string("mergeRinNav");
@@ -89,9 +87,11 @@ void MergeRinNav::process()
    merged.theHeader.valid |= gpstk::Rinex3NavHeader::validComment;
    merged.theHeader.valid |= gpstk::Rinex3NavHeader::validEoH;
 
-      // write the header
+      // sort and filter the data, and write the file
    std::string outputFile = outputFileOption.getValue().front();
-   fff.writeFile(outputFile, merged.theHeader);
+   fff.mergeFile(outputFile, merged.theHeader,
+                 Rinex3NavDataOperatorLessThanFull(),
+                 Rinex3NavDataOperatorEqualsFull());
 }
 
 int main(int argc, char* argv[])
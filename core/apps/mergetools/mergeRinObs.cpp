@@ -67,30 +67,46 @@ void MergeRinObs::process()
 {
    std::vector<std::string> files = inputFileOption.getValue();
 
-      // FFF will sort and merge the obs data using
-      // a simple time check
-   FileFilterFrameWithHeader<RinexObsStream, RinexObsData, RinexObsHeader> 
-      fff(files);
+      // FFF will merge the obs data from the files using a simple time
+      // check, without reading all of it into memory
+   FileFilterFrameWithHeader<RinexObsStream, RinexObsData, RinexObsHeader> fff;
+   fff.setStreaming(true);
+   fff.newSource(files);
 
       // get the header data
    RinexObsHeaderTouchHeaderMerge merged;
    fff.touchHeader(merged);
 
-      // sort and filter the data using the obs set from the merged header
-   fff.sort(RinexObsDataOperatorLessThanFull(merged.obsSet));
-   fff.unique(RinexObsDataOperatorEqualsSimple());
-   
-      // set the time of first obs in the header
-   merged.theHeader.firstObs = fff.front().time;
-
       // set the pgm/runby/date field
    merged.theHeader.fileProgram = std::string("mergeRinObs");
    merged.theHeader.fileAgency = std::string("gpstk");
    merged.theHeader.date = CivilTime(SystemTime()).asString();
 
-      // write the file
+      // open the output file
    std::string outputFile = outputFileOption.getValue().front();
-   fff.writeFile(outputFile, merged.theHeader);
+   std::string::size_type pos = outputFile.rfind('/');
+   if (pos != std::string::npos)
+      FileUtils::makeDir(outputFile.substr(0,pos).c_str(), 0755);
+   RinexObsStream output(outputFile.c_str(), std::ios::out|std::ios::trunc);
+   output.exceptions(std::ios::failbit);
+
+      // merge the data using the obs set from the merged header, and write
+      // the header, with the time of first obs, before the first data
+   bool headerWritten = false;
+   fff.streamMerge(RinexObsDataOperatorLessThanFull(merged.obsSet),
+                   RinexObsDataOperatorEqualsSimple(),
+                   [&](const RinexObsData& data)
+                   {
+                      if (!headerWritten)
+                      {
+                         merged.theHeader.firstObs = data.time;
+                         output << merged.theHeader;
+                         headerWritten = true;
+                      }
+                      output << data;
+                   });
+   if (!headerWritten)
+      output << merged.theHeader;
 }
 
 int main(int argc, char* argv[])
@@ -836,6 +836,9 @@ try {
       C.SP3EphStore.setPosMaxInterval(
          (C.SP3EphStore.getInterpolationOrder()-1) * dtp + 1.);
 
+      // loading is done; build the flat time indexes used in interpolation
+      C.SP3EphStore.compact();
+
       // dump the SP3 ephemeris store; while looping, check the GLO freq channel
       LOG(VERBOSE) << "\nDump clock and position stores, including file stores";
       // NB clock dumps are huge!
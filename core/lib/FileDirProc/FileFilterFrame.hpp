@@ -42,6 +42,9 @@
 #ifndef GPSTK_FILEFILTERFRAME_HPP
 #define GPSTK_FILEFILTERFRAME_HPP
 
+#include <cstdio>
+#include <memory>
+
 #include "FileSpec.hpp"
 #include "FileFilter.hpp"
 #include "FileHunter.hpp"
@@ -66,6 +69,11 @@ namespace gpstk
        * to.  
        *
        * See the examples in FileFilterFrameTest.cpp for a demonstration.
+       *
+       * For inputs too large to hold in memory, select streaming mode
+       * with setStreaming() before adding any source.  The data are then
+       * left in the files, and streamMerge() merges them in order, with
+       * only one record of each input in memory at a time.
        */
    template <class FileStream, class FileData>
    class FileFilterFrame : public FileFilter<FileData>
@@ -166,18 +174,108 @@ namespace gpstk
       bool writeFile(FileStream& stream) const
          throw(gpstk::Exception);
 
+         /**
+          * Selects streaming mode, in which the data of the sources are
+          * not loaded into the filter but are merged from the files by
+          * streamMerge().  This must be set before any source is added.
+          * @param on true for streaming mode.
+          * @param maxRecords the most records of an input that are held
+          *   in memory while it is sorted, when it is not in order.
+          * @throw InvalidRequest if data or sources have already been added.
+          */
+      FileFilterFrame& setStreaming(bool on,
+                                    unsigned long maxRecords = 100000)
+         throw(gpstk::InvalidRequest);
+
+         /// Returns true in streaming mode.
+      bool isStreaming() const
+      { return streaming; }
+
+         /**
+          * In streaming mode, merges the data of all the sources in the
+          * order of comp and passes each record to out, dropping each
+          * record for which bp(previous record, record) is true.  The
+          * records passed to out are those that sort(comp) then unique(bp)
+          * would leave in the filter.
+          *
+          * The inputs are merged with a heap, so that only one record of
+          * each input is in memory at a time.  Each input is read once to
+          * check that it is in order; one that is not is sorted in runs
+          * of at most maxRecords records (see setStreaming()), which are
+          * written to new temporary files of unique names and merged
+          * with the other inputs.
+          * @param comp strict weak ordering of the data.
+          * @param bp test for equality.
+          * @param out function or functor called with each record, in order.
+          * @param tempDir the directory of the temporary files, which are
+          *   removed before returning; if empty, the system temporary
+          *   directory (see FileUtils::makeTempFile()).
+          * @return the number of records passed to out.
+          * @throw InvalidRequest if not in streaming mode.
+          * @throw Exception if a temporary file can not be written.
+          */
+      template <class Compare, class BinaryPredicate, class Output>
+      unsigned long streamMerge(Compare comp, BinaryPredicate bp, Output out,
+                                const std::string& tempDir = std::string())
+         throw(gpstk::Exception);
+
    protected:
          ///  Run init() to load the data into the filter.
       void init(const std::vector<FileHunter::FilterPair>& filter= 
                 std::vector<FileHunter::FilterPair>()) 
          throw(gpstk::Exception);
 
+         /// Writes whatever must precede the data of the input file
+         /// source in a temporary file of streamMerge().
+      virtual void writeRunHeader(FileStream& stream,
+                                  const std::string& source)
+         const throw(gpstk::Exception)
+      {}
+
+         /// One input of streamMerge(): a file that is in order.  The
+         /// file is only opened once its first record is taken.
+      struct MergeSource
+      {
+         MergeSource(const std::string& file, const FileData& first,
+                     bool isTemp)
+               : fileName(file), head(first), temp(isTemp)
+         {}
+
+            /// Replaces head with the next record of the file.
+            /// @return false at the end of the file, which is then closed.
+         bool next()
+         {
+            if (!stream)
+            {
+               stream.reset(new FileStream(fileName.c_str()));
+               FileData first;
+               *stream >> first;
+            }
+            if (*stream >> head)
+               return true;
+            stream.reset();
+            return false;
+         }
+
+         std::string fileName;
+         std::shared_ptr<FileStream> stream;
+            /// the current record
+         FileData head;
+            /// true if the file is temporary
+         bool temp;
+      };
 
    protected:   
          /// The file spec for this filter
       FileSpec fs;
          /// the start and end dates for the filter.
       gpstk::CommonTime startTime, endTime;
+         /// true in streaming mode
+      bool streaming;
+         /// the most records of one input to sort in memory, when streaming
+      unsigned long maxRun;
+         /// the input files, when streaming
+      std::vector<std::string> streamFiles;
 
    };
 
@@ -188,7 +286,7 @@ namespace gpstk
    FileFilterFrame(const gpstk::CommonTime& start,
                    const gpstk::CommonTime& end)
          throw(gpstk::Exception)
-         : startTime(start), endTime(end)
+         : startTime(start), endTime(end), streaming(false), maxRun(100000)
    {}
 
    template <class FileStream, class FileData>
@@ -197,7 +295,7 @@ namespace gpstk
                    const gpstk::CommonTime& start,
                    const gpstk::CommonTime& end)
          throw(gpstk::Exception)
-         : startTime(start), endTime(end)
+         : startTime(start), endTime(end), streaming(false), maxRun(100000)
    {
       typename std::vector<std::string>::const_iterator itr;
       for (itr = fileList.begin(); itr != fileList.end(); itr++)
@@ -213,7 +311,8 @@ namespace gpstk
                    const gpstk::CommonTime& start,
                    const gpstk::CommonTime& end)
          throw(gpstk::Exception)
-         : fs(filename), startTime(start), endTime(end)
+         : fs(filename), startTime(start), endTime(end), streaming(false),
+           maxRun(100000)
    {
       init();
    }
@@ -225,7 +324,8 @@ namespace gpstk
                    const gpstk::CommonTime& end,
                    const std::vector<FileHunter::FilterPair>& filter)
          throw(gpstk::Exception)
-         : fs(spec), startTime(start), endTime(end)
+         : fs(spec), startTime(start), endTime(end), streaming(false),
+           maxRun(100000)
    {
       init(filter);
    }
@@ -311,6 +411,11 @@ namespace gpstk
 
          if (s.good())
          {
+            if (streaming)
+            {
+               streamFiles.push_back(*i);
+               continue;
+            }
             FileData data;
             while (s >> data)
                this->addData(data);
@@ -318,6 +423,165 @@ namespace gpstk
       }
    }
 
+   template <class FileStream, class FileData>
+   FileFilterFrame<FileStream, FileData>& 
+   FileFilterFrame<FileStream,FileData> :: 
+   setStreaming(bool on, unsigned long maxRecords)
+      throw(gpstk::InvalidRequest)
+   {
+      if (!this->empty() || !streamFiles.empty())
+      {
+         gpstk::InvalidRequest exc("Streaming mode must be set before"
+                                   " any source is added.");
+         GPSTK_THROW(exc);
+      }
+      streaming = on;
+      maxRun = (maxRecords > 0 ? maxRecords : 1);
+      return *this;
+   }
+
+   template <class FileStream, class FileData>
+   template <class Compare, class BinaryPredicate, class Output>
+   unsigned long FileFilterFrame<FileStream,FileData> :: 
+   streamMerge(Compare comp, BinaryPredicate bp, Output out,
+               const std::string& tempDir)
+      throw(gpstk::Exception)
+   {
+      if (!streaming)
+      {
+         gpstk::InvalidRequest exc("streamMerge() requires streaming mode.");
+         GPSTK_THROW(exc);
+      }
+
+      typedef typename std::vector<MergeSource>::size_type SourceIndex;
+      std::vector<MergeSource> sources;
+      unsigned long count = 0;
+      this->filtered = 0;
+
+      try
+      {
+            // check that each input is in order; sort the ones that are not
+            // in runs, written to temporary files
+         std::vector<std::string>::size_type i;
+         for (i = 0; i < streamFiles.size(); i++)
+         {
+            FileData first, prev, data;
+            unsigned long n = 0;
+            bool sorted = true;
+            {
+               FileStream s(streamFiles[i].c_str());
+               while (s >> data)
+               {
+                  if (n == 0)
+                     first = data;
+                  else if (comp(data, prev))
+                  {
+                     sorted = false;
+                     break;
+                  }
+                  prev = data;
+                  n++;
+               }
+            }
+            if (sorted)
+            {
+               if (n > 0)
+                  sources.push_back(MergeSource(streamFiles[i], first, false));
+               continue;
+            }
+
+            FileStream s(streamFiles[i].c_str());
+            std::vector<FileData> run;
+            bool more = true;
+            while (more)
+            {
+               run.clear();
+               while (run.size() < maxRun)
+               {
+                  if (!(s >> data))
+                  {
+                     more = false;
+                     break;
+                  }
+                  run.push_back(data);
+               }
+               if (run.empty())
+                  break;
+
+               std::stable_sort(run.begin(), run.end(), comp);
+                  // a new file, so that no file of another is overwritten
+               std::string runFile(FileUtils::makeTempFile(tempDir,
+                                                           "gpstkMerge"));
+               if (runFile.empty())
+               {
+                  gpstk::Exception exc("Could not create a temporary file"
+                                       " in '" + tempDir + "'");
+                  GPSTK_THROW(exc);
+               }
+               sources.push_back(MergeSource(runFile, run.front(), true));
+               FileStream r(runFile.c_str(), std::ios::out|std::ios::trunc);
+               r.exceptions(std::ios::failbit);
+               writeRunHeader(r, streamFiles[i]);
+               typename std::vector<FileData>::const_iterator itr;
+               for (itr = run.begin(); itr != run.end(); itr++)
+                  r << (*itr);
+            }
+         }
+
+            // merge with a heap of source indexes, earliest head on top;
+            // ties go to the earlier source, as in the stable sort()
+         std::vector<SourceIndex> heap;
+         for (SourceIndex j = 0; j < sources.size(); j++)
+            heap.push_back(j);
+         auto later = [&sources, &comp](SourceIndex a, SourceIndex b)
+         {
+            return comp(sources[b].head, sources[a].head) ||
+               (!comp(sources[a].head, sources[b].head) && a > b);
+         };
+         std::make_heap(heap.begin(), heap.end(), later);
+
+         FileData last;
+         while (!heap.empty())
+         {
+            std::pop_heap(heap.begin(), heap.end(), later);
+            MergeSource& src(sources[heap.back()]);
+            if (count > 0 && bp(last, src.head))
+               this->filtered++;
+            else
+            {
+               out(src.head);
+               last = src.head;
+               count++;
+            }
+            if (src.next())
+               std::push_heap(heap.begin(), heap.end(), later);
+            else
+               heap.pop_back();
+         }
+      }
+      catch (...)
+      {
+         for (SourceIndex j = 0; j < sources.size(); j++)
+            if (sources[j].temp)
+               std::remove(sources[j].fileName.c_str());
+         try { throw; }
+         catch (gpstk::Exception& e) { GPSTK_RETHROW(e); }
+         catch (std::exception& e)
+         {
+            gpstk::Exception ge(e.what());
+            GPSTK_THROW(ge);
+         }
+      }
+
+      for (SourceIndex j = 0; j < sources.size(); j++)
+         if (sources[j].temp)
+         {
+            sources[j].stream.reset();
+            std::remove(sources[j].fileName.c_str());
+         }
+      return count;
+   }
+
    template <class FileStream, class FileData>
    bool FileFilterFrame<FileStream,FileData> :: 
    writeFile(const std::string& str,
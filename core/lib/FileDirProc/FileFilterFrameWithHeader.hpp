@@ -45,6 +45,7 @@
 
 #include "Rinex3ObsData.hpp"
 #include "FileFilterFrame.hpp"
+#include <map>
 #include <math.h>
 
 namespace gpstk
@@ -192,6 +193,36 @@ namespace gpstk
                      const FileHeader& fh) const
          throw(gpstk::Exception);
 
+         /**
+          * In streaming mode, writes the data of all the sources to the
+          * file outputFile with the given header, merged with
+          * streamMerge(), so the file is the one writeFile() would write
+          * after sort(comp) and unique(bp).  This will overwrite any
+          * existing file with the same name.
+          * @return the number of records written.
+          */
+      template <class Compare, class BinaryPredicate>
+      unsigned long mergeFile(const std::string& outputFile,
+                              const FileHeader& fh,
+                              Compare comp, BinaryPredicate bp)
+         throw(gpstk::Exception)
+      {
+            // make the directory (if needed)
+         std::string::size_type pos = outputFile.rfind('/');
+
+         if (pos != std::string::npos)
+            gpstk::FileUtils::makeDir(outputFile.substr(0,pos).c_str(), 0755);
+
+         FileStream stream(outputFile.c_str(), std::ios::out|std::ios::trunc);
+         stream.exceptions(std::ios::failbit);
+
+         stream << fh;
+
+         return this->streamMerge(comp, bp,
+                                  [&stream](const FileData& data)
+                                  { stream << data; });
+      }
+
       /// Returns a list of the data in *this that isn't in r.
       template <class BinaryPredicate>
       std::list<FileData>
@@ -285,6 +316,22 @@ namespace gpstk
          throw(gpstk::InvalidRequest);
 
    protected:
+         /// Writes the header of the input file to a temporary file of
+         /// streamMerge(), so its data can be read back.
+      virtual void writeRunHeader(FileStream& stream,
+                                  const std::string& source)
+         const throw(gpstk::Exception)
+      {
+         typename std::map<std::string, FileHeader>::const_iterator itr =
+            streamHeaders.find(source);
+         if (itr == streamHeaders.end())
+         {
+            gpstk::InvalidRequest exc("No header for " + source);
+            GPSTK_THROW(exc);
+         }
+         stream << itr->second;
+      }
+
          ///  Run init() to load the data into the filter.  
       void init(const std::vector<FileHunter::FilterPair>& filter= 
                 std::vector<FileHunter::FilterPair>()) 
@@ -304,6 +351,8 @@ namespace gpstk
 
    protected:   
       std::list<FileHeader> headerList;
+         /// the header of each input file, when streaming
+      std::map<std::string, FileHeader> streamHeaders;
    };
 
       //@}
@@ -456,6 +505,8 @@ namespace gpstk
             FileHeader header;
             s >> header;
             headerList.push_back(header);
+            if (this->streaming)
+               streamHeaders[*i] = header;
          }
       }
    }
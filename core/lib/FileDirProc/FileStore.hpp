@@ -63,6 +63,8 @@ namespace gpstk
 
          /// A store of all headers loaded, indexed by file name
       std::map<std::string, HeaderType> headerMap;
+         /// The file names, in the order they were added
+      std::vector<std::string> fileOrder;
 
    public:
 
@@ -81,6 +83,11 @@ namespace gpstk
             names.push_back(fit->first);
          return names;
       }
+
+         /** Get a list of all the file names in the store, in the
+          * order they were added. */
+      const std::vector<std::string>& getFileNamesInOrder() const throw()
+      { return fileOrder; }
       
          /// Add a filename, with its header, to the store
       void addFile(const std::string& fn, HeaderType& header)
@@ -92,6 +99,7 @@ namespace gpstk
             GPSTK_THROW(e);
          }
          headerMap.insert(make_pair(fn,header));
+         fileOrder.push_back(fn);
       }
 
          /// Access the header for a given filename
@@ -133,6 +141,7 @@ namespace gpstk
          throw()
       {
          headerMap.clear();
+         fileOrder.clear();
       }
 
 
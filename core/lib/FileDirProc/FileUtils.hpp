@@ -50,6 +50,8 @@
 #include <iostream>
 // #endif
 
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <string>
 #include "StringUtils.hpp"
@@ -57,6 +59,7 @@
 #ifdef WIN32
 #include <direct.h>
 #include <io.h>
+#include <fcntl.h>
 #endif
 
 using namespace std;
@@ -153,6 +156,63 @@ namespace gpstk
       {
          return fileAccessCheck(fname.c_str(), mode);
       }
+
+         /**
+          * Creates a new, empty file with a unique name, so that no
+          * existing file is ever opened or truncated in its place.
+          * @param dir the directory of the file; if empty, the
+          *   directory named by TMPDIR (TEMP on Windows), or /tmp.
+          * @param prefix the start of the name of the file
+          * @return the name of the file, or an empty string if no
+          *   file could be created
+          */
+      inline std::string makeTempFile(const std::string& dir,
+                                      const std::string& prefix)
+      {
+         std::string path(dir);
+         if (path.empty())
+         {
+#ifdef WIN32
+            const char *env = std::getenv("TEMP");
+            path = (env ? env : ".");
+#else
+            const char *env = std::getenv("TMPDIR");
+            path = (env && *env ? env : "/tmp");
+#endif
+         }
+         if (path[path.length()-1] != '/' && path[path.length()-1] != '\\')
+            path += '/';
+         path += prefix + "XXXXXX";
+
+#ifdef WIN32
+            // _mktemp_s only picks an unused name; _O_EXCL makes the
+            // create fail, rather than open a file made since
+         for (int tries = 0; tries < 10; tries++)
+         {
+            std::string name(path);
+            if (_mktemp_s(&name[0], name.length()+1) != 0)
+               return std::string();
+            int fd = _open(name.c_str(), _O_CREAT|_O_EXCL|_O_RDWR,
+                           _S_IREAD|_S_IWRITE);
+            if (fd >= 0)
+            {
+               _close(fd);
+               return name;
+            }
+         }
+         return std::string();
+#else
+            // fdopen() and fclose() rather than close(), which would
+            // need unistd.h and its getopt() here
+         int fd = mkstemp(&path[0]);
+         if (fd < 0)
+            return std::string();
+         FILE *fp = fdopen(fd, "w");
+         if (fp)
+            fclose(fp);
+         return path;
+#endif
+      }
       
 
    } // namespace FileUtils
@@ -39,12 +39,14 @@
  * An FFStream for text files
  */
 
+#include <cstring>
 #include "FFTextStream.hpp"
 
 namespace gpstk
 {
    FFTextStream ::
    FFTextStream()
+         : mapped(false), mapPos(0)
    {
       init();
    }
@@ -53,13 +55,15 @@ namespace gpstk
    FFTextStream ::
    ~FFTextStream()
    {
+      unmap();
    }
 
 
    FFTextStream ::
    FFTextStream( const char* fn,
                  std::ios::openmode mode )
-         : FFStream(fn, mode)
+         : FFStream(fn, mode),
+           mapped(false), mapPos(0)
    {
       init();
    }
@@ -68,7 +72,8 @@ namespace gpstk
    FFTextStream ::
    FFTextStream( const std::string& fn,
                  std::ios::openmode mode )
-         : FFStream( fn.c_str(), mode )
+         : FFStream( fn.c_str(), mode ),
+           mapped(false), mapPos(0)
    {
       init();
    }
@@ -95,6 +100,39 @@ namespace gpstk
    init()
    {
       lineNumber = 0;
+      unmap();
+   }
+
+
+   bool FFTextStream ::
+   memoryMap()
+   {
+      unmap();
+      if (!is_open() || filename.empty())
+         return false;
+         // pick up where the fstream left off, e.g. after a header
+      std::streamoff start = 0;
+      if (good())
+      {
+         start = tellg();
+         if (start < 0)
+            start = 0;
+      }
+      if (!map.open(filename, true))
+         return false;
+      mapPos = (static_cast<std::size_t>(start) < map.size()
+                ? static_cast<std::size_t>(start) : map.size());
+      mapped = true;
+      return true;
+   }
+
+
+   void FFTextStream ::
+   unmap()
+   {
+      map.close();
+      mapped = false;
+      mapPos = 0;
    }
 
 
@@ -103,16 +141,22 @@ namespace gpstk
       throw(FFStreamError, gpstk::StringUtils::StringException)
    {
       unsigned int initialLineNumber = lineNumber;
+      std::size_t initialMapPos = mapPos;
 
       try
       {
          FFStream::tryFFStreamGet(rec);
+            // FFStream rewinds the fstream when a record fails to
+            // decode, do the same for the memory map.
+         if (fail() && !eof())
+            mapPos = initialMapPos;
       }
       catch(gpstk::Exception& e)
       {
          e.addText( std::string("Near file line ") +
                     gpstk::StringUtils::asString(lineNumber) );
          lineNumber = initialLineNumber;
+         mapPos = initialMapPos;
          mostRecentException = e;
          conditionalThrow();
       }
@@ -150,6 +194,17 @@ namespace gpstk
                      const bool expectEOF )
       throw(EndOfFile, FFStreamError, gpstk::StringUtils::StringException)
    {
+      if (mapped)
+      {
+            // like getline, leave the line alone if nothing is read
+         LineView view;
+         view.data = line.c_str();
+         view.length = line.length();
+         getMappedLine(view, expectEOF);
+         if (view.data != line.c_str())
+            line.assign(view.data, view.length);
+         return;
+      }
       try
       {
          std::getline(*this, line);
@@ -208,5 +263,121 @@ namespace gpstk
          }
       }
    }  // End of method 'FFTextStream::formattedGetLine()'
+
+
+   void FFTextStream ::
+   formattedGetLine( LineView& line,
+                     const bool expectEOF )
+      throw(EndOfFile, FFStreamError, gpstk::StringUtils::StringException)
+   {
+      if (mapped)
+      {
+         getMappedLine(line, expectEOF);
+      }
+      else
+      {
+         formattedGetLine(lineBuffer, expectEOF);
+         line.data = lineBuffer.c_str();
+         line.length = lineBuffer.length();
+      }
+   }
+
+
+      // This mirrors the std::getline based formattedGetLine() above,
+      // including the stream state flags, so that callers can't tell
+      // the difference between the two.
+   void FFTextStream ::
+   getMappedLine( LineView& line,
+                  const bool expectEOF )
+      throw(EndOfFile, FFStreamError)
+   {
+      try
+      {
+         if (!good())
+         {
+               // failed sentry, line is left unchanged
+            setstate(std::ios::failbit);
+            lineNumber++;
+         }
+         else if (mapPos >= map.size())
+         {
+            line.data = map.data() + mapPos;
+            line.length = 0;
+               // nothing extracted, just like getline
+            setstate(std::ios::eofbit | std::ios::failbit);
+            lineNumber++;
+         }
+         else
+         {
+            line.data = map.data() + mapPos;
+            std::size_t remain = map.size() - mapPos;
+            const char *eol = static_cast<const char*>(
+               std::memchr(line.data, '\n', remain));
+            if (eol == NULL)
+            {
+               line.length = remain;
+               mapPos = map.size();
+               setstate(std::ios::eofbit);
+            }
+            else
+            {
+               line.length = eol - line.data;
+               mapPos += line.length + 1;
+            }
+               // Remove CR characters left over from windows files
+            while ((line.length > 0) && (line.data[line.length-1] == '\r'))
+               line.length--;
+            for (std::size_t i=0; i<line.length; i++)
+               if (!isprint(line.data[i]))
+               {
+                  FFStreamError err("Non-text data in file.");
+                  GPSTK_THROW(err);
+               }
+            lineNumber++;
+         }
+         if (fail() && !eof())
+         {
+            FFStreamError err("Line too long");
+            GPSTK_THROW(err);
+         }
+            // catch EOF when stream exceptions are disabled
+         if ((line.length == 0) && eof())
+         {
+            if (expectEOF)
+            {
+               EndOfFile err("EOF encountered");
+               GPSTK_THROW(err);
+            }
+            else
+            {
+               FFStreamError err("Unexpected EOF encountered");
+               GPSTK_THROW(err);
+            }
+         }
+      }
+      catch(std::exception &e)
+      {
+            // catch EOF when exceptions are enabled
+         if ((line.length == 0) && eof())
+         {
+            if (expectEOF)
+            {
+               EndOfFile err("EOF encountered");
+               GPSTK_THROW(err);
+            }
+            else
+            {
+               FFStreamError err("Unexpected EOF");
+               GPSTK_THROW(err);
+            }
+         }
+         else
+         {
+            FFStreamError err("Critical file error: " +
+                              std::string(e.what()));
+            GPSTK_THROW(err);
+         }
+      }
+   }  // End of method 'FFTextStream::getMappedLine()'
    
 }  // End of namespace gpstk
@@ -42,7 +42,9 @@
 #ifndef GPSTK_FFTEXTSTREAM_HPP
 #define GPSTK_FFTEXTSTREAM_HPP
 
+#include <cstddef>
 #include "FFStream.hpp"
+#include "MappedFile.hpp"
 
 namespace gpstk
 {
@@ -57,10 +59,66 @@ namespace gpstk
        * update the line number - the derived class or programmer
        * needs to make sure that the reader or writer increments
        * lineNumber in these cases.
+       *
+       * For large input files, memoryMap() may be called after
+       * opening the stream to switch formattedGetLine() over to
+       * reading from a read-only memory map of the whole file rather
+       * than through the std::fstream buffer.  In this mode a LineView
+       * may be used to access each line without copying it.  The
+       * lineNumber, EOF and error semantics are the same in both
+       * modes.  Memory-mapped mode is for reading only, and any
+       * reading that bypasses formattedGetLine() (e.g. std::getline()
+       * or seekg() on the stream) is not supported in this mode.  The
+       * RINEX navigation, SP3 and RINEX clock files loaded by the
+       * ephemeris stores are read this way.
        */
    class FFTextStream : public FFStream
    {
    public:
+         /**
+          * Non-owning view of a single line read by formattedGetLine().
+          * The view remains valid until the next call to
+          * formattedGetLine(), open() or the destruction of the stream.
+          * The line is NOT null-terminated.
+          */
+      class LineView
+      {
+      public:
+            /// Initialize to an empty line.
+         LineView()
+               : data(""), length(0)
+         {}
+
+            /// Number of characters in the line, excluding any EOL.
+         std::string::size_type size() const
+         { return length; }
+
+            /// Character at position \a i, unchecked.
+         char operator[](std::string::size_type i) const
+         { return data[i]; }
+
+            /// Copy of the characters in [pos,pos+n), clipped to the line.
+         std::string substr(std::string::size_type pos = 0,
+                            std::string::size_type n = std::string::npos)
+            const
+         {
+            if (pos >= length)
+               return std::string();
+            if (n > length - pos)
+               n = length - pos;
+            return std::string(data + pos, n);
+         }
+
+            /// Copy of the whole line.
+         std::string str() const
+         { return std::string(data, length); }
+
+            /// First character of the line.
+         const char *data;
+            /// Number of characters in the line.
+         std::string::size_type length;
+      }; // End of class 'LineView'
+
          /// Default constructor
       FFTextStream();
 
@@ -83,11 +141,11 @@ namespace gpstk
       FFTextStream( const std::string& fn,
                     std::ios::openmode mode=std::ios::in );
 
-         /// Overrides open to reset the line number.
+         /// Overrides open to reset the line number and memory map.
       virtual void open( const char* fn,
                          std::ios::openmode mode );
 
-         /// Overrides open to reset the line number.
+         /// Overrides open to reset the line number and memory map.
       virtual void open( const std::string& fn,
                          std::ios::openmode mode );
 
@@ -117,6 +175,44 @@ namespace gpstk
                              const bool expectEOF = false )
          throw(EndOfFile, FFStreamError, gpstk::StringUtils::StringException);
 
+         /**
+          * Same as formattedGetLine(std::string&,const bool) but
+          * returns a view of the line rather than a copy.  When the
+          * stream is memory mapped, the view refers directly to the
+          * mapped file and no copying or allocation takes place.
+          * Otherwise the view refers to an internal buffer that is
+          * reused from line to line.
+          * @param[out] line is set to refer to the line read from
+          *   the file.
+          * @param[in] expectEOF set true if finding EOF on this read
+          *   is acceptable.
+          * @throw EndOfFile if \a expectEOF is true and an EOF is encountered.
+          * @throw FFStreamError if EOF is found and \a expectEOF is false
+          * @throw gpstk::StringUtils::StringException when a string
+          *   error occurs or if any other error happens.
+          */
+      void formattedGetLine( LineView& line,
+                             const bool expectEOF = false )
+         throw(EndOfFile, FFStreamError, gpstk::StringUtils::StringException);
+
+         /**
+          * Switch this stream to memory-mapped reading.  The file
+          * named by \a filename is mapped read-only and subsequent
+          * formattedGetLine() calls will continue reading from the
+          * current stream position within the mapped file.  Where
+          * memory mapping is not available, the file contents are
+          * read into memory once instead.  The mapping is released
+          * when the stream is re-opened or destroyed.
+          * @return true if the stream is now memory mapped, false if
+          *   the stream is not open or the file could not be mapped,
+          *   in which case the stream continues to read normally.
+          */
+      bool memoryMap();
+
+         /// Return true if formattedGetLine() reads from a memory map.
+      bool isMemoryMapped() const
+      { return mapped; }
+
 
    protected:
 
@@ -132,6 +228,23 @@ namespace gpstk
          /// Initialize internal data structures
       void init();
 
+         /// Release any memory map and return to normal reading.
+      void unmap();
+
+         /// Implementation of formattedGetLine() for mapped files.
+      void getMappedLine( LineView& line,
+                          const bool expectEOF )
+         throw(EndOfFile, FFStreamError);
+
+         /// true if formattedGetLine() reads from map.
+      bool mapped;
+         /// The file contents, when memoryMap() has been called.
+      MappedFile map;
+         /// Offset in map of the next line to be read.
+      std::size_t mapPos;
+         /// Buffer used by formattedGetLine(LineView&) when not mapped.
+      std::string lineBuffer;
+
    }; // End of class 'FFTextStream'
 
       //@}
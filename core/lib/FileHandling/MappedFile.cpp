@@ -0,0 +1,134 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/**
+ * @file MappedFile.cpp
+ * Read-only access to the whole contents of a file, by memory map
+ * where available.
+ */
+
+#include <fstream>
+#include <iterator>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "MappedFile.hpp"
+
+namespace gpstk
+{
+   MappedFile ::
+   MappedFile()
+      throw()
+         : mapData(NULL), mapSize(0), mapIsMmap(false)
+   {
+   }
+
+
+   MappedFile ::
+   ~MappedFile()
+      throw()
+   {
+      close();
+   }
+
+
+   bool MappedFile ::
+   open(const std::string& filename, bool sequential)
+      throw()
+   {
+      close();
+#ifndef _WIN32
+      int fd = ::open(filename.c_str(), O_RDONLY);
+      if (fd < 0)
+         return false;
+      struct stat st;
+      if ((::fstat(fd, &st) == 0) && (st.st_size > 0))
+      {
+         void *addr = ::mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+         if (addr != MAP_FAILED)
+         {
+            if (sequential)
+               ::madvise(addr, st.st_size, MADV_SEQUENTIAL);
+            mapData = static_cast<const char*>(addr);
+            mapSize = st.st_size;
+            mapIsMmap = true;
+         }
+      }
+      ::close(fd);
+#endif
+      if (!mapIsMmap)
+      {
+            // no mmap (or an empty file), so just read the file
+         try
+         {
+            std::ifstream ifs(filename.c_str(),
+                              std::ios::in|std::ios::binary);
+            if (!ifs)
+               return false;
+            mapCopy.assign(std::istreambuf_iterator<char>(ifs),
+                           std::istreambuf_iterator<char>());
+         }
+         catch (std::exception&)
+         {
+            close();
+            return false;
+         }
+         mapSize = mapCopy.size();
+         mapData = mapSize ? &mapCopy[0] : "";
+      }
+      return true;
+   }
+
+
+   void MappedFile ::
+   close()
+      throw()
+   {
+#ifndef _WIN32
+      if (mapIsMmap)
+      {
+         ::munmap(const_cast<char*>(mapData), mapSize);
+      }
+#endif
+      std::vector<char>().swap(mapCopy);
+      mapIsMmap = false;
+      mapData = NULL;
+      mapSize = 0;
+   }
+
+}  // End of namespace gpstk
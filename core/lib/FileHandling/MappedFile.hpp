@@ -0,0 +1,110 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/**
+ * @file MappedFile.hpp
+ * Read-only access to the whole contents of a file, by memory map
+ * where available.
+ */
+
+#ifndef GPSTK_MAPPEDFILE_HPP
+#define GPSTK_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /** The contents of a file, mapped into memory with mmap() or,
+       * where that is not available or fails, read into a buffer.
+       * Used by readers that parse a file in place, e.g.
+       * FFTextStream::memoryMap(). */
+   class MappedFile
+   {
+   public:
+      MappedFile() throw();
+      ~MappedFile() throw();
+
+         /** Map a file, after closing any file already mapped.
+          * @param[in] filename name of the file.
+          * @param[in] sequential true to advise the system that the
+          *   file will be read from start to end.
+          * @return true if the file was mapped or read, false if it
+          *   could not be opened. */
+      bool open(const std::string& filename, bool sequential = false)
+         throw();
+
+         /// Release the contents.
+      void close() throw();
+
+         /// Return true if a file is open.
+      bool isOpen() const throw()
+      { return (mapData != NULL); }
+
+         /// Return true if the contents are a memory map.
+      bool isMmap() const throw()
+      { return mapIsMmap; }
+
+         /// Return the start of the contents, NULL if not open.
+      const char* data() const throw()
+      { return mapData; }
+
+         /// Return the size of the contents in bytes.
+      std::size_t size() const throw()
+      { return mapSize; }
+
+   private:
+         /// Start of the contents, in the mapping or mapCopy.
+      const char *mapData;
+         /// Size of the contents in bytes.
+      std::size_t mapSize;
+         /// true if mapData refers to an mmap() region vs. mapCopy.
+      bool mapIsMmap;
+         /// File contents when mmap() is unavailable.
+      std::vector<char> mapCopy;
+
+         // not copyable; the mapping is owned
+      MappedFile(const MappedFile&);
+      MappedFile& operator=(const MappedFile&);
+   };
+
+      //@}
+
+}  // End of namespace gpstk
+#endif   // GPSTK_MAPPEDFILE_HPP
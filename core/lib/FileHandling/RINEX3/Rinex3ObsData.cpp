@@ -581,6 +581,35 @@ namespace gpstk
          // If the header hasn't been read, read it.
       if(!strm.headerRead) strm >> strm.header;
 
+      if(strm.fastDecode && strm.header.version >= 3)
+      {
+            // Clear out this ObsData, except for obs, which
+            // getObsFast() recycles.  The auxiliary header is only
+            // reset when it may have been used, as that is relatively
+            // expensive.
+         if((epochFlag >= 2 && epochFlag <= 5) || auxHeader.valid)
+            auxHeader = Rinex3ObsHeader();
+         time = CommonTime::BEGINNING_OF_TIME;
+         epochFlag = -1;
+         numSVs = -1;
+         clockOffset = 0.;
+         try
+         {
+            reallyGetRecordVer3(strm);
+         }
+         catch(Exception& e)
+         {
+            obs.clear();
+            GPSTK_RETHROW(e);
+         }
+         catch(std::exception& e)
+         {
+            obs.clear();
+            throw;
+         }
+         return;
+      }
+
       Rinex3ObsData rod;
 
          // clear out this ObsData
@@ -600,6 +629,13 @@ namespace gpstk
          return;
       }
 
+      reallyGetRecordVer3(strm);
+   } // end of reallyGetRecord()
+
+
+   void Rinex3ObsData::reallyGetRecordVer3(Rinex3ObsStream& strm)
+      throw(std::exception, FFStreamError, gpstk::StringUtils::StringException)
+   {
       string line;
 
          // read the first (epoch) line
@@ -631,7 +667,12 @@ namespace gpstk
          clockOffset = 0.0;
 
          // Read the observations: SV ID and data ----------------------------
-      if(epochFlag == 0 || epochFlag == 1 || epochFlag == 6)
+      if((epochFlag == 0 || epochFlag == 1 || epochFlag == 6) &&
+         strm.fastDecode)
+      {
+         getObsFast(strm);
+      }
+      else if(epochFlag == 0 || epochFlag == 1 || epochFlag == 6)
       {
          vector<RinexSatID> satIndex(numSVs);
          map<RinexSatID, vector<RinexDatum> > tempDataMap;
@@ -682,6 +723,7 @@ namespace gpstk
          // ... or the auxiliary header information
       else if(numSVs > 0)
       {
+         obs.clear();
          auxHeader.clear();
          for(int i = 0; i < numSVs; i++)
          {
@@ -701,10 +743,116 @@ namespace gpstk
             }
          }
       }
+      else
+      {
+         obs.clear();
+      }
 
       return;
 
-   } // end of reallyGetRecord()
+   } // end of reallyGetRecordVer3()
+
+
+      /** Parse the common "ann" form of a RINEX 3 satellite ID
+       * without going through RinexSatID::fromString().
+       * @param[in] str start of the satellite ID field
+       * @param[in] len number of characters available at \a str
+       * @param[out] sat the satellite ID if it could be parsed.
+       * @return false if the ID needs to be parsed the long way. */
+   static bool fastSatID(const char *str, std::string::size_type len,
+                         RinexSatID& sat)
+   {
+      if((len < 3) || (str[2] < '0') || (str[2] > '9'))
+         return false;
+      int id;
+      if(str[1] == ' ')
+         id = str[2] - '0';
+      else if((str[1] >= '0') && (str[1] <= '9'))
+         id = (str[1] - '0') * 10 + (str[2] - '0');
+      else
+         return false;
+      if(id <= 0)
+         return false;
+      SatID::SatelliteSystem sys;
+      switch(str[0])
+      {
+         case 'G': sys = SatID::systemGPS;     break;
+         case 'R': sys = SatID::systemGlonass; break;
+         case 'E': sys = SatID::systemGalileo; break;
+         case 'S': sys = SatID::systemGeosync; break;
+         case 'J': sys = SatID::systemQZSS;    break;
+         case 'C': sys = SatID::systemBeiDou;  break;
+         case 'I': sys = SatID::systemIRNSS;   break;
+         case 'T': sys = SatID::systemTransit; break;
+         default: return false;
+      }
+      sat = RinexSatID(id, sys);
+      return true;
+   }
+
+
+   void Rinex3ObsData::getObsFast(Rinex3ObsStream& strm)
+      throw(std::exception, FFStreamError, StringException)
+   {
+      FFTextStream::LineView line;
+      vector<RinexSatID>& sats(strm.epochSats);
+      sats.clear();
+
+      for(int isv = 0; isv < numSVs; isv++)
+      {
+         strm.formattedGetLine(line);
+            // equivalent of stripTrailing(line, " ")
+         std::string::size_type len = line.size();
+         while(len > 0 && line[len-1] == ' ')
+            len--;
+
+            // get the SV ID
+         RinexSatID sat;
+         if(!fastSatID(line.data, len, sat))
+         {
+            try
+            {
+               sat = RinexSatID(line.substr(0, len < 3 ? len : 3));
+            }
+            catch (Exception& e)
+            {
+               FFStreamError ffse(e);
+               GPSTK_THROW(ffse);
+            }
+         }
+         sats.push_back(sat);
+
+            // get the # data items (# entries in ObsType map of
+            // maps from header)
+         string gnss(1, sat.systemChar());
+         int size = strm.header.mapObsTypes[gnss].size();
+
+            // Fields past the end of the line are blank (see the
+            // note on padding in reallyGetRecordVer3).  Recycle the
+            // vector from the previous epoch where there is one.
+         vector<RinexDatum>& data(obs[sat]);
+         data.resize(size);
+         for(int i = 0; i < size; i++)
+         {
+            std::string::size_type pos = 3 + 16*i;
+            if(pos < len)
+               data[i].fromString(line.data + pos, len - pos);
+            else
+               data[i].fromString(line.data, 0);
+         }
+      }
+
+         // Drop the satellites left over from the previous epoch.
+      std::sort(sats.begin(), sats.end());
+      DataMap::iterator it = obs.begin();
+      while(it != obs.end())
+      {
+         if(std::binary_search(sats.begin(), sats.end(), it->first))
+            ++it;
+         else
+            obs.erase(it++);
+      }
+   } // end of getObsFast()
 
 
    CommonTime Rinex3ObsData::parseTime(const string& line,
@@ -54,6 +54,7 @@
 
 namespace gpstk
 {
+   class Rinex3ObsStream;
 
       /// @ingroup FileHandling
       //@{
@@ -198,6 +199,23 @@ namespace gpstk
 
    private:
 
+         /** Read a RINEX 3 epoch, i.e. the body of reallyGetRecord()
+          * for version 3 files.  When Rinex3ObsStream::fastDecode is
+          * set, the observations are decoded by getObsFast() rather
+          * than building a new DataMap.
+          * @param[in] strm the stream to read from. */
+      void reallyGetRecordVer3(Rinex3ObsStream& strm)
+         throw( std::exception, FFStreamError,
+                gpstk::StringUtils::StringException );
+
+         /** Read the satellite/observation lines of a RINEX 3 epoch
+          * into obs, reusing the existing map nodes and vectors and
+          * decoding each datum in place.
+          * @param[in] strm the stream positioned after the epoch line. */
+      void getObsFast(Rinex3ObsStream& strm)
+         throw( std::exception, FFStreamError,
+                gpstk::StringUtils::StringException );
+
 
          /// Writes the CommonTime into RINEX 3 format.
          /// If it's a bad time, it will return blanks.
@@ -0,0 +1,164 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/** @file Rinex3ObsPlan.cpp
+ * Resolve a list of RINEX observation types to header column indexes once,
+ * for fast access to the data of every epoch.
+ */
+
+#include "RinexObsID.hpp"
+#include "Rinex3ObsPlan.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   const int Rinex3ObsPlan::NONE;
+   const int Rinex3ObsPlan::NSLOTS;
+
+
+   Rinex3ObsPlan::Rinex3ObsPlan(const Rinex3ObsHeader& hdr,
+                                const vector<string>& types)
+      throw(InvalidRequest)
+         : ntypes(types.size()), table(NSLOTS*types.size(), NONE)
+   {
+      for(size_t k=0; k<ntypes; k++)
+      {
+         const string& type(types[k]);
+         if(type.size() == 4)
+         {
+            if(!isValidRinexObsID(type))
+            {
+               InvalidRequest ir(type + " is not a valid RinexObsID.");
+               GPSTK_THROW(ir);
+            }
+            resolve(hdr, type[0], type.substr(1), k);
+         }
+         else if(type.size() == 3)
+         {
+            if(!isValidRinexObsID(type))
+            {
+               InvalidRequest ir(type + " is not a valid RinexObsID.");
+               GPSTK_THROW(ir);
+            }
+            Rinex3ObsHeader::RinexObsMap::const_iterator it;
+            for(it = hdr.mapObsTypes.begin(); it != hdr.mapObsTypes.end(); ++it)
+               if(!it->first.empty())
+                  resolve(hdr, it->first[0], type, k);
+         }
+         else
+         {
+            InvalidRequest ir("Invalid type " + type);
+            GPSTK_THROW(ir);
+         }
+      }
+   }
+
+
+   Rinex3ObsPlan::Rinex3ObsPlan(const Rinex3ObsHeader& hdr,
+                                const vector<RinexObsID>& types)
+      throw()
+         : ntypes(types.size()), table(NSLOTS*types.size(), NONE)
+   {
+      Rinex3ObsHeader::RinexObsMap::const_iterator it;
+      for(it = hdr.mapObsTypes.begin(); it != hdr.mapObsTypes.end(); ++it)
+      {
+         const int s(it->first.empty() ? -1 : slot(it->first[0]));
+         if(s < 0) continue;
+         const Rinex3ObsHeader::RinexObsVec& rov(it->second);
+         for(size_t k=0; k<ntypes; k++)
+            for(size_t j=0; j<rov.size(); j++)
+               if(rov[j] == types[k])
+               {
+                  table[s*ntypes+k] = j;
+                  break;
+               }
+      }
+   }
+
+
+   void Rinex3ObsPlan::resolve(const Rinex3ObsHeader& hdr, const char sysChar,
+                               const string& type, const size_t k)
+      throw()
+   {
+      const int s(slot(sysChar));
+      const string sys(1, sysChar);
+      Rinex3ObsHeader::RinexObsMap::const_iterator it(hdr.mapObsTypes.find(sys));
+      if(s < 0 || it == hdr.mapObsTypes.end())
+         return;
+         // not every type is valid for every system, e.g. C1P for Galileo
+      if(!isValidRinexObsID(type, sysChar))
+         return;
+
+      const RinexObsID obsID(sys + type);
+      const Rinex3ObsHeader::RinexObsVec& rov(it->second);
+      for(size_t j=0; j<rov.size(); j++)
+         if(rov[j] == obsID)
+         {
+            table[s*ntypes+k] = j;
+            return;
+         }
+   }
+
+
+   void Rinex3ObsPlan::extract(const Rinex3ObsData& rod,
+                               vector<RinexSatID>& sats,
+                               vector<double>& data) const
+      throw()
+   {
+      sats.resize(rod.obs.size());
+      data.resize(rod.obs.size()*ntypes);
+
+      size_t i(0);
+      Rinex3ObsData::DataMap::const_iterator it;
+      for(it = rod.obs.begin(); it != rod.obs.end(); ++it, ++i)
+      {
+         sats[i] = it->first;
+         const vector<RinexDatum>& vrdata(it->second);
+         const int s(slot(it->first.systemChar()));
+         const int *row(s < 0 ? 0 : &table[s*ntypes]);
+         double *out(ntypes ? &data[i*ntypes] : 0);
+         for(size_t k=0; k<ntypes; k++)
+         {
+            const int j(row ? row[k] : NONE);
+            out[k] = (j == NONE || size_t(j) >= vrdata.size())
+               ? 0.0 : vrdata[j].data;
+         }
+      }
+   }
+
+} // End of namespace gpstk
@@ -0,0 +1,179 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file Rinex3ObsPlan.hpp
+ * Resolve a list of RINEX observation types to header column indexes once,
+ * for fast access to the data of every epoch.
+ */
+
+#ifndef GPSTK_RINEX3OBSPLAN_HPP
+#define GPSTK_RINEX3OBSPLAN_HPP
+
+#include <string>
+#include <vector>
+
+#include "Exception.hpp"
+#include "RinexSatID.hpp"
+#include "RinexDatum.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /** An immutable "accessor plan" for a RINEX observation file.
+       * Rinex3ObsData::getObs(sat, type, hdr) looks the system up in
+       * Rinex3ObsHeader::mapObsTypes and then searches the list of
+       * RinexObsIDs, for every satellite and every epoch. This class
+       * does that search once per header, for a given list of types,
+       * and stores the result in a table indexed by system character
+       * and type, so that each access is an array lookup.
+       *
+       * @code
+       * Rinex3ObsPlan plan(hdr, types);     // e.g. types = C1C, L1C, GC2W
+       * while(strm >> rod) {
+       *    plan.extract(rod, sats, data);   // sats.size() x types.size()
+       *    ...
+       * }
+       * @endcode
+       *
+       * The plan must be rebuilt if the header changes. */
+   class Rinex3ObsPlan
+   {
+   public:
+         /// Index of a type that is not in the header for a system.
+      static const int NONE = -1;
+
+         /// Default constructor, with no types.
+      Rinex3ObsPlan() : ntypes(0) {}
+
+         /** Construct a plan for the given types, from the header.
+          * @param[in] hdr header of the RINEX observation file
+          * @param[in] types list of observation types; a 3-character
+          *   type (e.g. "C1C") applies to every system in the header,
+          *   a 4-character type (e.g. "GC1C") to that system only.
+          * @throw InvalidRequest if a type is not a valid RINEX 3
+          *   observation type. A valid type that is not in the header
+          *   is not an error; its index is NONE. */
+      Rinex3ObsPlan(const Rinex3ObsHeader& hdr,
+                    const std::vector<std::string>& types)
+         throw(InvalidRequest);
+
+         /** Construct a plan for the given types, from the header; each
+          * type is looked for in the types of every system in the header,
+          * as by Rinex3ObsHeader::getObsIndex(sys, obsID). */
+      Rinex3ObsPlan(const Rinex3ObsHeader& hdr,
+                    const std::vector<RinexObsID>& types)
+         throw();
+
+         /// Number of types in the plan
+      size_t size() const throw()
+      { return ntypes; }
+
+         /** Index of type k in the data of a satellite of system
+          * sysChar, or NONE if there is no such data. */
+      int index(const char sysChar, const size_t k) const throw()
+      {
+         const int s(slot(sysChar));
+         return (s < 0 || k >= ntypes) ? NONE : table[s*ntypes+k];
+      }
+
+         /** Get type k of the satellite's data.
+          * @param[in] sat satellite of the data
+          * @param[in] vrdata data of that satellite, as in Rinex3ObsData::obs
+          * @param[in] k index of the type in the plan
+          * @param[out] rd the datum, if there is one
+          * @return true if the datum was found */
+      bool getObs(const RinexSatID& sat, const std::vector<RinexDatum>& vrdata,
+                  const size_t k, RinexDatum& rd) const throw()
+      {
+         const int j(index(sat.systemChar(), k));
+         if(j == NONE || size_t(j) >= vrdata.size()) return false;
+         rd = vrdata[j];
+         return true;
+      }
+
+         /** Get the value of type k of the satellite's data, or zero
+          * if there is none, which is also the RINEX value for no data. */
+      double getData(const RinexSatID& sat,
+                     const std::vector<RinexDatum>& vrdata,
+                     const size_t k) const throw()
+      {
+         const int j(index(sat.systemChar(), k));
+         return (j == NONE || size_t(j) >= vrdata.size()) ? 0.0 : vrdata[j].data;
+      }
+
+         /** Extract every type of the plan, for every satellite of an epoch,
+          * into a dense array. Missing data are zero.
+          * @param[in] rod epoch of data
+          * @param[out] sats satellites, in the order of rod.obs
+          * @param[out] data sats.size() rows by size() columns, row major;
+          *   data[i*size()+k] is type k of sats[i]. */
+      void extract(const Rinex3ObsData& rod, std::vector<RinexSatID>& sats,
+                   std::vector<double>& data) const throw();
+
+   private:
+         /// Row of the table for a system character, or -1 if none.
+      int slot(const char sysChar) const throw()
+      {
+         const int i(sysChar - 'A');
+         return (i < 0 || i >= NSLOTS) ? -1 : i;
+      }
+
+         /// Fill the table for type k, a 3-character obs type, for sysChar.
+      void resolve(const Rinex3ObsHeader& hdr, const char sysChar,
+                   const std::string& type, const size_t k) throw();
+
+         /// Number of table rows, one for each letter.
+      static const int NSLOTS = 26;
+
+         /// Number of types
+      size_t ntypes;
+
+         /// NSLOTS rows of ntypes indexes, row major.
+      std::vector<int> table;
+
+   }; // End of class 'Rinex3ObsPlan'
+
+      //@}
+
+} // End of namespace gpstk
+
+#endif   // GPSTK_RINEX3OBSPLAN_HPP
@@ -88,6 +88,7 @@ namespace gpstk
       headerRead = false;
       header = Rinex3ObsHeader();
       timesystem = TimeSystem::GPS;
+      fastDecode = true;
    }
 
 
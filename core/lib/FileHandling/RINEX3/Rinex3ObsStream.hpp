@@ -110,12 +110,25 @@ namespace gpstk
          /// Time system for epochs in this file
       TimeSystem timesystem;
 
+         /** When true (the default), RINEX 3 epochs are decoded by
+          * the allocation-free decoder in Rinex3ObsData, which
+          * parses the observations in place and reuses the storage
+          * of the previous epoch.  Set to false to use the original
+          * decoder, which gives identical results. */
+      bool fastDecode;
+
          /// Check if the input stream is the kind of Rinex3ObsStream
       static bool isRinex3ObsStream(std::istream& i);
 
    private:
          /// Initialize internal data structures.
       void init();
+
+         /// Satellites of the epoch being decoded, for the fast decoder.
+      std::vector<RinexSatID> epochSats;
+
+         /// Rinex3ObsData uses epochSats as scratch storage.
+      friend class Rinex3ObsData;
    }; // class 'Rinex3ObsStream'
 
       //@}
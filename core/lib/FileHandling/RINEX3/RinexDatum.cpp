@@ -44,6 +44,65 @@
 
 namespace gpstk
 {
+      /** Powers of ten that are exactly representable as doubles,
+       * used by fastAsDouble. */
+   static const double exactPow10[] =
+   {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,
+      1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+   };
+
+
+      /** Decode a fixed-point number such as a RINEX F14.3 field
+       * without making a copy of it.  The mantissa of at most 15
+       * digits and the power of ten are both exact in a double, so
+       * the single division gives the same correctly rounded value
+       * as strtod() does.  Anything else (exponents, embedded
+       * blanks, long mantissas) falls back to StringUtils::asDouble.
+       * @param[in] str the characters to decode.
+       * @param[in] len the number of characters at \a str.
+       * @return the same value as StringUtils::asDouble. */
+   static double fastAsDouble(const char *str, std::string::size_type len)
+   {
+      std::string::size_type i = 0;
+      while ((i < len) && (str[i] == ' '))
+         i++;
+      bool neg = false;
+      if ((i < len) && ((str[i] == '-') || (str[i] == '+')))
+      {
+         neg = (str[i] == '-');
+         i++;
+      }
+      unsigned long long mant = 0;
+      unsigned digits = 0, fracDigits = 0;
+      while ((i < len) && (str[i] >= '0') && (str[i] <= '9'))
+      {
+         mant = mant * 10 + (str[i++] - '0');
+         digits++;
+      }
+      if ((i < len) && (str[i] == '.'))
+      {
+         i++;
+         while ((i < len) && (str[i] >= '0') && (str[i] <= '9'))
+         {
+            mant = mant * 10 + (str[i++] - '0');
+            digits++;
+            fracDigits++;
+         }
+      }
+      while ((i < len) && (str[i] == ' '))
+         i++;
+      if ((digits == 0) || (digits > 15) || (i != len))
+      {
+         return StringUtils::asDouble(std::string(str, len));
+      }
+      double rv = static_cast<double>(mant);
+      if (fracDigits)
+         rv /= exactPow10[fracDigits];
+      return neg ? -rv : rv;
+   }
+
+
    RinexDatum ::
    RinexDatum()
          : data(0), lli(0), ssi(0),
@@ -101,6 +160,33 @@ namespace gpstk
    }
 
 
+   void RinexDatum ::
+   fromString(const char *str, std::string::size_type len)
+   {
+      std::string::size_type dataLen = (len < 14 ? len : 14);
+      std::string::size_type i;
+      for (i = 0; (i < dataLen) && (str[i] == ' '); i++)
+         ;
+      if (i == dataLen)
+      {
+         data = 0.;
+         dataBlank = true;
+      }
+      else
+      {
+         data = fastAsDouble(str, dataLen);
+         dataBlank = false;
+      }
+         // strtol of a single non-digit character is 0
+      char c = (len > 14 ? str[14] : ' ');
+      lliBlank = (c == ' ');
+      lli = ((c >= '0') && (c <= '9')) ? (c - '0') : 0;
+      c = (len > 15 ? str[15] : ' ');
+      ssiBlank = (c == ' ');
+      ssi = ((c >= '0') && (c <= '9')) ? (c - '0') : 0;
+   }
+
+
    std::string RinexDatum ::
    asString() const
    {
@@ -68,6 +68,16 @@ namespace gpstk
           * @throw AssertionFailure if str.length() != 16 */
       void fromString(const std::string& str);
 
+         /** Parse a RINEX OBS datum in place, without allocating.
+          * This produces exactly the same result as
+          * fromString(const std::string&) applied to the same
+          * characters padded with blanks to 16 characters.
+          * @param[in] str the start of the RINEX-formatted datum.
+          * @param[in] len the number of characters available at \a
+          *   str.  Columns at or beyond \a len are treated as blank,
+          *   columns beyond 16 are ignored. */
+      void fromString(const char *str, std::string::size_type len);
+
          /// Turn this datum into a RINEX OBS formatted string
       std::string asString() const;
 
@@ -282,6 +282,17 @@ namespace gpstk
       479001600, 6227020800, 87178291200, 1307674368000, 20922789888000,
       355687428096000, 6402373705728000 };
 
+   const size_t GlobalTropModel::MAX_CACHED_POSITIONS;
+
+   // dry mapping function height correction coefficients
+   static const double a_ht = 2.53e-5;
+   static const double b_ht = 5.49e-3;
+   static const double c_ht = 1.14e-3;
+   // dry and wet mapping function coefficients b, and wet c
+   static const double bh = 0.0029;
+   static const double bw = 0.00146;
+   static const double cw = 0.04391;
+
    // Compute and return the full tropospheric delay. The receiver height, 
    // latitude and time must has been set before using the appropriate
    // methods.
@@ -323,10 +334,7 @@ namespace gpstk
       throw(InvalidTropModel)
    {
       try {
-         double p;
-         p = RX.getAltitude();         if(p != height) setReceiverHeight(p);
-         p = RX.getGeodeticLatitude(); if(p != latitude) setReceiverLatitude(p);
-         p = RX.getLongitude();        if(p != longitude) setReceiverLongitude(p);
+         setPosition(RX.getAltitude(), RX.getGeodeticLatitude(), RX.getLongitude());
       }
       catch(GeometryException& e) {
          validHeight = validLat = valid = false;
@@ -346,6 +354,48 @@ namespace gpstk
 
    }  // end GlobalTropModel::correction(RX,SV)
 
+   // Compute the tropospheric delays and mapping functions for several
+   // satellites at once. Same arithmetic as correction(elevation), with the
+   // zenith delays and the mapping function numerators computed only once.
+   void GlobalTropModel::batch_correction(const std::vector<double>& elevation,
+                                          std::vector<double>& dry,
+                                          std::vector<double>& wet,
+                                          std::vector<double>& drymap,
+                                          std::vector<double>& wetmap) const
+      throw(InvalidTropModel)
+   {
+      try { testValidity(); }
+      catch(InvalidTropModel& e) { GPSTK_RETHROW(e); }
+
+      const size_t n(elevation.size());
+      dry.resize(n); wet.resize(n); drymap.resize(n); wetmap.resize(n);
+      if(n == 0) return;
+
+      const double dzd(GlobalTropModel::dry_zenith_delay());
+      const double wzd(GlobalTropModel::wet_zenith_delay());
+      const double fh(1.0 + ah/(1.0 + bh/(1.0 + ch)));
+      const double fht(1.0 + a_ht/(1.0 + b_ht/(1.0 + c_ht)));
+      const double fw(1.0 + aw/(1.0 + bw/(1.0 + cw)));
+      const double htkm(height/1000.0);
+
+      for(size_t i=0; i<n; i++) {
+         // Global mapping functions good down to 3 degrees of elevation
+         if(elevation[i] < 3.0) {
+            dry[i] = wet[i] = drymap[i] = wetmap[i] = 0.0;
+            continue;
+         }
+         double sine(::sin(elevation[i]*DEG_TO_RAD));
+         double map(fh / (sine + ah/(sine + bh/(sine + ch))));
+         map += ( (1.0/sine) - fht / (sine + a_ht/(sine + b_ht/(sine + c_ht)))
+                ) * htkm;
+         drymap[i] = map;
+         wetmap[i] = fw / (sine + aw/(sine + bw/(sine + cw)));
+         dry[i] = dzd * drymap[i];
+         wet[i] = wzd * wetmap[i];
+      }
+
+   }  // end GlobalTropModel::batch_correction()
+
    // Compute and return the zenith delay for hydrostatic (dry) component of
    // the troposphere. Use the Saastamoinen value.
    // Ref. Davis etal 1985 and Leick, 3rd ed, pg 197.
@@ -376,30 +426,7 @@ namespace gpstk
       try { testValidity(); } catch(InvalidTropModel& e) { GPSTK_RETHROW(e); }
       if(elevation < 3.0) { return 0.0; }
 
-      double clat = ::cos(latitude*DEG_TO_RAD);
-      double phh, c11h, c10h;
-
-      static const double bh = 0.0029;
-      static const double c0h = 0.062;
-      if(latitude < 0) {
-         phh = PI;
-         c11h = 0.007;
-         c10h = 0.002;
-      }
-      else {
-         phh = 0.0;
-         c11h = 0.005;
-         c10h = 0.001;
-      }
-      double ch = c0h + ((::cos(dayfactor + phh)+1.0)*c11h/2.0 + c10h)*(1.0-clat);
-
-      double am(0.0), aa(0.0);
-      for(int i=0; i<55; i++) {
-         am += (ADryMean[i]*aP[i] + BDryMean[i]*bP[i]) * 1.0e-5;
-         aa += (ADryAmp[i]*aP[i] + BDryAmp[i]*bP[i]) * 1.0e-5;
-      }
-      double ah = am + aa*::cos(dayfactor);
-
+      // ah and ch are computed in updateMapCoeff()
       double sine = ::sin(elevation*DEG_TO_RAD);
       //std::cout << "sine " << std::fixed << std::setprecision(16) << sine
       // << std::endl;
@@ -411,10 +438,6 @@ namespace gpstk
       // << std::endl;
 
       // height correction
-      static const double a_ht = 2.53e-5;
-      static const double b_ht = 5.49e-3;
-      static const double c_ht = 1.14e-3;
-
       map += ( (1.0/sine) - (1.0  + a_ht/(1.0  + b_ht/(1.0  + c_ht)))
                           / (sine + a_ht/(sine + b_ht/(sine + c_ht)))
              ) * (height/1000.0);
@@ -468,16 +491,7 @@ namespace gpstk
 
       if(elevation < 3.0) { return 0.0; }
 
-      static const double bw = 0.00146;
-      static const double cw = 0.04391;
-
-      double am(0.0), aa(0.0);
-      for(int i=0; i<55; i++) {
-         am += (AWetMean[i]*aP[i] + BWetMean[i]*bP[i]) * 1.0e-5;
-         aa += (AWetAmp[i]*aP[i] + BWetAmp[i]*bP[i]) * 1.0e-5;
-      }
-      double aw = am + aa*::cos(dayfactor);
-
+      // aw is computed in updateMapCoeff()
       double sine = ::sin(elevation*DEG_TO_RAD);
       //std::cout << "sine " << std::fixed << std::setprecision(16) << sine
       // << std::endl;
@@ -510,34 +524,22 @@ namespace gpstk
       try { testValidity(); }
       catch(InvalidTropModel& e) { GPSTK_RETHROW(e); }
       
-      int i;
-
       // undulation and orthometric height
-      U = 0.0;
-      for(i=0; i<55; i++) U += (Ageoid[i]*aP[i] + Bgeoid[i]*bP[i]);
+      U = sums.undul;
       double orthoht(height - U);
       if(orthoht > 44247.) GPSTK_THROW(InvalidTropModel(
                            "Invalid Global trop model: Rx Height is too large"));
 
       // press at geoid
-      double am(0.0),aa(0.0),v0;
-      for(i=0; i<55; i++) {
-         am += (APressMean[i]*aP[i] + BPressMean[i]*bP[i]);
-         aa += (APressAmp[i]*aP[i] + BPressAmp[i]*bP[i]);
-      }
-      v0 = am + aa * ::cos(dayfactor);
+      double v0;
+      v0 = sums.pressMean + sums.pressAmp * ::cos(dayfactor);
       
       // pressure at height
       // NB this implies any orthoht > 1/2.26e-5 == 44247.78m is invalid!
       P = v0 * ::pow(1.0-2.26e-5*orthoht,5.225);
 
       // temper on geoid
-      am = aa = 0.0;
-      for(i=0; i<55; i++) {
-         am += (ATempMean[i]*aP[i] + BTempMean[i]*bP[i]);
-         aa += (ATempAmp[i]*aP[i] + BTempAmp[i]*bP[i]);
-      }
-      v0 = am + aa * ::cos(dayfactor);
+      v0 = sums.tempMean + sums.tempAmp * ::cos(dayfactor);
 
       // temp at height
       T = v0 - 6.5e-3 * orthoht;
@@ -548,7 +550,7 @@ namespace gpstk
    // @param ht   Height of the receiver above mean sea level, in meters.
    void GlobalTropModel::setReceiverHeight(const double& ht)
    {
-      if(height != ht) {
+      if(!validHeight || height != ht) {
          height = ht; 
          validHeight = true;
          validCoeff = false;
@@ -561,10 +563,10 @@ namespace gpstk
    // @param lat  Latitude of receiver, in degrees.
    void GlobalTropModel::setReceiverLatitude(const double& lat)
    {
-      if(latitude != lat) {
+      if(!validLat || latitude != lat) {
          latitude = lat;
          validLat = true;
-         validCoeff = false;
+         validCoeff = validSums = false;
          setValid();          // calls updateGTMCoeff()
       }
    }
@@ -574,10 +576,10 @@ namespace gpstk
    // @param lat  Longitude of receiver, in degrees East.
    void GlobalTropModel::setReceiverLongitude(const double& lon)
    {
-      if(longitude != lon) {
+      if(!validLon || longitude != lon) {
          longitude = lon;
          validLon = true;
-         validCoeff = false;
+         validCoeff = validSums = false;
          setValid();          // calls updateGTMCoeff()
       }
    }
@@ -588,7 +590,7 @@ namespace gpstk
    void GlobalTropModel::setTime(const double& mjd)
    {
       double df(TWO_PI*(mjd - 44266.0)/365.25);       // -44239 + 1 - 28
-      if(df != dayfactor) {
+      if(df != dayfactor || !validDay) {
          dayfactor = df;
          validDay = true;
          validCoeff = false;
@@ -619,13 +621,27 @@ namespace gpstk
    // @param rxPos Receiver position object.
    void GlobalTropModel::setParameters(const CommonTime& time, const Position& rxPos)
    {
-      validDay = validHeight = validLat = validLon = validCoeff = false;
-      setTime(time);
-      setReceiverHeight(rxPos.getHeight());
-      setReceiverLatitude(rxPos.getGeodeticLatitude());
-      setReceiverLongitude(rxPos.getLongitude());
+      setPosition(rxPos.getHeight(), rxPos.getGeodeticLatitude(),
+                  rxPos.getLongitude());
+      setTime(time);       // calls setValid()
+   }
+
+   // Set height, latitude and longitude together, so that the coefficients are
+   // updated once, and only for the new position.
+   void GlobalTropModel::setPosition(const double& ht, const double& lat,
+                                     const double& lon)
+      throw(InvalidTropModel)
+   {
+      if(!validLat || !validLon || lat != latitude || lon != longitude)
+         validCoeff = validSums = false;
+      if(!validHeight || ht != height)
+         validCoeff = false;
 
-      setValid();          // calls updateGTMCoeff()
+      height = ht;
+      latitude = lat;
+      longitude = lon;
+      validHeight = validLat = validLon = true;
+      setValid();          // calls updateGTMCoeff() if position changed
    }
 
    // Must update coeff when latitude or lon changes
@@ -633,8 +649,18 @@ namespace gpstk
    {
       if(!validLon || !validLat) return;
 
+      // sums at a position already seen
+      std::pair<double,double> key(latitude,longitude);
+      std::map< std::pair<double,double>, HarmonicSums >::const_iterator it;
+      it = sumCache.find(key);
+      if(it != sumCache.end()) {
+         sums = it->second;
+         return;
+      }
+
       // compute Legendre functions and spherical harmonics
       int i,j,k;
+      double P[10][10], aP[55], bP[55];
       double sinlat(::sin(latitude*DEG_TO_RAD));
       for(i=0; i<=9; i++) {
          for(j=0; j<=i; j++) {
@@ -662,6 +688,53 @@ namespace gpstk
          }
       }
 
+      // sum the expansions; mean and amplitude of each quantity
+      HarmonicSums hs;
+      hs.undul = 0.0;
+      for(i=0; i<55; i++) hs.undul += (Ageoid[i]*aP[i] + Bgeoid[i]*bP[i]);
+
+      hs.pressMean = hs.pressAmp = hs.tempMean = hs.tempAmp = 0.0;
+      hs.dryMean = hs.dryAmp = hs.wetMean = hs.wetAmp = 0.0;
+      for(i=0; i<55; i++) {
+         hs.pressMean += (APressMean[i]*aP[i] + BPressMean[i]*bP[i]);
+         hs.pressAmp += (APressAmp[i]*aP[i] + BPressAmp[i]*bP[i]);
+         hs.tempMean += (ATempMean[i]*aP[i] + BTempMean[i]*bP[i]);
+         hs.tempAmp += (ATempAmp[i]*aP[i] + BTempAmp[i]*bP[i]);
+         hs.dryMean += (ADryMean[i]*aP[i] + BDryMean[i]*bP[i]) * 1.0e-5;
+         hs.dryAmp += (ADryAmp[i]*aP[i] + BDryAmp[i]*bP[i]) * 1.0e-5;
+         hs.wetMean += (AWetMean[i]*aP[i] + BWetMean[i]*bP[i]) * 1.0e-5;
+         hs.wetAmp += (AWetAmp[i]*aP[i] + BWetAmp[i]*bP[i]) * 1.0e-5;
+      }
+
+      sums = hs;
+      if(sumCache.size() >= MAX_CACHED_POSITIONS) sumCache.clear();
+      sumCache[key] = hs;
+
+   }
+
+   // Compute the mapping function coefficients, which depend on position and
+   // time but not elevation.
+   void GlobalTropModel::updateMapCoeff(void) throw()
+   {
+      double clat = ::cos(latitude*DEG_TO_RAD);
+      double phh, c11h, c10h;
+
+      static const double c0h = 0.062;
+      if(latitude < 0) {
+         phh = PI;
+         c11h = 0.007;
+         c10h = 0.002;
+      }
+      else {
+         phh = 0.0;
+         c11h = 0.005;
+         c10h = 0.001;
+      }
+      ch = c0h + ((::cos(dayfactor + phh)+1.0)*c11h/2.0 + c10h)*(1.0-clat);
+
+      double cosday(::cos(dayfactor));
+      ah = sums.dryMean + sums.dryAmp*cosday;
+      aw = sums.wetMean + sums.wetAmp*cosday;
    }
 
    // Utility to test valid flags
@@ -670,6 +743,8 @@ namespace gpstk
       if(!valid) {
          if(!validLat)
             GPSTK_THROW(InvalidTropModel("Invalid Global trop model: Rx Latitude"));
+         if(!validLon)
+            GPSTK_THROW(InvalidTropModel("Invalid Global trop model: Rx Longitude"));
          if(!validHeight)
             GPSTK_THROW(InvalidTropModel("Invalid Global trop model: Rx Height"));
          if(!validDay)
@@ -43,6 +43,9 @@
 #ifndef GLOBAL_TROP_MODEL_HPP
 #define GLOBAL_TROP_MODEL_HPP
 
+#include <map>
+#include <utility>
+
 #include "CommonTime.hpp"
 #include "TropModel.hpp"
 
@@ -86,6 +89,13 @@ namespace gpstk
    ///            time  => dayfactor => P,T => wet/dry zen/map
    ///            humid => wet zen
    ///
+   /// The spherical harmonic expansions depend only on latitude and longitude;
+   /// their mean and annual amplitude sums are saved for each position, so that
+   /// a model used for many stations (e.g. a network solution) computes them once
+   /// per station, and a change of day or height costs only a few operations.
+   /// The mapping function coefficients are computed once per change of
+   /// parameters, not once per elevation.
+   ///
    /// NB. members of base TropModel::temp,press,humid; valid
    ///     members of GlobalTropModel::height,latitude,longitude,dayfactor,undul;
    ///                                  validHeight, validLat, validLon, validDay
@@ -97,7 +107,7 @@ namespace gpstk
    public:
       /// Default constructor
       GlobalTropModel(void) : validCoeff(false), validHeight(false), validLat(false),
-                              validLon(false), validDay(false)
+                              validLon(false), validDay(false), validSums(false)
       {
          TropModel::humid = 50.0;
          valid = false;
@@ -115,6 +125,7 @@ namespace gpstk
                       const double& mjd)
       {
          validCoeff = validHeight = validLat = validLon = validDay = valid = false;
+         validSums = false;
          setReceiverHeight(ht);
          setReceiverLatitude(lat);
          setReceiverLongitude(lon);
@@ -128,6 +139,7 @@ namespace gpstk
       GlobalTropModel(const Position& RX, const CommonTime& time)
       {
          validCoeff = validHeight = validLat = validLon = validDay = valid = false;
+         validSums = false;
          setReceiverHeight(RX.getAltitude());
          setReceiverLatitude(RX.getGeodeticLatitude());
          setReceiverLongitude(RX.getLongitude());
@@ -182,6 +194,16 @@ namespace gpstk
          return correction(RX,SV);
       }
 
+      /// Compute the tropospheric delays and mapping functions for several
+      /// satellites at once; cf. TropModel::batch_correction(). Elevations below
+      /// 3 degrees give zero.
+      virtual void batch_correction(const std::vector<double>& elevation,
+                                    std::vector<double>& dry,
+                                    std::vector<double>& wet,
+                                    std::vector<double>& drymap,
+                                    std::vector<double>& wetmap) const
+         throw(InvalidTropModel);
+
       /// Compute and return the zenith delay for hydrostatic (dry) component of
       /// the troposphere. Use the Saastamoinen value.
       /// Ref. Davis etal 1985 and Leick, 3rd ed, pg 197.
@@ -267,6 +289,18 @@ namespace gpstk
       /// @param rxPos Receiver position object.
       virtual void setParameters(const CommonTime& time, const Position& rxPos);
 
+      /// Remove the saved spherical harmonic sums of all positions.
+      void clearCache(void) throw()
+         { sumCache.clear(); }
+
+      /// Number of positions for which spherical harmonic sums are saved.
+      size_t cacheSize(void) const throw()
+         { return sumCache.size(); }
+
+      /// Maximum number of positions saved; when it is reached the cache is
+      /// emptied, so a moving receiver does not make it grow without limit.
+      static const size_t MAX_CACHED_POSITIONS = 1024;
+
    private:
       /// Define the time of interest; this is required before calling
       /// correction() or any of the zenith_delay routines.
@@ -301,13 +335,40 @@ namespace gpstk
 
       static const double Factorial[19];
 
+      /// Mean and annual amplitude of the spherical harmonic expansions at one
+      /// position; the amplitude is multiplied by cos(dayfactor).
+      struct HarmonicSums
+      {
+         double undul;                    ///< geoid undulation
+         double pressMean, pressAmp;      ///< pressure at the geoid
+         double tempMean, tempAmp;        ///< temperature at the geoid
+         double dryMean, dryAmp;          ///< dry mapping coefficient a
+         double wetMean, wetAmp;          ///< wet mapping coefficient a
+      };
+
       double height, latitude, longitude, dayfactor, undul;
-      double P[10][10], aP[55], bP[55];
-      bool validHeight, validLat, validLon, validDay, validCoeff;
+      bool validHeight, validLat, validLon, validDay, validCoeff, validSums;
+
+      /// sums at (latitude,longitude)
+      HarmonicSums sums;
+
+      /// sums for each position seen, keyed by (latitude,longitude)
+      std::map< std::pair<double,double>, HarmonicSums > sumCache;
+
+      /// dry (ah,ch) and wet (aw) mapping function coefficients at the
+      /// current position and time
+      double ah, ch, aw;
 
       /// Update coefficients when latitude and/or longitude changes
       void updateGTMCoeff(void);
 
+      /// Compute the mapping function coefficients ah, ch, aw from the sums
+      void updateMapCoeff(void) throw();
+
+      /// Set height, latitude and longitude together, updating once
+      void setPosition(const double& ht, const double& lat, const double& lon)
+         throw(InvalidTropModel);
+
       /// Utility to test valid flags
       void testValidity(void) const throw(InvalidTropModel);
 
@@ -318,8 +379,12 @@ namespace gpstk
          try{
             valid = validHeight && validLat && validLon && validDay;
             if(valid && !validCoeff) {
-               updateGTMCoeff();
+               if(!validSums) {
+                  updateGTMCoeff();
+                  validSums = true;
+               }
                validCoeff = true;
+               updateMapCoeff();
                getGPT(press,temp,undul);
             }
          } catch(Exception& e) { GPSTK_RETHROW(e); }
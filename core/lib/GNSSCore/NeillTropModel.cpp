@@ -94,6 +94,7 @@ namespace gpstk
    NeillTropModel::NeillTropModel( const Position& RX,
                                    const CommonTime& time )
    {
+      validHeight = validLat = validDOY = valid = validMap = false;
       setReceiverHeight(RX.getAltitude());
       setReceiverLatitude(RX.getGeodeticLatitude( ));
       setDayOfYear(time);
@@ -164,6 +165,51 @@ namespace gpstk
    }
 
 
+      // Compute the tropospheric delays and mapping functions for several
+      // satellites at once. Same arithmetic as correction(elevation), with
+      // the zenith delays and the mapping function numerators computed once.
+   void NeillTropModel::batch_correction(const std::vector<double>& elevation,
+                                         std::vector<double>& dry,
+                                         std::vector<double>& wet,
+                                         std::vector<double>& drymap,
+                                         std::vector<double>& wetmap) const
+      throw(InvalidTropModel)
+   {
+      THROW_IF_INVALID_DETAILED();
+
+      const size_t n(elevation.size());
+      dry.resize(n); wet.resize(n); drymap.resize(n); wetmap.resize(n);
+      if(n == 0) return;
+
+      static const double a(0.0000253), b(0.00549), c(0.00114);
+      const double dzd(NeillTropModel::dry_zenith_delay());
+      const double wzd(NeillTropModel::wet_zenith_delay());
+      const double fd(1.+dryA/(1.+dryB/(1.+dryC)));
+      const double fht(1.+a/(1.+b/(1.+c)));
+      const double fw(1.+ wetA/ (1.+ wetB/(1.+wetC) ));
+      const double htkm(NeillHeight/1000.0);
+
+      for(size_t i=0; i<n; i++)
+      {
+            // Neill mapping functions work down to 3 degrees of elevation
+         if(elevation[i] < 3.0)
+         {
+            dry[i] = wet[i] = drymap[i] = wetmap[i] = 0.0;
+            continue;
+         }
+
+         double se = ::sin(elevation[i]*DEG_TO_RAD);
+         double map = fd/(se+dryA/(se+dryB/(se+dryC)));
+         map += htkm * ( 1./se - ( fht / (se+a/(se+b/(se+c))) ) );
+         drymap[i] = map;
+         wetmap[i] = fw / (se + wetA/(se + wetB/(se+wetC) ) );
+         dry[i] = dzd * drymap[i];
+         wet[i] = wzd * wetmap[i];
+      }
+
+   }  // end NeillTropModel::batch_correction()
+
+
       /* Compute and return the full tropospheric delay, given the
        * positions of receiver and satellite.
        *
@@ -356,43 +402,7 @@ namespace gpstk
          return 0.0;
       }
 
-      double lat, t, ct;
-      lat = fabs(NeillLat);         // degrees
-      t = static_cast<double>(NeillDOY) - 28.0;  // mid-winter
-
-      if(NeillLat < 0.0)              // southern hemisphere
-      {
-         t += 365.25/2.;
-      }
-
-      t *= 360.0/365.25;            // convert to degrees
-      ct = ::cos(t*DEG_TO_RAD);
-
-      double a, b, c;
-      if(lat < 15.0)
-      {
-         a = NeillDryA[0];
-         b = NeillDryB[0];
-         c = NeillDryC[0];
-      }
-      else if(lat < 75.)      // coefficients are for 15,30,45,60,75 deg
-      {
-         int i=int(lat/15.0)-1;
-         double frac=(lat-15.*(i+1))/15.;
-         a = NeillDryA[i] + frac*(NeillDryA[i+1]-NeillDryA[i]);
-         b = NeillDryB[i] + frac*(NeillDryB[i+1]-NeillDryB[i]);
-         c = NeillDryC[i] + frac*(NeillDryC[i+1]-NeillDryC[i]);
-
-         a -= ct * (NeillDryA1[i] + frac*(NeillDryA1[i+1]-NeillDryA1[i]));
-         b -= ct * (NeillDryB1[i] + frac*(NeillDryB1[i+1]-NeillDryB1[i]));
-         c -= ct * (NeillDryC1[i] + frac*(NeillDryC1[i+1]-NeillDryC1[i]));
-      }
-      else
-      {
-         a = NeillDryA[4] - ct * NeillDryA1[4];
-         b = NeillDryB[4] - ct * NeillDryB1[4];
-         c = NeillDryC[4] - ct * NeillDryC1[4];
-      }
+      double a(dryA), b(dryB), c(dryC);   // cf. updateMapCoeff()
 
       double se = ::sin(elevation*DEG_TO_RAD);
       double map = (1.+a/(1.+b/(1.+c)))/(se+a/(se+b/(se+c)));
@@ -422,28 +432,7 @@ namespace gpstk
          return 0.0;
       }
 
-      double a,b,c,lat;
-      lat = fabs(NeillLat);         // degrees
-      if(lat < 15.0)
-      {
-         a = NeillWetA[0];
-         b = NeillWetB[0];
-         c = NeillWetC[0];
-      }
-      else if(lat < 75.)          // coefficients are for 15,30,45,60,75 deg
-      {
-         int i=int(lat/15.0)-1;
-         double frac=(lat-15.*(i+1))/15.;
-         a = NeillWetA[i] + frac*(NeillWetA[i+1]-NeillWetA[i]);
-         b = NeillWetB[i] + frac*(NeillWetB[i+1]-NeillWetB[i]);
-         c = NeillWetC[i] + frac*(NeillWetC[i+1]-NeillWetC[i]);
-      }
-      else
-      {
-         a = NeillWetA[4];
-         b = NeillWetB[4];
-         c = NeillWetC[4];
-      }
+      double a(wetA), b(wetB), c(wetC);   // cf. updateMapCoeff()
 
       double se = ::sin(elevation*DEG_TO_RAD);
       double map = ( 1.+ a/ (1.+ b/(1.+c) ) ) / (se + a/(se + b/(se+c) ) );
@@ -477,9 +466,74 @@ namespace gpstk
 
       valid = validHeight && validLat && validDOY;
 
+      if(valid) updateMapCoeff();
+
    }
 
 
+      // Interpolate the mapping function coefficients for the current
+      // latitude and day of year, unless they are already computed.
+   void NeillTropModel::updateMapCoeff(void) throw()
+   {
+      if(validMap && mapLat == NeillLat && mapDOY == NeillDOY)
+      {
+         return;
+      }
+
+      double lat, t, ct;
+      lat = fabs(NeillLat);         // degrees
+      t = static_cast<double>(NeillDOY) - 28.0;  // mid-winter
+
+      if(NeillLat < 0.0)              // southern hemisphere
+      {
+         t += 365.25/2.;
+      }
+
+      t *= 360.0/365.25;            // convert to degrees
+      ct = ::cos(t*DEG_TO_RAD);
+
+      if(lat < 15.0)
+      {
+         dryA = NeillDryA[0];
+         dryB = NeillDryB[0];
+         dryC = NeillDryC[0];
+         wetA = NeillWetA[0];
+         wetB = NeillWetB[0];
+         wetC = NeillWetC[0];
+      }
+      else if(lat < 75.)      // coefficients are for 15,30,45,60,75 deg
+      {
+         int i=int(lat/15.0)-1;
+         double frac=(lat-15.*(i+1))/15.;
+         dryA = NeillDryA[i] + frac*(NeillDryA[i+1]-NeillDryA[i]);
+         dryB = NeillDryB[i] + frac*(NeillDryB[i+1]-NeillDryB[i]);
+         dryC = NeillDryC[i] + frac*(NeillDryC[i+1]-NeillDryC[i]);
+
+         dryA -= ct * (NeillDryA1[i] + frac*(NeillDryA1[i+1]-NeillDryA1[i]));
+         dryB -= ct * (NeillDryB1[i] + frac*(NeillDryB1[i+1]-NeillDryB1[i]));
+         dryC -= ct * (NeillDryC1[i] + frac*(NeillDryC1[i+1]-NeillDryC1[i]));
+
+         wetA = NeillWetA[i] + frac*(NeillWetA[i+1]-NeillWetA[i]);
+         wetB = NeillWetB[i] + frac*(NeillWetB[i+1]-NeillWetB[i]);
+         wetC = NeillWetC[i] + frac*(NeillWetC[i+1]-NeillWetC[i]);
+      }
+      else
+      {
+         dryA = NeillDryA[4] - ct * NeillDryA1[4];
+         dryB = NeillDryB[4] - ct * NeillDryB1[4];
+         dryC = NeillDryC[4] - ct * NeillDryC1[4];
+         wetA = NeillWetA[4];
+         wetB = NeillWetB[4];
+         wetC = NeillWetC[4];
+      }
+
+      mapLat = NeillLat;
+      mapDOY = NeillDOY;
+      validMap = true;
+
+   }  // end NeillTropModel::updateMapCoeff()
+
+
       // Define the receiver height; this is required before calling
       // correction() or any of the zenith_delay routines.
       //
@@ -570,9 +624,9 @@ namespace gpstk
       NeillDOY = static_cast<int>(ydst.doy);
       validDOY = true;
       NeillLat = rxPos.getGeodeticLatitude();
-      validHeight = true;
-      NeillLat = rxPos.getHeight();
       validLat = true;
+      NeillHeight = rxPos.getHeight();
+      validHeight = true;
 
          // Change the value of field "valid" if everything is already set
       valid = validHeight && validLat && validDOY;
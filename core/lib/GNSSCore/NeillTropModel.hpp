@@ -76,6 +76,11 @@ namespace gpstk
        *   trop = neillTM.correction(elevation);
        * @endcode
        *
+       * The mapping function coefficients, which depend on latitude and day
+       * of year, are interpolated once when those change rather than for
+       * every elevation; batch_correction() computes the delays of all the
+       * satellites of an epoch in one call.
+       *
        * @warning The Neill mapping functions are defined for elevation
        * angles down to 3 degrees.
        *
@@ -86,7 +91,8 @@ namespace gpstk
 
          /// Default constructor
       NeillTropModel(void)
-      { validHeight=false; validLat=false; validDOY=false; valid=false; };
+      { validHeight=false; validLat=false; validDOY=false; valid=false;
+        validMap=false; };
 
 
          /// Constructor to create a Neill trop model providing just the
@@ -97,7 +103,8 @@ namespace gpstk
          /// @param ht   Height of the receiver above mean sea level, in
          ///             meters.
       NeillTropModel(const double& ht)
-      { setReceiverHeight(ht); };
+      { validHeight=false; validLat=false; validDOY=false; valid=false;
+        validMap=false; setReceiverHeight(ht); };
 
 
          /// Constructor to create a Neill trop model providing the height of
@@ -111,7 +118,9 @@ namespace gpstk
       NeillTropModel( const double& ht,
                       const double& lat,
                       const int& doy )
-      { setReceiverHeight(ht); setReceiverLatitude(lat); setDayOfYear(doy); };
+      { validHeight=false; validLat=false; validDOY=false; valid=false;
+        validMap=false;
+        setReceiverHeight(ht); setReceiverLatitude(lat); setDayOfYear(doy); };
 
 
          /// Constructor to create a Neill trop model providing the position
@@ -247,6 +256,17 @@ namespace gpstk
          throw(InvalidTropModel);
 
 
+         /// Compute the tropospheric delays and mapping functions for several
+         /// satellites at once; cf. TropModel::batch_correction(). Elevations
+         /// below 3 degrees give zero.
+      virtual void batch_correction(const std::vector<double>& elevation,
+                                    std::vector<double>& dry,
+                                    std::vector<double>& wet,
+                                    std::vector<double>& drymap,
+                                    std::vector<double>& wetmap) const
+         throw(InvalidTropModel);
+
+
          /// Compute and return the zenith delay for dry component of
          /// the troposphere.
       virtual double dry_zenith_delay(void) const
@@ -344,6 +364,18 @@ namespace gpstk
       bool validHeight;
       bool validLat;
       bool validDOY;
+
+         /// Mapping function coefficients a,b,c, dry and wet, for the
+         /// latitude mapLat and day of year mapDOY
+      double dryA, dryB, dryC;
+      double wetA, wetB, wetC;
+      double mapLat;
+      int mapDOY;
+      bool validMap;
+
+         /// Interpolate the mapping function coefficients for the current
+         /// latitude and day of year, unless they are already computed.
+      void updateMapCoeff(void) throw();
    };
 
 }
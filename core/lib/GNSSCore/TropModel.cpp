@@ -70,6 +70,37 @@ namespace gpstk
 
    }  // end TropModel::correction(elevation)
 
+      // Compute the tropospheric delays and the mapping functions for
+      // several satellites at once.
+   void TropModel::batch_correction(const std::vector<double>& elevation,
+                                    std::vector<double>& dry,
+                                    std::vector<double>& wet,
+                                    std::vector<double>& drymap,
+                                    std::vector<double>& wetmap) const
+      throw(InvalidTropModel)
+   {
+      THROW_IF_INVALID();
+
+      const size_t n(elevation.size());
+      dry.resize(n); wet.resize(n); drymap.resize(n); wetmap.resize(n);
+      if(n == 0) return;
+
+      const double dzd(dry_zenith_delay()), wzd(wet_zenith_delay());
+      for(size_t i=0; i<n; i++) {
+            // correction() decides the elevation cutoff, which differs
+            // between models (e.g. 5 degrees in GCATTropModel)
+         if(elevation[i] < 0.0 || correction(elevation[i]) == 0.0) {
+            dry[i] = wet[i] = drymap[i] = wetmap[i] = 0.0;
+            continue;
+         }
+         drymap[i] = dry_mapping_function(elevation[i]);
+         wetmap[i] = wet_mapping_function(elevation[i]);
+         dry[i] = dzd * drymap[i];
+         wet[i] = wzd * wetmap[i];
+      }
+
+   }  // end TropModel::batch_correction()
+
       // Compute and return the full tropospheric delay, given the positions of
       // receiver and satellite and the time tag. This version is most useful
       // within positioning algorithms, where the receiver position and timetag may
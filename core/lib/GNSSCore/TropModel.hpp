@@ -43,6 +43,8 @@
 #ifndef TROP_MODEL_HPP
 #define TROP_MODEL_HPP
 
+#include <vector>
+
 #include "Exception.hpp"
 #include "ObsEpochMap.hpp"
 #include "WxObsMap.hpp"
@@ -149,6 +151,27 @@ namespace gpstk
          throw(InvalidTropModel)
       { Position R(RX),S(SV);  return TropModel::correction(R,S,tt); }
 
+         /// Compute the tropospheric delay for several satellites at once, for
+         /// example all the satellites in view at one epoch, together with the
+         /// mapping functions, which are the partials of the delay with respect
+         /// to the dry and wet zenith delays. The zenith delays are computed only
+         /// once; the total delay for satellite i is dry[i]+wet[i], which equals
+         /// correction(elevation[i]). All outputs are zero where correction()
+         /// is, e.g. below the elevation cutoff of the model. This default
+         /// calls correction() for each satellite to find the cutoff; models
+         /// override it to avoid that.
+         /// @param elevation Elevations of satellites as seen at receiver, in degrees
+         /// @param dry    output hydrostatic (dry) delays, in meters
+         /// @param wet    output wet delays, in meters
+         /// @param drymap output dry mapping functions
+         /// @param wetmap output wet mapping functions
+      virtual void batch_correction(const std::vector<double>& elevation,
+                                    std::vector<double>& dry,
+                                    std::vector<double>& wet,
+                                    std::vector<double>& drymap,
+                                    std::vector<double>& wetmap) const
+         throw(InvalidTropModel);
+
          /// Compute and return the zenith delay for hydrostatic (dry)
          /// component of the troposphere
       virtual double dry_zenith_delay(void) const
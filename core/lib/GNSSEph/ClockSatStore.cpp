@@ -337,8 +337,10 @@ namespace gpstk
                oldrec.sig_accel = rec.sig_accel;
             }
          }
-         else  // create a new entry in the table
+         else {   // create a new entry in the table
+            uncompact();
             tables[sat][ttag] = rec;
+         }
       }
       catch(InvalidRequest& ir) { GPSTK_RETHROW(ir); }
    }
@@ -365,6 +367,7 @@ namespace gpstk
             rec.drift = rec.sig_drift = 0.0;
             rec.accel = rec.sig_accel = 0.0;
 
+            uncompact();
             tables[sat][ttag] = rec;
          }
       }
@@ -395,6 +398,7 @@ namespace gpstk
             rec.bias = rec.sig_bias = 0.0;
             rec.accel = rec.sig_accel = 0.0;
 
+            uncompact();
             tables[sat][ttag] = rec;
          }
       }
@@ -425,10 +429,82 @@ namespace gpstk
             rec.drift = rec.sig_drift = 0.0;
             rec.bias = rec.sig_bias = 0.0;
 
+            uncompact();
             tables[sat][ttag] = rec;
          }
       }
       catch(InvalidRequest& ir) { GPSTK_RETHROW(ir); }
    }
 
+   // Append the time system, data flags and tables to an ephemeris cache
+   void ClockSatStore::writeCache(EphemerisCacheWriter& cw) const throw()
+   {
+      cw.put(static_cast<int>(storeTimeSystem.getTimeSystem()));
+      cw.put(havePosition);
+      cw.put(haveVelocity);
+      cw.put(haveClockBias);
+      cw.put(haveClockDrift);
+      cw.put(haveClockAccel);
+      cw.put(static_cast<unsigned int>(tables.size()));
+      SatTable::const_iterator it;
+      for(it=tables.begin(); it!=tables.end(); ++it)
+      {
+         cw.put(it->first);
+         cw.put(static_cast<unsigned int>(it->second.size()));
+         DataTable::const_iterator jt;
+         for(jt=it->second.begin(); jt!=it->second.end(); ++jt)
+         {
+            cw.put(jt->first);
+            cw.put(jt->second.bias);
+            cw.put(jt->second.sig_bias);
+            cw.put(jt->second.drift);
+            cw.put(jt->second.sig_drift);
+            cw.put(jt->second.accel);
+            cw.put(jt->second.sig_accel);
+         }
+      }
+   }
+
+   // Replace the time system, data flags and tables with those in a cache
+   void ClockSatStore::readCache(EphemerisCacheReader& cr) throw(Exception)
+   {
+      try {
+         int ts;
+         cr.get(ts);
+         cr.get(havePosition);
+         cr.get(haveVelocity);
+         cr.get(haveClockBias);
+         cr.get(haveClockDrift);
+         cr.get(haveClockAccel);
+         storeTimeSystem = TimeSystem(ts);
+
+         uncompact();
+         tables.clear();
+         unsigned int nsat, nrec;
+         cr.get(nsat);
+         for(unsigned int i=0; i<nsat; i++)
+         {
+            SatID sat;
+            cr.get(sat);
+            cr.get(nrec);
+            DataTable& table(tables[sat]);
+            for(unsigned int j=0; j<nrec; j++)
+            {
+               CommonTime ttag;
+               ClockRecord rec;
+               cr.get(ttag);
+               cr.get(rec.bias);
+               cr.get(rec.sig_bias);
+               cr.get(rec.drift);
+               cr.get(rec.sig_drift);
+               cr.get(rec.accel);
+               cr.get(rec.sig_accel);
+                  // written in order, so each record goes at the end
+               table.insert(table.end(), std::make_pair(ttag, rec));
+            }
+         }
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
 }  // End of namespace gpstk
@@ -50,6 +50,7 @@
 #include "Exception.hpp"
 #include "SatID.hpp"
 #include "CommonTime.hpp"
+#include "EphemerisCache.hpp"
 #include "TabularSatStore.hpp"
 #include "FileStore.hpp"
 
@@ -252,6 +253,16 @@ namespace gpstk
       void rejectBadClocks(const bool flag)
       { rejectBadClockFlag = flag; }
 
+         /** Append the time system, data flags and tables to an
+          * ephemeris cache being written. */
+      void writeCache(EphemerisCacheWriter& cw) const throw();
+
+         /** Replace the time system, data flags and tables with
+          * those read from an ephemeris cache written by
+          * writeCache(); other settings are unchanged.
+          * @throw Exception if the cache is exhausted */
+      void readCache(EphemerisCacheReader& cr) throw(Exception);
+
          /// Set the type of interpolation to Lagrange (default)
       void setLagrangeInterp(void) throw()
       { interpType = 2; setInterpolationOrder(10); }
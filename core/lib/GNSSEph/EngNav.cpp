@@ -43,6 +43,7 @@
 #include <iostream>
 #include <cmath>
 #include "EngNav.hpp"
+#include "PackedNavBits.hpp"
 #include "GNSSconstants.hpp"
 
 #ifdef _MSC_VER
@@ -51,6 +52,52 @@
 #define LDEXP(x,y) std::ldexp(x,y)
 #endif
 
+namespace
+{
+      /** Parity bits of the 24 data bits of a subframe word, a byte at
+       * a time; see EngNav::computeParity() for the bit masks.  The
+       * parity of a word is the exclusive-or of the entries for its
+       * three data bytes, and of D29*, D30* of the previous word. */
+   struct ParityTable
+   {
+      ParityTable()
+      {
+         const uint32_t bmask[6] = { 0x3B1F3480L, 0x1D8F9A40L, 0x2EC7CD00L,
+                                     0x1763E680L, 0x2BB1F340L, 0x0B7A89C0L };
+         for (unsigned k = 0; k < 3; k++)
+         {
+            for (uint32_t b = 0; b < 256; b++)
+            {
+               uint32_t d = b << (22 - 8*k);
+               uint8_t D = 0;
+               for (unsigned i = 0; i < 6; i++)
+                  D |= (gpstk::BinUtils::countBits(bmask[i] & d) % 2) << (5-i);
+               table[k][b] = D;
+            }
+         }
+      }
+      uint8_t table[3][256];
+   };
+
+   const ParityTable parityTable;
+
+      /// Same as EngNav::computeParity().
+   inline uint32_t tableParity(uint32_t sfword, uint32_t psfword,
+                               bool knownUpright)
+   {
+      uint32_t d = sfword;
+      uint32_t D29 = psfword & 0x02;
+      uint32_t D30 = psfword & 0x01;
+      if (D30 && !knownUpright)
+         d = ~d;
+         // D29* enters D25, D27 and D30; D30* enters D26, D28 and D29
+      return parityTable.table[0][(d >> 22) & 0xff] ^
+         parityTable.table[1][(d >> 14) & 0xff] ^
+         parityTable.table[2][(d >> 6) & 0xff] ^
+         (D29 ? 0x29 : 0) ^ (D30 ? 0x16 : 0);
+   }
+}
+
 namespace gpstk
 {
    /// DecodeBits .
@@ -649,28 +696,13 @@ namespace gpstk
            D29    10 1011 1011 0001 1111 0011 0100 0000
            D30    00 1011 0111 1010 1000 1001 1100 0000
          */
-      uint32_t bmask[6] = { 0x3B1F3480L, 0x1D8F9A40L, 0x2EC7CD00L,
-                            0x1763E680L, 0x2BB1F340L, 0x0B7A89C0L };
-
-      uint32_t D = 0;
-      uint32_t d = sfword;
-      uint32_t D29 = getd29(psfword);
-      uint32_t D30 = getd30(psfword);
 
          // If D30 of the previous subframe was set, complement the word
          // to get the source data bits.  This will also complement the
          // parity, but we don't need the original parity to compute the
-         // new.
-      if (D30 && !knownUpright)
-         d = ~d;
-      D |= ((D29 + BinUtils::countBits(bmask[0] & d)) % 2) << 5;
-      D |= ((D30 + BinUtils::countBits(bmask[1] & d)) % 2) << 4;
-      D |= ((D29 + BinUtils::countBits(bmask[2] & d)) % 2) << 3;
-      D |= ((D30 + BinUtils::countBits(bmask[3] & d)) % 2) << 2;
-      D |= ((D30 + BinUtils::countBits(bmask[4] & d)) % 2) << 1;
-      D |= ((D29 + BinUtils::countBits(bmask[5] & d)) % 2);
-
-      return D;
+         // new.  The parity bits are looked up a data byte at a time
+         // in tables made from bmask.
+      return tableParity(sfword, psfword, knownUpright);
    }
 
    uint32_t EngNav :: fixParity(uint32_t sfword,
@@ -717,17 +749,36 @@ namespace gpstk
 
    bool EngNav :: checkParity(const uint32_t sf[10], bool knownUpright)
    {
-      return
-         ((sf[0] & 0x0000003f) == computeParity(sf[0],     0, knownUpright)) &&
-         ((sf[1] & 0x0000003f) == computeParity(sf[1], sf[0], knownUpright)) &&
-         ((sf[2] & 0x0000003f) == computeParity(sf[2], sf[1], knownUpright)) &&
-         ((sf[3] & 0x0000003f) == computeParity(sf[3], sf[2], knownUpright)) &&
-         ((sf[4] & 0x0000003f) == computeParity(sf[4], sf[3], knownUpright)) &&
-         ((sf[5] & 0x0000003f) == computeParity(sf[5], sf[4], knownUpright)) &&
-         ((sf[6] & 0x0000003f) == computeParity(sf[6], sf[5], knownUpright)) &&
-         ((sf[7] & 0x0000003f) == computeParity(sf[7], sf[6], knownUpright)) &&
-         ((sf[8] & 0x0000003f) == computeParity(sf[8], sf[7], knownUpright)) &&
-         ((sf[9] & 0x0000003f) == computeParity(sf[9], sf[8], knownUpright));
+      return checkParity(&sf, 1, knownUpright) != 0;
+   }
+
+   bool EngNav :: checkParity(const PackedNavBits& pnb, bool knownUpright)
+   {
+      if (pnb.getNumBits() < 300)
+         return false;
+      uint32_t sf[10];
+      for (unsigned n = 0; n < 10; n++)
+         sf[n] = pnb.asUnsignedLong(30*n, 30, 1);
+      return checkParity(sf, knownUpright);
+   }
+
+   uint64_t EngNav :: checkParity(const uint32_t *const sf[], unsigned n,
+                                  bool knownUpright)
+   {
+      uint64_t passed = 0;
+      if (n > parityBatchMax)
+         n = parityBatchMax;
+      for (unsigned i = 0; i < n; i++)
+      {
+            // OR together the differences of all ten words, so there
+            // is no branch until the end of the subframe
+         const uint32_t *w = sf[i];
+         uint32_t bad = (w[0] & 0x3f) ^ tableParity(w[0], 0, knownUpright);
+         for (unsigned j = 1; j < 10; j++)
+            bad |= (w[j] & 0x3f) ^ tableParity(w[j], w[j-1], knownUpright);
+         passed |= uint64_t(bad == 0) << i;
+      }
+      return passed;
    }
 
    void EngNav :: convertQuant(const uint32_t input[10],
@@ -57,6 +57,7 @@ namespace gpstk
       //@{
 
    struct DecodeQuant;
+   class PackedNavBits;
 
       /**
        * Base class for ICD-GPS-200 navigation messages.  This class
@@ -122,6 +123,34 @@ namespace gpstk
       static bool checkParity(const uint32_t input[10], bool knownUpright=true);
       static bool checkParity(const std::vector<uint32_t>& v, bool knownUpright=true);
 
+         /**
+          * Perform a parity check on a navigation message subframe
+          * held in a PackedNavBits object as 300 bits, ten 30-bit
+          * words.
+          * @return true if the parity check is successful, false if
+          *   it fails or there are fewer than 300 bits.
+          */
+      static bool checkParity(const PackedNavBits& pnb, bool knownUpright=true);
+
+         /// The most subframes checked by one call to the batch checkParity().
+      static const unsigned parityBatchMax = 64;
+
+         /**
+          * Perform parity checks on a batch of navigation message
+          * subframes.  The parity of each word is computed from
+          * lookup tables, and every word of every subframe is checked
+          * without branching on the results, so that a batch is
+          * checked much faster than the subframes one at a time.
+          * @param sf pointers to the subframes, each ten words as for
+          *   checkParity(const uint32_t[10],bool).
+          * @param n the number of subframes, at most parityBatchMax.
+          * @param knownUpright When this is not set, the words
+          *   following a word with D30 set are complemented first.
+          * @return a mask with bit i set if subframe sf[i] passed.
+          */
+      static uint64_t checkParity(const uint32_t *const sf[], unsigned n,
+                                  bool knownUpright=true);
+
 
          /// This is the old routine only left around for compatibility
       static bool subframeParity(const long input[10]);
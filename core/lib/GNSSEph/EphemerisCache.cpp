@@ -0,0 +1,462 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+
+/** @file EphemerisCache.cpp
+ * Binary snapshot ("cache") files of loaded ephemeris stores. */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdint.h>
+#include <sys/stat.h>
+#include "EphemerisCache.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   namespace
+   {
+      const char cacheMagic[8] = { 'G','P','S','T','k','E','C','F' };
+      const uint32_t byteOrderMark = 0x01020304;
+         /// magic, version, byte order mark, payload length, checksum
+      const size_t headerSize = 8 + 4 + 4 + 8 + 8;
+
+         /// 64-bit FNV-1a hash of n bytes
+      uint64_t fnv1a(const char *p, size_t n)
+      {
+         uint64_t h = 14695981039346656037ULL;
+         for(size_t i=0; i<n; i++)
+         {
+            h ^= static_cast<unsigned char>(p[i]);
+            h *= 1099511628211ULL;
+         }
+         return h;
+      }
+
+         /** Get the size and modification time of a file, the time
+          * in nanoseconds where the system keeps it, so that a file
+          * rewritten within the same second is still seen to change. */
+      bool fileStamp(const string& filename, long long& size, long long& mtime)
+      {
+         struct stat st;
+         if(::stat(filename.c_str(), &st) != 0)
+            return false;
+         size = static_cast<long long>(st.st_size);
+#if defined(__APPLE__)
+         mtime = static_cast<long long>(st.st_mtimespec.tv_sec) * 1000000000LL
+            + st.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+         mtime = static_cast<long long>(st.st_mtime) * 1000000000LL;
+#else
+         mtime = static_cast<long long>(st.st_mtim.tv_sec) * 1000000000LL
+            + st.st_mtim.tv_nsec;
+#endif
+         return true;
+      }
+
+      template <class T>
+      void append(vector<char>& buf, const T& value)
+      {
+         const char *p = reinterpret_cast<const char*>(&value);
+         buf.insert(buf.end(), p, p+sizeof(T));
+      }
+
+      void appendString(vector<char>& buf, const string& s)
+      {
+         append(buf, static_cast<uint32_t>(s.size()));
+         buf.insert(buf.end(), s.begin(), s.end());
+      }
+   }
+
+
+   const unsigned int EphemerisCacheReader::version = 2;
+
+
+   EphemerisCacheWriter::EphemerisCacheWriter(const string& k) throw()
+         : kind(k)
+   {
+   }
+
+
+   void EphemerisCacheWriter::addSource(const string& filename)
+      throw(FileMissingException)
+   {
+      long long fsize, mtime;
+      if(!fileStamp(filename, fsize, mtime))
+      {
+         FileMissingException e("Cannot stat source file " + filename);
+         GPSTK_THROW(e);
+      }
+      sourceNames.push_back(filename);
+      sourceSizes.push_back(fsize);
+      sourceTimes.push_back(mtime);
+   }
+
+
+   void EphemerisCacheWriter::putBytes(const void *p, size_t n) throw()
+   {
+      const char *c = static_cast<const char*>(p);
+      body.insert(body.end(), c, c+n);
+   }
+
+
+   void EphemerisCacheWriter::put(bool b) throw()
+   {
+      append(body, static_cast<uint8_t>(b ? 1 : 0));
+   }
+
+
+   void EphemerisCacheWriter::put(int i) throw()
+   {
+      append(body, static_cast<int32_t>(i));
+   }
+
+
+   void EphemerisCacheWriter::put(unsigned int u) throw()
+   {
+      append(body, static_cast<uint32_t>(u));
+   }
+
+
+   void EphemerisCacheWriter::put(long long l) throw()
+   {
+      append(body, static_cast<int64_t>(l));
+   }
+
+
+   void EphemerisCacheWriter::put(double d) throw()
+   {
+      append(body, d);
+   }
+
+
+   void EphemerisCacheWriter::put(const string& s) throw()
+   {
+      appendString(body, s);
+   }
+
+
+   void EphemerisCacheWriter::put(const CommonTime& t) throw()
+   {
+      long day, msod;
+      double fsod;
+      TimeSystem ts;
+      t.getInternal(day, msod, fsod, ts);
+      put(static_cast<long long>(day));
+      put(static_cast<long long>(msod));
+      put(fsod);
+      put(static_cast<int>(ts.getTimeSystem()));
+   }
+
+
+   void EphemerisCacheWriter::put(const SatID& sat) throw()
+   {
+      put(sat.id);
+      put(static_cast<int>(sat.system));
+   }
+
+
+   void EphemerisCacheWriter::put(const ObsID& oid) throw()
+   {
+      put(static_cast<int>(oid.type));
+      put(static_cast<int>(oid.band));
+      put(static_cast<int>(oid.code));
+   }
+
+
+   void EphemerisCacheWriter::put(const Triple& t) throw()
+   {
+      put(t[0]);
+      put(t[1]);
+      put(t[2]);
+   }
+
+
+   void EphemerisCacheWriter::write(const string& filename) const
+      throw(FileMissingException)
+   {
+      vector<char> payload;
+      payload.reserve(body.size() + 64*(sourceNames.size()+1));
+      appendString(payload, kind);
+      append(payload, static_cast<uint32_t>(sourceNames.size()));
+      for(size_t i=0; i<sourceNames.size(); i++)
+      {
+         appendString(payload, sourceNames[i]);
+         append(payload, static_cast<int64_t>(sourceSizes[i]));
+         append(payload, static_cast<int64_t>(sourceTimes[i]));
+      }
+      payload.insert(payload.end(), body.begin(), body.end());
+
+      vector<char> header;
+      header.insert(header.end(), cacheMagic, cacheMagic+8);
+      append(header, static_cast<uint32_t>(EphemerisCacheReader::version));
+      append(header, byteOrderMark);
+      append(header, static_cast<uint64_t>(payload.size()));
+      append(header, fnv1a(payload.empty() ? "" : &payload[0], payload.size()));
+
+         // write a temporary file and rename it, so that a reader
+         // never sees a partly written cache
+      string tmpname(filename + ".tmp");
+      {
+         ofstream ofs(tmpname.c_str(), ios::out|ios::binary|ios::trunc);
+         ofs.write(&header[0], header.size());
+         if(!payload.empty())
+            ofs.write(&payload[0], payload.size());
+         if(!ofs)
+         {
+            ofs.close();
+            std::remove(tmpname.c_str());
+            FileMissingException e("Cannot write cache file " + filename);
+            GPSTK_THROW(e);
+         }
+      }
+      std::remove(filename.c_str());
+      if(std::rename(tmpname.c_str(), filename.c_str()) != 0)
+      {
+         std::remove(tmpname.c_str());
+         FileMissingException e("Cannot write cache file " + filename);
+         GPSTK_THROW(e);
+      }
+   }
+
+
+   EphemerisCacheReader::EphemerisCacheReader() throw()
+         : data(NULL), size(0), pos(0)
+   {
+   }
+
+
+   EphemerisCacheReader::~EphemerisCacheReader() throw()
+   {
+      close();
+   }
+
+
+   void EphemerisCacheReader::close() throw()
+   {
+      file.close();
+      sourceNames.clear();
+      data = NULL;
+      size = pos = 0;
+   }
+
+
+   bool EphemerisCacheReader::open(const string& filename, const string& kind,
+                                   const vector<string>& sources)
+      throw()
+   {
+      close();
+      try
+      {
+         if(!file.open(filename))
+            return false;
+         data = file.data();
+         const size_t mapSize = file.size();
+
+            // header
+         uint32_t ver, bom;
+         uint64_t length, checksum;
+         if(mapSize < headerSize || memcmp(data, cacheMagic, 8) != 0)
+         {
+            close();
+            return false;
+         }
+         memcpy(&ver, data+8, 4);
+         memcpy(&bom, data+12, 4);
+         memcpy(&length, data+16, 8);
+         memcpy(&checksum, data+24, 8);
+         if(ver != version || bom != byteOrderMark ||
+            length != mapSize - headerSize ||
+            fnv1a(data+headerSize, length) != checksum)
+         {
+            close();
+            return false;
+         }
+         pos = headerSize;
+         size = mapSize;
+
+            // kind and sources
+         string k;
+         get(k);
+         unsigned int nsrc;
+         get(nsrc);
+         if(k != kind || nsrc != sources.size())
+         {
+            close();
+            return false;
+         }
+         vector<string> names;
+         for(unsigned int i=0; i<nsrc; i++)
+         {
+            string name;
+            int64_t fsize, mtime;
+            long long nowSize, nowTime;
+            get(name);
+            getBytes(&fsize, 8);
+            getBytes(&mtime, 8);
+            if(!fileStamp(name, nowSize, nowTime) ||
+               nowSize != fsize || nowTime != mtime)
+            {
+               close();
+               return false;
+            }
+            names.push_back(name);
+         }
+            // the same files in the same order, since a store loaded
+            // in another order may hold different data
+         if(names != sources)
+         {
+            close();
+            return false;
+         }
+         sourceNames.swap(names);
+      }
+      catch(Exception&)
+      {
+         close();
+         return false;
+      }
+      return true;
+   }
+
+
+   void EphemerisCacheReader::getBytes(void *p, size_t n) throw(Exception)
+   {
+      if(n > size - pos)
+      {
+         Exception e("Unexpected end of ephemeris cache");
+         GPSTK_THROW(e);
+      }
+      memcpy(p, data+pos, n);
+      pos += n;
+   }
+
+
+   void EphemerisCacheReader::get(bool& b) throw(Exception)
+   {
+      uint8_t u;
+      getBytes(&u, 1);
+      b = (u != 0);
+   }
+
+
+   void EphemerisCacheReader::get(int& i) throw(Exception)
+   {
+      int32_t v;
+      getBytes(&v, 4);
+      i = v;
+   }
+
+
+   void EphemerisCacheReader::get(unsigned int& u) throw(Exception)
+   {
+      uint32_t v;
+      getBytes(&v, 4);
+      u = v;
+   }
+
+
+   void EphemerisCacheReader::get(long long& l) throw(Exception)
+   {
+      int64_t v;
+      getBytes(&v, 8);
+      l = v;
+   }
+
+
+   void EphemerisCacheReader::get(double& d) throw(Exception)
+   {
+      getBytes(&d, sizeof(double));
+   }
+
+
+   void EphemerisCacheReader::get(string& s) throw(Exception)
+   {
+      uint32_t n;
+      getBytes(&n, 4);
+      if(n > size - pos)
+      {
+         Exception e("Unexpected end of ephemeris cache");
+         GPSTK_THROW(e);
+      }
+      s.assign(data+pos, n);
+      pos += n;
+   }
+
+
+   void EphemerisCacheReader::get(CommonTime& t) throw(Exception)
+   {
+      long long day, msod;
+      double fsod;
+      int ts;
+      get(day);
+      get(msod);
+      get(fsod);
+      get(ts);
+      t.setInternal(static_cast<long>(day), static_cast<long>(msod), fsod,
+                    TimeSystem(ts));
+   }
+
+
+   void EphemerisCacheReader::get(SatID& sat) throw(Exception)
+   {
+      int sys;
+      get(sat.id);
+      get(sys);
+      sat.system = static_cast<SatID::SatelliteSystem>(sys);
+   }
+
+
+   void EphemerisCacheReader::get(ObsID& oid) throw(Exception)
+   {
+      int type, band, code;
+      get(type);
+      get(band);
+      get(code);
+      oid = ObsID(static_cast<ObsID::ObservationType>(type),
+                  static_cast<ObsID::CarrierBand>(band),
+                  static_cast<ObsID::TrackingCode>(code));
+   }
+
+
+   void EphemerisCacheReader::get(Triple& t) throw(Exception)
+   {
+      get(t[0]);
+      get(t[1]);
+      get(t[2]);
+   }
+
+}  // namespace gpstk
@@ -0,0 +1,192 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+
+/** @file EphemerisCache.hpp
+ * Binary snapshot ("cache") files of loaded ephemeris stores, used to
+ * skip parsing the same text files again on later runs. */
+
+#ifndef GPSTK_EPHEMERISCACHE_HPP
+#define GPSTK_EPHEMERISCACHE_HPP
+
+#include <string>
+#include <vector>
+#include "Exception.hpp"
+#include "CommonTime.hpp"
+#include "SatID.hpp"
+#include "ObsID.hpp"
+#include "Triple.hpp"
+#include "MappedFile.hpp"
+
+namespace gpstk
+{
+      /// @ingroup GNSSEph
+      //@{
+
+      /** Writer of an ephemeris cache file.  The store that is
+       * being saved names the source files it was loaded from with
+       * addSource(), then appends its contents with the put()
+       * methods, and finally calls write().
+       *
+       * The file is a fixed header (magic string, format version,
+       * byte order mark, payload length and a 64-bit FNV-1a checksum
+       * of the payload) followed by the payload: a string naming
+       * the kind of store, the list of source files with their size
+       * and modification time, and the store contents.  Values are
+       * written in native byte order; the file is a cache for the
+       * machine that wrote it, not an interchange format.
+       * @see EphemerisCacheReader */
+   class EphemerisCacheWriter
+   {
+   public:
+         /** Start a cache file for a store of the given kind, e.g.
+          * "SP3EphemerisStore". */
+      EphemerisCacheWriter(const std::string& kind) throw();
+
+         /** Record a source file of the store, with its current size
+          * and modification time.
+          * @throw FileMissingException if the file cannot be found */
+      void addSource(const std::string& filename)
+         throw(FileMissingException);
+
+         /// @name Append a value to the payload
+         //@{
+      void put(bool b) throw();
+      void put(int i) throw();
+      void put(unsigned int u) throw();
+      void put(long long l) throw();
+      void put(double d) throw();
+      void put(const std::string& s) throw();
+      void put(const CommonTime& t) throw();
+      void put(const SatID& sat) throw();
+      void put(const ObsID& oid) throw();
+      void put(const Triple& t) throw();
+         //@}
+
+         /** Write the cache file; an existing file is replaced.
+          * @throw FileMissingException if the file cannot be written */
+      void write(const std::string& filename) const
+         throw(FileMissingException);
+
+   private:
+         /// Append n raw bytes to the payload.
+      void putBytes(const void *p, size_t n) throw();
+
+         /// The kind of store, checked by EphemerisCacheReader::open()
+      std::string kind;
+         /// Source file names, sizes and modification times
+      std::vector<std::string> sourceNames;
+      std::vector<long long> sourceSizes, sourceTimes;
+         /// Store contents
+      std::vector<char> body;
+   };
+
+
+      /** Reader of an ephemeris cache file written by
+       * EphemerisCacheWriter.  open() maps the file into memory
+       * with MappedFile and validates it; the get() methods then return the values in
+       * the order they were put().
+       * @see EphemerisCacheWriter */
+   class EphemerisCacheReader
+   {
+   public:
+      EphemerisCacheReader() throw();
+      ~EphemerisCacheReader() throw();
+
+         /** Open and validate a cache file.  The file is accepted
+          * only if it is intact (checksum), was written by this
+          * version of the format for a store of the given kind, and
+          * its source files are exactly the given files in the same
+          * order, each still with the size and modification time (to
+          * the nanosecond, where the system keeps it) it had when the
+          * cache was written.
+          * @param[in] filename name of the cache file
+          * @param[in] kind kind of store expected
+          * @param[in] sources names of the files the store would
+          *   otherwise be loaded from
+          * @return true if the cache is valid and positioned at the
+          *   start of the store contents, false if it is missing,
+          *   damaged or stale. */
+      bool open(const std::string& filename, const std::string& kind,
+                const std::vector<std::string>& sources) throw();
+
+         /// Source file names of the open cache, in the order written.
+      const std::vector<std::string>& getSources() const throw()
+      { return sourceNames; }
+
+         /** @name Get the next value of the payload
+          * @throw Exception if the payload is exhausted */
+         //@{
+      void get(bool& b) throw(Exception);
+      void get(int& i) throw(Exception);
+      void get(unsigned int& u) throw(Exception);
+      void get(long long& l) throw(Exception);
+      void get(double& d) throw(Exception);
+      void get(std::string& s) throw(Exception);
+      void get(CommonTime& t) throw(Exception);
+      void get(SatID& sat) throw(Exception);
+      void get(ObsID& oid) throw(Exception);
+      void get(Triple& t) throw(Exception);
+         //@}
+
+         /// Return true when every value has been read.
+      bool atEnd() const throw()
+      { return pos == size; }
+
+         /// Unmap the file.
+      void close() throw();
+
+         /// Format version written and accepted.
+      static const unsigned int version;
+
+   private:
+         /// Copy the next n bytes of the payload to p.
+      void getBytes(void *p, size_t n) throw(Exception);
+
+      const char *data;             ///< start of the file contents
+      size_t size;                  ///< end of the payload
+      size_t pos;                   ///< next byte to get
+      MappedFile file;              ///< the file contents
+      std::vector<std::string> sourceNames;
+
+         // not copyable
+      EphemerisCacheReader(const EphemerisCacheReader&);
+      EphemerisCacheReader& operator=(const EphemerisCacheReader&);
+   };
+
+      //@}
+
+}  // namespace gpstk
+
+#endif // GPSTK_EPHEMERISCACHE_HPP
@@ -59,6 +59,9 @@ namespace gpstk
    // ordering has been determined.
    void GPSEphemerisStore::rationalize(void)
    {
+      // validity intervals change, so existing orbit fits do not apply
+      fits.clear();
+
       // loop over satellites
       SatTableMap::iterator it;
       for (it = satTables.begin(); it != satTables.end(); it++) {
@@ -255,4 +258,173 @@ namespace gpstk
       return n;
    }
 
+   namespace
+   {
+         // The members of a GPSEphemeris, in cache order
+      void putEphemeris(EphemerisCacheWriter& cw, const GPSEphemeris& eph)
+      {
+         cw.put(eph.dataLoadedFlag);
+         cw.put(eph.satID);
+         cw.put(eph.obsID);
+         cw.put(eph.ctToe);
+         cw.put(eph.ctToc);
+         cw.put(eph.af0);
+         cw.put(eph.af1);
+         cw.put(eph.af2);
+         cw.put(eph.M0);
+         cw.put(eph.dn);
+         cw.put(eph.ecc);
+         cw.put(eph.A);
+         cw.put(eph.OMEGA0);
+         cw.put(eph.i0);
+         cw.put(eph.w);
+         cw.put(eph.OMEGAdot);
+         cw.put(eph.idot);
+         cw.put(eph.dndot);
+         cw.put(eph.Adot);
+         cw.put(eph.Cuc);
+         cw.put(eph.Cus);
+         cw.put(eph.Crc);
+         cw.put(eph.Crs);
+         cw.put(eph.Cic);
+         cw.put(eph.Cis);
+         cw.put(eph.beginValid);
+         cw.put(eph.endValid);
+
+         cw.put(eph.transmitTime);
+         cw.put(static_cast<long long>(eph.HOWtime));
+         cw.put(static_cast<int>(eph.IODE));
+         cw.put(static_cast<int>(eph.IODC));
+         cw.put(static_cast<int>(eph.health));
+         cw.put(static_cast<int>(eph.accuracyFlag));
+         cw.put(eph.accuracy);
+         cw.put(eph.Tgd);
+         cw.put(static_cast<int>(eph.codeflags));
+         cw.put(static_cast<int>(eph.L2Pdata));
+         cw.put(static_cast<int>(eph.fitDuration));
+         cw.put(static_cast<int>(eph.fitint));
+      }
+
+      short getShort(EphemerisCacheReader& cr)
+      {
+         int i;
+         cr.get(i);
+         return static_cast<short>(i);
+      }
+
+      void getEphemeris(EphemerisCacheReader& cr, GPSEphemeris& eph)
+      {
+         cr.get(eph.dataLoadedFlag);
+         cr.get(eph.satID);
+         cr.get(eph.obsID);
+         cr.get(eph.ctToe);
+         cr.get(eph.ctToc);
+         cr.get(eph.af0);
+         cr.get(eph.af1);
+         cr.get(eph.af2);
+         cr.get(eph.M0);
+         cr.get(eph.dn);
+         cr.get(eph.ecc);
+         cr.get(eph.A);
+         cr.get(eph.OMEGA0);
+         cr.get(eph.i0);
+         cr.get(eph.w);
+         cr.get(eph.OMEGAdot);
+         cr.get(eph.idot);
+         cr.get(eph.dndot);
+         cr.get(eph.Adot);
+         cr.get(eph.Cuc);
+         cr.get(eph.Cus);
+         cr.get(eph.Crc);
+         cr.get(eph.Crs);
+         cr.get(eph.Cic);
+         cr.get(eph.Cis);
+         cr.get(eph.beginValid);
+         cr.get(eph.endValid);
+
+         long long how;
+         cr.get(eph.transmitTime);
+         cr.get(how);
+         eph.HOWtime = static_cast<long>(how);
+         eph.IODE = getShort(cr);
+         eph.IODC = getShort(cr);
+         eph.health = getShort(cr);
+         eph.accuracyFlag = getShort(cr);
+         cr.get(eph.accuracy);
+         cr.get(eph.Tgd);
+         eph.codeflags = getShort(cr);
+         eph.L2Pdata = getShort(cr);
+         eph.fitDuration = getShort(cr);
+         eph.fitint = getShort(cr);
+      }
+   }
+
+   //-----------------------------------------------------------------------------
+   void GPSEphemerisStore::writeCache(EphemerisCacheWriter& cw) const
+      throw(Exception)
+   {
+      cw.put(initialTime);
+      cw.put(finalTime);
+      cw.put(static_cast<unsigned int>(satTables.size()));
+      SatTableMap::const_iterator it;
+      for(it = satTables.begin(); it != satTables.end(); ++it)
+      {
+         const TimeOrbitEphTable& table(it->second);
+         cw.put(it->first);
+         cw.put(static_cast<unsigned int>(table.size()));
+         TimeOrbitEphTable::const_iterator jt;
+         for(jt = table.begin(); jt != table.end(); ++jt)
+         {
+            const GPSEphemeris *eph = dynamic_cast<const GPSEphemeris*>(jt->second);
+            if(!eph)
+            {
+               InvalidRequest e("Cannot cache " + jt->second->getName()
+                                + " in a GPSEphemerisStore");
+               GPSTK_THROW(e);
+            }
+            cw.put(static_cast<long long>(jt->first.getNanoseconds()));
+            cw.put(static_cast<int>(jt->first.getTimeSystem().getTimeSystem()));
+            putEphemeris(cw, *eph);
+         }
+      }
+   }
+
+   //-----------------------------------------------------------------------------
+   void GPSEphemerisStore::readCache(EphemerisCacheReader& cr)
+      throw(Exception)
+   {
+      try
+      {
+         clear();
+         cr.get(initialTime);
+         cr.get(finalTime);
+         unsigned int nsat, neph;
+         cr.get(nsat);
+         for(unsigned int i=0; i<nsat; i++)
+         {
+            SatID sat;
+            cr.get(sat);
+            cr.get(neph);
+            TimeOrbitEphTable& table(satTables[sat]);
+            for(unsigned int j=0; j<neph; j++)
+            {
+               long long ns;
+               int ts;
+               GPSEphemeris eph;
+               cr.get(ns);
+               cr.get(ts);
+               getEphemeris(cr, eph);
+               table.insert(table.end(), std::make_pair(
+                  TimeKey(ns, static_cast<TimeSystem::Systems>(ts)),
+                  eph.clone()));
+            }
+         }
+      }
+      catch(Exception& e)
+      {
+         clear();
+         GPSTK_RETHROW(e);
+      }
+   }
+
 } // namespace
@@ -45,6 +45,7 @@
 
 #include "OrbitEphStore.hpp"
 #include "GPSEphemeris.hpp"
+#include "EphemerisCache.hpp"
 #include "Exception.hpp"
 #include "SatID.hpp"
 #include "CommonTime.hpp"
@@ -140,6 +141,19 @@ namespace gpstk
          return gpseph;
       }
 
+         /** Append the time limits and all ephemerides, with their
+          * keys, to an ephemeris cache being written.
+          * @throw InvalidRequest if the store holds an ephemeris that
+          *   is not a GPSEphemeris */
+      void writeCache(EphemerisCacheWriter& cw) const throw(Exception);
+
+         /** Replace the ephemerides and time limits with those read
+          * from an ephemeris cache written by writeCache().  The
+          * tables are rebuilt exactly as written, without going
+          * through addEphemeris().
+          * @throw Exception if the cache is exhausted */
+      void readCache(EphemerisCacheReader& cr) throw(Exception);
+
          /// Add all ephemerides to an existing list<GPSEphemeris> for given satellite
          /// If sat.id is -1 (the default), all ephemerides are added.
          /// @return the number of ephemerides added.
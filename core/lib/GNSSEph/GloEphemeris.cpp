@@ -37,6 +37,8 @@
 /// @file GloEphemeris.cpp
 /// Ephemeris data for GLONASS.
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include "GloEphemeris.hpp"
 #include "TimeString.hpp"
@@ -96,16 +98,133 @@ namespace gpstk
 
       }
 
-         // Get the data out of the GloRecord structure
-      double px( x[0] );   // X coordinate (km)
-      double vx( v[0] );   // X velocity   (km/s)
-      double ax( a[0] );   // X acceleration (km/s^2)
-      double py( x[1] );   // Y coordinate
-      double vy( v[1] );   // Y velocity
-      double ay( a[1] );   // Y acceleration
-      double pz( x[2] );   // Z coordinate
-      double vz( v[2] );   // Z velocity
-      double az( a[2] );   // Z acceleration
+         // Initial state, rotated to an absolute coordinate system
+      double state[6], s0, numSeconds;
+      initialState( state, s0, numSeconds );
+
+         // Integrate satellite state to desired epoch
+      integrate( state, s0, numSeconds, epoch - ephTime );
+
+      PZ90Ellipsoid pz90;
+      return stateToXvt( state, s0 + pz90.angVelocity()*numSeconds, epoch );
+
+   }  // End of method 'GloEphemeris::svXvt(const CommonTime& t)'
+
+
+   void GloEphemeris::computeTrajectory( Trajectory& traj,
+                                         double spacing ) const
+      throw( gpstk::InvalidRequest )
+   {
+
+      if(!valid)
+      {
+         InvalidRequest exc("computeTrajectory(): No valid data stored.");
+         GPSTK_THROW(exc);
+      }
+      if( !(spacing > 0.0) )
+      {
+         InvalidRequest exc("computeTrajectory(): spacing must be positive.");
+         GPSTK_THROW(exc);
+      }
+
+      PZ90Ellipsoid pz90;
+      double we( pz90.angVelocity() );
+
+         // Nodes from at least 15 minutes before to 15 minutes after
+      int n( static_cast<int>(std::ceil(900.0/spacing - 1e-9)) );
+      double init[6], s0, sod0;
+      initialState( init, s0, sod0 );
+      traj.spacing = spacing;
+      traj.first = -n*spacing;
+      traj.angle = s0 + we*sod0;
+      traj.nodes.assign( 9*(2*n+1), 0.0 );
+
+         // Integrate backward then forward from the epoch, one node
+         // at a time
+      for( int dir = -1; dir <= 1; dir += 2 )
+      {
+         double state[6], numSeconds( sod0 ), accel[3], dxt[6];
+         std::copy( init, init+6, state );
+         for( int k = 0; k <= n; k++ )
+         {
+            if( k > 0 )
+               integrate( state, s0, numSeconds, dir*spacing );
+            double s( s0 + we*numSeconds );
+            accel[0] = a[0]*std::cos(s) - a[1]*std::sin(s);
+            accel[1] = a[0]*std::sin(s) + a[1]*std::cos(s);
+            accel[2] = a[2];
+            derivative( state, accel, dxt );
+            double *node( &traj.nodes[9*(n + dir*k)] );
+            for( int j = 0; j < 3; j++ )
+            {
+               node[j]   = state[2*j];
+               node[3+j] = state[2*j+1];
+               node[6+j] = dxt[2*j+1];
+            }
+         }
+      }
+
+   }  // End of method 'GloEphemeris::computeTrajectory()'
+
+
+   Xvt GloEphemeris::svXvt( const CommonTime& epoch,
+                            const Trajectory& traj ) const
+      throw( gpstk::InvalidRequest )
+   {
+
+      double dt( epoch - ephTime );
+
+         // Same limits as svXvt(const CommonTime&)
+      if ( dt < -900.0 || dt >= 900.0 )
+      {
+         InvalidRequest e( "Requested time is out of ephemeris data" );
+         GPSTK_THROW(e);
+      }
+
+      std::size_t nnodes( traj.nodes.size()/9 );
+      double u( traj.spacing > 0.0 ? (dt - traj.first)/traj.spacing : -1.0 );
+      if ( epoch == ephTime || nnodes < 2 || u < 0.0 || u > nnodes-1 )
+         return svXvtOverrideFit(epoch);
+
+         // Quintic Hermite interpolation between the bracketing nodes,
+         // from the position, velocity and acceleration at each
+      std::size_t i( std::min(static_cast<std::size_t>(u), nnodes-2) );
+      u -= i;
+      const double *p0( &traj.nodes[9*i] ), *p1( &traj.nodes[9*(i+1)] );
+      double h( traj.spacing ), h2( h*h );
+      double u2( u*u ), u3( u2*u ), u4( u3*u ), u5( u4*u );
+      double H0( 1.0 - 10.0*u3 + 15.0*u4 - 6.0*u5 );
+      double H1( u - 6.0*u3 + 8.0*u4 - 3.0*u5 );
+      double H2( 0.5*u2 - 1.5*u3 + 1.5*u4 - 0.5*u5 );
+      double H3( 0.5*u3 - u4 + 0.5*u5 );
+      double H4( -4.0*u3 + 7.0*u4 - 3.0*u5 );
+      double H5( 10.0*u3 - 15.0*u4 + 6.0*u5 );
+      double D0( -30.0*u2 + 60.0*u3 - 30.0*u4 );
+      double D1( 1.0 - 18.0*u2 + 32.0*u3 - 15.0*u4 );
+      double D2( u - 4.5*u2 + 6.0*u3 - 2.5*u4 );
+      double D3( 1.5*u2 - 4.0*u3 + 2.5*u4 );
+      double D4( -12.0*u2 + 28.0*u3 - 15.0*u4 );
+      double D5( 30.0*u2 - 60.0*u3 + 30.0*u4 );
+
+      double state[6];
+      for( int j = 0; j < 3; j++ )
+      {
+         state[2*j] = H0*p0[j] + h*H1*p0[3+j] + h2*H2*p0[6+j]
+                    + h2*H3*p1[6+j] + h*H4*p1[3+j] + H5*p1[j];
+         state[2*j+1] = ( D0*p0[j] + h*D1*p0[3+j] + h2*D2*p0[6+j]
+                        + h2*D3*p1[6+j] + h*D4*p1[3+j] + D5*p1[j] ) / h;
+      }
+
+      PZ90Ellipsoid pz90;
+      return stateToXvt( state, traj.angle + pz90.angVelocity()*dt, epoch );
+
+   }  // End of method 'GloEphemeris::svXvt(epoch, traj)'
+
+
+   void GloEphemeris::initialState( double state[6],
+                                    double& s0,
+                                    double& sod ) const
+   {
 
          // We will need some PZ-90 ellipsoid parameters
       PZ90Ellipsoid pz90;
@@ -113,101 +232,205 @@ namespace gpstk
 
          // Get sidereal time at Greenwich at 0 hours UT
       double gst( getSidTime( ephTime ) );
-      double s0( gst*PI/12.0 );
+      s0 = gst*PI/12.0;
       YDSTime ytime( ephTime );
-      double numSeconds( ytime.sod );
-      double s( s0 + we*numSeconds );
+      sod = ytime.sod;
+      double s( s0 + we*sod );
       double cs( std::cos(s) );
       double ss( std::sin(s) );
 
-         // Initial state matrix
-      Vector<double> initialState(6), accel(3), dxt1(6), dxt2(6), dxt3(6),
-                     dxt4(6), tempRes(6);
-
          // Get the reference state out of GloEphemeris object data. Values
          // must be rotated from PZ-90 to an absolute coordinate system
-         // Initial x coordinate (m)
-      initialState(0)  = (px*cs - py*ss);
-         // Initial y coordinate
-      initialState(2)  = (px*ss + py*cs);
-         // Initial z coordinate
-      initialState(4)  = pz;
+      state[0] = (x[0]*cs - x[1]*ss);                 // x coordinate (km)
+      state[2] = (x[0]*ss + x[1]*cs);                 // y coordinate
+      state[4] = x[2];                                // z coordinate
+      state[1] = (v[0]*cs - v[1]*ss - we*state[2]);   // x velocity (km/s)
+      state[3] = (v[0]*ss + v[1]*cs + we*state[0]);   // y velocity
+      state[5] = v[2];                                // z velocity
 
-         // Initial x velocity   (m/s)
-      initialState(1)  = (vx*cs - vy*ss - we*initialState(2) );
-         // Initial y velocity
-      initialState(3)  = (vx*ss + vy*cs + we*initialState(0) );
-         // Initial z velocity
-      initialState(5)  = vz;
+   }  // End of method 'GloEphemeris::initialState()'
 
 
+   void GloEphemeris::integrate( double state[6],
+                                 double s0,
+                                 double& sod,
+                                 double dt ) const
+   {
+      if ( integrator == DormandPrince54 )
+         integrateDP54( state, s0, sod, dt );
+      else
+         integrateRK4( state, s0, sod, dt );
+   }
+
+
+   void GloEphemeris::integrateRK4( double state[6],
+                                    double s0,
+                                    double& sod,
+                                    double dt ) const
+   {
+
+      PZ90Ellipsoid pz90;
+      double we( pz90.angVelocity() );
+
+      double accel[3], dxt1[6], dxt2[6], dxt3[6], dxt4[6], tempRes[6];
+
          // Integrate satellite state to desired epoch using the given step
       double rkStep( step );
+      if ( dt < 0.0 ) rkStep = step*(-1.0);
+      double work( 0.0 );
 
-      if ( (epoch - ephTime) < 0.0 ) rkStep = step*(-1.0);
-      CommonTime workEpoch( ephTime );
-
-      double tolerance( 1e-9 );
-      bool done( false );
-      while (!done)
+      const double tol( 1e-9 );
+      while ( std::fabs( dt - work ) >= tol )
       {
 
             // If we are about to overstep, change the stepsize appropriately
             // to hit our target final time.
          if( rkStep > 0.0 )
          {
-            if( (workEpoch + rkStep) > epoch )
-               rkStep = (epoch - workEpoch);
+            if( (work + rkStep) > dt )
+               rkStep = (dt - work);
          }
          else
          {
-            if ( (workEpoch + rkStep) < epoch )
-               rkStep = (epoch - workEpoch);
+            if ( (work + rkStep) < dt )
+               rkStep = (dt - work);
          }
 
-         numSeconds += rkStep;
-         s = s0 + we*( numSeconds );
-         cs = std::cos(s);
-         ss = std::sin(s);
+         sod += rkStep;
+         double s( s0 + we*sod );
+         double cs( std::cos(s) );
+         double ss( std::sin(s) );
 
             // Accelerations are computed once per iteration
-         accel(0) = ax*cs - ay*ss;
-         accel(1) = ax*ss + ay*cs;
-         accel(2) = az;
+         accel[0] = a[0]*cs - a[1]*ss;
+         accel[1] = a[0]*ss + a[1]*cs;
+         accel[2] = a[2];
 
-         dxt1 = derivative( initialState, accel );
+         derivative( state, accel, dxt1 );
          for( int j = 0; j < 6; ++j )
-            tempRes(j) = initialState(j) + rkStep*dxt1(j)/2.0;
+            tempRes[j] = state[j] + rkStep*dxt1[j]/2.0;
 
-         dxt2 = derivative( tempRes, accel );
+         derivative( tempRes, accel, dxt2 );
          for( int j = 0; j < 6; ++j )
-            tempRes(j) = initialState(j) + rkStep*dxt2(j)/2.0;
+            tempRes[j] = state[j] + rkStep*dxt2[j]/2.0;
 
-         dxt3 = derivative( tempRes, accel );
+         derivative( tempRes, accel, dxt3 );
          for( int j = 0; j < 6; ++j )
-            tempRes(j) = initialState(j) + rkStep*dxt3(j);
+            tempRes[j] = state[j] + rkStep*dxt3[j];
 
-         dxt4 = derivative( tempRes, accel );
+         derivative( tempRes, accel, dxt4 );
          for( int j = 0; j < 6; ++j )
-            initialState(j) = initialState(j) + rkStep * ( dxt1(j)
-                            + 2.0 * ( dxt2(j) + dxt3(j) ) + dxt4(j) ) / 6.0;
+            state[j] = state[j] + rkStep * ( dxt1[j]
+                     + 2.0 * ( dxt2[j] + dxt3[j] ) + dxt4[j] ) / 6.0;
+
+         work += rkStep;
+
+      }  // End of 'while ( std::fabs( dt - work ) >= tol )'
+
+   }  // End of method 'GloEphemeris::integrateRK4()'
+
+
+   void GloEphemeris::integrateDP54( double state[6],
+                                     double s0,
+                                     double& sod,
+                                     double dt ) const
+   {
+
+         // Dormand-Prince 5(4) coefficients; the last row of A gives
+         // the 5th order solution, E the difference from the 4th.
+      static const double C[7] = { 0.0, 1.0/5.0, 3.0/10.0, 4.0/5.0,
+                                   8.0/9.0, 1.0, 1.0 };
+      static const double A[7][6] = {
+         { 0.0 },
+         { 1.0/5.0 },
+         { 3.0/40.0, 9.0/40.0 },
+         { 44.0/45.0, -56.0/15.0, 32.0/9.0 },
+         { 19372.0/6561.0, -25360.0/2187.0, 64448.0/6561.0,
+           -212.0/729.0 },
+         { 9017.0/3168.0, -355.0/33.0, 46732.0/5247.0, 49.0/176.0,
+           -5103.0/18656.0 },
+         { 35.0/384.0, 0.0, 500.0/1113.0, 125.0/192.0, -2187.0/6784.0,
+           11.0/84.0 } };
+      static const double E[7] = { 71.0/57600.0, 0.0, -71.0/16695.0,
+                                   71.0/1920.0, -17253.0/339200.0,
+                                   22.0/525.0, -1.0/40.0 };
+         // Largest step (s); GLONASS orbits have a period of ~40000 s
+      const double maxStep( 300.0 );
+
+      PZ90Ellipsoid pz90;
+      double we( pz90.angVelocity() );
+
+      double k[7][6], y[6], accel[3];
+      double h( std::min(std::fabs(dt), 60.0) );
+      if ( dt < 0.0 ) h = -h;
+      double work( 0.0 );
+
+      while ( std::fabs( dt - work ) >= 1e-9 )
+      {
+         if ( (h > 0.0 && work + h > dt) || (h < 0.0 && work + h < dt) )
+            h = dt - work;
+
+         for( int st = 0; st < 7; st++ )
+         {
+            for( int j = 0; j < 6; j++ )
+            {
+               y[j] = state[j];
+               for( int m = 0; m < st; m++ )
+                  y[j] += h*A[st][m]*k[m][j];
+            }
+               // the luni-solar acceleration turns with the Earth
+            double s( s0 + we*(sod + C[st]*h) );
+            accel[0] = a[0]*std::cos(s) - a[1]*std::sin(s);
+            accel[1] = a[0]*std::sin(s) + a[1]*std::cos(s);
+            accel[2] = a[2];
+            derivative( y, accel, k[st] );
+         }
+
+         double err( 0.0 );
+         for( int j = 0; j < 6; j++ )
+         {
+            double ej( 0.0 );
+            for( int m = 0; m < 7; m++ )
+               ej += E[m]*k[m][j];
+            err = std::max( err, std::fabs(h*ej) );
+         }
 
+            // accept the step if the error is small enough, or the
+            // step can not usefully get smaller
+         if ( err <= tolerance || std::fabs(h) < 1e-3 )
+         {
+            std::copy( y, y+6, state );
+            work += h;
+            sod += h;
+         }
 
-            // If we are within tolerance of the target time, we are done.
-         workEpoch += rkStep;
-         if ( std::fabs(epoch - workEpoch ) < tolerance )
-            done = true;
+         double fac( err > 0.0 ? 0.9*std::pow(tolerance/err, 0.2) : 5.0 );
+         h *= std::min( 5.0, std::max(0.2, fac) );
+         if ( std::fabs(h) > maxStep )
+            h = ( h < 0.0 ? -maxStep : maxStep );
+      }
 
-      }  // End of 'while (!done)...'
+   }  // End of method 'GloEphemeris::integrateDP54()'
 
 
-      px = initialState(0);
-      py = initialState(2);
-      pz = initialState(4);
-      vx = initialState(1);
-      vy = initialState(3);
-      vz = initialState(5);
+   Xvt GloEphemeris::stateToXvt( const double state[6],
+                                 double s,
+                                 const CommonTime& epoch ) const
+   {
 
+      PZ90Ellipsoid pz90;
+      double we( pz90.angVelocity() );
+      double cs( std::cos(s) );
+      double ss( std::sin(s) );
+
+      double px( state[0] );
+      double py( state[2] );
+      double pz( state[4] );
+      double vx( state[1] );
+      double vy( state[3] );
+      double vz( state[5] );
+
+      Xvt sv;
       sv.x[0] = 1000.0*( px*cs + py*ss );         // X coordinate
       sv.x[1] = 1000.0*(-px*ss + py*cs);          // Y coordinate
       sv.x[2] = 1000.0*pz;                        // Z coordinate
@@ -222,11 +445,9 @@ namespace gpstk
       sv.clkdrift = clkdrift;
       sv.frame = ReferenceFrame::PZ90;
 
-         // We are done, let's return
       return sv;
 
-
-   }  // End of method 'GloEphemeris::svXvt(const CommonTime& t)'
+   }  // End of method 'GloEphemeris::stateToXvt()'
 
 
       // Get the epoch time for this ephemeris
@@ -438,24 +659,21 @@ namespace gpstk
 
 
       // Function implementing the derivative of GLONASS orbital model.
-   Vector<double> GloEphemeris::derivative( const Vector<double>& inState,
-                                            const Vector<double>& accel )
-      const
+   void GloEphemeris::derivative( const double inState[6],
+                                  const double accel[3],
+                                  double dxt[6] ) const
    {
 
          // We will need some important PZ90 ellipsoid values
-      PZ90Ellipsoid pz90;
-      const double j20( pz90.j20() );
-      const double mu( pz90.gm_km() );
-      const double ae( pz90.a_km() );
+      static const PZ90Ellipsoid pz90;
+      static const double j20( pz90.j20() );
+      static const double mu( pz90.gm_km() );
+      static const double ae( pz90.a_km() );
 
          // Let's start getting the current satellite position and velocity
-      double  x( inState(0) );          // X coordinate
-      //double vx( inState(1) );          // X velocity
-      double  y( inState(2) );          // Y coordinate
-      //double vy( inState(3) );          // Y velocity
-      double  z( inState(4) );          // Z coordinate
-      //double vz( inState(5) );          // Z velocity
+      double  x( inState[0] );          // X coordinate
+      double  y( inState[2] );          // Y coordinate
+      double  z( inState[4] );          // Z coordinate
 
       double r2( x*x + y*y + z*z );
       double r( std::sqrt(r2) );
@@ -470,25 +688,21 @@ namespace gpstk
       double cmz( k1*(3.0-5.0*zr2) );
       double k2(cm-xmu);
 
-      double gloAx( k2*xr + accel(0) );
-      double gloAy( k2*yr + accel(1) );
-      double gloAz( (cmz-xmu)*zr + accel(2) );
-
-      Vector<double> dxt(6, 0.0);
+      double gloAx( k2*xr + accel[0] );
+      double gloAy( k2*yr + accel[1] );
+      double gloAz( (cmz-xmu)*zr + accel[2] );
 
          // Let's insert data related to X coordinates
-      dxt(0) = inState(1);       // Set X'  = Vx
-      dxt(1) = gloAx;            // Set Vx' = gloAx
+      dxt[0] = inState[1];       // Set X'  = Vx
+      dxt[1] = gloAx;            // Set Vx' = gloAx
 
          // Let's insert data related to Y coordinates
-      dxt(2) = inState(3);       // Set Y'  = Vy
-      dxt(3) = gloAy;            // Set Vy' = gloAy
+      dxt[2] = inState[3];       // Set Y'  = Vy
+      dxt[3] = gloAy;            // Set Vy' = gloAy
 
          // Let's insert data related to Z coordinates
-      dxt(4) = inState(5);       // Set Z'  = Vz
-      dxt(5) = gloAz;            // Set Vz' = gloAz
-
-      return dxt;
+      dxt[4] = inState[5];       // Set Z'  = Vz
+      dxt[5] = gloAz;            // Set Vz' = gloAz
 
    }  // End of method 'GloEphemeris::derivative()'
 
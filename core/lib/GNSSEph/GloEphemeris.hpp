@@ -41,6 +41,7 @@
 #define GPSTK_GLOEPHEMERIS_HPP
 
 #include <iostream>
+#include <vector>
 #include "Triple.hpp"
 #include "Xvt.hpp"
 #include "CommonTime.hpp"
@@ -63,9 +64,36 @@ namespace gpstk
    {
    public:
 
+         /// Methods of integrating the equations of motion.
+      enum Integrator
+      {
+         RungeKutta4,     ///< Fixed step 4th order Runge-Kutta (default)
+         DormandPrince54  ///< Adaptive step 5(4) order Dormand-Prince
+      };
+
+         /** Integrated states of the satellite at evenly spaced nodes
+          * over the interval of validity of an ephemeris, from which
+          * svXvt(const CommonTime&,const Trajectory&) interpolates.
+          * @see computeTrajectory() */
+      struct Trajectory
+      {
+         Trajectory() : spacing(0), first(0), angle(0) {}
+            /// Seconds between nodes.
+         double spacing;
+            /// Time of the first node, in seconds from the ephemeris epoch.
+         double first;
+            /// Rotation angle (rad) of the PZ-90 frame at the epoch.
+         double angle;
+            /** Position (km), velocity (km/s) and acceleration
+             * (km/s^2) x, y, z at each node, 9 values per node, in
+             * the absolute frame used for integration. */
+         std::vector<double> nodes;
+      };
+
          /// Default constructor
       GloEphemeris()
-            : valid(false), step(1.0)
+            : valid(false), step(1.0), integrator(RungeKutta4),
+              tolerance(1e-10)
       {};
 
 
@@ -100,6 +128,30 @@ namespace gpstk
           */
       Xvt svXvtOverrideFit(const CommonTime& epoch) const;
 
+         /** Integrate the orbit over the interval of validity of this
+          * ephemeris, plus or minus 15 minutes, and save the state at
+          * evenly spaced nodes.  The nodes are integrated just as
+          * svXvt() would integrate to their times.
+          * @param[out] traj the integrated nodes.
+          * @param[in] spacing seconds between nodes; when a multiple of
+          *   the integration step, the nodes match svXvt() exactly.
+          * @throw InvalidRequest if no data has been stored or the
+          *   spacing is not positive. */
+      void computeTrajectory(Trajectory& traj, double spacing = 60.0) const
+         throw( gpstk::InvalidRequest );
+
+         /** Compute satellite position & velocity at the given time by
+          * quintic Hermite interpolation of a trajectory from
+          * computeTrajectory(), which is much faster than integrating
+          * from the ephemeris epoch.  With the default spacing the
+          * interpolation error is well under a millimeter.
+          * @param epoch   Epoch to compute position and velocity.
+          * @param traj    Trajectory computed from this ephemeris.
+          * @throw InvalidRequest if the epoch is out of the interval
+          *   of validity. */
+      Xvt svXvt(const CommonTime& epoch, const Trajectory& traj) const
+         throw( gpstk::InvalidRequest );
+
          /// Get the epoch time for this ephemeris
       CommonTime getEphemerisEpoch() const
          throw( gpstk::InvalidRequest );
@@ -155,6 +207,21 @@ namespace gpstk
       { step = rkStep; return (*this); };
 
 
+         /// Get the method used to integrate the orbit.
+      Integrator getIntegrator() const
+      { return integrator; };
+
+
+         /** Set the method used to integrate the orbit.
+          *
+          * @param method  How to integrate.
+          * @param tol     For DormandPrince54, the largest error
+          *   estimate allowed in a step, in km and km/s.
+          */
+      GloEphemeris& setIntegrator( Integrator method, double tol = 1e-10 )
+      { integrator = method; tolerance = tol; return (*this); };
+
+
          /// Get the acceleration vector.
       Triple getAcc() const
          throw()
@@ -244,14 +311,46 @@ namespace gpstk
          /// Integration step for Runge-Kutta algorithm (1 second by default)
       double step;
 
+         /// Method used to integrate the orbit.
+      Integrator integrator;
+
+         /// Error allowed per step of the DormandPrince54 integrator.
+      double tolerance;
+
 
          /// Compute true sidereal time (in hours) at Greenwich at 0 hours UT.
       double getSidTime( const CommonTime& time ) const;
 
 
-         /// Function implementing the derivative of GLONASS orbital model.
-      Vector<double> derivative( const Vector<double>& inState,
-                                 const Vector<double>& accel ) const;
+         /** Function implementing the derivative of GLONASS orbital
+          * model, for the state (x, vx, y, vy, z, vz). */
+      void derivative( const double inState[6],
+                       const double accel[3],
+                       double dxt[6] ) const;
+
+         /** Get the state at the ephemeris epoch in the absolute
+          * frame, and the Greenwich sidereal angle (rad) at 0h UT of
+          * the epoch day, and the seconds of that day at the epoch. */
+      void initialState( double state[6], double& s0, double& sod ) const;
+
+         /** Integrate a state by dt seconds with the chosen
+          * integrator.  sod is the seconds of day of the state,
+          * updated on return. */
+      void integrate( double state[6], double s0, double& sod,
+                      double dt ) const;
+
+         /// Integrate with fixed step 4th order Runge-Kutta.
+      void integrateRK4( double state[6], double s0, double& sod,
+                         double dt ) const;
+
+         /// Integrate with adaptive step 5(4) order Dormand-Prince.
+      void integrateDP54( double state[6], double s0, double& sod,
+                          double dt ) const;
+
+         /** Rotate a state at sidereal angle s back to the PZ-90
+          * frame and fill in the Xvt for time epoch. */
+      Xvt stateToXvt( const double state[6], double s,
+                      const CommonTime& epoch ) const;
 
 
 
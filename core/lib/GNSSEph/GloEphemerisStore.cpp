@@ -56,12 +56,15 @@ namespace gpstk
       {
             // Get a GloEphemeris object from Rinex3NavData object
          GloEphemeris gloEphem(data);
+         gloEphem.setIntegrator(integrator, integTol);
 
          CommonTime t( data.time);
          t.setTimeSystem(TimeSystem::GLO);   // must be GLONASS time
 
          SatID sat( data.sat );
-         pe[sat][t] = gloEphem; // find or add entry
+         GloEphemeris& stored = pe[sat][t]; // find or add entry
+         stored = gloEphem;
+         trajectories.erase(&stored);
 
          if (t < initialTime)
             initialTime = t;
@@ -125,7 +128,8 @@ namespace gpstk
       const TimeGloMap& sem = svmap->second;
 
          // Look for 'i': the first element whose key >= epoch.
-      TimeGloMap::const_iterator i = sem.lower_bound(epoch);;
+      const TimeKey key(epoch);
+      TimeGloMap::const_iterator i = sem.lower_bound(key);
 
          // Values to be returned will be stored here
       Xvt sv;
@@ -139,26 +143,24 @@ namespace gpstk
       }
 
          // If key > (epoch+900), we must use the previous record if possible.
-      if ( ( i->first > (epoch+900.0) ) && ( i != sem.begin() ) )
+      if ( ( i->first > (key+900.0) ) && ( i != sem.begin() ) )
       {
          i = --i;
       }
 
          // Check that the given epoch is within the available time limits for
          // this specific satellite, with a margin of 15 minutes (900 seconds).
-      if ( epoch <  (i->first - 900.0) ||
-           epoch >= (i->first   + 900.0)   )
+      if ( key <  (i->first - 900.0) ||
+           key >= (i->first   + 900.0)   )
       {
          InvalidRequest e( "Requested time is out of boundaries for satellite "
                           + StringUtils::asString(sat) );
          GPSTK_THROW(e);
       }
 
-         // We now have the proper reference data record. Let's use it
-      GloEphemeris data( i->second );
-
          // Compute the satellite position, velocity and clock offset
-      sv = data.svXvt( epoch );
+         // with the proper reference data record
+      sv = ephXvt( i->second, epoch );
 
          // We are done, let's return
       return sv;
@@ -166,6 +168,133 @@ namespace gpstk
    }; // End of method 'GloEphemerisStore::getXvt()'
 
 
+   unsigned GloEphemerisStore::getXvts( const vector<XvtQuery>& queries,
+                                        vector<Xvt>& xvts,
+                                        vector<XvtStatus>& status ) const
+      throw()
+   {
+      unsigned nvalid(0);
+      xvts.resize(queries.size());
+      status.resize(queries.size());
+
+         // Time limits of the store, with the margin of 15 minutes
+      const CommonTime tbeg(initialTime - 900.0), tend(finalTime + 900.0);
+
+      GloEphMap::const_iterator svmap(pe.end());
+      TimeGloMap::const_iterator iprev;
+      bool havePrev(false);
+
+      for(size_t k=0; k<queries.size(); k++)
+      {
+         const SatID& sat(queries[k].first);
+         const CommonTime& epoch(queries[k].second);
+
+         if(k == 0 || !(sat == queries[k-1].first))
+         {
+            svmap = pe.find(sat);
+            havePrev = false;
+         }
+
+         status[k] = Failed;
+         try
+         {
+            if(epoch.getTimeSystem() != initialTime.getTimeSystem())
+               status[k] = Failed;
+            else if(epoch < tbeg || epoch > tend || svmap == pe.end())
+               status[k] = NotFound;
+            else
+            {
+                  // Select the record just as getXvt() does
+               const TimeGloMap& sem = svmap->second;
+               const TimeKey key(epoch);
+               TimeGloMap::const_iterator i = sem.lower_bound(key);
+               if ( i == sem.end() )
+                  --i;
+               if ( ( i->first > (key+900.0) ) && ( i != sem.begin() ) )
+                  --i;
+
+               if ( key <  (i->first - 900.0) ||
+                    key >= (i->first + 900.0)   )
+                  status[k] = NotFound;
+               else
+               {
+                  if(havePrev && i == iprev && epoch == queries[k-1].second)
+                     xvts[k] = xvts[k-1];
+                  else
+                     xvts[k] = ephXvt( i->second, epoch );
+                  status[k] = Valid;
+                  nvalid++;
+                  iprev = i;
+               }
+            }
+         }
+         catch(...)
+         {
+            status[k] = Failed;
+         }
+
+         havePrev = (status[k] == Valid);
+         if(status[k] != Valid)
+         {
+            xvts[k] = Xvt();
+            xvts[k].health = Xvt::HealthStatus::Unavailable;
+         }
+      }
+
+      return nvalid;
+
+   }; // End of method 'GloEphemerisStore::getXvts()'
+
+
+   GloEphemerisStore& GloEphemerisStore::setIntegrator(
+      GloEphemeris::Integrator method,
+      double tol )
+   {
+      integrator = method;
+      integTol = tol;
+      for( GloEphMap::iterator it = pe.begin(); it != pe.end(); ++it )
+      {
+         for( TimeGloMap::iterator tgmIter = it->second.begin();
+              tgmIter != it->second.end();
+              ++tgmIter )
+         {
+            tgmIter->second.setIntegrator(method, tol);
+         }
+      }
+      trajectories.clear();
+      return *this;
+
+   }; // End of method 'GloEphemerisStore::setIntegrator()'
+
+
+   GloEphemerisStore& GloEphemerisStore::setTrajectoryCache( bool use,
+                                                             double spacing )
+   {
+      if( spacing != trajSpacing )
+         trajectories.clear();
+      useTrajectories = use;
+      trajSpacing = spacing;
+      return *this;
+
+   }; // End of method 'GloEphemerisStore::setTrajectoryCache()'
+
+
+   Xvt GloEphemerisStore::ephXvt( const GloEphemeris& eph,
+                                  const CommonTime& epoch ) const
+   {
+      if( !useTrajectories )
+         return eph.svXvt( epoch );
+
+      AddressCache<GloEphemeris, GloEphemeris::Trajectory>::ValuePtr traj(
+         trajectories.get( &eph,
+                           [&](GloEphemeris::Trajectory& newTraj)
+                           { eph.computeTrajectory( newTraj, trajSpacing ); } ));
+
+      return eph.svXvt( epoch, *traj );
+
+   }; // End of method 'GloEphemerisStore::ephXvt()'
+
+
    Xvt GloEphemerisStore::computeXvt(const SatID& sat,
                                      const CommonTime& epoch) const throw()
    {
@@ -202,7 +331,8 @@ namespace gpstk
          const TimeGloMap& sem = svmap->second;
 
             // Look for 'i': the first element whose key >= epoch.
-         TimeGloMap::const_iterator i = sem.lower_bound(epoch);;
+         const TimeKey key(epoch);
+         TimeGloMap::const_iterator i = sem.lower_bound(key);
 
             // If we reached the end, the requested time is beyond the last
             // ephemeris record, but it may still be within the allowable time
@@ -214,7 +344,7 @@ namespace gpstk
 
             // If key > (epoch+900), we must use the previous record
             // if possible.
-         if ((i->first > (epoch+900.0)) && (i != sem.begin()))
+         if ((i->first > (key+900.0)) && (i != sem.begin()))
          {
             i = --i;
          }
@@ -222,17 +352,17 @@ namespace gpstk
             // Check that the given epoch is within the available time
             // limits for this specific satellite, with a margin of 15
             // minutes (900 seconds).
-         if ((epoch <  (i->first - 900.0)) ||
-             (epoch >= (i->first + 900.0)))
+         if ((key <  (i->first - 900.0)) ||
+             (key >= (i->first + 900.0)))
          {
             return rv;
          }
 
             // We now have the proper reference data record. Let's use it
-         GloEphemeris data(i->second);
+         const GloEphemeris& data(i->second);
 
             // Compute the satellite position, velocity and clock offset
-         rv = data.svXvt(epoch);
+         rv = ephXvt(data, epoch);
          rv.health = (data.getHealth() == 0 ? Xvt::HealthStatus::Healthy
                       : Xvt::HealthStatus::Unhealthy);
       }
@@ -281,7 +411,8 @@ namespace gpstk
          const TimeGloMap& sem = svmap->second;
 
             // Look for 'i': the first element whose key >= epoch.
-         TimeGloMap::const_iterator i = sem.lower_bound(epoch);;
+         const TimeKey key(epoch);
+         TimeGloMap::const_iterator i = sem.lower_bound(key);
 
             // If we reached the end, the requested time is beyond the last
             // ephemeris record, but it may still be within the allowable time
@@ -293,7 +424,7 @@ namespace gpstk
 
             // If key > (epoch+900), we must use the previous record
             // if possible.
-         if ((i->first > (epoch+900.0)) && (i != sem.begin()))
+         if ((i->first > (key+900.0)) && (i != sem.begin()))
          {
             i = --i;
          }
@@ -301,8 +432,8 @@ namespace gpstk
             // Check that the given epoch is within the available time
             // limits for this specific satellite, with a margin of 15
             // minutes (900 seconds).
-         if ((epoch <  (i->first - 900.0)) ||
-             (epoch >= (i->first + 900.0)))
+         if ((key <  (i->first - 900.0)) ||
+             (key >= (i->first + 900.0)))
          {
             return rv;
          }
@@ -460,6 +591,7 @@ namespace gpstk
 
          // Update the data map before returning
       pe = bak;
+      trajectories.clear();
 
       return;
       
@@ -577,7 +709,8 @@ namespace gpstk
       const TimeGloMap& sem = svmap->second;
 
          // 'i' will be the first element whose key >= epoch.
-      TimeGloMap::const_iterator i = sem.lower_bound(epoch);
+      const TimeKey key(epoch);
+      TimeGloMap::const_iterator i = sem.lower_bound(key);
 
          // If we reached the end, the requested time is beyond the last
          // ephemeris record, but it may still be within the allowable time
@@ -588,15 +721,15 @@ namespace gpstk
       }
 
          // If key > (epoch+900), we must use the previous record if possible.
-      if ( ( i->first > (epoch+900.0) ) && ( i != sem.begin() ) )
+      if ( ( i->first > (key+900.0) ) && ( i != sem.begin() ) )
       {
          i = --i;
       }
 
          // Check that the given epoch is within the available time limits for
          // this specific satellite, with a margin of 15 minutes (900 seconds).
-      if ( epoch < (i->first - 900.0) ||
-           epoch > (i->first   + 900.0)   )
+      if ( key < (i->first - 900.0) ||
+           key > (i->first   + 900.0)   )
       {
          InvalidRequest e( "Requested time is out of boundaries for satellite "
                           + StringUtils::asString(sat) );
@@ -41,6 +41,7 @@
 #define GPSTK_GLOEPHEMERISSTORE_HPP
 
 #include <iostream>
+#include <map>
 #include <set>
 
 #include "XvtStore.hpp"
@@ -49,7 +50,9 @@
 #include "PZ90Ellipsoid.hpp"
 #include "Vector.hpp"
 #include "YDSTime.hpp"
+#include "TimeKey.hpp"
 #include "TimeSystemCorr.hpp"
+#include "AddressCache.hpp"
 
 namespace gpstk
 {
@@ -58,7 +61,8 @@ namespace gpstk
 
       // First, let's declare some useful type definitions
 
-   typedef std::map<CommonTime, GloEphemeris> TimeGloMap;
+      /// Ephemerides of one satellite, keyed by epoch (see TimeKey).
+   typedef std::map<TimeKey, GloEphemeris> TimeGloMap;
 
    typedef std::map<SatID, TimeGloMap> GloEphMap;
 
@@ -73,7 +77,11 @@ namespace gpstk
       GloEphemerisStore()
             : initialTime(CommonTime::END_OF_TIME),
               finalTime(CommonTime::BEGINNING_OF_TIME),
-              step(1.0)
+              step(1.0),
+              useTrajectories(false),
+              trajSpacing(60.0),
+              integrator(GloEphemeris::RungeKutta4),
+              integTol(1e-10)
       {
             setCheckHealthFlag(false);
       }
@@ -87,7 +95,11 @@ namespace gpstk
                          bool checkHealth )
             : initialTime(CommonTime::END_OF_TIME),
               finalTime(CommonTime::BEGINNING_OF_TIME),
-              step(rkStep)
+              step(rkStep),
+              useTrajectories(false),
+              trajSpacing(60.0),
+              integrator(GloEphemeris::RungeKutta4),
+              integTol(1e-10)
       {
             setCheckHealthFlag(false);
       }
@@ -115,6 +127,25 @@ namespace gpstk
       Xvt getXvt( const SatID& sat,
                   const CommonTime& epoch ) const;
 
+         /** Batch version of getXvt(); see XvtStore::getXvts().  The
+          *  store limits are computed once per batch, the satellite's
+          *  table is looked up once for each run of adjacent queries
+          *  of the same satellite, the ephemeris is integrated in
+          *  place rather than copied, and repeated queries of the
+          *  same satellite and time share one integration.  No
+          *  exceptions are thrown.
+          *
+          *  @param[in] queries list of (SatID, time) pairs
+          *  @param[out] xvts results, resized to queries.size()
+          *  @param[out] status outcome of each query
+          *
+          *  @return the number of queries with status Valid
+          */
+      virtual unsigned getXvts( const std::vector<XvtQuery>& queries,
+                                std::vector<Xvt>& xvts,
+                                std::vector<XvtStatus>& status ) const
+         throw();
+
          /** Compute the position, velocity and clock offset of the
           * indicated object in ECEF coordinates (meters) at the
           * indicated time.
@@ -151,6 +182,36 @@ namespace gpstk
       GloEphemerisStore& setIntegrationStep( double rkStep )
       { step = rkStep; return (*this); };
 
+         /// Get the method used to integrate the orbits.
+      GloEphemeris::Integrator getIntegrator() const
+      { return integrator; };
+
+         /** Set the method used to integrate the orbits of the
+          * ephemerides in the store and of those added later.
+          *
+          * @param method  How to integrate.
+          * @param tol     Error allowed per step by DormandPrince54.
+          */
+      GloEphemerisStore& setIntegrator( GloEphemeris::Integrator method,
+                                        double tol = 1e-10 );
+
+         /// Get whether integrated trajectories are cached.
+      bool getTrajectoryCache() const
+      { return useTrajectories; };
+
+         /** Set whether integrated trajectories are cached.  When
+          * enabled, the orbit of each ephemeris is integrated over
+          * its whole interval of validity the first time it is used
+          * (see GloEphemeris::computeTrajectory()), and later queries
+          * interpolate in it, instead of every query integrating from
+          * the ephemeris epoch.
+          *
+          * @param use       Enable or disable the cache.
+          * @param spacing   Seconds between the integrated states.
+          */
+      GloEphemerisStore& setTrajectoryCache( bool use,
+                                             double spacing = 60.0 );
+
          /// Get whether satellite health bit will be used or not.
       bool getCheckHealthFlag() const
       { return onlyHealthy; };
@@ -187,6 +248,7 @@ namespace gpstk
       virtual void clear(void)
       {
          pe.clear();
+         trajectories.clear();
          initialTime = CommonTime::END_OF_TIME;
          finalTime = CommonTime::BEGINNING_OF_TIME;
          return;
@@ -295,6 +357,29 @@ namespace gpstk
          /// Integration step for Runge-Kutta algorithm (1 second by default)
       double step;
 
+         /// Whether to cache integrated trajectories
+      bool useTrajectories;
+
+         /// Seconds between the states of the cached trajectories
+      double trajSpacing;
+
+         /// Method used to integrate the orbits
+      GloEphemeris::Integrator integrator;
+
+         /// Error allowed per step by the adaptive integrator
+      double integTol;
+
+         /** Trajectories computed from the ephemerides in 'pe',
+          * filled by ephXvt().  Entries are removed when the
+          * ephemeris they belong to changes. */
+      mutable AddressCache<GloEphemeris, GloEphemeris::Trajectory>
+         trajectories;
+
+         /** Compute position, velocity and clock of a satellite from
+          * an ephemeris in 'pe', from its cached trajectory if
+          * enabled. */
+      Xvt ephXvt( const GloEphemeris& eph, const CommonTime& epoch ) const;
+
    };  // End of class 'GloEphemerisStore'
 
       //@}
@@ -0,0 +1,258 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file OrbitEphBatch.cpp
+/// Evaluate the broadcast Kepler orbit and clock model of many OrbitEph objects
+/// at many times at once.
+
+#include <cmath>
+#include "OrbitEphBatch.hpp"
+#include "GNSSconstants.hpp"
+#include "GPSEllipsoid.hpp"
+#include "GPSWeekSecond.hpp"
+#include "StringUtils.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   const int OrbitEphBatch::KeplerIterations;
+   const size_t OrbitEphBatch::BlockSize;
+
+   size_t OrbitEphBatch::addEphemeris(const OrbitEph& eph)
+      throw(InvalidRequest)
+   {
+      if(!eph.dataLoadedFlag)
+         GPSTK_THROW(InvalidRequest("Data not loaded"));
+
+      GPSEllipsoid ell;
+      double ahalf(::sqrt(eph.A));
+
+      toe.push_back(eph.ctToe);
+      tocOff.push_back(eph.ctToe - eph.ctToc);
+      af0.push_back(eph.af0);
+      af1.push_back(eph.af1);
+      af2.push_back(eph.af2);
+      M0.push_back(eph.M0);
+      dn.push_back(eph.dn);
+      dndot.push_back(eph.dndot);
+      ecc.push_back(eph.ecc);
+      A.push_back(eph.A);
+      Adot.push_back(eph.Adot);
+      Ahalf.push_back(ahalf);
+      amm0.push_back(::sqrt(ell.gm()) / (eph.A*ahalf));   // Eqn specifies A0
+      OMEGA0.push_back(eph.OMEGA0);
+      OMEGAdot.push_back(eph.OMEGAdot);
+      i0.push_back(eph.i0);
+      idot.push_back(eph.idot);
+      w.push_back(eph.w);
+      Cuc.push_back(eph.Cuc);
+      Cus.push_back(eph.Cus);
+      Crc.push_back(eph.Crc);
+      Crs.push_back(eph.Crs);
+      Cic.push_back(eph.Cic);
+      Cis.push_back(eph.Cis);
+      // SOW is time-system-independent
+      omegaToe.push_back(ell.angVelocity() * GPSWeekSecond(eph.ctToe).sow);
+
+      return toe.size()-1;
+   }
+
+   void OrbitEphBatch::clear() throw()
+   {
+      toe.clear(); tocOff.clear();
+      af0.clear(); af1.clear(); af2.clear();
+      M0.clear(); dn.clear(); dndot.clear(); ecc.clear();
+      A.clear(); Adot.clear(); Ahalf.clear(); amm0.clear();
+      OMEGA0.clear(); OMEGAdot.clear(); i0.clear(); idot.clear(); w.clear();
+      Cuc.clear(); Cus.clear(); Crc.clear(); Crs.clear(); Cic.clear(); Cis.clear();
+      omegaToe.clear();
+   }
+
+   void OrbitEphBatch::svXvt(const vector<size_t>& index,
+                             const vector<CommonTime>& times,
+                             vector<Xvt>& xvts) const
+      throw(InvalidRequest)
+   {
+      if(index.size() != times.size())
+         GPSTK_THROW(InvalidRequest("Input vectors differ in length"));
+
+      vector<double> tk(index.size());
+      for(size_t i=0; i<index.size(); i++) {
+         if(index[i] >= size())
+            GPSTK_THROW(InvalidRequest("Invalid ephemeris index "
+                                       + StringUtils::asString(index[i])));
+         tk[i] = times[i] - toe[index[i]];
+      }
+
+      xvts.resize(index.size());
+      if(index.size() > 0)
+         compute(index.size(), &index[0], &tk[0], &xvts[0]);
+   }
+
+   void OrbitEphBatch::svXvt(const CommonTime& t, vector<Xvt>& xvts) const
+      throw(InvalidRequest)
+   {
+      vector<size_t> index(size());
+      vector<double> tk(size());
+      for(size_t k=0; k<size(); k++) {
+         index[k] = k;
+         tk[k] = t - toe[k];
+      }
+
+      xvts.resize(size());
+      if(size() > 0)
+         compute(size(), &index[0], &tk[0], &xvts[0]);
+   }
+
+   void OrbitEphBatch::svXvt(size_t k, const CommonTime& t0, double dt,
+                             size_t n, vector<Xvt>& xvts) const
+      throw(InvalidRequest)
+   {
+      if(k >= size())
+         GPSTK_THROW(InvalidRequest("Invalid ephemeris index "
+                                    + StringUtils::asString(k)));
+
+      vector<size_t> index(n, k);
+      vector<double> tk(n);
+      const double tk0(t0 - toe[k]);
+      for(size_t i=0; i<n; i++)
+         tk[i] = tk0 + double(i)*dt;
+
+      xvts.resize(n);
+      if(n > 0)
+         compute(n, &index[0], &tk[0], &xvts[0]);
+   }
+
+   // The algorithm is that of OrbitEph::svXvt() (IS-GPS-200 Table 30-II),
+   // rearranged into stages, each a loop over a block of queries.
+   void OrbitEphBatch::compute(size_t n, const size_t *index, const double *tk,
+                               Xvt *xvts) const throw()
+   {
+      GPSEllipsoid ell;
+      const double sqrtgm(::sqrt(ell.gm()));
+      const double we(ell.angVelocity());
+      const double twoPI(2.0 * PI);
+
+      double e[BlockSize], t[BlockSize], meana[BlockSize], ea[BlockSize];
+      double amm[BlockSize], Ak[BlockSize];
+
+      for(size_t beg=0; beg<n; beg += BlockSize) {
+         const size_t m(n-beg < BlockSize ? n-beg : BlockSize);
+         const size_t *idx(index + beg);
+         Xvt *out(xvts + beg);
+         size_t j;
+
+         // mean anomaly
+         for(j=0; j<m; j++) {
+            const size_t k(idx[j]);
+            t[j] = tk[beg+j];
+            e[j] = ecc[k];
+            Ak[j] = A[k] + Adot[k] * t[j];
+            amm[j] = amm0[k] + (dn[k] + 0.5*dndot[k]*t[j]);
+            meana[j] = ::fmod(M0[k] + t[j] * amm[j], twoPI);
+            ea[j] = meana[j] + e[j] * ::sin(meana[j]);
+         }
+
+         // Kepler's equation, fixed number of Newton iterations
+         for(int it=0; it<KeplerIterations; it++) {
+            for(j=0; j<m; j++)
+               ea[j] += (meana[j] - (ea[j] - e[j] * ::sin(ea[j])))
+                      / (1.0 - e[j] * ::cos(ea[j]));
+         }
+
+         // position, velocity and clock
+         for(j=0; j<m; j++) {
+            const size_t k(idx[j]);
+            const double lecc(e[j]), elapte(t[j]);
+
+            // true anomaly
+            const double q(::sqrt(1.0 - lecc*lecc));
+            const double sinea(::sin(ea[j])), cosea(::cos(ea[j]));
+            const double G(1.0 - lecc * cosea);
+            const double truea(::atan2(q * sinea, cosea - lecc));
+
+            // argument of latitude and 2nd harmonic corrections
+            const double alat(truea + w[k]);
+            const double c2al(::cos(2.0*alat)), s2al(::sin(2.0*alat));
+            const double du(c2al * Cuc[k] + s2al * Cus[k]);
+            const double dr(c2al * Crc[k] + s2al * Crs[k]);
+            const double di(c2al * Cic[k] + s2al * Cis[k]);
+
+            const double U(alat + du);
+            const double R(Ak[j]*G + dr);
+            const double AINC(i0[k] + idot[k] * elapte + di);
+            const double ANLON(OMEGA0[k] + (OMEGAdot[k] - we) * elapte
+                               - omegaToe[k]);
+
+            const double cosu(::cos(U)), sinu(::sin(U));
+            const double xip(R * cosu), yip(R * sinu);
+            const double can(::cos(ANLON)), san(::sin(ANLON));
+            const double cinc(::cos(AINC)), sinc(::sin(AINC));
+
+            Xvt& sv(out[j]);
+            sv.x[0] = xip*can - yip*cinc*san;
+            sv.x[1] = xip*san + yip*cinc*can;
+            sv.x[2] = yip*sinc;
+
+            const double dek(amm[j] * Ak[j] / R);
+            const double dlk(Ahalf[k] * q * sqrtgm / (R*R));
+            const double div(idot[k] - 2.0 * dlk * (Cic[k]*s2al - Cis[k]*c2al));
+            const double domk(OMEGAdot[k] - we);
+            const double duv(dlk * (1.0 + 2.0 * (Cus[k]*c2al - Cuc[k]*s2al)));
+            const double drv(Ak[j] * lecc * dek * sinea
+                             - 2.0 * dlk * (Crc[k]*s2al - Crs[k]*c2al));
+            const double dxp(drv*cosu - R*sinu*duv);
+            const double dyp(drv*sinu + R*cosu*duv);
+
+            sv.v[0] = dxp*can - xip*san*domk - dyp*cinc*san
+                      + yip*(sinc*san*div - cinc*can*domk);
+            sv.v[1] = dxp*san + xip*can*domk + dyp*cinc*can
+                      - yip*(sinc*can*div + cinc*san*domk);
+            sv.v[2] = dyp*sinc + yip*cinc*div;
+
+            // clock; relativity uses this eccentric anomaly, which differs
+            // from that of OrbitEph::svRelativity() only by the dndot term
+            const double elaptc(elapte + tocOff[k]);
+            sv.clkbias = af0[k] + elaptc * (af1[k] + elaptc * af2[k]);
+            sv.clkdrift = af1[k] + elaptc * af2[k];
+            sv.relcorr = REL_CONST * lecc * ::sqrt(Ak[j]) * sinea;
+            sv.frame = ReferenceFrame::WGS84;
+         }
+      }
+   }
+
+} // end namespace
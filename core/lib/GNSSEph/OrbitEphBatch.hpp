@@ -0,0 +1,164 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/** @file OrbitEphBatch.hpp
+ * Evaluate the broadcast Kepler orbit and clock model of many OrbitEph
+ * objects at many times at once, using a structure-of-arrays layout
+ * and branch-free loops. */
+
+#ifndef GPSTK_ORBITEPHBATCH_HPP
+#define GPSTK_ORBITEPHBATCH_HPP
+
+#include <vector>
+#include "Exception.hpp"
+#include "CommonTime.hpp"
+#include "Xvt.hpp"
+#include "OrbitEph.hpp"
+
+namespace gpstk
+{
+      /// @ingroup GNSSEph
+      //@{
+
+      /** Batch evaluator of OrbitEph::svXvt().  The orbit and clock
+       * parameters of each ephemeris added to the batch are copied
+       * into contiguous arrays, one per parameter, and the
+       * evaluation is done in blocks of queries, one computation
+       * stage at a time, so that each stage is a simple loop over
+       * the block that the compiler can vectorize.  Kepler's
+       * equation is solved with a fixed number of Newton iterations
+       * (KeplerIterations) rather than to a tolerance, so that there
+       * are no data-dependent branches.
+       *
+       * Results agree with OrbitEph::svXvt() to well below a
+       * millimeter in position (see OrbitEphBatch_T).  As in
+       * OrbitEph::svXvt(), GPSEllipsoid constants are used for all
+       * systems, and the derived-class svXvt() of BDSEphemeris
+       * (GEO satellites) is not reproduced.
+       *
+       * Typical use, e.g. a visibility map on a grid of times:
+       * @code
+       * OrbitEphBatch batch;
+       * for(...) batch.addEphemeris(eph);
+       * batch.svXvt(k, t0, 30.0, 2880, xvts);   // one day of eph k
+       * @endcode */
+   class OrbitEphBatch
+   {
+   public:
+         /// Number of Newton iterations used to solve Kepler's equation
+      static const int KeplerIterations = 6;
+
+         /// Default constructor, an empty batch.
+      OrbitEphBatch() throw()
+      {}
+
+         /** Add an ephemeris to the batch.
+          * @param[in] eph ephemeris; its parameters are copied.
+          * @return the index of the ephemeris in the batch.
+          * @throw InvalidRequest if eph has no data loaded. */
+      size_t addEphemeris(const OrbitEph& eph)
+         throw(InvalidRequest);
+
+         /// Return the number of ephemerides in the batch.
+      size_t size() const throw()
+      { return toe.size(); }
+
+         /// Remove all ephemerides from the batch.
+      void clear() throw();
+
+         /** Compute position, velocity, clock bias, drift and
+          * relativity correction of ephemeris index[i] at time
+          * times[i], for each i.
+          * @param[in] index indexes (from addEphemeris()) of the ephemerides
+          * @param[in] times times of interest, same length as index
+          * @param[out] xvts results, resized to index.size()
+          * @throw InvalidRequest if the input lengths differ or an
+          *   index is out of range. */
+      void svXvt(const std::vector<size_t>& index,
+                 const std::vector<CommonTime>& times,
+                 std::vector<Xvt>& xvts) const
+         throw(InvalidRequest);
+
+         /** Compute Xvt for every ephemeris in the batch at one time.
+          * @param[in] t time of interest
+          * @param[out] xvts results, resized to size(), in the order
+          *   the ephemerides were added. */
+      void svXvt(const CommonTime& t, std::vector<Xvt>& xvts) const
+         throw(InvalidRequest);
+
+         /** Compute Xvt for one ephemeris at n evenly spaced times
+          * t0, t0+dt, ..., t0+(n-1)*dt.
+          * @param[in] k index of the ephemeris
+          * @param[in] t0 first time of interest
+          * @param[in] dt time step in seconds
+          * @param[in] n number of times
+          * @param[out] xvts results, resized to n
+          * @throw InvalidRequest if k is out of range. */
+      void svXvt(size_t k, const CommonTime& t0, double dt, size_t n,
+                 std::vector<Xvt>& xvts) const
+         throw(InvalidRequest);
+
+         /** Computational kernel used by the svXvt() methods:
+          * compute Xvt of ephemeris index[i] at tk[i] seconds past
+          * its Toe, for i=0..n-1.  Indexes are not checked.
+          * @param[in] n number of queries
+          * @param[in] index array of n ephemeris indexes
+          * @param[in] tk array of n times since Toe (seconds)
+          * @param[out] xvts array of n results */
+      void compute(size_t n, const size_t *index, const double *tk,
+                   Xvt *xvts) const throw();
+
+   private:
+         /// Number of queries processed by each pass of compute()
+      static const size_t BlockSize = 64;
+
+         // Ephemeris parameters, one element per ephemeris.  The
+         // names are those of OrbitEph.
+      std::vector<CommonTime> toe;   ///< ctToe
+      std::vector<double> tocOff;    ///< ctToe - ctToc (seconds)
+      std::vector<double> af0, af1, af2;
+      std::vector<double> M0, dn, dndot, ecc, A, Adot, Ahalf, amm0;
+      std::vector<double> OMEGA0, OMEGAdot, i0, idot, w;
+      std::vector<double> Cuc, Cus, Crc, Crs, Cic, Cis;
+      std::vector<double> omegaToe;  ///< (Earth rate) * (Toe seconds of week)
+
+   }; // end class OrbitEphBatch
+
+      //@}
+
+} // end namespace
+
+#endif // GPSTK_ORBITEPHBATCH_HPP
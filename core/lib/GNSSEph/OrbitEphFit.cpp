@@ -0,0 +1,206 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file OrbitEphFit.cpp
+/// Chebyshev polynomial fits to the orbit and clock of an OrbitEph.
+
+#include <cmath>
+#include <algorithm>
+#include "OrbitEphFit.hpp"
+#include "GNSSconstants.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   const int OrbitEphFit::MaxDegree;
+   const int OrbitEphFit::NumComp;
+
+   void OrbitEphFit::fit(const OrbitEph& eph, double tolerance,
+                         double segment, int degree)
+      throw(InvalidRequest, InvalidParameter)
+   {
+      if(!eph.dataLoadedFlag)
+         GPSTK_THROW(InvalidRequest("Data not loaded"));
+      if(!(segment > 0.0))
+         GPSTK_THROW(InvalidParameter("Segment length must be positive"));
+      if(degree < 2 || degree > MaxDegree)
+         GPSTK_THROW(InvalidParameter("Degree out of range"));
+
+      coef.clear();
+      usable.clear();
+      maxErr = 0.0;
+      span = 0.0;
+      begin = eph.beginValid;
+      double length(eph.endValid - eph.beginValid);
+      if(!(length > 0.0) || length > 604800.0)
+         return;
+
+      size_t nseg(static_cast<size_t>(::ceil(length/segment)));
+      span = length;
+      segLen = length / nseg;
+      ncoef = degree + 1;
+      coef.resize(nseg * NumComp * ncoef);
+      usable.resize(nseg);
+
+         // cos(pi*j*(k+1/2)/n), the Chebyshev polynomials at the nodes
+      vector<double> cosines(ncoef * ncoef);
+      for(int j=0; j<ncoef; j++)
+         for(int k=0; k<ncoef; k++)
+            cosines[j*ncoef+k] = ::cos(PI * j * (k+0.5) / ncoef);
+
+      vector<double> values(NumComp * ncoef);
+      for(size_t seg=0; seg<nseg; seg++)
+      {
+         const CommonTime t0(begin + seg*segLen);
+
+            // the exact values at the nodes
+         for(int k=0; k<ncoef; k++)
+         {
+            double s(cosines[ncoef+k]);
+            Xvt xvt(eph.svXvt(t0 + 0.5*(s+1.0)*segLen));
+            frame = xvt.frame;
+            values[k] = xvt.x[0];
+            values[ncoef+k] = xvt.x[1];
+            values[2*ncoef+k] = xvt.x[2];
+            values[3*ncoef+k] = xvt.v[0];
+            values[4*ncoef+k] = xvt.v[1];
+            values[5*ncoef+k] = xvt.v[2];
+            values[6*ncoef+k] = xvt.clkbias;
+            values[7*ncoef+k] = xvt.clkdrift;
+            values[8*ncoef+k] = xvt.relcorr;
+         }
+
+         double *c(&coef[seg * NumComp * ncoef]);
+         for(int m=0; m<NumComp; m++)
+         {
+            for(int j=0; j<ncoef; j++)
+            {
+               double sum(0.0);
+               for(int k=0; k<ncoef; k++)
+                  sum += values[m*ncoef+k] * cosines[j*ncoef+k];
+               c[m*ncoef+j] = (j == 0 ? 1.0 : 2.0) * sum / ncoef;
+            }
+         }
+
+            // test at evenly spaced points, including the segment
+            // ends, where the interpolation error is largest
+         double segErr(0.0);
+         const int ntest(2 * ncoef);
+         double val[NumComp];
+         for(int i=0; i<=ntest; i++)
+         {
+            double s(-1.0 + 2.0 * i / ntest);
+            Xvt xvt(eph.svXvt(t0 + 0.5*(s+1.0)*segLen));
+            evaluate(seg, s, val);
+            double dx(val[0]-xvt.x[0]), dy(val[1]-xvt.x[1]),
+               dz(val[2]-xvt.x[2]);
+            double posErr(::sqrt(dx*dx + dy*dy + dz*dz));
+            double clkErr(C_MPS * ::fabs(val[6] + val[8]
+                                         - xvt.clkbias - xvt.relcorr));
+            segErr = std::max(segErr, std::max(posErr, clkErr));
+         }
+         maxErr = std::max(maxErr, segErr);
+         usable[seg] = (segErr <= tolerance);
+      }
+   }
+
+
+   bool OrbitEphFit::svXvt(const CommonTime& t, Xvt& xvt) const throw()
+   {
+      if(usable.empty())
+         return false;
+
+      double dt;
+      try
+      {
+         dt = t - begin;
+      }
+      catch(...)
+      {
+         return false;
+      }
+      if(!(dt >= 0.0 && dt <= span))
+         return false;
+
+      size_t seg(std::min(static_cast<size_t>(dt / segLen), usable.size()-1));
+      if(!usable[seg])
+         return false;
+
+      double val[NumComp];
+      evaluate(seg, 2.0 * (dt - seg*segLen) / segLen - 1.0, val);
+
+      xvt.x[0] = val[0];
+      xvt.x[1] = val[1];
+      xvt.x[2] = val[2];
+      xvt.v[0] = val[3];
+      xvt.v[1] = val[4];
+      xvt.v[2] = val[5];
+      xvt.clkbias = val[6];
+      xvt.clkdrift = val[7];
+      xvt.relcorr = val[8];
+      xvt.frame = frame;
+      return true;
+   }
+
+
+   size_t OrbitEphFit::numUsable() const throw()
+   {
+      return count(usable.begin(), usable.end(), 1);
+   }
+
+
+   void OrbitEphFit::evaluate(size_t seg, double s, double val[])
+      const throw()
+   {
+         // T[j](s) by the recurrence T[j+1] = 2s T[j] - T[j-1]
+      double T[MaxDegree+1];
+      T[0] = 1.0;
+      T[1] = s;
+      for(int j=2; j<ncoef; j++)
+         T[j] = 2.0*s*T[j-1] - T[j-2];
+
+      const double *c(&coef[seg * NumComp * ncoef]);
+      for(int m=0; m<NumComp; m++, c+=ncoef)
+      {
+         double v(0.0);
+         for(int j=0; j<ncoef; j++)
+            v += c[j] * T[j];
+         val[m] = v;
+      }
+   }
+
+} // end namespace
@@ -0,0 +1,157 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/** @file OrbitEphFit.hpp
+ * Chebyshev polynomial fits to the orbit and clock of an OrbitEph
+ * over its interval of validity. */
+
+#ifndef GPSTK_ORBITEPHFIT_HPP
+#define GPSTK_ORBITEPHFIT_HPP
+
+#include <vector>
+#include "Exception.hpp"
+#include "CommonTime.hpp"
+#include "ReferenceFrame.hpp"
+#include "Xvt.hpp"
+#include "OrbitEph.hpp"
+
+namespace gpstk
+{
+      /// @ingroup GNSSEph
+      //@{
+
+      /** Chebyshev polynomial approximation of OrbitEph::svXvt().
+       * The interval of validity of the ephemeris (beginValid to
+       * endValid) is divided into segments of equal length, and in
+       * each segment the ECEF position and velocity, the clock bias
+       * and drift and the relativity correction are interpolated at
+       * the Chebyshev nodes of the segment.  Velocity is fitted
+       * rather than differentiated from position because the
+       * velocity of OrbitEph::svXvt() is itself an approximation
+       * (differing from the derivative of its position by up to a
+       * few decimeters per second), and the fit must agree with the
+       * exact evaluation it falls back to.
+       *
+       * Each segment is then compared with OrbitEph::svXvt() at
+       * points between the nodes, and is used only if both the
+       * position error and the clock error (clkbias+relcorr, times
+       * the speed of light) are within the tolerance given to fit().
+       * svXvt() returns false for times in other segments or
+       * outside the interval, and the caller is expected to fall
+       * back to OrbitEph::svXvt(); see OrbitEphStore::setOrbitFit().
+       *
+       * Evaluation costs the same at any time: a few multiplies per
+       * coefficient and no transcendental functions.  With the
+       * defaults (one hour segments, degree 10), GPS positions agree
+       * with OrbitEph::svXvt() to well below a millimeter (see
+       * OrbitEphFit_T). */
+   class OrbitEphFit
+   {
+   public:
+         /// Largest polynomial degree accepted by fit()
+      static const int MaxDegree = 20;
+
+         /// Default constructor, no fit; svXvt() always returns false.
+      OrbitEphFit() throw()
+            : span(0.0), segLen(0.0), ncoef(0), maxErr(0.0)
+      {}
+
+         /** Fit the orbit and clock of an ephemeris over its interval
+          * of validity.  Nothing is fitted if the interval is empty
+          * or longer than a week.
+          * @param[in] eph ephemeris to fit
+          * @param[in] tolerance largest position or clock error, in
+          *   meters, for a segment to be used
+          * @param[in] segment longest segment length in seconds
+          * @param[in] degree degree of the polynomials
+          * @throw InvalidRequest if eph has no data loaded.
+          * @throw InvalidParameter if segment is not positive or
+          *   degree is not in 2..MaxDegree. */
+      void fit(const OrbitEph& eph, double tolerance = 0.001,
+               double segment = 3600.0, int degree = 10)
+         throw(InvalidRequest, InvalidParameter);
+
+         /** Compute position, velocity, clock bias, drift and
+          * relativity correction from the fit.  The health of xvt is
+          * not set.
+          * @param[in] t time of interest
+          * @param[out] xvt the result, changed only if true is returned
+          * @return false if t is not in a segment within tolerance */
+      bool svXvt(const CommonTime& t, Xvt& xvt) const throw();
+
+         /// Return the number of segments fitted.
+      size_t numSegments() const throw()
+      { return usable.size(); }
+
+         /// Return the number of segments within tolerance.
+      size_t numUsable() const throw();
+
+         /** Return the largest error, in meters, found by fit() when
+          * testing the segments, including those not within
+          * tolerance. */
+      double maxError() const throw()
+      { return maxErr; }
+
+   private:
+         /** Number of quantities fitted: x, y, z, vx, vy, vz,
+          * clkbias, clkdrift, relcorr */
+      static const int NumComp = 9;
+
+      CommonTime begin;            ///< start of the first segment
+      double span;                 ///< seconds from begin to the end
+      double segLen;               ///< seconds per segment
+      int ncoef;                   ///< coefficients per polynomial
+      double maxErr;               ///< see maxError()
+      ReferenceFrame frame;        ///< frame of the fitted positions
+
+         /** Coefficients, NumComp*ncoef per segment, ncoef per
+          * component. */
+      std::vector<double> coef;
+
+         /// Whether each segment is within tolerance
+      std::vector<char> usable;
+
+         /** Evaluate the Chebyshev polynomials of segment seg at
+          * normalized time s in [-1,1]. */
+      void evaluate(size_t seg, double s, double val[]) const throw();
+
+   }; // end class OrbitEphFit
+
+      //@}
+
+} // end namespace
+
+#endif // GPSTK_ORBITEPHFIT_HPP
@@ -78,7 +78,7 @@ namespace gpstk
             GPSTK_THROW(InvalidRequest("Not healthy"));
 
             // compute the position, velocity and time
-         Xvt sv = eph->svXvt(t);
+         Xvt sv = ephXvt(*eph, t);
          sv.health = (eph->isHealthy() ? Xvt::HealthStatus::Healthy
                       : Xvt::HealthStatus::Unhealthy);
          return sv;
@@ -90,6 +90,65 @@ namespace gpstk
    }
 
 
+   unsigned OrbitEphStore::getXvts(const vector<XvtQuery>& queries,
+                                   vector<Xvt>& xvts,
+                                   vector<XvtStatus>& status) const
+      throw()
+   {
+      unsigned nvalid(0);
+      xvts.resize(queries.size());
+      status.resize(queries.size());
+
+         // the table of the previous query's satellite, reused while
+         // the satellite does not change
+      SatTableMap::const_iterator sit(satTables.end());
+      const OrbitEph *eph(NULL);
+      for(size_t i=0; i<queries.size(); i++)
+      {
+         const SatID& sat(queries[i].first);
+         const CommonTime& t(queries[i].second);
+         if(i == 0 || !(sat == queries[i-1].first))
+            sit = satTables.find(sat);
+
+         status[i] = NotFound;
+         try
+         {
+            if(sit != satTables.end())
+            {
+                  // the previous ephemeris serves if it would be found again
+               if(!(eph && i > 0 && sat == queries[i-1].first &&
+                    t == queries[i-1].second))
+                  eph = (strictMethod ? findUserOrbitEph(sit->second, t)
+                                      : findNearOrbitEph(sit->second, t));
+               if(!eph)
+                  status[i] = NotFound;
+               else if(onlyHealthy && !eph->isHealthy())
+                  status[i] = Unhealthy;
+               else
+               {
+                  xvts[i] = ephXvt(*eph, t);
+                  xvts[i].health = (eph->isHealthy() ? Xvt::HealthStatus::Healthy
+                                    : Xvt::HealthStatus::Unhealthy);
+                  status[i] = Valid;
+                  nvalid++;
+               }
+            }
+         }
+         catch(...)
+         {
+            status[i] = Failed;
+         }
+
+         if(status[i] != Valid)
+         {
+            xvts[i] = Xvt();
+            xvts[i].health = Xvt::HealthStatus::Unavailable;
+         }
+      }
+      return nvalid;
+   }
+
+
    Xvt OrbitEphStore::computeXvt(const SatID& sat, const CommonTime& t) const
       throw()
    {
@@ -102,7 +161,7 @@ namespace gpstk
          if (eph != nullptr)
          {
                // compute the position, velocity and time
-            rv = eph->svXvt(t);
+            rv = ephXvt(*eph, t);
             rv.health = (eph->isHealthy() ? Xvt::HealthStatus::Healthy
                          : Xvt::HealthStatus::Unhealthy);
          }
@@ -114,6 +173,40 @@ namespace gpstk
    }
 
 
+   void OrbitEphStore::setOrbitFit(bool use, double tolerance,
+                                   double segment, int degree)
+   {
+      if(!(segment > 0.0))
+         GPSTK_THROW(InvalidParameter("Segment length must be positive"));
+      if(degree < 2 || degree > OrbitEphFit::MaxDegree)
+         GPSTK_THROW(InvalidParameter("Degree out of range"));
+
+      if(tolerance != fitTolerance || segment != fitSegment ||
+         degree != fitDegree)
+         fits.clear();
+      useFits = use;
+      fitTolerance = tolerance;
+      fitSegment = segment;
+      fitDegree = degree;
+   }
+
+
+   Xvt OrbitEphStore::ephXvt(const OrbitEph& eph, const CommonTime& t) const
+   {
+      if(!useFits)
+         return eph.svXvt(t);
+
+      AddressCache<OrbitEph, OrbitEphFit>::ValuePtr fit(
+         fits.get(&eph, [&](OrbitEphFit& newFit)
+                  { newFit.fit(eph, fitTolerance, fitSegment, fitDegree); }));
+
+      Xvt sv;
+      if(fit->svXvt(t, sv))
+         return sv;
+      return eph.svXvt(t);
+   }
+
+
    Xvt::HealthStatus OrbitEphStore ::
    getSVHealth(const SatID& sat, const CommonTime& t) const throw()
    {
@@ -300,6 +393,7 @@ namespace gpstk
          if(it==toet.begin()) {
             // candidate is before beginning of map
             if(it->second->ctToe == eph->ctToe) {
+               fits.erase(it->second);
                toet.erase(it);
             }
             ret = eph->clone();
@@ -325,6 +419,7 @@ namespace gpstk
          // Check if iterator points to late transmission of
          // same OrbitEph as candidate
          if(it->second->ctToe == eph->ctToe) {
+            fits.erase(it->second);
             toet.erase(it);
             ret = eph->clone();
             toet[keyVal] = ret;
@@ -361,7 +456,10 @@ namespace gpstk
          if(lower != eMap.begin())
          {
             for (TimeOrbitEphTable::iterator emi = eMap.begin(); emi != lower; emi++)
+            {
+               fits.erase(emi->second);
                delete emi->second;
+            }
             eMap.erase(eMap.begin(), lower);
          }
 
@@ -369,7 +467,10 @@ namespace gpstk
          if(upper != eMap.end())
          {
             for (TimeOrbitEphTable::iterator emi = upper; emi != eMap.end(); emi++)
+            {
+               fits.erase(emi->second);
                delete emi->second;
+            }
             eMap.erase(upper, eMap.end());
          }
       }
@@ -381,6 +482,7 @@ namespace gpstk
    //---------------------------------------------------------------------------------
    void OrbitEphStore::clear(void)
    {
+      fits.clear();
       for(SatTableMap::iterator ui=satTables.begin(); ui!=satTables.end(); ui++) {
          TimeOrbitEphTable& toet = ui->second;
          for(TimeOrbitEphTable::iterator toeti = toet.begin(); toeti != toet.end(); toeti++) {
@@ -436,11 +538,15 @@ namespace gpstk
                                                    const CommonTime& t) const
    {
       // Is this satellite found in the table?
-      if(satTables.find(sat) == satTables.end())
+      SatTableMap::const_iterator it = satTables.find(sat);
+      if(it == satTables.end())
          return NULL;
-      // Define reference to the relevant map of orbital elements
-      const TimeOrbitEphTable& table = getTimeOrbitEphMap(sat);
+      return findUserOrbitEph(it->second, t);
+   }
 
+   const OrbitEph* OrbitEphStore::findUserOrbitEph(const TimeOrbitEphTable& table,
+                                                   const CommonTime& t)
+   {
       // The map is ordered by beginning times of validity, which
       // is another way of saying "earliest transmit time".  A call
       // to table.lower_bound(t) will return the element of the map
@@ -449,9 +555,11 @@ namespace gpstk
       if (table.empty())
          return NULL;
 
-      TimeOrbitEphTable::const_iterator it = table.find(t);
-      if(it == table.end()) {                   // not a direct match
-         it = table.lower_bound(t);
+      // lower_bound() returns a direct match if there is one, so a
+      // single search (of integer keys) serves both cases.
+      const TimeKey key(t);
+      TimeOrbitEphTable::const_iterator it = table.lower_bound(key);
+      if(it == table.end() || it->first != key) {   // not a direct match
 
          // Tricky case here.  If the key is beyond the last key in the table,
          // lower_bound() will return table.end(). However, this doesn't entirely
@@ -524,27 +632,28 @@ namespace gpstk
                                                    const CommonTime& t) const
    {
         // Check for any OrbitEph for this SV
-      if(satTables.find(sat) == satTables.end())
+      SatTableMap::const_iterator it = satTables.find(sat);
+      if(it == satTables.end())
          return NULL;
+      return findNearOrbitEph(it->second, t);
+   }
 
-      // No OrbitEph in store for requested sat time
-      // Define reference to the relevant map of orbital elements
-      const TimeOrbitEphTable& table = getTimeOrbitEphMap(sat);
-
+   const OrbitEph* OrbitEphStore::findNearOrbitEph(const TimeOrbitEphTable& table,
+                                                   const CommonTime& t)
+   {
       if (table.empty())
          return NULL;
 
-      TimeOrbitEphTable::const_iterator itNext = table.find(t);
-      if(itNext != table.end())               // exact match
+      // lower_bound returns the first element with key >= t
+      const TimeKey key(t);
+      TimeOrbitEphTable::const_iterator itNext = table.lower_bound(key);
+      if(itNext != table.end() && itNext->first == key)   // exact match
          return itNext->second;
 
       // Three cases:
       // 1. t is within a gap within the store
       // 2. t is before all OrbitEph in the store
       // 3. t is after all OrbitEph in the store
-
-      // lower_bound returns the first element with key >= t
-      itNext = table.lower_bound(t);
       if(itNext == table.begin())             // Test for case 2
       {
             // Verify the first item in the table has a fit interval that
@@ -48,13 +48,17 @@
 
 #include <iostream>
 #include <list>
+#include <map>
 #include <set>
 
 #include "OrbitEph.hpp"
+#include "OrbitEphFit.hpp"
 #include "Exception.hpp"
 #include "SatID.hpp"
 #include "CommonTime.hpp"
+#include "TimeKey.hpp"
 #include "XvtStore.hpp"
+#include "AddressCache.hpp"
 //#include "Rinex3NavData.hpp"
 
 namespace gpstk
@@ -78,7 +82,11 @@ namespace gpstk
       OrbitEphStore()
             : initialTime(CommonTime::END_OF_TIME),
               finalTime(CommonTime::BEGINNING_OF_TIME),
-              strictMethod(true)
+              strictMethod(true),
+              useFits(false),
+              fitTolerance(0.001),
+              fitSegment(3600.0),
+              fitDegree(10)
       {
          timeSystem = TimeSystem::Any;
          initialTime.setTimeSystem(timeSystem);
@@ -103,6 +111,18 @@ namespace gpstk
           *   there are no orbit elements at time t. */
       virtual Xvt getXvt(const SatID& id, const CommonTime& t) const;
 
+         /** Batch version of getXvt(); see XvtStore::getXvts().  The
+          * satellite's table is looked up once for each run of
+          * adjacent queries of the same satellite, and no exceptions
+          * are thrown or caught for queries without an ephemeris.
+          * @param[in] queries list of (SatID, time) pairs
+          * @param[out] xvts results, resized to queries.size()
+          * @param[out] status outcome of each query
+          * @return the number of queries with status Valid */
+      virtual unsigned getXvts(const std::vector<XvtQuery>& queries,
+                               std::vector<Xvt>& xvts,
+                               std::vector<XvtStatus>& status) const throw();
+
          /** Compute the position, velocity and clock offset of the
           * indicated object in ECEF coordinates (meters) at the
           * indicated time.
@@ -349,10 +369,37 @@ namespace gpstk
          return false; 
       }
 
+         /// Return true if orbit fits are used; see setOrbitFit().
+      bool getOrbitFit(void) const
+      { return useFits; }
+
+         /// Return the error allowed in the orbit fits, in meters.
+      double getOrbitFitTolerance(void) const
+      { return fitTolerance; }
+
+         /** Set whether getXvt(), getXvts() and computeXvt() use
+          * Chebyshev fits to the ephemerides (see OrbitEphFit)
+          * instead of evaluating the orbit elements.  Each
+          * ephemeris is fitted over its interval of validity the
+          * first time it is used.  Times at which the fit is not
+          * within tolerance, and times outside the interval of
+          * validity, are evaluated exactly as without fits.
+          * @param[in] use enable or disable the fits
+          * @param[in] tolerance largest position or clock error, in
+          *   meters, for a fit to be used
+          * @param[in] segment longest fit segment, in seconds
+          * @param[in] degree degree of the fitted polynomials
+          * @throw InvalidParameter if segment is not positive or
+          *   degree is not in 2..OrbitEphFit::MaxDegree. */
+      void setOrbitFit(bool use, double tolerance = 0.001,
+                       double segment = 3600.0, int degree = 10);
+
          /** This map stores sets of unique orbital elements for a
           * single satellite.  The key is the beginning of the period
-          * of validity for each set of elements. */
-      typedef std::map<CommonTime, OrbitEph*> TimeOrbitEphTable;
+          * of validity for each set of elements, held as a TimeKey
+          * so that lookups are integer comparisons; it converts to
+          * and from CommonTime implicitly. */
+      typedef std::map<TimeKey, OrbitEph*> TimeOrbitEphTable;
 
          /** This map holds all unique OrbitEph for each satellite The
           * key is the SatID of the satellite. */
@@ -386,6 +433,30 @@ namespace gpstk
          /// flag indicating search method (find...Eph) to use.
       bool strictMethod;
 
+         /// Whether to use orbit fits; see setOrbitFit()
+      bool useFits;
+
+         /// Parameters of the orbit fits; see setOrbitFit()
+      double fitTolerance, fitSegment;
+      int fitDegree;
+
+         /** Fits of the ephemerides in satTables.  Entries must be
+          * removed when the ephemeris they belong to is deleted or
+          * changed. */
+      mutable AddressCache<OrbitEph, OrbitEphFit> fits;
+
+         /** Compute position, velocity and clock of a satellite from
+          * an ephemeris in satTables, from its fit if enabled. */
+      Xvt ephXvt(const OrbitEph& eph, const CommonTime& t) const;
+
+         /// findUserOrbitEph() within the given satellite's table
+      static const OrbitEph* findUserOrbitEph(const TimeOrbitEphTable& table,
+                                              const CommonTime& t);
+
+         /// findNearOrbitEph() within the given satellite's table
+      static const OrbitEph* findNearOrbitEph(const TimeOrbitEphTable& table,
+                                              const CommonTime& t);
+
          /// Convenience routines
       void updateTimeLimits(const OrbitEph* eph)
       {
@@ -55,7 +55,8 @@ namespace gpstk
    PackedNavBits::PackedNavBits()
                  : transmitTime(CommonTime::BEGINNING_OF_TIME),
                    parityStatus(psUnknown),
-                   bits(900),
+                   words((900+63)/64, 0),
+                   bits_size(900),
                    bits_used(0),
                    rxID(""),
                    xMitCoerced(false)
@@ -65,7 +66,8 @@ namespace gpstk
    PackedNavBits::PackedNavBits(const SatID& satSysArg, 
                                 const ObsID& obsIDArg,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
+                                : words((900+63)/64, 0),
+                                  bits_size(900),
                                   parityStatus(psUnknown),
                                   bits_used(0),
                                   rxID(""),
@@ -81,7 +83,8 @@ namespace gpstk
                                 const ObsID& obsIDArg,
                                 const std::string rxString,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
+                                : words((900+63)/64, 0),
+                                  bits_size(900),
                                   parityStatus(psUnknown),
                                   bits_used(0),
                                   rxID(""),
@@ -99,7 +102,8 @@ namespace gpstk
                                 const NavID& navIDArg,
                                 const std::string rxString,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
+                                : words((900+63)/64, 0),
+                                  bits_size(900),
                                   parityStatus(psUnknown),
                                   bits_used(0),
                                   rxID(""),
@@ -122,12 +126,10 @@ namespace gpstk
       rxID   = right.rxID;
       transmitTime = right.transmitTime;
       bits_used = right.bits_used;
-      bits.resize(bits_used);
+      words = right.words;
+      bits_size = right.bits_size;
+      resizeBits(bits_used);
       parityStatus = right.parityStatus;
-      for (int i=0;i<bits_used;i++)
-      {
-         bits[i] = right.bits[i];
-      }
       xMitCoerced = right.xMitCoerced;
    }
  
@@ -185,7 +187,8 @@ namespace gpstk
    
    void PackedNavBits::clearBits()
    {
-      bits.clear();
+      words.clear();
+      bits_size = 0;
       bits_used = 0;
    }
 
@@ -224,20 +227,16 @@ namespace gpstk
                                       const int numBits ) const
       throw(InvalidParameter)                                    
    {
-      uint64_t temp = 0L;       // Set up a temporary variable with a known size
-                                // It needs to be AT LEAST 33 bits.
       size_t stop = startBit + numBits;
-      if (stop>bits.size())
+      if (stop>bits_size)
       {
          InvalidParameter exc("Requested bits not present.");
          GPSTK_THROW(exc);
       }
-      for (size_t i=startBit; i<stop; ++i)
-      {
-         temp <<= 1;
-         if (bits[i]) temp++;
-      }
-      return( temp ); 
+         // Only the last 64 bits of a longer field fit in the result
+      if (numBits>64)
+         return getField( stop-64, 64 );
+      return getField( startBit, numBits );
    }
 
    unsigned long PackedNavBits::asUnsignedLong(const int startBit, 
@@ -456,7 +455,7 @@ namespace gpstk
 
    bool PackedNavBits::asBool( const unsigned bitNum) const
    {
-      return bits[bitNum]; 
+      return (words[bitNum>>6] >> (63 - (bitNum&63))) & 1; 
    }
 
 
@@ -598,32 +597,80 @@ namespace gpstk
    {
       int old_bits_used = bits_used;
       bits_used += right.bits_used;
-      bits.resize(bits_used);
-      
-      for (int i=0;i<right.bits_used;i++)
-      {
-         bits[i+old_bits_used] = right.bits[i];
-      }
+      resizeBits(bits_used);
+      copyField(right, 0, right.bits_used, old_bits_used);
    }
 
    void PackedNavBits::addUint64_t( const uint64_t value, const int numBits )
    {
-      size_t ndx = bits_used;
-      uint64_t mask = 0x0000000000000001L;
-      mask <<= (numBits-1);
+      if (bits_used+numBits > bits_size)
+         resizeBits(bits_used+numBits);
+      setField( bits_used, numBits, value );
+      bits_used += numBits;
+   }
 
-      for (int i=0; i<numBits; ++i)
+   //--------------------------------------------------------------------------
+   // Bit i is bit (63 - i%64) of words[i/64].  A field therefore covers
+   // at most two words, and is extracted or inserted with shifts and masks.
+   void PackedNavBits::resizeBits( const size_t newSize )
+   {
+      words.resize( (newSize+63)/64, 0 );
+      bits_size = newSize;
+         // keep the bits beyond the end clear
+      if (newSize%64)
+         words.back() &= ~uint64_t(0) << (64 - newSize%64);
+   }
+
+   uint64_t PackedNavBits::getField( const size_t startBit, 
+                                     const int numBits ) const
+   {
+      if (numBits<=0) return 0;
+      size_t ndx = startBit >> 6;
+      unsigned offset = startBit & 63;
+      uint64_t field = words[ndx] << offset;
+      if (offset+numBits > 64)
+         field |= words[ndx+1] >> (64 - offset);
+      return field >> (64 - numBits);
+   }
+
+   void PackedNavBits::setField( const size_t startBit, const int numBits,
+                                 const uint64_t value )
+   {
+      if (numBits<=0) return;
+      size_t ndx = startBit >> 6;
+      unsigned offset = startBit & 63;
+      uint64_t ones = ~uint64_t(0);
+      if (numBits<64) ones >>= (64 - numBits);
+      uint64_t field = value & ones;
+      if (offset+numBits <= 64)
       {
-         bits[ndx] = false;
-         if (value & mask) 
-         {
-             //set the bits to true
-            bits[ndx] = true;
-         }
-         mask>>= 1;
-         ndx++;
+         unsigned shift = 64 - offset - numBits;
+         words[ndx] = (words[ndx] & ~(ones << shift)) | (field << shift);
+      }
+      else
+      {
+            // split across two words
+         unsigned numLow = offset + numBits - 64;
+         words[ndx] = (words[ndx] & (~uint64_t(0) << (64 - offset)))
+            | (field >> numLow);
+         unsigned shift = 64 - numLow;
+         words[ndx+1] = (words[ndx+1] & (~uint64_t(0) >> numLow))
+            | (field << shift);
+      }
+   }
+
+   void PackedNavBits::copyField( const PackedNavBits& from,
+                                  const size_t startBit,
+                                  const size_t numBits,
+                                  const size_t offset )
+   {
+      size_t done = 0;
+      while (done<numBits)
+      {
+         int n = (numBits-done>64) ? 64 : int(numBits-done);
+         setField( startBit+offset+done, n, from.getField(startBit+done, n) );
+         done += n;
       }
-      bits_used += numBits;
    }
 
    //--------------------------------------------------------------------------
@@ -633,9 +680,9 @@ namespace gpstk
    // in which left has a FALSE whereas right has a TRUE starting at the 
    // lowest index and scanning to the maximum index.
    //
-   // NOTE: This is one of the cases in which the PackedNavBits implementation 
-   // is probably not the fastest.  Since we are scanning a bit array rather 
-   // than testing a series of unsigned ints.
+   // Since the first bit is the most significant bit of the first word,
+   // and the unused bits of the last word are clear, comparing the words
+   // as unsigned integers gives the same result as the bit scan.
    bool PackedNavBits::operator<(const PackedNavBits& right) const
    {
          // If the two objects don't have the same number of bits,
@@ -643,43 +690,53 @@ namespace gpstk
          // happen.  In the context of NavFilter, data SHOULD be
          // from the same system, therefore, the same length should 
          // always be true.
-      if (bits.size()!=right.bits.size())
+      if (bits_size!=right.bits_size)
       {
-         if (bits.size()<right.bits.size()) return true;
+         if (bits_size<right.bits_size) return true;
          return false;
       }
 
-      for (int i=0;i<bits.size();i++)
+      for (size_t i=0;i<words.size();i++)
       {
-         if (bits[i]==false && right.bits[i]==true)
-         //if (bits[i]<right.bits[i])
-         {
-            return true;
-         }
-         if (bits[i]==true && right.bits[i]==false)
-         {
-            return false;
-         }
+         if (words[i]!=right.words[i])
+            return words[i]<right.words[i];
       }
       return false;
    }
 
+   //--------------------------------------------------------------------------
+   std::size_t PackedNavBits::hash() const
+   {
+         // 64-bit FNV-1a over the words and the size
+      uint64_t h = 0xcbf29ce484222325ULL;
+      const uint64_t prime = 0x100000001b3ULL;
+      h = (h ^ bits_size) * prime;
+      for (size_t i=0;i<words.size();i++)
+      {
+         h = (h ^ words[i]) * prime;
+         h ^= h >> 32;
+      }
+      return std::size_t(h);
+   }
+
+   //--------------------------------------------------------------------------
+   std::vector<bool> PackedNavBits::getBits() const
+   {
+      std::vector<bool> bits(bits_size);
+      for (size_t i=0;i<bits_size;i++)
+         bits[i] = asBool(i);
+      return bits;
+   }
+
    void PackedNavBits::invert( )
    {
-         // Each bit is either 1 or 0.
-         // Starting with 1 and subtracting the 
-         // current value will yield the inverse
-         //   
-         //  Input    Equation     Result
-         //    1       1 - 1          0
-         //    0       1 - 0          1
-         //
-         // This accomplishes the purpose without incurring
-         // the cost of a conditional statement.
-      for (int i=0;i<bits.size();i++)
+         // Invert a word at a time, then clear the bits
+         // beyond the end again.
+      for (size_t i=0;i<words.size();i++)
       {
-         bits[i] = 1 - bits[i];
+         words[i] = ~words[i];
       }
+      resizeBits(bits_size);
    } 
 
       /**
@@ -704,10 +761,8 @@ namespace gpstk
       short finalBit = endBit;
       if (finalBit==-1) finalBit = bits_used - 1;
 
-      for (short i=startBit; i<=finalBit; i++)
-      {
-         bits[i] = from.bits[i];
-      }
+      if (finalBit>=startBit)
+         copyField(from, startBit, finalBit-startBit+1);
    }
 
 
@@ -737,20 +792,7 @@ namespace gpstk
          GPSTK_THROW(exc);
       }
 
-      size_t ndx = startBit;
-      uint64_t mask = 0x0000000000000001L; 
-
-      mask <<= (numBits-1);
-      for (int i=0; i<numBits; i++)
-      {
-         bits[ndx] = false;
-         if (out & mask)
-         {
-            bits[ndx] = true;
-         }
-         mask >>= 1;
-         ndx++;
-      }
+      setField( startBit, numBits, out );
    }
 
 
@@ -765,7 +807,7 @@ namespace gpstk
    //--------------------------------------------------------------------------
    void PackedNavBits::trimsize()
    {
-      bits.resize(bits_used);
+      resizeBits(bits_used);
    }
 
    //--------------------------------------------------------------------------
@@ -825,26 +867,23 @@ namespace gpstk
       s << endl;     
 
       s << endl << "Packed Bits, Left Justified, 32 Bits Long:\n";
-      int numBitInWord = 0;
       int word_count   = 0;
       uint32_t word    = 0;
-      for(size_t i = 0; i < bits.size(); ++i)
+      size_t i = 0;
+      for( ; i+32 <= bits_size; i += 32)
       {
-         word <<= 1;
-         if (bits[i]) word++;
-       
-         numBitInWord++;
-         if (numBitInWord >= 32)
-         {
-            s << "  0x" << setw(8) << setfill('0') << hex << word << dec << setfill(' ');
-            numBitInWord = 0;
-            word_count++;
-            //Print four words per line 
-            if (word_count %5 == 0) s << endl;        
-         }
+         word = (uint32_t) getField(i, 32);
+         s << "  0x" << setw(8) << setfill('0') << hex << word << dec << setfill(' ');
+         word_count++;
+         //Print four words per line 
+         if (word_count %5 == 0) s << endl;        
+      }
+      int numBitInWord = bits_size - i;
+      if (numBitInWord > 0 )
+      {
+         word = (uint32_t) getField(i, numBitInWord) << (32 - numBitInWord);
+         s << "  0x" << setw(8) << setfill('0') << hex << word << dec << setfill(' ');
       }
-      word <<= 32 - numBitInWord;
-      if (numBitInWord > 0 ) s << "  0x" << setw(8) << setfill('0') << hex << word << dec << setfill(' ');
       s.setf(ios::fixed, ios::floatfield);
       s.precision(3);
       s.flags(oldFlags);      // Reset whatever conditions pertained on entry
@@ -863,38 +902,30 @@ namespace gpstk
       s.setf(ios::uppercase); 
       int rollover = numPerLine;
       
-      int numBitInWord = 0;
-      int bit_count    = 0; 
       int word_count   = 0;
       uint32_t word    = 0;
-      for(size_t i = 0; i < bits.size(); ++i)
+      size_t i = 0;
+      for( ; i+numBitsPerWord <= bits_size; i += numBitsPerWord)
       {
-         word <<= 1;
-         if (bits[i]) word++;
-       
-         numBitInWord++;
-         if (numBitInWord >= numBitsPerWord)
-         {
-            s << delimiter << " 0x" << setw(8) << setfill('0') << hex << word << dec << setfill(' ');
-            word = 0;
-            numBitInWord = 0;
-            word_count++;
+         word = (uint32_t) getField(i, numBitsPerWord);
+         s << delimiter << " 0x" << setw(8) << setfill('0') << hex << word << dec << setfill(' ');
+         word_count++;
             
             //Print "numPerLine" words per line,
             //but ONLY if there are more bits left to put on the next line.
-            if (word_count>0 && 
-                word_count % rollover == 0 &&
-                (i+1) < bits.size()) s << endl;        
-         }
+         if (word_count>0 && 
+             word_count % rollover == 0 &&
+             (i+numBitsPerWord) < bits_size) s << endl;        
       }
          // Need to check if there is a partial word in the buffer
-      word <<= 32 - numBitInWord;
+      int numBitInWord = bits_size - i;
       if (numBitInWord>0)
       {
+         word = (uint32_t) getField(i, numBitInWord) << (32 - numBitInWord);
          s << delimiter << " 0x" << setw(8) << setfill('0') << hex << word << dec << setfill(' ');
       }
       s.flags(oldFlags);      // Reset whatever conditions pertained on entry
-      return(bits.size()); 
+      return(bits_size); 
    }
 
    bool PackedNavBits::operator==(const PackedNavBits& right) const
@@ -947,19 +978,21 @@ namespace gpstk
    {
          // If the two objects don't have the same number of bits,
          // don't even try to compare them. 
-      if (bits.size()!=right.bits.size()) return false; 
+      if (bits_size!=right.bits_size) return false; 
+      if (bits_size==0) return true;
 
       short startBit = startBitA;
       short endBit = endBitA; 
          // Check for nonsense arguments
       if (endBit==-1 ||
-          endBit>=int(bits.size())) endBit = bits.size()-1;
+          endBit>=int(bits_size)) endBit = bits_size-1;
       if (startBit<0) startBit=0;
-      if (startBit>=int(bits.size())) startBit = bits.size()-1;
+      if (startBit>=int(bits_size)) startBit = bits_size-1;
 
-      for (int i=startBit;i<=endBit;i++)
+      for (int i=startBit;i<=endBit;i+=64)
       {
-         if (bits[i]!=right.bits[i])
+         int n = (endBit-i+1 > 64) ? 64 : endBit-i+1;
+         if (getField(i,n)!=right.getField(i,n))
          {
             return false;
          }
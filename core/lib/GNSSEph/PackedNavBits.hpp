@@ -356,6 +356,13 @@ namespace gpstk
           */
       bool operator<(const PackedNavBits& right) const; 
 
+         /**
+          * Hash of the bit array, for use with hashed containers of
+          *   the NavFilter keys.  Objects for which matchBits() is
+          *   true have the same hash; the metadata are not included.
+          */
+      std::size_t hash() const;
+
          /**
           *  Bitwise invert contents of this object.
           */
@@ -423,8 +430,8 @@ namespace gpstk
        void setXmitCoerced(bool tf=true) {xMitCoerced=tf;}
        bool isXmitCoerced() const {return xMitCoerced;}
 
-      const std::vector<bool>& getBits() const
-      { return bits; }
+         /// Return a copy of the bit array, one element per bit.
+      std::vector<bool> getBits() const;
 
          /** Indicate the status of parity/CRC checking.  Must be
           * explicitly set after construction, no parity checking is
@@ -437,7 +444,12 @@ namespace gpstk
       NavID navID;             /**< Defines the navigation message tracked */ 
       std::string rxID;        /**< Defines the receiver that collected the data */
       CommonTime transmitTime; /**< Time nav message is transmitted */
-      std::vector<bool> bits;  /**< Holds the packed data */
+         /** Holds the packed data, 64 bits per word, with bit 0 in
+             the most significant bit of the first word.  Bits beyond
+             bits_size are always zero, so that words can be compared
+             and hashed directly. */
+      std::vector<uint64_t> words;
+      size_t bits_size;        /**< Size of the bit array */
       int bits_used;
       
       bool xMitCoerced;        /**< Used to indicate that the transmit
@@ -451,6 +463,23 @@ namespace gpstk
          /** Pack the bits */
       void addUint64_t( const uint64_t value, const int numBits );
 
+         /** Resize the bit array, clearing any new bits */
+      void resizeBits( const size_t newSize );
+
+         /** Get numBits (at most 64) bits starting at startBit,
+             right justified, without checking the bit array size */
+      uint64_t getField( const size_t startBit, const int numBits ) const;
+
+         /** Set numBits (at most 64) bits starting at startBit to the
+             low bits of value, without checking the bit array size */
+      void setField( const size_t startBit, const int numBits,
+                     const uint64_t value );
+
+         /** Copy numBits bits starting at startBit from another
+             object to startBit+offset in this object */
+      void copyField( const PackedNavBits& from, const size_t startBit,
+                      const size_t numBits, const size_t offset=0 );
+
          /** Extend the sign bit for signed values */
       int64_t SignExtend( const int startBit, const int numBits ) const;
    
@@ -368,6 +368,7 @@ namespace gpstk
             if(haveAcceleration) { oldrec.Acc = rec.Acc; oldrec.sigAcc = rec.sigAcc; }
          }
          else {   // create a new entry in the table
+            uncompact();
             tables[sat][ttag] = rec;
          }
       }
@@ -395,6 +396,7 @@ namespace gpstk
             rec.sigPos = Sig;
             rec.Vel = rec.sigVel = rec.Acc = rec.sigAcc = Triple(0,0,0);
 
+            uncompact();
             tables[sat][ttag] = rec;
          }
       }
@@ -424,6 +426,7 @@ namespace gpstk
             rec.sigVel = Sig;
             rec.Pos = rec.sigPos = rec.Acc = rec.sigAcc = Triple(0,0,0);
 
+            uncompact();
             tables[sat][ttag] = rec;
          }
       }
@@ -453,12 +456,84 @@ namespace gpstk
             rec.sigAcc = Sig;
             rec.Vel = rec.sigVel = rec.Pos = rec.sigPos = Triple(0,0,0);
 
+            uncompact();
             tables[sat][ttag] = rec;
          }
       }
       catch(InvalidRequest& ir) { GPSTK_RETHROW(ir); }
    }
 
+   // Append the time system, data flags and tables to an ephemeris cache
+   void PositionSatStore::writeCache(EphemerisCacheWriter& cw) const throw()
+   {
+      cw.put(static_cast<int>(storeTimeSystem.getTimeSystem()));
+      cw.put(havePosition);
+      cw.put(haveVelocity);
+      cw.put(haveClockBias);
+      cw.put(haveClockDrift);
+      cw.put(haveAcceleration);
+      cw.put(static_cast<unsigned int>(tables.size()));
+      SatTable::const_iterator it;
+      for(it=tables.begin(); it!=tables.end(); ++it)
+      {
+         cw.put(it->first);
+         cw.put(static_cast<unsigned int>(it->second.size()));
+         DataTable::const_iterator jt;
+         for(jt=it->second.begin(); jt!=it->second.end(); ++jt)
+         {
+            cw.put(jt->first);
+            cw.put(jt->second.Pos);
+            cw.put(jt->second.sigPos);
+            cw.put(jt->second.Vel);
+            cw.put(jt->second.sigVel);
+            cw.put(jt->second.Acc);
+            cw.put(jt->second.sigAcc);
+         }
+      }
+   }
+
+   // Replace the time system, data flags and tables with those in a cache
+   void PositionSatStore::readCache(EphemerisCacheReader& cr) throw(Exception)
+   {
+      try {
+         int ts;
+         cr.get(ts);
+         cr.get(havePosition);
+         cr.get(haveVelocity);
+         cr.get(haveClockBias);
+         cr.get(haveClockDrift);
+         cr.get(haveAcceleration);
+         storeTimeSystem = TimeSystem(ts);
+
+         uncompact();
+         tables.clear();
+         unsigned int nsat, nrec;
+         cr.get(nsat);
+         for(unsigned int i=0; i<nsat; i++)
+         {
+            SatID sat;
+            cr.get(sat);
+            cr.get(nrec);
+            DataTable& table(tables[sat]);
+            for(unsigned int j=0; j<nrec; j++)
+            {
+               CommonTime ttag;
+               PositionRecord rec;
+               cr.get(ttag);
+               cr.get(rec.Pos);
+               cr.get(rec.sigPos);
+               cr.get(rec.Vel);
+               cr.get(rec.sigVel);
+               cr.get(rec.Acc);
+               cr.get(rec.sigAcc);
+                  // written in order, so each record goes at the end
+               table.insert(table.end(), std::make_pair(ttag, rec));
+            }
+         }
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
    //@}
 
 }  // End of namespace gpstk
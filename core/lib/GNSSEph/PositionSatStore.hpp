@@ -50,6 +50,7 @@
 #include "SatID.hpp"
 #include "CommonTime.hpp"
 #include "Triple.hpp"
+#include "EphemerisCache.hpp"
 #include "SP3Data.hpp"
 
 namespace gpstk
@@ -257,6 +258,16 @@ namespace gpstk
       void rejectBadPositions(const bool flag)
       { rejectBadPosFlag=flag; }
 
+         /** Append the time system, data flags and tables to an
+          * ephemeris cache being written. */
+      void writeCache(EphemerisCacheWriter& cw) const throw();
+
+         /** Replace the time system, data flags and tables with
+          * those read from an ephemeris cache written by
+          * writeCache(); other settings are unchanged.
+          * @throw Exception if the cache is exhausted */
+      void readCache(EphemerisCacheReader& cr) throw(Exception);
+
    }; // end class PositionSatStore
 
       //@}
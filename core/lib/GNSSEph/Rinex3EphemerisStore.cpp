@@ -46,6 +46,7 @@
 #include "GalEphemeris.hpp"
 #include "BDSEphemeris.hpp"
 #include "QZSEphemeris.hpp"
+#include "ParallelFor.hpp"
 
 using namespace std;
 
@@ -106,68 +107,100 @@ namespace gpstk
       return false;
    }
 
-   // load the given Rinex navigation file
-   // return -1 failed to open file,
-   //        -2 failed to read header (this->Rhead),
-   //        -3 failed to read data (this->Rdata),
-   //       >=0 number of nav records read
-   int Rinex3EphemerisStore::loadFile(const string& filename, bool dump, ostream& s)
+   namespace
    {
-      try {
-         int nread(0);
+         // The contents of one file, read by readNavFile() and then
+         // added to the store by storeNavFile().
+      struct StagedNavFile
+      {
+         StagedNavFile() : status(0) {}
+         int status;             ///< 0, or the loadFile() failure code
+         string what;            ///< description of the failure
+         Rinex3NavHeader head;
+         vector<Rinex3NavData> recs;
+      };
+
+         // Read the file; this touches no store and so may run concurrently.
+      void readNavFile(const string& filename, StagedNavFile& sf)
+      {
          Rinex3NavStream strm;
-         what = string();
-         
          strm.open(filename.c_str(), ios::in);
          if(!strm.is_open()) {
-            what = string("File ") + filename + string(" could not be opened.");
-            return -1;
+            sf.what = string("File ") + filename + string(" could not be opened.");
+            sf.status = -1;
+            return;
          }
          strm.exceptions(ios::failbit);
+         strm.memoryMap();
 
-         try { strm >> Rhead; }
+         try { strm >> sf.head; }
          catch(Exception& e) {
-            what = string("Failed to read header of file ") + filename
+            sf.what = string("Failed to read header of file ") + filename
                + string(" : ") + e.getText();
-            return -2;
-         }
-         if(dump) Rhead.dump(s);
-
-         // add to FileStore
-         NavFiles.addFile(filename, Rhead);
-
-         // add to mapTimeCorr
-         if(Rhead.mapTimeCorr.size() > 0) {
-            map<string, TimeSystemCorrection>::const_iterator it;
-            for(it=Rhead.mapTimeCorr.begin(); it!=Rhead.mapTimeCorr.end(); ++it)
-               addTimeCorr(it->second);
+            sf.status = -2;
+            return;
          }
 
+         Rinex3NavData Rdata;
          while(1) {
             // read the record
             try { strm >> Rdata; }
             catch(Exception& e) {
-               what = string("Failed to read data in file ") + filename
+               sf.what = string("Failed to read data in file ") + filename
                   + string(" : ") + e.getText();
-               return -3;
+               sf.status = -3;
+               return;
             }
             catch(std::exception& e) {
-               what = string("std excep: ") + e.what();
-               return -3;
+               sf.what = string("std excep: ") + e.what();
+               sf.status = -3;
+               return;
             }
             catch(...) {
-               what = string("Unknown exception while reading data of file ")
+               sf.what = string("Unknown exception while reading data of file ")
                   + filename;
-               return -3;
+               sf.status = -3;
+               return;
             }
 
             if(!strm.good() || strm.eof()) break;
 
-            nread++;
-            if(dump) Rdata.dump(s);
+            sf.recs.push_back(Rdata);
+         }
+      }
+
+         // Add the contents of a staged file to the store, stopping where
+         // loadFile() would have if the file could not be read.
+         // @return as loadFile()
+      int storeNavFile(Rinex3EphemerisStore& store, const string& filename,
+                       const StagedNavFile& sf, bool dump, ostream& s)
+      {
+         store.what = sf.what;
+         if(sf.status == -1)
+            return sf.status;
+
+         store.Rhead = sf.head;
+         if(sf.status == -2)
+            return sf.status;
+         if(dump) store.Rhead.dump(s);
+
+         // add to FileStore
+         store.addFile(filename, store.Rhead);
+
+         // add to mapTimeCorr
+         if(store.Rhead.mapTimeCorr.size() > 0) {
+            map<string, TimeSystemCorrection>::const_iterator it;
+            for(it=store.Rhead.mapTimeCorr.begin();
+                it!=store.Rhead.mapTimeCorr.end(); ++it)
+               store.addTimeCorr(it->second);
+         }
+
+         for(size_t i=0; i<sf.recs.size(); i++) {
+            store.Rdata = sf.recs[i];
+            if(dump) store.Rdata.dump(s);
 
             try {
-               addEphemeris(Rdata);
+               store.addEphemeris(store.Rdata);
             }
             catch(Exception& e) {
                cout << "addEphemeris caught excp " << e.what();
@@ -175,7 +208,23 @@ namespace gpstk
             }
          }
 
-         return nread;
+         if(sf.status != 0)
+            return sf.status;
+         return sf.recs.size();
+      }
+   }
+
+   // load the given Rinex navigation file
+   // return -1 failed to open file,
+   //        -2 failed to read header (this->Rhead),
+   //        -3 failed to read data (this->Rdata),
+   //       >=0 number of nav records read
+   int Rinex3EphemerisStore::loadFile(const string& filename, bool dump, ostream& s)
+   {
+      try {
+         StagedNavFile sf;
+         readNavFile(filename, sf);
+         return storeNavFile(*this, filename, sf, dump, s);
       }
       catch(Exception& e) {
          GPSTK_RETHROW(e);
@@ -183,6 +232,36 @@ namespace gpstk
 
    } // end Rinex3EphemerisStore::loadFile
 
+   // load the given Rinex navigation files, reading them in parallel; files
+   // are read in windows of a few per thread, to bound the memory used for
+   // staging, and each window is added to the store in order.
+   int Rinex3EphemerisStore::loadFiles(const vector<string>& filenames,
+                                       unsigned nthreads)
+   {
+      try {
+         int nread(0);
+         nthreads = parallelThreadCount(nthreads, filenames.size());
+         const size_t window(4*nthreads);
+         for(size_t beg=0; beg < filenames.size(); beg += window) {
+            size_t n(std::min(window, filenames.size()-beg));
+            vector<StagedNavFile> staged(n);
+            parallelFor(n, nthreads, [&](size_t i)
+               { readNavFile(filenames[beg+i], staged[i]); });
+            for(size_t i=0; i<n; i++) {
+               int nf = storeNavFile(*this, filenames[beg+i], staged[i],
+                                     false, cout);
+               if(nf < 0) return nf;
+               nread += nf;
+            }
+         }
+         return nread;
+      }
+      catch(Exception& e) {
+         GPSTK_RETHROW(e);
+      }
+
+   } // end Rinex3EphemerisStore::loadFiles
+
    // Find the appropriate time system correction object in the collection for the
    // given time systems, and dump it to a string and return that string.
    string Rinex3EphemerisStore::dumpTimeSystemCorrection(
@@ -297,6 +376,65 @@ namespace gpstk
       catch(InvalidRequest& ir) { GPSTK_RETHROW(ir); }
    }
 
+   // Batch version of getXvt(): split the queries between the orbit and
+   // GLONASS stores, correcting the time systems, and merge the results.
+   unsigned Rinex3EphemerisStore::getXvts(const vector<XvtQuery>& queries,
+                                          vector<Xvt>& xvts,
+                                          vector<XvtStatus>& status) const
+      throw()
+   {
+      xvts.resize(queries.size());
+      status.resize(queries.size());
+
+      vector<XvtQuery> orbQ, gloQ;
+      vector<size_t> orbI, gloI;
+      for(size_t i=0; i<queries.size(); i++) {
+         const SatID& sat(queries[i].first);
+         TimeSystem ts;
+         switch(sat.system) {
+            case SatID::systemGPS:     ts = TimeSystem::GPS; break;
+            case SatID::systemGalileo: ts = TimeSystem::GAL; break;
+            case SatID::systemBeiDou:  ts = TimeSystem::BDT; break;
+            case SatID::systemQZSS:    ts = TimeSystem::QZS; break;
+            case SatID::systemGlonass: ts = TimeSystem::GLO; break;
+            default:                   ts = TimeSystem::Unknown; break;
+         }
+
+         status[i] = Failed;
+         xvts[i] = Xvt();
+         xvts[i].health = Xvt::HealthStatus::Unavailable;
+         if(ts == TimeSystem::Unknown)       // unsupported satellite system
+            continue;
+
+         try {
+            XvtQuery q(sat, correctTimeSystem(queries[i].second, ts));
+            if(ts == TimeSystem::GLO) { gloQ.push_back(q); gloI.push_back(i); }
+            else                      { orbQ.push_back(q); orbI.push_back(i); }
+         }
+         catch(...) { }
+      }
+
+      unsigned nvalid(0);
+      vector<Xvt> subXvts;
+      vector<XvtStatus> subStatus;
+      if(orbQ.size() > 0) {
+         nvalid += ORBstore.getXvts(orbQ, subXvts, subStatus);
+         for(size_t k=0; k<orbI.size(); k++) {
+            xvts[orbI[k]] = subXvts[k];
+            status[orbI[k]] = subStatus[k];
+         }
+      }
+      if(gloQ.size() > 0) {
+         nvalid += GLOstore.getXvts(gloQ, subXvts, subStatus);
+         for(size_t k=0; k<gloI.size(); k++) {
+            xvts[gloI[k]] = subXvts[k];
+            status[gloI[k]] = subStatus[k];
+         }
+      }
+
+      return nvalid;
+   }
+
 
    Xvt Rinex3EphemerisStore ::
    computeXvt(const SatID& sat, const CommonTime& inttag) const throw()
@@ -46,6 +46,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <vector>
 #include <algorithm>
 
 #include "Exception.hpp"
@@ -130,6 +131,18 @@ namespace gpstk
           *    information as to why the request failed. */
       virtual Xvt getXvt(const SatID& sat, const CommonTime& ttag) const;
 
+         /** Batch version of getXvt(); see XvtStore::getXvts().  The
+          * queries are converted to the time system of each
+          * satellite and passed, in one batch per store, to the
+          * getXvts() of the orbit and GLONASS stores.
+          * @param[in] queries list of (SatID, time) pairs
+          * @param[out] xvts results, resized to queries.size()
+          * @param[out] status outcome of each query
+          * @return the number of queries with status Valid */
+      virtual unsigned getXvts(const std::vector<XvtQuery>& queries,
+                               std::vector<Xvt>& xvts,
+                               std::vector<XvtStatus>& status) const throw();
+
          /** Compute the position, velocity and clock offset of the
           * indicated object in ECEF coordinates (meters) at the
           * indicated time.
@@ -268,6 +281,22 @@ namespace gpstk
       int loadFile(const std::string& filename, bool dump=false,
                    std::ostream& s=std::cout);
 
+         /** load RINEX navigation files, reading them on up to
+          * nthreads threads.  Records are added to the store in the
+          * order of the list, so the result, including the handling
+          * of duplicate and overlapping ephemerides, is the same as
+          * calling loadFile() on each file in turn.
+          * @param vector<string> filenames files to load, in order
+          * @param unsigned nthreads number of reader threads, 0 for
+          *   one per hardware thread
+          * @return the total number of nav records read, or the
+          *   (negative) loadFile() return for the first file that
+          *   failed; the files before it are loaded, and this->what
+          *   describes the failure
+          * @throw some other problem */
+      int loadFiles(const std::vector<std::string>& filenames,
+                    unsigned nthreads = 0);
+
          /** use to access the data records in the store in bulk Add
           * all Rinex3NavData in this store to the given list. If sat
           * is defined, (its default is (-1,mixed)), then add only
@@ -42,13 +42,70 @@
 #include "RinexEphemerisStore.hpp"
 #include "MiscMath.hpp"
 #include "GNSSconstants.hpp"
+#include "ParallelFor.hpp"
 #include <iostream>
 #include <fstream>
+#include <exception>
 
 using namespace gpstk::StringUtils;
 using namespace std;
 namespace gpstk
 {
+   namespace
+   {
+         // The contents of one file, read by readNavFile() and then
+         // added to the store by storeNavFile().
+      struct StagedNavFile
+      {
+         StagedNavFile() : haveHeader(false) {}
+         bool haveHeader;          ///< false if open or header failed
+         RinexNavHeader header;
+         vector<RinexNavData> recs;
+         exception_ptr error;      ///< error while reading, if any
+      };
+
+         // Read the file; this touches no store and so may run concurrently.
+      void readNavFile(const string& filename, StagedNavFile& sf)
+      {
+         try
+         {
+            RinexNavStream strm(filename.c_str());
+            if (!strm)
+            {
+               FileMissingException e("File " + filename + " could not be opened.");
+               GPSTK_THROW(e);
+            }
+            strm.memoryMap();
+
+            strm >> sf.header;
+            sf.haveHeader = true;
+
+            RinexNavData rec;
+            while(strm >> rec)
+               sf.recs.push_back(rec);
+         }
+         catch (...)
+         {
+            sf.error = current_exception();
+         }
+      }
+
+         // Add the contents of a staged file to the store, stopping where
+         // loadFile() would have if the file could not be read.
+      void storeNavFile(RinexEphemerisStore& store, const string& filename,
+                        StagedNavFile& sf)
+      {
+         if(sf.haveHeader)
+         {
+            store.addFile(filename, sf.header);
+            for(size_t i=0; i<sf.recs.size(); i++)
+               store.addEphemeris(sf.recs[i]);
+         }
+         if(sf.error)
+            rethrow_exception(sf.error);
+      }
+   }
+
    //-----------------------------------------------------------------------------
    //-----------------------------------------------------------------------------
    void RinexEphemerisStore::loadFile(const std::string& filename)
@@ -56,27 +113,108 @@ namespace gpstk
    {
       try
       {
-         RinexNavStream strm(filename.c_str());
-         if (!strm)
+         StagedNavFile sf;
+         readNavFile(filename, sf);
+         storeNavFile(*this, filename, sf);
+      }
+      catch (gpstk::Exception& e)
+      {
+	GPSTK_RETHROW(e);
+      }
+   }  // end RinexEphemerisStore::load
+
+
+   //-----------------------------------------------------------------------------
+   // Files are read in windows of a few per thread, to bound the memory used
+   // for staging, and each window is added to the store in order.
+   //-----------------------------------------------------------------------------
+   void RinexEphemerisStore::loadFiles(const vector<string>& filenames,
+                                       unsigned nthreads)
+      throw(FileMissingException)
+   {
+      try
+      {
+         nthreads = parallelThreadCount(nthreads, filenames.size());
+         const size_t window(4*nthreads);
+         for(size_t beg=0; beg < filenames.size(); beg += window)
          {
-            FileMissingException e("File " + filename + " could not be opened.");
-            GPSTK_THROW(e);
+            size_t n(std::min(window, filenames.size()-beg));
+            vector<StagedNavFile> staged(n);
+            parallelFor(n, nthreads, [&](size_t i)
+               { readNavFile(filenames[beg+i], staged[i]); });
+            for(size_t i=0; i<n; i++)
+               storeNavFile(*this, filenames[beg+i], staged[i]);
          }
-      
-         RinexNavHeader header;
-         strm >> header;
+      }
+      catch (gpstk::Exception& e)
+      {
+	GPSTK_RETHROW(e);
+      }
+   }  // end RinexEphemerisStore::loadFiles
 
-         addFile(filename, header);
 
-         RinexNavData rec;
-         while(strm >> rec)
-            addEphemeris(rec);
+   //-----------------------------------------------------------------------------
+   //-----------------------------------------------------------------------------
+   void RinexEphemerisStore::saveCache(const std::string& filename) const
+      throw(Exception)
+   {
+      try
+      {
+         EphemerisCacheWriter cw("RinexEphemerisStore");
+         const vector<string>& names(getFileNamesInOrder());
+         for(size_t i=0; i<names.size(); i++)
+            cw.addSource(names[i]);
+         cw.put(strictMethod);
+         writeCache(cw);
+         cw.write(filename);
       }
       catch (gpstk::Exception& e)
       {
-	GPSTK_RETHROW(e);
+         GPSTK_RETHROW(e);
       }
-   }  // end RinexEphemerisStore::load
+   }  // end RinexEphemerisStore::saveCache
+
+
+   //-----------------------------------------------------------------------------
+   //-----------------------------------------------------------------------------
+   bool RinexEphemerisStore::loadCache(const std::string& filename,
+                                       const vector<string>& filenames)
+      throw(Exception)
+   {
+      EphemerisCacheReader cr;
+      if(!cr.open(filename, "RinexEphemerisStore", filenames))
+         return false;
+
+      try
+      {
+         bool strict;
+         cr.get(strict);
+         if(strict != strictMethod)
+            return false;
+
+            // headers, from the files
+         const vector<string>& names(cr.getSources());
+         vector<RinexNavHeader> headers(names.size());
+         for(size_t i=0; i<names.size(); i++)
+         {
+            RinexNavStream strm(names[i].c_str());
+            strm.exceptions(ios::failbit);
+            try { strm >> headers[i]; }
+            catch (gpstk::Exception&) { return false; }
+            catch (std::exception&) { return false; }
+         }
+
+         readCache(cr);
+         FileStore<RinexNavHeader>::clear();
+         for(size_t i=0; i<names.size(); i++)
+            addFile(names[i], headers[i]);
+      }
+      catch (gpstk::Exception& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+      return true;
+   }  // end RinexEphemerisStore::loadCache
 
 
    //--------------------------------------------------------------------------
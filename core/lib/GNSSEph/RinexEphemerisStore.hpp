@@ -44,6 +44,8 @@
 #define GPSTK_RINEX_EPHEMERIS_STORE_HPP
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "GPSEphemerisStore.hpp"
 #include "FileStore.hpp"
@@ -80,6 +82,48 @@ namespace gpstk
          /// load the given Rinex file
       void loadFile(const std::string& filename) 
          throw(FileMissingException);
+
+         /** Load the given Rinex files, reading them on up to
+          * nthreads threads.  The records are added to the store in
+          * the order of the list, so the result, including the
+          * handling of duplicate and overlapping ephemerides, is the
+          * same as calling loadFile() on each file in turn.
+          * @param filenames files to load, in order
+          * @param nthreads number of reader threads, 0 for one per
+          *   hardware thread
+          * @throw FileMissingException as loadFile(); the files
+          *   preceding the failed one are loaded. */
+      void loadFiles(const std::vector<std::string>& filenames,
+                     unsigned nthreads = 0)
+         throw(FileMissingException);
+
+         /** Save the loaded ephemerides to a binary cache file, so
+          * that a later run can restore the store with loadCache()
+          * instead of reading the RINEX files again.  The cache
+          * records the size and modification time of each loaded
+          * file.
+          * @param filename name of the cache file, replaced if it
+          *   exists
+          * @throw Exception if a loaded file cannot be found or the
+          *   cache cannot be written */
+      void saveCache(const std::string& filename) const throw(Exception);
+
+         /** Replace the ephemerides and the file list with those of
+          * a cache file written by saveCache(), if it is valid:
+          * intact, and written from exactly these files in the order
+          * they were loaded, none of which has changed since, by a store
+          * with the same search method.  Otherwise the store is not
+          * changed.  The file headers are read again from the files;
+          * the data are not.
+          * @param filename name of the cache file
+          * @param filenames the RINEX navigation files the store
+          *   would otherwise be loaded from
+          * @return true if the store was loaded from the cache
+          * @throw Exception if a valid cache cannot be read, in
+          *   which case the store is cleared */
+      bool loadCache(const std::string& filename,
+                     const std::vector<std::string>& filenames)
+         throw(Exception);
    };
 
       //@}
@@ -43,6 +43,7 @@
 /// interpolation algorithm.
 
 #include <iostream>
+#include <exception>
 
 #include "Exception.hpp"
 #include "SatID.hpp"
@@ -58,6 +59,8 @@
 #include "Rinex3ClockData.hpp"
 
 #include "FileStore.hpp"
+#include "ParallelFor.hpp"
+#include "EphemerisCache.hpp"
 #include "ClockSatStore.hpp"
 #include "PositionSatStore.hpp"
 
@@ -113,6 +116,64 @@ namespace gpstk
    }
 
 
+   unsigned SP3EphemerisStore::getXvts(const vector<XvtQuery>& queries,
+                                       vector<Xvt>& xvts,
+                                       vector<XvtStatus>& status) const
+      throw()
+   {
+      unsigned nvalid(0);
+      xvts.resize(queries.size());
+      status.resize(queries.size());
+
+      bool present(false);
+      CommonTime tbeg, tend;
+      for(size_t i=0; i<queries.size(); i++) {
+         const SatID& sat(queries[i].first);
+         const CommonTime& ttag(queries[i].second);
+
+         status[i] = Failed;
+         try {
+            // time limits common to the position and clock tables of sat
+            if(i == 0 || !(sat == queries[i-1].first)) {
+               present = (posStore.ndata(sat) > 0 && clkStore.ndata(sat) > 0);
+               if(present) {
+                  tbeg = posStore.getInitialTime(sat);
+                  tend = posStore.getFinalTime(sat);
+                  CommonTime tc(clkStore.getInitialTime(sat));
+                  if(tc > tbeg) tbeg = tc;
+                  tc = clkStore.getFinalTime(sat);
+                  if(tc < tend) tend = tc;
+               }
+            }
+
+            if(!present || ttag < tbeg || ttag > tend)
+               status[i] = NotFound;
+            else if(i > 0 && status[i-1] == Valid && sat == queries[i-1].first
+                    && ttag == queries[i-1].second) {
+               xvts[i] = xvts[i-1];
+               status[i] = Valid;
+            }
+            else {
+               xvts[i] = getXvt(sat,ttag);
+               status[i] = Valid;
+            }
+         }
+         // too few records around ttag to interpolate
+         catch(InvalidRequest&) { status[i] = NotFound; }
+         catch(...) { status[i] = Failed; }
+
+         if(status[i] == Valid)
+            nvalid++;
+         else {
+            xvts[i] = Xvt();
+            xvts[i].health = Xvt::HealthStatus::Unavailable;
+         }
+      }
+
+      return nvalid;
+   }
+
+
    Xvt SP3EphemerisStore::computeXvt(const SatID& sat, const CommonTime& ttag)
       const throw()
    {
@@ -293,12 +354,70 @@ namespace gpstk
    }
 
 
-      // This is a private utility routine used by the loadFile and loadSP3File routines.
-      // Store position (velocity) and clock data from SP3 files in clock and position
-      // stores. Also update the FileStore with the filename and SP3 header.
-   void SP3EphemerisStore::loadSP3Store(const string& filename, bool fillClockStore)
-      throw(Exception)
+      // Contents of one SP3 or RINEX clock file, read by readFile() and then
+      // added to the store by storeFile().
+   struct SP3EphemerisStore::StagedFile
+   {
+      StagedFile() : isSP3(true), haveHeader(false), dataError(false) {}
+      bool isSP3;                            ///< SP3, else RINEX clock
+      bool haveHeader;                       ///< false if open or header failed
+      bool dataError;                        ///< error came from reading data
+      SP3Header sp3Head;
+      std::vector<SP3Data> sp3Data;
+      Rinex3ClockHeader clkHead;
+      std::vector<Rinex3ClockData> clkData;  ///< "AS" records only
+      std::exception_ptr error;              ///< error saved while reading
+   };
+
+
+      // Read an SP3 or RINEX clock file, determining the type as loadFile()
+      // does unless useSP3 is true.
+   void SP3EphemerisStore::readFile(const string& filename, bool useSP3,
+                                    StagedFile& sf)
+      throw()
    {
+      if(useSP3)
+      {
+         readSP3File(filename, sf);
+         return;
+      }
+
+         // must determine what kind of file it is
+      bool isSP3 = true;
+      try
+      {
+            // decide if the file is SP3
+         SP3Stream strm(filename.c_str(),std::ios::in);
+         if (strm)
+         {
+               // read the header
+            SP3Header header;
+            strm >> header;
+         }
+         if (!strm)
+         {
+            isSP3 = false;
+         }
+         strm.close();
+      }
+      catch(...)
+      {
+         sf.error = std::current_exception();
+         return;
+      }
+
+      if(isSP3)
+         readSP3File(filename, sf);
+      else
+         readRinexClockFile(filename, sf);
+   }
+
+
+      // Read the header and data records of an SP3 file.
+   void SP3EphemerisStore::readSP3File(const string& filename, StagedFile& sf)
+      throw()
+   {
+      sf.isSP3 = true;
       try
       {
             // open the input stream
@@ -309,22 +428,147 @@ namespace gpstk
             GPSTK_THROW(e);
          }
          strm.exceptions(ios::failbit);
-            //cout << "Opened file " << filename << endl;
-
-            // declare header and data
-         SP3Header head;
+         strm.memoryMap();
 
             // read the SP3 ephemeris header
          try
          {
-            strm >> head;
+            strm >> sf.sp3Head;
          }
          catch(Exception& e)
          {
             e.addText("Error reading header of file " + filename + e.getText());
             GPSTK_RETHROW(e);
          }
-            //cout << "Read header" << endl; head.dump();
+         sf.haveHeader = true;
+
+            // read data
+         try
+         {
+            SP3Data data;
+            while(strm >> data)
+            {
+               if (strm.eof())
+                  break;
+               sf.sp3Data.push_back(data);
+            }
+         }
+         catch(Exception& e)
+         {
+            sf.dataError = true;
+            throw;
+         }
+
+            // close
+         strm.close();
+      }
+      catch (Exception& e)
+      {
+         sf.error = std::current_exception();
+      }
+      catch (std::exception& e)
+      {
+         gpstk::Exception exc("std::exception " + std::string(e.what()));
+         exc.addLocation(FILE_LOCATION);
+         sf.error = std::make_exception_ptr(exc);
+      }
+      catch (...)
+      {
+         gpstk::Exception exc("Unknown exception");
+         exc.addLocation(FILE_LOCATION);
+         sf.error = std::make_exception_ptr(exc);
+      }
+   }
+
+
+      // Read the header and satellite clock ("AS") records of a RINEX clock file.
+   void SP3EphemerisStore::readRinexClockFile(const string& filename,
+                                              StagedFile& sf)
+      throw()
+   {
+      sf.isSP3 = false;
+      try
+      {
+            // open the input stream
+         Rinex3ClockStream strm(filename.c_str());
+         if(!strm.is_open())
+         {
+            Exception e("File " + filename + " could not be opened");
+            GPSTK_THROW(e);
+         }
+         strm.exceptions(std::ios::failbit);
+         strm.memoryMap();
+
+            // read the RINEX clock header
+         try
+         {
+            strm >> sf.clkHead;
+         }
+         catch(Exception& e)
+         {
+            e.addText("Error reading header of file " + filename);
+            GPSTK_RETHROW(e);
+         }
+         sf.haveHeader = true;
+
+            // read data
+         try
+         {
+            Rinex3ClockData data;
+            while(strm >> data)
+            {
+               if(data.datatype == std::string("AS"))
+                  sf.clkData.push_back(data);
+            }
+         }
+         catch(Exception& e)
+         {
+            sf.dataError = true;
+            throw;
+         }
+
+         strm.close();
+      }
+      catch(...)
+      {
+         sf.error = std::current_exception();
+      }
+   }
+
+
+      // Add the contents of a staged file to the store.
+   void SP3EphemerisStore::storeFile(const string& filename, StagedFile& sf)
+      throw(Exception)
+   {
+      try
+      {
+         if(sf.isSP3)
+            storeSP3File(filename, sf, useSP3clock);
+         else
+            storeRinexClockFile(filename, sf);
+      }
+      catch(Exception& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+   }
+
+
+      // Store position (velocity) and clock data from a staged SP3 file in the
+      // clock and position stores, and update the FileStore with the filename
+      // and SP3 header.
+   void SP3EphemerisStore::storeSP3File(const string& filename, StagedFile& sf,
+                                        bool fillClockStore)
+      throw(Exception)
+   {
+      try
+      {
+            // failed to open or read the header
+         if(!sf.haveHeader)
+            std::rethrow_exception(sf.error);
+
+         SP3Header& head(sf.sp3Head);
+
 
             // check/save TimeSystem to storeTimeSystem
          if(head.timeSystem != TimeSystem::Any &&
@@ -350,16 +594,17 @@ namespace gpstk
             }
          }  // end if header time system is set
 
+
             // save in FileStore
          SP3Files.addFile(filename, head);
+         fileOrder.push_back(filename);
 
-            // read data
+            // assemble records
          bool isC(head.version==SP3Header::SP3c);
          bool goNext,haveP,haveV,haveEP,haveEV,predP,predC;
          int i;
          CommonTime ttag;
          SatID sat;
-         SP3Data data;
          PositionRecord prec;
          ClockRecord crec;
 
@@ -376,19 +621,14 @@ namespace gpstk
             haveP = haveV = haveEP = haveEV = predP = predC = false;
             goNext = true;
 
-            while(strm >> data)
+            for(size_t k=0; k<sf.sp3Data.size(); k++)
             {
-                  //cout << "Read data " << data.RecType
-                  //<< " at " << printTime(data.time,"%Y %m %d %H %M %S") << endl;
+               const SP3Data& data(sf.sp3Data[k]);
 
                   // The SP3 doc says that records will be in order....
                   // use while to loop twice, if necessary: as soon as a RecType is
                   // repeated, the current records are output, then the loop
                   // returns to start filling the records again.
-                  //strm.dumpState();
-               if (strm.eof())
-                  break;
-               
                while(1)
                {
                   if(data.RecType == '*')
@@ -553,7 +793,11 @@ namespace gpstk
                }  // end while loop (loop twice)
             }  // end read loop
 
-            if(haveP || haveV)
+               // an error reading data ends the file here, as when streaming
+            if(sf.error && sf.dataError)
+               std::rethrow_exception(sf.error);
+
+            if(!sf.error && (haveP || haveV))
             {
                if(rejectBadPosFlag &&
                   (prec.Pos[0]==0.0 ||
@@ -585,123 +829,31 @@ namespace gpstk
             GPSTK_RETHROW(e);
          }
 
-            // close
-         strm.close();
-
+         if(sf.error)
+            std::rethrow_exception(sf.error);
       }
       catch (Exception& e)
       {
          GPSTK_RETHROW(e);
       }
-      catch (std::exception& e)
-      {
-         gpstk::Exception exc("std::exception " + std::string(e.what()));
-         GPSTK_THROW(exc);
-      }
-      catch (...)
-      {
-         gpstk::Exception exc("Unknown exception");
-         GPSTK_THROW(exc);
-      }
-   }
-
-      // Load an SP3 ephemeris file; if the clock store uses RINEX clock files,
-      // this routine will also accept that file type and load the data into the
-      // clock store. This routine will may set the velocity, acceleration, bias
-      // or drift 'have' flags.
-   void SP3EphemerisStore::loadFile(const string& filename) throw(Exception)
-   {
-      try
-      {
-            // if using only SP3, simply read the SP3
-         if(useSP3clock)
-         {
-            loadSP3Store(filename, true);
-            return;
-         }
-
-            // must determine what kind of file it is
-         bool isSP3 = true;
-
-            // decide if the file is SP3
-         SP3Stream strm(filename.c_str(),std::ios::in);
-         if (strm)
-         {
-               // read the header
-            SP3Header header;
-            strm >> header;
-         }
-         if (!strm)
-         {
-            isSP3 = false;
-         }
-         strm.close();
-
-            // call the appropriate load routine
-         if(isSP3)
-         {
-            loadSP3File(filename);
-         }
-         else
-         {
-            loadRinexClockFile(filename);
-         }
-
-      }
-      catch(Exception& e)
-      {
-         GPSTK_RETHROW(e);
-      }
    }
 
-      // Load an SP3 ephemeris file; may set the velocity and acceleration flags.
-      // If the clock store uses RINEX clock files, this ignores the clock data.
-   void SP3EphemerisStore::loadSP3File(const std::string& filename)
-      throw(Exception)
-   {
-      try
-      {
-         loadSP3Store(filename, useSP3clock);
-      }
-      catch(Exception& e)
-      {
-         GPSTK_RETHROW(e);
-      }
-   }
 
-      // Load a RINEX clock file; may set the 'have' bias and drift flags
-   void SP3EphemerisStore::loadRinexClockFile(const std::string& filename)
+      // Store clock data from a staged RINEX clock file in the clock store, and
+      // update the FileStore with the filename and header.
+   void SP3EphemerisStore::storeRinexClockFile(const string& filename,
+                                               StagedFile& sf)
       throw(Exception)
    {
       try
       {
          if(useSP3clock) useRinexClockData();
 
-            // open the input stream
-         Rinex3ClockStream strm(filename.c_str());
-         if(!strm.is_open())
-         {
-            Exception e("File " + filename + " could not be opened");
-            GPSTK_THROW(e);
-         }
-         strm.exceptions(std::ios::failbit);
-            //cout << "Opened file " << filename << endl;
-
-            // declare header and data
-         Rinex3ClockHeader head;
-         Rinex3ClockData data;
+            // failed to open or read the header
+         if(!sf.haveHeader)
+            std::rethrow_exception(sf.error);
 
-            // read the RINEX clock header
-         try
-         {
-            strm >> head;
-         }
-         catch(Exception& e)
-         {
-            e.addText("Error reading header of file " + filename);
-            GPSTK_RETHROW(e);
-         }
-            //cout << "Read header" << endl; head.dump();
+         Rinex3ClockHeader& head(sf.clkHead);
 
             // check/save TimeSystem to storeTimeSystem
          if(head.timeSystem != TimeSystem::Any &&
@@ -739,25 +891,25 @@ namespace gpstk
 
             // save in FileStore
          clkFiles.addFile(filename, head);
+         fileOrder.push_back(filename);
 
-            // read data
+            // add data
          try
          {
-            while(strm >> data)
+            for(size_t k=0; k<sf.clkData.size(); k++)
             {
-                  //data.dump(cout);
-
-               if(data.datatype == std::string("AS"))
-               {
-                  data.time.setTimeSystem(head.timeSystem);
-                     // add this data
-                  ClockRecord rec;
-                  rec.bias = data.bias; rec.sig_bias = data.sig_bias,
-                                           rec.drift = data.drift; rec.sig_drift = data.sig_drift,
-                                                                      rec.accel = data.accel; rec.sig_accel = data.sig_accel;
-                  clkStore.addClockRecord(data.sat, data.time, rec);
-               }
+               Rinex3ClockData& data(sf.clkData[k]);
+               data.time.setTimeSystem(head.timeSystem);
+                  // add this data
+               ClockRecord rec;
+               rec.bias = data.bias; rec.sig_bias = data.sig_bias;
+               rec.drift = data.drift; rec.sig_drift = data.sig_drift;
+               rec.accel = data.accel; rec.sig_accel = data.sig_accel;
+               clkStore.addClockRecord(data.sat, data.time, rec);
             }
+
+            if(sf.error && sf.dataError)
+               std::rethrow_exception(sf.error);
          }
          catch(Exception& e)
          {
@@ -765,8 +917,218 @@ namespace gpstk
             GPSTK_RETHROW(e);
          }
 
-         strm.close();
+         if(sf.error)
+            std::rethrow_exception(sf.error);
+      }
+      catch(Exception& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+   }
+
 
+      // This is a private utility routine used by the loadFile and loadSP3File routines.
+      // Store position (velocity) and clock data from SP3 files in clock and position
+      // stores. Also update the FileStore with the filename and SP3 header.
+   void SP3EphemerisStore::loadSP3Store(const string& filename, bool fillClockStore)
+      throw(Exception)
+   {
+      try
+      {
+         StagedFile sf;
+         readSP3File(filename, sf);
+         storeSP3File(filename, sf, fillClockStore);
+      }
+      catch (Exception& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+   }
+
+      // Load an SP3 ephemeris file; if the clock store uses RINEX clock files,
+      // this routine will also accept that file type and load the data into the
+      // clock store. This routine will may set the velocity, acceleration, bias
+      // or drift 'have' flags.
+   void SP3EphemerisStore::loadFile(const string& filename) throw(Exception)
+   {
+      try
+      {
+         StagedFile sf;
+         readFile(filename, useSP3clock, sf);
+         storeFile(filename, sf);
+      }
+      catch(Exception& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+   }
+
+      // Load SP3 and/or RINEX clock files, reading them in parallel. Files are
+      // read in windows of a few per thread, to bound the memory used for
+      // staging, and each window is added to the store in order. The file type
+      // decision depends on useSP3clock, which loading cannot change from false
+      // to true, so it is the same for every file of the list.
+   void SP3EphemerisStore::loadFiles(const vector<string>& filenames,
+                                     unsigned nthreads)
+      throw(Exception)
+   {
+      try
+      {
+         nthreads = parallelThreadCount(nthreads, filenames.size());
+         const size_t window(4*nthreads);
+         for(size_t beg=0; beg < filenames.size(); beg += window)
+         {
+            size_t n(std::min(window, filenames.size()-beg));
+            vector<StagedFile> staged(n);
+            const bool useSP3(useSP3clock);
+            parallelFor(n, nthreads, [&](size_t i)
+               { readFile(filenames[beg+i], useSP3, staged[i]); });
+            for(size_t i=0; i<n; i++)
+               storeFile(filenames[beg+i], staged[i]);
+         }
+      }
+      catch(Exception& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+   }
+
+      // Save the loaded data to a binary cache file
+   void SP3EphemerisStore::saveCache(const string& filename) const
+      throw(Exception)
+   {
+      try
+      {
+         EphemerisCacheWriter cw("SP3EphemerisStore");
+         size_t i;
+         for(i=0; i<fileOrder.size(); i++)
+            cw.addSource(fileOrder[i]);
+
+            // settings that change what is loaded
+         cw.put(useSP3clock);
+         cw.put(rejectBadPosFlag);
+         cw.put(rejectBadClockFlag);
+         cw.put(rejectPredPosFlag);
+         cw.put(rejectPredClockFlag);
+
+            // data
+         vector<string> sp3names(SP3Files.getFileNames());
+         for(i=0; i<fileOrder.size(); i++)
+            cw.put(binary_search(sp3names.begin(), sp3names.end(),
+                                 fileOrder[i]));
+         cw.put(static_cast<int>(storeTimeSystem.getTimeSystem()));
+         posStore.writeCache(cw);
+         clkStore.writeCache(cw);
+
+         cw.write(filename);
+      }
+      catch(Exception& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+   }
+
+      // Restore the store from a binary cache file, if it is valid
+   bool SP3EphemerisStore::loadCache(const string& filename,
+                                     const vector<string>& filenames)
+      throw(Exception)
+   {
+      EphemerisCacheReader cr;
+      if(!cr.open(filename, "SP3EphemerisStore", filenames))
+         return false;
+
+      try
+      {
+         bool sp3clk, badPos, badClk, predPos, predClk;
+         cr.get(sp3clk);
+         cr.get(badPos);
+         cr.get(badClk);
+         cr.get(predPos);
+         cr.get(predClk);
+         if(sp3clk != useSP3clock ||
+            badPos != rejectBadPosFlag || badClk != rejectBadClockFlag ||
+            predPos != rejectPredPosFlag || predClk != rejectPredClockFlag)
+            return false;
+
+            // headers, from the files
+         const vector<string>& names(cr.getSources());
+         FileStore<SP3Header> sp3fs;
+         FileStore<Rinex3ClockHeader> clkfs;
+         for(size_t i=0; i<names.size(); i++)
+         {
+            bool isSP3;
+            cr.get(isSP3);
+            StagedFile sf;
+            if(isSP3)
+            {
+               SP3Stream strm(names[i].c_str());
+               strm.exceptions(ios::failbit);
+               try { strm >> sf.sp3Head; }
+               catch(Exception&) { return false; }
+               catch(std::exception&) { return false; }
+               sp3fs.addFile(names[i], sf.sp3Head);
+            }
+            else
+            {
+               Rinex3ClockStream strm(names[i].c_str());
+               strm.exceptions(ios::failbit);
+               try { strm >> sf.clkHead; }
+               catch(Exception&) { return false; }
+               catch(std::exception&) { return false; }
+               clkfs.addFile(names[i], sf.clkHead);
+            }
+         }
+
+            // data
+         int ts;
+         cr.get(ts);
+         try
+         {
+            posStore.readCache(cr);
+            clkStore.readCache(cr);
+         }
+         catch(Exception& e)
+         {
+            clear();
+            GPSTK_RETHROW(e);
+         }
+         storeTimeSystem = TimeSystem(ts);
+         SP3Files = sp3fs;
+         clkFiles = clkfs;
+         fileOrder = names;
+      }
+      catch(Exception& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+      return true;
+   }
+
+
+      // Load an SP3 ephemeris file; may set the velocity and acceleration flags.
+      // If the clock store uses RINEX clock files, this ignores the clock data.
+   void SP3EphemerisStore::loadSP3File(const std::string& filename)
+      throw(Exception)
+   {
+      try
+      {
+         loadSP3Store(filename, useSP3clock);
+      }
+      catch(Exception& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+   }
+
+      // Load a RINEX clock file; may set the 'have' bias and drift flags
+   void SP3EphemerisStore::loadRinexClockFile(const std::string& filename)
+      throw(Exception)
+   {
+      try
+      {
+         StagedFile sf;
+         readRinexClockFile(filename, sf);
+         storeRinexClockFile(filename, sf);
       }
       catch(Exception& e)
       {
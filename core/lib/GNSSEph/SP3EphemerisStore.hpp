@@ -96,6 +96,9 @@ namespace gpstk
          /// FileStore for the (optional) RINEX clock input files
       FileStore<Rinex3ClockHeader> clkFiles;
 
+         /// The SP3 and RINEX clock files, in the order they were loaded
+      std::vector<std::string> fileOrder;
+
          /** flag indicating whether the clock store contains data
           * from SP3 (true, the default) or Rinex clock (false)
           * files */
@@ -132,6 +135,41 @@ namespace gpstk
       void loadSP3Store(const std::string& filename, bool fillClockStore)
          throw(Exception);
 
+         /** Contents of one SP3 or RINEX clock file, as read by
+          * readFile() for storing by storeFile(); defined in the
+          * implementation. */
+      struct StagedFile;
+
+         /** Read an SP3 or RINEX clock file into sf without touching
+          * the store, so that files may be read concurrently. Errors
+          * are saved in sf, to be thrown by storeFile().
+          * @param useSP3 if true, read as SP3, else determine the file
+          *   type as loadFile() does. */
+      static void readFile(const std::string& filename, bool useSP3,
+                           StagedFile& sf) throw();
+
+         /// Read an SP3 file into sf; see readFile().
+      static void readSP3File(const std::string& filename, StagedFile& sf)
+         throw();
+
+         /// Read a RINEX clock file into sf; see readFile().
+      static void readRinexClockFile(const std::string& filename,
+                                     StagedFile& sf) throw();
+
+         /** Add the contents of sf to the store, as loadSP3Store() or
+          * loadRinexClockFile() does, and throw any error saved while
+          * reading it at the point where those would have thrown it. */
+      void storeFile(const std::string& filename, StagedFile& sf)
+         throw(Exception);
+
+         /// Add the SP3 data of sf to the store; see storeFile().
+      void storeSP3File(const std::string& filename, StagedFile& sf,
+                        bool fillClockStore) throw(Exception);
+
+         /// Add the RINEX clock data of sf to the store; see storeFile().
+      void storeRinexClockFile(const std::string& filename, StagedFile& sf)
+         throw(Exception);
+
    public:
 
          /// Default constructor
@@ -160,6 +198,21 @@ namespace gpstk
       virtual Xvt getXvt(const SatID& sat, const CommonTime& ttag)
          const throw(InvalidRequest);
 
+         /** Batch version of getXvt(); see XvtStore::getXvts().  The
+          * time limits of the position and clock tables of each
+          * satellite are found once for each run of adjacent queries
+          * of that satellite, and queries outside them are rejected
+          * with status NotFound without an exception being thrown.
+          * Queries inside them with too few records to interpolate
+          * are also NotFound, as for the default getXvts().
+          * @param[in] queries list of (SatID, time) pairs
+          * @param[out] xvts results, resized to queries.size()
+          * @param[out] status outcome of each query
+          * @return the number of queries with status Valid */
+      virtual unsigned getXvts(const std::vector<XvtQuery>& queries,
+                               std::vector<Xvt>& xvts,
+                               std::vector<XvtStatus>& status) const throw();
+
          /** Compute the position, velocity and clock offset of the
           * indicated object in ECEF coordinates (meters) at the
           * indicated time.
@@ -350,7 +403,21 @@ namespace gpstk
       virtual void clearClock(void) throw()
       { clkStore.clear(); }
 
-   
+         /** Freeze the position and clock stores after all files are
+          * loaded, building flat time indexes that speed up the
+          * interpolation queries; see TabularSatStore::compact().
+          * Loading more data discards them. */
+      void compact(void) throw()
+      {
+         posStore.compact();
+         clkStore.compact();
+      }
+
+         /// Return true if both position and clock stores are compacted.
+      bool isCompacted(void) const throw()
+      { return (posStore.isCompacted() && clkStore.isCompacted()); }
+
+
          /** Choose to load the clock data tables from RINEX clock
           * files. This will clear the clock store; loadFile() or
           * loadRinexClockFile() should be called after this, to load
@@ -601,6 +668,57 @@ namespace gpstk
           * @throw if time step is inconsistent with previous value */
       void loadRinexClockFile(const std::string& filename) throw(Exception);
 
+         /** Load SP3 and/or RINEX clock files, reading them on up to
+          * nthreads threads.  The data are added to the store in the
+          * order of the list, so the result, including the handling
+          * of duplicate and overlapping records and the checks of
+          * time system and time step, is the same as calling
+          * loadFile() on each file in turn.
+          * @param filenames names of files (SP3 or RINEX clock format)
+          *   to load, in order
+          * @param nthreads number of reader threads, 0 for one per
+          *   hardware thread
+          * @throw as loadFile(); the files preceding the failed one
+          *   are loaded. */
+      void loadFiles(const std::vector<std::string>& filenames,
+                     unsigned nthreads = 0) throw(Exception);
+
+         /** Save the loaded data to a binary cache file, so that a
+          * later run can restore the store with loadCache() instead
+          * of reading the SP3 and RINEX clock files again.  The cache
+          * records the size and modification time of each loaded
+          * file, and the settings that affect loading (useSP3clock
+          * and the reject flags).
+          * @param filename name of the cache file, replaced if it
+          *   exists
+          * @throw Exception if a loaded file cannot be found or the
+          *   cache cannot be written */
+      void saveCache(const std::string& filename) const throw(Exception);
+
+         /** Replace the position and clock data and the file lists
+          * with those of a cache file written by saveCache(), if it
+          * is valid: intact, and written from exactly these files in
+          * the order they were loaded, none of which has changed since,
+          * with the same settings as this store.  Otherwise the
+          * store is not changed.  The file headers are read again
+          * from the files; the data are not.  For example
+          * @code
+          * if(!store.loadCache(cacheName, files))
+          * {
+          *    store.loadFiles(files);
+          *    store.saveCache(cacheName);
+          * }
+          * @endcode
+          * @param filename name of the cache file
+          * @param filenames the SP3 and RINEX clock files the store
+          *   would otherwise be loaded from
+          * @return true if the store was loaded from the cache
+          * @throw Exception if a valid cache cannot be read, in
+          *   which case the store is cleared */
+      bool loadCache(const std::string& filename,
+                     const std::vector<std::string>& filenames)
+         throw(Exception);
+
 
          /** Add a complete PositionRecord to the store; this is the
           * preferred method of adding data to the tables.
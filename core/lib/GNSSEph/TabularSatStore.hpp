@@ -43,6 +43,8 @@
 #define GPSTK_TABULAR_SAT_STORE_INCLUDE
 
 #include <map>
+#include <vector>
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 
@@ -128,6 +130,32 @@ namespace gpstk
 
       typedef typename DataTable::const_iterator DataTableIterator;
 
+         /** Flat, time-ordered index of the DataTable of one
+          * satellite, built by compact().  iters[i] points to the
+          * i-th entry of the table and secs[i] is its time in
+          * seconds relative to t0 (the first time in the table).  If
+          * the table spacing is uniform, step is that spacing and the
+          * index of a time is computed directly, otherwise it is
+          * found by a binary search of secs. */
+      struct FlatTable
+      {
+         std::vector<DataTableIterator> iters;
+         std::vector<double> secs;
+         CommonTime t0;
+         double step;
+         bool uniform;
+      };
+
+         /// std::map with key=SatID, value=FlatTable
+      typedef std::map<SatID, FlatTable> FlatSatTable;
+
+         /** Flat indexes of the data tables, valid only when
+          * compacted is true; see compact(). */
+      FlatSatTable flatTables;
+
+         /// True when flatTables is valid.
+      bool compacted;
+
          // member functions
    public:
          /// Default constructor
@@ -135,11 +163,96 @@ namespace gpstk
       : storeTimeSystem(TimeSystem::Any),
          havePosition(false), haveVelocity(false),
          haveClockBias(false), haveClockDrift(false),
-         checkDataGap(false), checkInterval(false)
+         checkDataGap(false), checkInterval(false),
+         compacted(false)
       {}
+
+         /** Copy constructor.  The flat indexes refer to the tables
+          * of the original, so they are rebuilt for the copy. */
+      TabularSatStore(const TabularSatStore& right) throw()
+      : tables(right.tables), storeTimeSystem(right.storeTimeSystem),
+         havePosition(right.havePosition), haveVelocity(right.haveVelocity),
+         haveClockBias(right.haveClockBias),
+         haveClockDrift(right.haveClockDrift),
+         checkDataGap(right.checkDataGap), gapInterval(right.gapInterval),
+         checkInterval(right.checkInterval), maxInterval(right.maxInterval),
+         compacted(false)
+      {
+         if(right.compacted)
+            compact();
+      }
+
+         /// Assignment operator; see the copy constructor.
+      TabularSatStore& operator=(const TabularSatStore& right) throw()
+      {
+         if(this == &right)
+            return *this;
+         uncompact();
+         tables = right.tables;
+         storeTimeSystem = right.storeTimeSystem;
+         havePosition = right.havePosition;
+         haveVelocity = right.haveVelocity;
+         haveClockBias = right.haveClockBias;
+         haveClockDrift = right.haveClockDrift;
+         checkDataGap = right.checkDataGap;
+         gapInterval = right.gapInterval;
+         checkInterval = right.checkInterval;
+         maxInterval = right.maxInterval;
+         if(right.compacted)
+            compact();
+         return *this;
+      }
+
          /// Destructor
       virtual ~TabularSatStore() {}
 
+         /** Freeze the store after loading: build, for each
+          * satellite, a flat time-ordered index of its data table,
+          * so that getTableInterval() and
+          * getNonCenteredTableInterval() locate a time with an O(1)
+          * index computation (uniform table spacing) or a binary
+          * search of a contiguous array, rather than by walking the
+          * map.  Results of all queries are unchanged.  Adding data
+          * to the store, edit() and clear() discard the flat
+          * indexes; call compact() again when loading is done. */
+      void compact() throw()
+      {
+         flatTables.clear();
+         typename SatTable::const_iterator it;
+         for(it=tables.begin(); it!=tables.end(); ++it)
+         {
+            const DataTable& dtab(it->second);
+            if(dtab.empty())
+               continue;
+
+            FlatTable& flat(flatTables[it->first]);
+            flat.iters.reserve(dtab.size());
+            flat.secs.reserve(dtab.size());
+            flat.t0 = dtab.begin()->first;
+            DataTableIterator jt;
+            for(jt=dtab.begin(); jt!=dtab.end(); ++jt)
+            {
+               flat.iters.push_back(jt);
+               flat.secs.push_back(jt->first - flat.t0);
+            }
+
+               // uniform if every step matches the first to 1 msec
+            const size_t n(flat.secs.size());
+            flat.step = (n > 1 ? flat.secs[1] : 0.0);
+            flat.uniform = (flat.step > 0.0);
+            for(size_t i=2; flat.uniform && i<n; i++)
+            {
+               if(std::fabs(flat.secs[i]-flat.secs[i-1]-flat.step) > 1.e-3)
+                  flat.uniform = false;
+            }
+         }
+         compacted = true;
+      }
+
+         /// Return true if the store has been compacted; see compact().
+      bool isCompacted() const throw()
+      { return compacted; }
+
          /** Return data value for the given satellite at the given
           * time (usually via interpolation of the data table).
           * @param[in] sat the SatID of the satellite of interest
@@ -172,6 +285,55 @@ namespace gpstk
       virtual DataRecord getValue(const SatID& sat, const CommonTime& ttag)
          const throw(InvalidRequest) = 0;
 
+   protected:
+         /** Discard the flat indexes built by compact(); derived
+          * classes must call this before adding entries to tables. */
+      void uncompact() throw()
+      {
+         if(compacted)
+         {
+            flatTables.clear();
+            compacted = false;
+         }
+      }
+
+         /** Find, using the flat index of a satellite, the position
+          * of the first table entry with time >= ttag, i.e. the
+          * index equivalent of DataTable::lower_bound(ttag).
+          * @param[in] flat flat index of the satellite's table
+          * @param[in] ttag time of interest
+          * @param[out] exactMatch true if the entry at the returned
+          *   index has time equal to ttag
+          * @return index in [0,flat.iters.size()] */
+      static size_t flatLowerBound(const FlatTable& flat,
+                                   const CommonTime& ttag,
+                                   bool& exactMatch)
+      {
+         const size_t n(flat.iters.size());
+         const double dt(ttag - flat.t0);
+         size_t i;
+         if(dt <= 0.0)
+            i = 0;
+         else if(flat.uniform)
+         {
+            double x(std::ceil(dt/flat.step - 1.e-6));
+            i = (x >= double(n) ? n : size_t(x));
+         }
+         else
+            i = std::lower_bound(flat.secs.begin(), flat.secs.end(), dt)
+               - flat.secs.begin();
+
+            // the guess is within roundoff; settle it with CommonTime
+         while(i > 0 && !(flat.iters[i-1]->first < ttag))
+            --i;
+         while(i < n && flat.iters[i]->first < ttag)
+            ++i;
+
+         exactMatch = (i < n && !(ttag < flat.iters[i]->first));
+         return i;
+      }
+
+   public:
          /** Locate the given time in the DataTable for the given
           * satellite.  Return two const iterators it1 and it2
           * (it1<it2) giving the range of 2*nhalf points, nhalf on
@@ -243,6 +405,12 @@ namespace gpstk
                GPSTK_THROW(e);
             }
 
+               // use the flat index if the store has been compacted
+            if(compacted)
+               return getFlatTableInterval(sat, flatTables.find(sat)->second,
+                                           ttag, nhalf, it1, it2,
+                                           exactReturn);
+
                // find the timetag in this table
 
                /** @note throw here if time systems do not match and
@@ -371,6 +539,132 @@ namespace gpstk
          }
       }
 
+   protected:
+         /** Implementation of getTableInterval() using the flat index
+          * of the satellite's table, built by compact(); the logic,
+          * results and exceptions are identical to those of the
+          * map-based search in getTableInterval(), but the
+          * interval is located and expanded by index arithmetic.
+          * @param[in] sat satellite of interest
+          * @param[in] flat flat index for sat, size >= 2
+          * @param[in] ttag, nhalf, it1, it2, exactReturn see
+          *   getTableInterval() */
+      bool getFlatTableInterval(const SatID& sat,
+                                const FlatTable& flat,
+                                const CommonTime& ttag,
+                                const int& nhalf,
+                                typename DataTable::const_iterator& it1,
+                                typename DataTable::const_iterator& it2,
+                                bool exactReturn)
+         const throw(InvalidRequest)
+      {
+         static const char *fmt=
+            " at time %F/%.3g %4Y/%02m/%02d %2H:%02M:%.3f %P";
+         const std::vector<DataTableIterator>& iters(flat.iters);
+         const size_t n(iters.size());
+
+         bool exactMatch;
+         size_t i2(flatLowerBound(flat, ttag, exactMatch));
+         if(exactMatch && exactReturn)
+         {
+            it1 = iters[i2];
+            return true;
+         }
+
+         if(i2 == n)
+         {
+            InvalidRequest e("No data in time range for satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
+
+            // ttag is <= first time in table
+         if(i2 == 0)
+         {
+            if(exactMatch && nhalf==1)
+            {
+               it1 = iters[0];
+               it2 = iters[1];
+               return exactMatch;
+            }
+            InvalidRequest e("Inadequate data before(1) requested time for"
+                             " satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
+
+         size_t i1(i2-1);
+         if(i1 == 0)
+         {
+            if(nhalf==1)
+            {
+               it1 = iters[0];
+               it2 = iters[1];
+               return exactMatch;
+            }
+            InvalidRequest e("Inadequate data before(2) requested time for"
+                             " satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
+
+         if(checkDataGap && (iters[i2]->first-iters[i1]->first) > gapInterval)
+         {
+            InvalidRequest e("Gap at interpolation time for satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
+
+            // now expand the interval to include 2*nhalf timesteps
+         for(int k=0; k<nhalf-1; k++)
+         {
+            bool last(k==nhalf-2);
+            if(--i1 == 0 && !last)
+            {
+               InvalidRequest
+                  e("Inadequate data before(3) requested time for"
+                    " satellite " + gpstk::StringUtils::asString(sat) +
+                    printTime(ttag,fmt));
+               GPSTK_THROW(e);
+            }
+
+            if(++i2 == n)
+            {
+               if(exactMatch && last && i1 != 0)
+               {
+                  i2--;
+                  i1--;
+               }
+               else
+               {
+                  InvalidRequest
+                     e("Inadequate data after(2) requested time for"
+                       " satellite " + gpstk::StringUtils::asString(sat) +
+                       printTime(ttag,fmt));
+                  GPSTK_THROW(e);
+               }
+            }
+         }
+
+         if(checkInterval && (iters[i2]->first-iters[i1]->first) > maxInterval)
+         {
+            InvalidRequest e("Interpolation interval too large for"
+                             " satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
+
+         it1 = iters[i1];
+         it2 = iters[i2];
+         return exactMatch;
+      }
+
+   public:
          /** Version of getTableInterval() which does not require the
           * time of interest to lie in the center of the interval,
           * with nhalf points on either side.  (See getTableInterval()
@@ -441,9 +735,19 @@ namespace gpstk
                // find the timetag in this table
                /** @note throw here if time systems do not match and
                 * are not "Any" */
-            it1 = dtable.find(ttag);
-               // is it an exact match?
-            bool exactMatch(it1 != dtable.end());
+            bool exactMatch;
+            if(compacted && !dtable.empty())
+            {
+               const FlatTable& flat(flatTables.find(sat)->second);
+               size_t i(flatLowerBound(flat, ttag, exactMatch));
+               it1 = (i < flat.iters.size() ? flat.iters[i] : dtable.end());
+            }
+            else
+            {
+               it1 = dtable.find(ttag);
+                  // is it an exact match?
+               exactMatch = (it1 != dtable.end());
+            }
 
                // user must decide whether to return with exact value;
                // e.g. without velocity data, user needs the interval
@@ -452,7 +756,9 @@ namespace gpstk
                return true;
 
                // lower_bound points to the first element with key >= ttag
-            it1 = it2 = dtable.lower_bound(ttag);
+            if(!compacted || dtable.empty())
+               it1 = dtable.lower_bound(ttag);
+            it2 = it1;
 
                // Should we allow to predict data?
             if(it1 == dtable.end())
@@ -651,6 +957,8 @@ namespace gpstk
                 const CommonTime& tmax = CommonTime::END_OF_TIME)
          throw()
       {
+         uncompact();
+
             // loop over satellites
          typename SatTable::iterator it;
          for(it=tables.begin(); it!=tables.end(); it++)
@@ -678,6 +986,7 @@ namespace gpstk
          /// Remove all data and reset time limits
       inline void clear() throw()
       {
+         uncompact();
          typename std::map<SatID, DataTable>::iterator satit;
          for(satit=tables.begin(); satit!=tables.end(); ++satit)
             satit->second.clear();
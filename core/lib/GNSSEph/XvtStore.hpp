@@ -45,6 +45,8 @@
 
 #include <iostream>
 #include <set>
+#include <vector>
+#include <utility>
 
 #include "Exception.hpp"
 #include "CommonTime.hpp"
@@ -62,6 +64,18 @@ namespace gpstk
    class XvtStore
    {
    public:
+         /// Outcome of each query in the batch getXvts().
+      enum XvtStatus
+      {
+         Valid,      ///< The Xvt was computed, as getXvt() would return it.
+         NotFound,   ///< No data for the object at the requested time.
+         Unhealthy,  ///< onlyHealthy is set and the object is unhealthy.
+         Failed      ///< The Xvt could not be computed for another reason.
+      };
+
+         /// One query for getXvts(): the object and the time of interest.
+      typedef std::pair<IndexType, CommonTime> XvtQuery;
+
       virtual ~XvtStore()
       {}
 
@@ -75,6 +89,66 @@ namespace gpstk
          ///    information as to why the request failed.
       virtual Xvt getXvt(const IndexType& id, const CommonTime& t) const = 0;
 
+         /** Batch version of getXvt(), computing the position,
+          * velocity and clock offset for each of a list of (object,
+          * time) queries, for example every satellite at one or
+          * more epochs.  Instead of throwing, the outcome of each
+          * query is returned in status; where status[i] != Valid,
+          * xvts[i] is a default Xvt with health Unavailable.  This
+          * implementation simply calls getXvt() for each query, and
+          * when that throws InvalidRequest uses computeXvt() to tell
+          * an unhealthy object (Unhealthy) from missing data
+          * (NotFound); derived stores override it to amortize lookups
+          * over the whole batch, in which case queries for the same
+          * object should be adjacent and in time order for best
+          * effect.
+          * @param[in] queries list of (object, time) pairs
+          * @param[out] xvts results, resized to queries.size()
+          * @param[out] status outcome of each query, resized to
+          *   queries.size()
+          * @return the number of queries with status Valid */
+      virtual unsigned getXvts(const std::vector<XvtQuery>& queries,
+                               std::vector<Xvt>& xvts,
+                               std::vector<XvtStatus>& status) const throw()
+      {
+         unsigned nvalid(0);
+         xvts.resize(queries.size());
+         status.resize(queries.size());
+         for(size_t i=0; i<queries.size(); i++)
+         {
+            status[i] = Failed;
+            try
+            {
+               if(!isPresent(queries[i].first))
+                  status[i] = NotFound;
+               else
+               {
+                  xvts[i] = getXvt(queries[i].first, queries[i].second);
+                  status[i] = Valid;
+                  nvalid++;
+               }
+            }
+            catch(InvalidRequest&)
+            {
+                  // getXvt() refuses unhealthy data when onlyHealthy
+                  // is set, but computeXvt() ignores that flag
+               Xvt::HealthStatus health(
+                  computeXvt(queries[i].first, queries[i].second).health);
+               status[i] = (health == Xvt::HealthStatus::Unhealthy
+                            ? Unhealthy : NotFound);
+            }
+            catch(...)
+            {
+            }
+            if(status[i] != Valid)
+            {
+               xvts[i] = Xvt();
+               xvts[i].health = Xvt::HealthStatus::Unavailable;
+            }
+         }
+         return nvalid;
+      }
+
          /** Compute the position, velocity and clock offset of the
           * indicated object in ECEF coordinates (meters) at the
           * indicated time.
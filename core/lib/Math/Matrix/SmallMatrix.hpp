@@ -0,0 +1,393 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file SmallMatrix.hpp
+/// Matrix and vector classes with dimensions fixed at compile time, and
+/// Cholesky and LDLT solvers for them, for small problems in inner loops.
+
+#ifndef GPSTK_SMALL_MATRIX_HPP
+#define GPSTK_SMALL_MATRIX_HPP
+
+#include "Matrix.hpp"
+
+namespace gpstk
+{
+
+      /// @ingroup MathGroup
+      //@{
+
+      /**
+       * A vector of N elements held in a fixed array, so that it
+       * never allocates.  It may be used wherever a ConstVectorBase
+       * or RefVectorBase is accepted, and converts to and from
+       * Vector<T>.
+       */
+   template <class T, size_t N>
+   class SmallVector : public RefVectorBase<T, SmallVector<T,N> >
+   {
+   public:
+         /// Default constructor; all elements are zero.
+      SmallVector()
+      { for(size_t i=0; i<N; i++) v[i] = T(0); }
+
+         /// Constructor with all elements set to initialValue.
+      explicit SmallVector(const T initialValue)
+      { for(size_t i=0; i<N; i++) v[i] = initialValue; }
+
+         /// Copy from any vector of length N.
+      template <class E>
+      SmallVector(const ConstVectorBase<T, E>& x) throw(VectorException)
+      { assign(x); }
+
+         /// Copy from any vector of length N.
+      template <class E>
+      SmallVector& operator=(const ConstVectorBase<T, E>& x)
+         throw(VectorException)
+      { assign(x); return *this; }
+
+         /// Set all elements to t.
+      SmallVector& operator=(const T t)
+      { for(size_t i=0; i<N; i++) v[i] = t; return *this; }
+
+         /// The number of elements, N.
+      size_t size() const { return N; }
+
+         /// Non-const element i.
+      T& operator[] (size_t i) { return v[i]; }
+         /// Const element i.
+      T operator[] (size_t i) const { return v[i]; }
+         /// Non-const element i.
+      T& operator() (size_t i) { return v[i]; }
+         /// Const element i.
+      T operator() (size_t i) const { return v[i]; }
+
+   private:
+      template <class E>
+      void assign(const ConstVectorBase<T, E>& x) throw(VectorException)
+      {
+         if(x.size() != N) {
+            VectorException e("Invalid length for SmallVector assignment");
+            GPSTK_THROW(e);
+         }
+         for(size_t i=0; i<N; i++) v[i] = x[i];
+      }
+
+      T v[N];
+   };
+
+      /**
+       * An R by C matrix held in a fixed array, so that it never
+       * allocates.  It may be used wherever a ConstMatrixBase or
+       * RefMatrixBase is accepted, and converts to and from
+       * Matrix<T>; e.g.
+       * @code
+       * SmallMatrix<double,4,4> N(PTP);     // from a Matrix, 4x4 only
+       * Matrix<double> Cov(N);              // back to a Matrix
+       * @endcode
+       */
+   template <class T, size_t R, size_t C>
+   class SmallMatrix : public RefMatrixBase<T, SmallMatrix<T,R,C> >
+   {
+   public:
+         /// Default constructor; all elements are zero.
+      SmallMatrix()
+      { for(size_t i=0; i<R*C; i++) m[i] = T(0); }
+
+         /// Constructor with all elements set to initialValue.
+      explicit SmallMatrix(const T initialValue)
+      { for(size_t i=0; i<R*C; i++) m[i] = initialValue; }
+
+         /// Copy from any R by C matrix.
+      template <class E>
+      SmallMatrix(const ConstMatrixBase<T, E>& x) throw(MatrixException)
+      { assign(x); }
+
+         /// Copy from any R by C matrix.
+      template <class E>
+      SmallMatrix& operator=(const ConstMatrixBase<T, E>& x)
+         throw(MatrixException)
+      { assign(x); return *this; }
+
+         /// Set all elements to t.
+      SmallMatrix& operator=(const T t)
+      { for(size_t i=0; i<R*C; i++) m[i] = t; return *this; }
+
+         /// The number of elements, R*C.
+      size_t size() const { return R*C; }
+         /// The number of rows, R.
+      size_t rows() const { return R; }
+         /// The number of columns, C.
+      size_t cols() const { return C; }
+
+         /// Non-const element (i,j).
+      T& operator() (size_t i, size_t j) { return m[i*C+j]; }
+         /// Const element (i,j).
+      T operator() (size_t i, size_t j) const { return m[i*C+j]; }
+
+   private:
+      template <class E>
+      void assign(const ConstMatrixBase<T, E>& x) throw(MatrixException)
+      {
+         if(x.rows() != R || x.cols() != C) {
+            MatrixException e("Invalid dimensions for SmallMatrix assignment");
+            GPSTK_THROW(e);
+         }
+         for(size_t i=0; i<R; i++)
+            for(size_t j=0; j<C; j++)
+               m[i*C+j] = x(i,j);
+      }
+
+         /// the elements, in row major order
+      T m[R*C];
+   };
+
+      /// Matrix product of two SmallMatrix.
+   template <class T, size_t R, size_t K, size_t C>
+   inline SmallMatrix<T,R,C> operator*(const SmallMatrix<T,R,K>& l,
+                                       const SmallMatrix<T,K,C>& r)
+   {
+      SmallMatrix<T,R,C> p;
+      for(size_t i=0; i<R; i++)
+         for(size_t k=0; k<K; k++) {
+            const T lik(l(i,k));
+            for(size_t j=0; j<C; j++)
+               p(i,j) += lik*r(k,j);
+         }
+      return p;
+   }
+
+      /// Product of a SmallMatrix and a SmallVector.
+   template <class T, size_t R, size_t C>
+   inline SmallVector<T,R> operator*(const SmallMatrix<T,R,C>& l,
+                                     const SmallVector<T,C>& r)
+   {
+      SmallVector<T,R> p;
+      for(size_t i=0; i<R; i++)
+         for(size_t j=0; j<C; j++)
+            p(i) += l(i,j)*r(j);
+      return p;
+   }
+
+      /// Transpose of a SmallMatrix.
+   template <class T, size_t R, size_t C>
+   inline SmallMatrix<T,C,R> transpose(const SmallMatrix<T,R,C>& m)
+   {
+      SmallMatrix<T,C,R> t;
+      for(size_t i=0; i<R; i++)
+         for(size_t j=0; j<C; j++)
+            t(j,i) = m(i,j);
+      return t;
+   }
+
+      /**
+       * Cholesky decomposition A = L*transpose(L) of a symmetric,
+       * positive definite SmallMatrix, with the solution of A*x=b and
+       * the inverse of A.  Only the lower triangle of A is used.
+       * Unlike Cholesky<T>, this never allocates.
+       */
+   template <class T, size_t N>
+   class SmallCholesky
+   {
+   public:
+         /** Decompose A.
+          * @throw SingularMatrixException if A is not positive
+          *   definite (a pivot is <= 0). */
+      void operator() (const SmallMatrix<T,N,N>& A)
+         throw(SingularMatrixException)
+      {
+         size_t i,j,k;
+         for(j=0; j<N; j++) {
+            T d(A(j,j));
+            for(k=0; k<j; k++) d -= L(j,k)*L(j,k);
+            if(d <= T(0)) {
+               SingularMatrixException e("SmallCholesky fails - eigenvalue <= 0");
+               GPSTK_THROW(e);
+            }
+            L(j,j) = SQRT(d);
+            const T inv(T(1)/L(j,j));
+            for(i=j+1; i<N; i++) {
+               T s(A(i,j));
+               for(k=0; k<j; k++) s -= L(i,k)*L(j,k);
+               L(i,j) = s*inv;
+            }
+            for(i=0; i<j; i++) L(i,j) = T(0);
+         }
+      }
+
+         /// Solve A*x=b by back substitution; x is returned as b.
+      void backSub(SmallVector<T,N>& b) const
+      {
+         size_t i,k;
+         for(i=0; i<N; i++) {             // L*y = b
+            for(k=0; k<i; k++) b(i) -= L(i,k)*b(k);
+            b(i) /= L(i,i);
+         }
+         for(i=N; i-- > 0; ) {            // LT*x = y
+            for(k=i+1; k<N; k++) b(i) -= L(k,i)*b(k);
+            b(i) /= L(i,i);
+         }
+      }
+
+         /// Return the inverse of A.
+      SmallMatrix<T,N,N> inverse() const
+      {
+         SmallMatrix<T,N,N> inv;
+         SmallVector<T,N> col;
+         for(size_t j=0; j<N; j++) {
+            col = T(0);
+            col(j) = T(1);
+            backSub(col);
+            for(size_t i=0; i<N; i++) inv(i,j) = col(i);
+         }
+         return inv;
+      }
+
+         /** Rank-one update: replace the decomposition of A with that of
+          * A + x*transpose(x), in O(N^2) operations. */
+      void update(SmallVector<T,N> x)
+      {
+         for(size_t k=0; k<N; k++) {
+            const T r(SQRT(L(k,k)*L(k,k) + x(k)*x(k)));
+            const T c(r/L(k,k)), s(x(k)/L(k,k));
+            L(k,k) = r;
+            for(size_t i=k+1; i<N; i++) {
+               L(i,k) = (L(i,k) + s*x(i))/c;
+               x(i) = c*x(i) - s*L(i,k);
+            }
+         }
+      }
+
+         /** Rank-one downdate: replace the decomposition of A with that
+          * of A - x*transpose(x), in O(N^2) operations.
+          * @throw SingularMatrixException if the result is not
+          *   positive definite, in which case L is undefined. */
+      void downdate(SmallVector<T,N> x) throw(SingularMatrixException)
+      {
+         for(size_t k=0; k<N; k++) {
+            const T r2(L(k,k)*L(k,k) - x(k)*x(k));
+            if(r2 <= T(0)) {
+               SingularMatrixException e("SmallCholesky downdate fails - eigenvalue <= 0");
+               GPSTK_THROW(e);
+            }
+            const T r(SQRT(r2));
+            const T c(r/L(k,k)), s(x(k)/L(k,k));
+            L(k,k) = r;
+            for(size_t i=k+1; i<N; i++) {
+               L(i,k) = (L(i,k) - s*x(i))/c;
+               x(i) = c*x(i) - s*L(i,k);
+            }
+         }
+      }
+
+         /// Lower triangular factor
+      SmallMatrix<T,N,N> L;
+   };
+
+      /**
+       * LDLT decomposition A = L*D*transpose(L) of a symmetric,
+       * positive definite SmallMatrix, where L is unit lower
+       * triangular and D is diagonal; it avoids the square roots of
+       * SmallCholesky.  Only the lower triangle of A is used.
+       */
+   template <class T, size_t N>
+   class SmallLDLT
+   {
+   public:
+         /** Decompose A.
+          * @throw SingularMatrixException if A is not positive
+          *   definite (an element of D is <= 0). */
+      void operator() (const SmallMatrix<T,N,N>& A)
+         throw(SingularMatrixException)
+      {
+         size_t i,j,k;
+         SmallVector<T,N> LD;             // row j of L times D
+         for(j=0; j<N; j++) {
+            T d(A(j,j));
+            for(k=0; k<j; k++) {
+               LD(k) = L(j,k)*D(k);
+               d -= LD(k)*L(j,k);
+            }
+            if(d <= T(0)) {
+               SingularMatrixException e("SmallLDLT fails - eigenvalue <= 0");
+               GPSTK_THROW(e);
+            }
+            D(j) = d;
+            L(j,j) = T(1);
+            for(i=j+1; i<N; i++) {
+               T s(A(i,j));
+               for(k=0; k<j; k++) s -= L(i,k)*LD(k);
+               L(i,j) = s/d;
+            }
+            for(i=0; i<j; i++) L(i,j) = T(0);
+         }
+      }
+
+         /// Solve A*x=b by back substitution; x is returned as b.
+      void backSub(SmallVector<T,N>& b) const
+      {
+         size_t i,k;
+         for(i=0; i<N; i++)               // L*y = b
+            for(k=0; k<i; k++) b(i) -= L(i,k)*b(k);
+         for(i=0; i<N; i++) b(i) /= D(i); // D*z = y
+         for(i=N; i-- > 0; )              // LT*x = z
+            for(k=i+1; k<N; k++) b(i) -= L(k,i)*b(k);
+      }
+
+         /// Return the inverse of A.
+      SmallMatrix<T,N,N> inverse() const
+      {
+         SmallMatrix<T,N,N> inv;
+         SmallVector<T,N> col;
+         for(size_t j=0; j<N; j++) {
+            col = T(0);
+            col(j) = T(1);
+            backSub(col);
+            for(size_t i=0; i<N; i++) inv(i,j) = col(i);
+         }
+         return inv;
+      }
+
+         /// Unit lower triangular factor
+      SmallMatrix<T,N,N> L;
+         /// Diagonal factor
+      SmallVector<T,N> D;
+   };
+
+      //@}
+
+}  // namespace
+
+#endif
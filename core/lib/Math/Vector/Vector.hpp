@@ -77,10 +77,10 @@ namespace gpstk
       typedef const T* const_iterator;
 
          /// Default constructor
-      Vector() : v(NULL), s(0)
+      Vector() : v(NULL), s(0), c(0)
       {}
          /// Constructor given an initial size.
-      Vector(size_t siz) : v(NULL), s(siz)
+      Vector(size_t siz) : v(NULL), s(siz), c(siz)
       {
          if (siz>0)
          {
@@ -95,7 +95,7 @@ namespace gpstk
           * Constructor given an initial size and default value for
           * all elements.
           */
-      Vector(size_t siz, const T defaultValue) : v(NULL), s(siz)
+      Vector(size_t siz, const T defaultValue) : v(NULL), s(siz), c(siz)
       {
          if (siz>0)
          {
@@ -111,7 +111,8 @@ namespace gpstk
           * Copy constructor from a ConstVectorBase type.
           */
       template <class E>
-      Vector(const ConstVectorBase<T, E>& r) : v(NULL), s(r.size())
+      Vector(const ConstVectorBase<T, E>& r)
+            : v(NULL), s(r.size()), c(r.size())
       {
          if (r.size()>0)
          {
@@ -126,7 +127,7 @@ namespace gpstk
          /**
           * Copy constructor.
           */
-      Vector(const Vector& r) : v(NULL), s(r.s)
+      Vector(const Vector& r) : v(NULL), s(r.s), c(r.s)
       {
          if (r.s>0)
          {
@@ -141,7 +142,7 @@ namespace gpstk
          /**
           * Valarray constructor
           */
-      Vector(const std::valarray<T>& r) : v(NULL), s(r.size())
+      Vector(const std::valarray<T>& r) : v(NULL), s(r.size()), c(r.size())
       {
          if (r.size())
          {
@@ -158,7 +159,7 @@ namespace gpstk
       template <class E>
       Vector(const ConstVectorBase<T, E>& vec,
              size_t top,
-             size_t num) : v(NULL), s(0)
+             size_t num) : v(NULL), s(0), c(0)
       {
             // sanity checks...
          if ( top >= vec.size() || 
@@ -177,7 +178,7 @@ namespace gpstk
             size_t i;
             for(i = 0; i < num; i++)
                v[i] = vec(top+i);
-            s = num;
+            s = c = num;
          }
       }
    
@@ -255,11 +256,13 @@ namespace gpstk
          return (*this); 
       }
 
-         /// Resizes the vector.  if index > size, the vector will be
-         /// erased and the contents destroyed.
+         /// Resizes the vector.  if index > the largest size the vector
+         /// has had, the vector will be erased and the contents destroyed;
+         /// otherwise the storage is reused, so that resizing a vector
+         /// back and forth does not allocate.
       Vector& resize(const size_t index)
       { 
-         if (index > s)
+         if (index > c)
          {
             if (v)
                delete [] v;
@@ -268,6 +271,7 @@ namespace gpstk
                VectorException e("Vector.resize(size_t) failed to allocate");
                GPSTK_THROW(e);
             }
+            c = index;
          }
          s = index;
          return *this;
@@ -368,6 +372,8 @@ namespace gpstk
       T* v;
          /// The size of the vector.
       size_t s;
+         /// The number of elements allocated, >= s.
+      size_t c;
    };
       // end class Vector<T>
 
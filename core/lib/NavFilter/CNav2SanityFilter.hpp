@@ -76,6 +76,10 @@ namespace gpstk
          /// Return the filter name.
       virtual std::string filterName() const throw()
       { return "CNav2Sanity"; }
+
+         /// Each message is checked on its own.
+      virtual Sharding sharding() const throw()
+      { return shardSignal; }
    };
 
       //@}
@@ -83,6 +83,11 @@ namespace gpstk
       virtual std::string filterName() const throw()
       { return "CrossSource"; }
 
+         /** Subframes are only compared with others from the same
+          * PRN, so instances may be divided by PRN. */
+      virtual Sharding sharding() const throw()
+      { return shardPRN; }
+
       virtual void setMinIdentical(const unsigned value)
       { minIdentical = value;}
 
@@ -98,9 +103,13 @@ namespace gpstk
 
    protected:
          /// Map from subframe data to source list
-      typedef std::map<CNavFilterData*, NavMsgList, CNavMsgSort> MessageMap;
+      typedef std::map<CNavFilterData*, NavMsgList, CNavMsgSort,
+                       NavPoolAllocator<std::pair<CNavFilterData* const,
+                                                  NavMsgList> > > MessageMap;
          /// Map from PRN to SubframeMap
-      typedef std::map<uint32_t, MessageMap> NavMap;
+      typedef std::map<uint32_t, MessageMap, std::less<uint32_t>,
+                       NavPoolAllocator<std::pair<const uint32_t,
+                                                  MessageMap> > > NavMap;
 
          /// Nav subframes grouped by prn and unique nav bits
       NavMap groupedNav;
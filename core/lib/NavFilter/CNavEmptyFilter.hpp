@@ -74,6 +74,10 @@ namespace gpstk
          /// Return the filter name.
       virtual std::string filterName() const throw()
       { return "Empty"; }
+
+         /// Each message is checked on its own.
+      virtual Sharding sharding() const throw()
+      { return shardSignal; }
    };
 
       //@}
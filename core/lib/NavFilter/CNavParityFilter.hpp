@@ -72,6 +72,10 @@ namespace gpstk
          /// Return the filter name.
       virtual std::string filterName() const throw()
       { return "CRC"; }
+
+         /// Each message is checked on its own.
+      virtual Sharding sharding() const throw()
+      { return shardSignal; }
    };
 
       //@}
@@ -75,6 +75,10 @@ namespace gpstk
       virtual std::string filterName() const throw()
       { return "AlmVal"; }
 
+         /// Each message is checked on its own.
+      virtual Sharding sharding() const throw()
+      { return shardSignal; }
+
          /// Specific value range checks
       static bool checkAlmValRange(LNavFilterData* fd);
    };
@@ -84,11 +84,20 @@ namespace gpstk
       virtual std::string filterName() const throw()
       { return "CrossSource"; }
 
+         /** Subframes are only compared with others from the same
+          * PRN, so instances may be divided by PRN. */
+      virtual Sharding sharding() const throw()
+      { return shardPRN; }
+
    protected:
          /// Map from subframe data to source list
-      typedef std::map<LNavFilterData*, NavMsgList, LNavMsgSort> SubframeMap;
+      typedef std::map<LNavFilterData*, NavMsgList, LNavMsgSort,
+                       NavPoolAllocator<std::pair<LNavFilterData* const,
+                                                  NavMsgList> > > SubframeMap;
          /// Map from PRN to SubframeMap
-      typedef std::map<uint32_t, SubframeMap> NavMap;
+      typedef std::map<uint32_t, SubframeMap, std::less<uint32_t>,
+                       NavPoolAllocator<std::pair<const uint32_t,
+                                                  SubframeMap> > > NavMap;
 
          /// Nav subframes grouped by prn and unique nav bits
       NavMap groupedNav;
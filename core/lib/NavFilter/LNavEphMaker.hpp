@@ -113,6 +113,10 @@ namespace gpstk
       virtual std::string filterName() const throw()
       { return "EphMaker"; }
 
+         /// Ephemerides are assembled separately for each source.
+      virtual Sharding sharding() const throw()
+      { return shardSignal; }
+
          /// Storage for the assembly of ephemerides.
       EphMap ephemerides;
          /** Storage of pointers to complete, valid ephemerides.  This
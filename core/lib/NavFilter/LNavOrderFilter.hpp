@@ -120,7 +120,8 @@ namespace gpstk
       unsigned procDepth;
 
    protected:
-      typedef std::set<LNavFilterData*, LNavTimeSort> SubframeSet;
+      typedef std::set<LNavFilterData*, LNavTimeSort,
+                       NavPoolAllocator<LNavFilterData*> > SubframeSet;
 
          /// Ordered set of nav message subframes
       SubframeSet orderedNav;
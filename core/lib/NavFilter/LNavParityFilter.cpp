@@ -49,16 +49,28 @@ namespace gpstk
    void LNavParityFilter ::
    validate(NavMsgList& msgBitsIn, NavMsgList& msgBitsOut)
    {
-      NavMsgList::iterator i;
-         // check parity of each subframe and put the valid ones in
-         // the output
-      for (i = msgBitsIn.begin(); i != msgBitsIn.end(); i++)
+      const uint32_t *batch[EngNav::parityBatchMax];
+      NavMsgList::iterator i = msgBitsIn.begin();
+         // check parity of the subframes in batches and put the valid
+         // ones in the output
+      while (i != msgBitsIn.end())
       {
-         LNavFilterData *fd = dynamic_cast<LNavFilterData*>(*i);
-         if (EngNav::checkParity(fd->sf))
-            accept(*i, msgBitsOut);
-         else
-            reject(*i);
+         NavMsgList::iterator first = i;
+         unsigned n;
+         for (n = 0; i != msgBitsIn.end() && n < EngNav::parityBatchMax;
+              i++, n++)
+         {
+            LNavFilterData *fd = dynamic_cast<LNavFilterData*>(*i);
+            batch[n] = fd->sf;
+         }
+         uint64_t passed = EngNav::checkParity(batch, n);
+         for (n = 0; first != i; first++, n++)
+         {
+            if (passed & (uint64_t(1) << n))
+               accept(*first, msgBitsOut);
+            else
+               reject(*first);
+         }
       }
    }
 }
@@ -42,6 +42,7 @@
 #include <list>
 #include <ObsID.hpp>
 #include <NavFilterKey.hpp>
+#include <NavFilterPool.hpp>
 
 namespace gpstk
 {
@@ -53,7 +54,25 @@ namespace gpstk
    class NavFilter
    {
    public:
-      typedef std::list<NavFilterKey*> NavMsgList;
+         /** A list of navigation messages.  The list nodes are
+          * recycled by NavPoolAllocator, so this is not a
+          * std::list<NavFilterKey*>; code that passes or converts
+          * lists of messages must use this typedef. */
+      typedef std::list<NavFilterKey*,
+                        NavPoolAllocator<NavFilterKey*> > NavMsgList;
+
+         /** How the messages given to validate() may be divided
+          * among separate instances of a filter, each with its own
+          * internal state, as done by ShardedNavFilterMgr. */
+      enum Sharding
+      {
+            /// All messages must be given to the same instance.
+         shardNone,
+            /// Messages may be divided by NavFilterKey::prn.
+         shardPRN,
+            /// Messages may be divided by prn, carrier and code.
+         shardSignal
+      };
 
       NavFilter();
 
@@ -103,6 +122,14 @@ namespace gpstk
           * human-readable ones. */
       virtual std::string filterName() const throw() = 0;
 
+         /** Return how the messages processed by this filter may be
+          * divided among separate instances of it.  Filters that keep
+          * no state between messages, or that only compare messages
+          * from the same source, should override this.  The default
+          * of shardNone is always safe. */
+      virtual Sharding sharding() const throw()
+      { return shardNone; }
+
          /// Debug support 
       virtual void dumpRejected(std::ostream& out) const; 
 
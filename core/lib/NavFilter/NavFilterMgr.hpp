@@ -98,9 +98,21 @@ namespace gpstk
        *      created dynamically on the heap and freed as the data is
        *      either rejected or accepted.  This approach is most
        *      useful when using filters of depth 2 and larger.
+       *   3. Getting the filter data objects from a NavFilterKeyPool
+       *      and putting them back once they come out of the
+       *      filters, which avoids allocating an object for each
+       *      message.
        *
        * @see NavFilterMgr for a list of examples.
        *
+       * @section NavFilterShard Sharding
+       *
+       * ShardedNavFilterMgr divides the messages among several
+       * independent chains of filters, by PRN or by signal, and runs
+       * the chains on separate threads.  Each filter declares with
+       * NavFilter::sharding() how its input may be divided; filters
+       * that compare messages across PRNs can not be used this way.
+       *
        * @section GPSLNAV GPS Legacy Nav Filters
        *
        * Filters in this group use the data class LNavFilterData,
@@ -171,7 +183,8 @@ namespace gpstk
          /// A list of navigation data filters.
       typedef std::list<NavFilter*> FilterList;
          /// A set of unique filter pointers.
-      typedef std::set<NavFilter*> FilterSet;
+      typedef std::set<NavFilter*, std::less<NavFilter*>,
+                       NavPoolAllocator<NavFilter*> > FilterSet;
 
          /// Do-nothing default constructor.
       NavFilterMgr();
@@ -199,6 +212,14 @@ namespace gpstk
           *   configured filters. */
       NavFilter::NavMsgList validate(NavFilterKey* msgBits);
 
+         /** Validate a list of navigation messages, passing the whole
+          * list through each filter in turn.
+          * @param[in] msgBits The navigation messages to
+          *   validate/filter, as for validate(NavFilterKey*).
+          * @return Any messages that have successfully passed all
+          *   configured filters. */
+      NavFilter::NavMsgList validate(const NavFilter::NavMsgList& msgBits);
+
          /** Flush the stored data for all known filters.  This method
           * should be called by the user after all data has been added
           * to the filter manager via validate().
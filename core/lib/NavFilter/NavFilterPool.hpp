@@ -0,0 +1,259 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#ifndef NAVFILTERPOOL_HPP
+#define NAVFILTERPOOL_HPP
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include "NavFilterKey.hpp"
+
+namespace gpstk
+{
+      /// @ingroup NavFilter
+      //@{
+
+      /** Allocator for the nodes of the lists, sets and maps that
+       * carry navigation messages between filters.  Single nodes are
+       * recycled through a free list kept per thread and per node
+       * type, so that once a stream of messages has reached a steady
+       * state, passing messages through NavFilterMgr does not touch
+       * the heap.  Nodes may be freed by a different thread than the
+       * one that allocated them.  Each free list holds at most
+       * maxCached nodes, and the rest are returned to the heap.
+       * Containers may outlive the free list of their thread, e.g. a
+       * static or thread_local list whose first node was allocated
+       * after it was constructed; nodes freed once the free list is
+       * gone go straight back to the heap. */
+   template <class T>
+   class NavPoolAllocator
+   {
+   public:
+      typedef T value_type;
+
+         /// The most free nodes kept by each thread for each type.
+      static const std::size_t maxCached = 65536;
+
+      template <class U>
+      struct rebind
+      { typedef NavPoolAllocator<U> other; };
+
+      NavPoolAllocator() throw()
+      {}
+      template <class U>
+      NavPoolAllocator(const NavPoolAllocator<U>&) throw()
+      {}
+
+      T* allocate(std::size_t n)
+      {
+         if (n == 1)
+         {
+            FreeList& fl(freeList());
+            if (fl.head != NULL)
+            {
+               Node *node = fl.head;
+               fl.head = node->next;
+               fl.count--;
+               return reinterpret_cast<T*>(node);
+            }
+         }
+         return static_cast<T*>(::operator new(n * sizeof(Slot)));
+      }
+
+      void deallocate(T* p, std::size_t n) throw()
+      {
+         FreeList& fl(freeList());
+         if ((n == 1) && !fl.closed && (fl.count < maxCached))
+         {
+            Node *node = reinterpret_cast<Node*>(p);
+            node->next = fl.head;
+            fl.head = node;
+            fl.count++;
+            return;
+         }
+         ::operator delete(p);
+      }
+
+   private:
+         /// A free node, overlaid on the storage of a T.
+      struct Node
+      {
+         Node *next;
+      };
+         /// Storage big and aligned enough for either a T or a Node.
+      union Slot
+      {
+         alignas(T) char t[sizeof(T)];
+         Node node;
+      };
+         /** The free nodes of one thread.  This has no destructor,
+          * so it can still be used while the thread or program exits
+          * after the nodes have been returned to the heap. */
+      struct FreeList
+      {
+         Node *head;
+         std::size_t count;
+            /// Set once the nodes are returned to the heap at exit.
+         bool closed;
+      };
+         /// Returns the free nodes of its thread to the heap at exit.
+      struct Closer
+      {
+         ~Closer()
+         {
+            FreeList& fl(threadList());
+            fl.closed = true;
+            while (fl.head != NULL)
+            {
+               Node *node = fl.head;
+               fl.head = node->next;
+               ::operator delete(node);
+            }
+            fl.count = 0;
+         }
+      };
+
+      static FreeList& threadList()
+      {
+         static thread_local FreeList fl = { NULL, 0, false };
+         return fl;
+      }
+
+      static FreeList& freeList()
+      {
+         static thread_local Closer closer;
+         (void)closer;
+         return threadList();
+      }
+   };
+
+   template <class T, class U>
+   bool operator==(const NavPoolAllocator<T>&, const NavPoolAllocator<U>&)
+      throw()
+   { return true; }
+   template <class T, class U>
+   bool operator!=(const NavPoolAllocator<T>&, const NavPoolAllocator<U>&)
+      throw()
+   { return false; }
+
+
+      /** A pool of navigation message objects, such as
+       * LNavFilterData, for applications that create one per
+       * subframe.  Objects are created in blocks and handed out by
+       * get(), and given back with put() once they have come out of
+       * the filters, either accepted or rejected, and are no longer
+       * needed.  An object from get() keeps whatever values it had
+       * when it was put back.  All objects are destroyed with the
+       * pool, so it must outlive any use of them.  A pool is not
+       * safe to share between threads.
+       * @code{.cpp}
+       * NavFilterKeyPool<LNavFilterData> pool;
+       * LNavFilterData *fd = pool.get();
+       * fd->sf = subframeBuffer;
+       * NavFilter::NavMsgList l = mgr.validate(fd);
+       * for (nmli = l.begin(); nmli != l.end(); nmli++)
+       * {
+       *    // ... use the message
+       *    pool.put(*nmli);
+       * }
+       * @endcode
+       */
+   template <class T>
+   class NavFilterKeyPool
+   {
+   public:
+         /** Initialize an empty pool.
+          * @param[in] blockSize The number of objects created at a
+          *   time when the pool runs out. */
+      NavFilterKeyPool(std::size_t blockSize = 1024)
+            : block(blockSize == 0 ? 1 : blockSize)
+      {}
+
+      ~NavFilterKeyPool()
+      {
+         for (std::size_t i = 0; i < blocks.size(); i++)
+            delete [] blocks[i];
+      }
+
+         /// Get an object from the pool.
+      T* get()
+      {
+         if (avail.empty())
+         {
+            T *newBlock = new T[block];
+            blocks.push_back(newBlock);
+            avail.reserve(blocks.size() * block);
+            for (std::size_t i = block; i > 0; i--)
+               avail.push_back(newBlock + i - 1);
+         }
+         T *rv = avail.back();
+         avail.pop_back();
+         return rv;
+      }
+
+         /** Return an object to the pool.
+          * @param[in] obj An object that came from get() of this
+          *   pool, given as the NavFilterKey pointer that comes out
+          *   of the filters. */
+      void put(NavFilterKey* obj)
+      { avail.push_back(static_cast<T*>(obj)); }
+
+         /// Return the number of objects that have been created.
+      std::size_t capacity() const throw()
+      { return blocks.size() * block; }
+
+         /// Return the number of objects currently handed out.
+      std::size_t inUse() const throw()
+      { return capacity() - avail.size(); }
+
+   private:
+         // the pool owns its objects
+      NavFilterKeyPool(const NavFilterKeyPool&);
+      NavFilterKeyPool& operator=(const NavFilterKeyPool&);
+
+         /// Number of objects per block.
+      std::size_t block;
+         /// The blocks of objects.
+      std::vector<T*> blocks;
+         /// Objects not handed out, the next one at the back.
+      std::vector<T*> avail;
+   };
+
+      //@}
+}
+
+#endif // NAVFILTERPOOL_HPP
@@ -120,7 +120,8 @@ namespace gpstk
       unsigned procDepth;
 
    protected:
-      typedef std::set<NavFilterKey*, NavTimeSort> SubframeSet;
+      typedef std::set<NavFilterKey*, NavTimeSort,
+                       NavPoolAllocator<NavFilterKey*> > SubframeSet;
 
          /// Ordered set of nav message subframes
       SubframeSet orderedNav;
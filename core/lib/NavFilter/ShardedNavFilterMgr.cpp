@@ -0,0 +1,216 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include "ShardedNavFilterMgr.hpp"
+
+namespace gpstk
+{
+   ShardedNavFilterMgr ::
+   ShardedNavFilterMgr(unsigned shards, unsigned threads)
+         : shardMgrs(shards == 0 ? 1 : shards),
+           shardFilters(shardMgrs.size()),
+           pool(new WorkerPool(parallelThreadCount(threads,
+                                                   shardMgrs.size()))),
+           scope(NavFilter::shardSignal),
+           started(false)
+   {
+   }
+
+
+   void ShardedNavFilterMgr ::
+   addFilter(const FilterFactory& factory)
+   {
+      if (started)
+      {
+         InvalidRequest exc("Filters must be added before validate()");
+         GPSTK_THROW(exc);
+      }
+      std::unique_ptr<NavFilter> first(factory());
+      NavFilter::Sharding sharding = first->sharding();
+      if (!tailFilters.empty() || (sharding == NavFilter::shardNone))
+      {
+         tailMgr.addFilter(first.get());
+         tailFilters.push_back(std::move(first));
+         return;
+      }
+      std::vector<std::unique_ptr<NavFilter> > made(shardMgrs.size());
+      made[0] = std::move(first);
+      for (unsigned s = 1; s < made.size(); s++)
+      {
+         made[s].reset(factory());
+      }
+      if (sharding < scope)
+         scope = sharding;
+      for (unsigned s = 0; s < made.size(); s++)
+      {
+         shardMgrs[s].addFilter(made[s].get());
+         shardFilters[s].push_back(std::move(made[s]));
+      }
+   }
+
+
+   NavFilter::NavMsgList ShardedNavFilterMgr ::
+   validate(const NavFilter::NavMsgList& msgBits)
+   {
+      started = true;
+      std::vector<NavFilter::NavMsgList> in(shardMgrs.size()),
+         out(shardMgrs.size());
+      NavFilter::NavMsgList::const_iterator nmli;
+      for (nmli = msgBits.begin(); nmli != msgBits.end(); nmli++)
+      {
+         in[shardOf(*nmli)].push_back(*nmli);
+      }
+         // Each shard touches only its own filters and lists.
+      pool->run(shardMgrs.size(),
+                [&](std::size_t s)
+                { out[s] = shardMgrs[s].validate(in[s]); });
+      rejected.clear();
+      for (unsigned s = 0; s < shardMgrs.size(); s++)
+      {
+         rejected.insert(shardMgrs[s].rejected.begin(),
+                         shardMgrs[s].rejected.end());
+      }
+      NavFilter::NavMsgList rv(merge(out));
+      if (!tailFilters.empty() && !rv.empty())
+      {
+         rv = tailMgr.validate(rv);
+         rejected.insert(tailMgr.rejected.begin(), tailMgr.rejected.end());
+      }
+      return rv;
+   }
+
+
+   NavFilter::NavMsgList ShardedNavFilterMgr ::
+   finalize()
+   {
+      NavFilter::NavMsgList rv, flushed;
+      std::vector<NavFilter::NavMsgList> out(shardMgrs.size());
+      rejected.clear();
+         // Flush the shards one filter at a time, so that, as with
+         // NavFilterMgr, the tail sees what each filter held back
+         // in the order of the filters.
+      for (unsigned i = 0; i < shardFilters[0].size(); i++)
+      {
+         pool->run(shardMgrs.size(),
+                   [&](std::size_t s)
+                   { out[s] = finalizeShard(s, i); });
+         flushed = merge(out);
+         if (!tailFilters.empty() && !flushed.empty())
+         {
+            flushed = tailMgr.validate(flushed);
+         }
+         rv.splice(rv.end(), flushed);
+      }
+      if (!tailFilters.empty())
+      {
+         flushed = tailMgr.finalize();
+         rv.splice(rv.end(), flushed);
+      }
+      return rv;
+   }
+
+
+   unsigned ShardedNavFilterMgr ::
+   processingDepth()
+      const throw()
+   {
+         // each NavFilterMgr counts the current epoch once
+      return shardMgrs[0].processingDepth() + tailMgr.processingDepth() - 1;
+   }
+
+
+   unsigned ShardedNavFilterMgr ::
+   shardOf(const NavFilterKey* msgBits)
+      const throw()
+   {
+      unsigned long key = msgBits->prn;
+      if (scope == NavFilter::shardSignal)
+      {
+         key = (key * 31 + msgBits->carrier) * 31 + msgBits->code;
+      }
+      return key % shardMgrs.size();
+   }
+
+
+   NavFilter* ShardedNavFilterMgr ::
+   getFilter(unsigned shard, unsigned index)
+      const
+   {
+      if (shard < shardFilters.size())
+      {
+         if (index < shardFilters[shard].size())
+            return shardFilters[shard][index].get();
+         index -= shardFilters[shard].size();
+         if (index < tailFilters.size())
+            return tailFilters[index].get();
+      }
+      InvalidParameter exc("No such shard or filter");
+      GPSTK_THROW(exc);
+   }
+
+
+   NavFilter::NavMsgList ShardedNavFilterMgr ::
+   merge(std::vector<NavFilter::NavMsgList>& out)
+   {
+      NavFilter::NavMsgList rv;
+      for (unsigned s = 0; s < out.size(); s++)
+      {
+         rv.splice(rv.end(), out[s]);
+      }
+         // list::sort is stable, keeping the shard order within a time
+      rv.sort([](const NavFilterKey* l, const NavFilterKey* r)
+              { return l->timeStamp < r->timeStamp; });
+      return rv;
+   }
+
+
+   NavFilter::NavMsgList ShardedNavFilterMgr ::
+   finalizeShard(unsigned shard, unsigned index)
+   {
+      std::vector<std::unique_ptr<NavFilter> >& filters(shardFilters[shard]);
+      NavFilter::NavMsgList rv1, rv2;
+      filters[index]->rejected.clear();
+      filters[index]->finalize(rv1);
+      for (unsigned i = index + 1; (i < filters.size()) && !rv1.empty(); i++)
+      {
+         filters[i]->rejected.clear();
+         rv2.clear();
+         filters[i]->validate(rv1, rv2);
+         rv1.swap(rv2);
+      }
+      return rv1;
+   }
+}
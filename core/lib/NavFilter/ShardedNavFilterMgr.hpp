@@ -0,0 +1,171 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#ifndef SHARDEDNAVFILTERMGR_HPP
+#define SHARDEDNAVFILTERMGR_HPP
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "NavFilterMgr.hpp"
+#include "Exception.hpp"
+#include "WorkerPool.hpp"
+
+namespace gpstk
+{
+      /// @ingroup NavFilter
+      //@{
+
+      /** Filters navigation messages like NavFilterMgr, but divides
+       * the messages among a number of shards, each with its own
+       * instances of the filters, and processes the shards on
+       * separate threads.  Messages are assigned to shards by PRN,
+       * or by PRN, carrier and code when every filter allows it (see
+       * NavFilter::sharding()), so that each filter instance sees
+       * all the messages it would compare with each other.
+       *
+       * A filter that can not be sharded, such as LNavOrderFilter
+       * which compares each message with the newest of all PRNs,
+       * and all filters added after it, form a tail that has a
+       * single instance of each filter.  The tail is given the
+       * merged output of the shards on the calling thread.
+       *
+       * Since each shard needs its own filter instances, filters are
+       * added as functions that create them.  The manager owns the
+       * filters it creates.
+       *
+       * \code{.cpp}
+       * ShardedNavFilterMgr mgr(8);
+       * mgr.addFilter([]() { return new LNavParityFilter; });
+       * mgr.addFilter([]() { return new LNavCrossSourceFilter; });
+       * // one epoch's worth of subframes from all receivers
+       * NavFilter::NavMsgList l = mgr.validate(epochMsgs);
+       * \endcode
+       *
+       * The output of each shard comes out of its filters in the
+       * same order as from a NavFilterMgr given that shard's
+       * messages.  The outputs are merged in time stamp order, with
+       * messages of the same time in shard order.  The shards are
+       * processed by a pool of threads started by the constructor.
+       */
+   class ShardedNavFilterMgr
+   {
+   public:
+         /// Creates a new filter for a shard.
+      typedef std::function<NavFilter*()> FilterFactory;
+
+         /** Initialize with no filters.
+          * @param[in] shards The number of shards, at least 1.
+          * @param[in] threads The number of threads used to process
+          *   the shards, 0 for one per hardware thread. */
+      ShardedNavFilterMgr(unsigned shards, unsigned threads = 0);
+
+         /** Add a filter to each shard, after those already added.
+          * If the filter can not be sharded, or a filter that can
+          * not be sharded has already been added, a single instance
+          * is added to the tail instead.  All filters must be added
+          * before validate() is called.
+          * @param[in] factory Called once per shard, or once for the
+          *   tail, to create the filter instance.
+          * @throw InvalidRequest if validate() has already been called. */
+      void addFilter(const FilterFactory& factory);
+
+         /** Validate a list of navigation messages, typically all the
+          * messages for one epoch.
+          * @param[in] msgBits The navigation messages to
+          *   validate/filter, as for NavFilterMgr::validate().
+          * @return Any messages that have successfully passed all
+          *   configured filters, in time stamp order. */
+      NavFilter::NavMsgList validate(const NavFilter::NavMsgList& msgBits);
+
+         /** Flush the stored data for all filters in all shards.
+          * @return The remaining messages successfully passing the
+          *   filters, in time stamp order. */
+      NavFilter::NavMsgList finalize();
+
+         /// @see NavFilterMgr::processingDepth()
+      unsigned processingDepth() const throw();
+
+         /// Return the number of shards.
+      unsigned numShards() const throw()
+      { return shardMgrs.size(); }
+
+         /// Return the shard that a message is processed in.
+      unsigned shardOf(const NavFilterKey* msgBits) const throw();
+
+         /** Return a filter instance of a shard, e.g. to get the
+          * completeEphs of an LNavEphMaker.  Filters in the tail
+          * have the same instance for all shards.
+          * @param[in] shard The shard, less than numShards().
+          * @param[in] index The position of the filter in the order
+          *   they were added.
+          * @throw InvalidParameter if either is out of range. */
+      NavFilter* getFilter(unsigned shard, unsigned index) const;
+
+         /** This set contains the filter instances, of all shards,
+          * with rejected data after a validate() or finalize() call,
+          * as for NavFilterMgr::rejected. */
+      NavFilterMgr::FilterSet rejected;
+
+   private:
+         /// Merge the shard outputs in time stamp order.
+      NavFilter::NavMsgList merge(std::vector<NavFilter::NavMsgList>& out);
+
+         /** Finalize one filter of a shard and pass its output
+          * through the rest of that shard's filters, as
+          * NavFilterMgr::finalize() does for each filter. */
+      NavFilter::NavMsgList finalizeShard(unsigned shard, unsigned index);
+
+         /// One manager per shard, using the filters in shardFilters.
+      std::vector<NavFilterMgr> shardMgrs;
+         /// The filters owned by this object, by shard.
+      std::vector<std::vector<std::unique_ptr<NavFilter> > > shardFilters;
+         /// Manager for the unsharded filters after the shards.
+      NavFilterMgr tailMgr;
+         /// The filters owned by this object in tailMgr.
+      std::vector<std::unique_ptr<NavFilter> > tailFilters;
+         /// Threads that process the shards.
+      std::unique_ptr<WorkerPool> pool;
+         /// How messages are divided, the narrowest of the filters.
+      NavFilter::Sharding scope;
+         /// Set by the first validate(), after which filters are fixed.
+      bool started;
+   };
+
+      //@}
+}
+
+#endif // SHARDEDNAVFILTERMGR_HPP
@@ -39,6 +39,7 @@
 /// given data, or a solution including editing via a RAIM algorithm.
 
 #include "MathBase.hpp"
+#include "SmallMatrix.hpp"
 #include "PRSolution.hpp"
 #include "GPSEllipsoid.hpp"
 #include "Combinations.hpp"
@@ -57,6 +58,205 @@ namespace gpstk
 
    ostream& operator<<(ostream& os, const WtdAveStats& was)
       { was.dump(os,was.getMessage()); return os;}
+
+   namespace
+   {
+      // Tolerance on singular values used by inverseSVD(), relative to the
+      // largest; smallNormalSolve() must not be used where it would apply.
+      const double normalSolveTol(1.e-8);
+
+      // Compute the covariance Cov = inverse(PT*W*P) and generalized inverse
+      // G = Cov*PT*W of the partials P (Nsvs x N) and weight matrix W = iMC
+      // (Nsvs x Nsvs, or empty for unit weights), using a fixed-size LDLT so
+      // that nothing is allocated. Cov and G must already be dimensioned.
+      // Throws SingularMatrixException if PT*W*P is not positive definite, or
+      // if it might be so poorly conditioned that inverseSVD() would edit its
+      // singular values; the caller then falls back to inverseSVD().
+      // The condition number of a positive definite A is bounded by
+      // trace(A)*trace(inverse(A)), so the LDLT inverse is used only when that
+      // bound is below the inverseSVD() tolerance, where both give the same
+      // (unedited) inverse.
+      template <size_t N>
+      void smallNormalSolve(const Matrix<double>& P, const Matrix<double>& iMC,
+                            Matrix<double>& Cov, Matrix<double>& G)
+      {
+         const size_t nsv(P.rows());
+         size_t i,j,k;
+         double sum;
+
+         // G = PT*W for now
+         if(iMC.rows() > 0) {
+            for(k=0; k<N; k++) for(i=0; i<nsv; i++) {
+               for(sum=0.0,j=0; j<nsv; j++) sum += P(j,k)*iMC(j,i);
+               G(k,i) = sum;
+            }
+         }
+         else {
+            for(k=0; k<N; k++) for(i=0; i<nsv; i++) G(k,i) = P(i,k);
+         }
+
+         // information matrix PT*W*P, lower triangle
+         SmallMatrix<double,N,N> info;
+         for(j=0; j<N; j++) for(k=0; k<=j; k++) {
+            for(sum=0.0,i=0; i<nsv; i++) sum += G(j,i)*P(i,k);
+            info(j,k) = sum;
+         }
+
+         SmallLDLT<double,N> ldlt;
+         ldlt(info);
+         SmallMatrix<double,N,N> inv(ldlt.inverse());
+
+         double trace(0.0),invTrace(0.0);
+         for(j=0; j<N; j++) { trace += info(j,j); invTrace += inv(j,j); }
+         if(!(trace*invTrace < 1.0/normalSolveTol)) {
+            SingularMatrixException e("Normal matrix is nearly singular");
+            GPSTK_THROW(e);
+         }
+
+         for(j=0; j<N; j++) for(k=0; k<N; k++) Cov(j,k) = inv(j,k);
+
+         // G = inverse(PT*W*P)*PT*W, a column at a time
+         SmallVector<double,N> col;
+         for(i=0; i<nsv; i++) {
+            for(k=0; k<N; k++) col(k) = G(k,i);
+            ldlt.backSub(col);
+            for(k=0; k<N; k++) G(k,i) = col(k);
+         }
+      }
+
+      // Call smallNormalSolve() for the usual solution dimensions, 3 position
+      // plus 1 to 5 clocks; return false, doing nothing, for any other.
+      bool normalSolve(const Matrix<double>& P, const Matrix<double>& iMC,
+                       Matrix<double>& Cov, Matrix<double>& G)
+      {
+         switch(P.cols()) {
+            case 4: smallNormalSolve<4>(P, iMC, Cov, G); return true;
+            case 5: smallNormalSolve<5>(P, iMC, Cov, G); return true;
+            case 6: smallNormalSolve<6>(P, iMC, Cov, G); return true;
+            case 7: smallNormalSolve<7>(P, iMC, Cov, G); return true;
+            case 8: smallNormalSolve<8>(P, iMC, Cov, G); return true;
+            default: return false;
+         }
+      }
+
+      // Screen the RAIM combinations of one stage. Given the all-in-view
+      // partials P (Nsvs x N), pre-fit residuals R and weights W (length Nsvs,
+      // or empty for unit weights), all at the converged all-in-view solution,
+      // compute for each combination of 'stage' rejected satellites (in the
+      // order of Combinations) the RMS post-fit residual of the subset solution
+      // linearized there, and a bound Err on the difference between that and
+      // the RMSResidual SimplePRSolution() would find for the subset, given its
+      // convergence limit conv. PT*W*P is factored once; the factor for each
+      // subset comes from it by rank-one downdates.
+      // RMS is -1 for a combination that cannot be screened, e.g. because it
+      // rejects every satellite of one system.
+      //
+      // Err is derived as follows. Let d be the position change from the
+      // all-in-view solution to the subset solution. Between the two, the
+      // linearized model is in error, in any one residual, by at most
+      //   range curvature             d^2/(2*range), range > 1.9e7m
+      //   earth rotation correction   omega*|SV|/c * d < 1.e-5*d
+      //   trop correction             the height derivative of the slant
+      //                               delay, < 2.e-2*d down to 1 degree
+      //   change of the partials      d/range times the residual
+      // A change of at most u in each residual changes the RMS post-fit
+      // residual of a weighted least squares solution by at most
+      // (1+sqrt(wmax/wmin))*u. SimplePRSolution() reports the residuals of
+      // the iterate before the last, whose step is < conv, and a step x changes
+      // a residual by at most sqrt(2)*|x|. Everything is doubled to cover the
+      // difference between d and the linearized position change, and the terms
+      // of higher order.
+      template <size_t N>
+      void smallScreenCombos(const Matrix<double>& P, const Vector<double>& R,
+                             const Vector<double>& W, const int stage,
+                             const double conv,
+                             vector<double>& RMS, vector<double>& Err)
+      {
+         const size_t nsv(P.rows());
+         size_t i,j,k;
+         double w,e,sum,d,rms;
+         double wmin(1.0),wmax(1.0);
+
+         SmallMatrix<double,N,N> info;
+         SmallVector<double,N> b,x,dX;
+         for(i=0; i<nsv; i++) {
+            w = (W.size() > 0 ? W(i) : 1.0);
+            if(i == 0 || w < wmin) wmin = w;
+            if(i == 0 || w > wmax) wmax = w;
+            for(j=0; j<N; j++) {
+               b(j) += w*P(i,j)*R(i);
+               for(k=0; k<=j; k++) info(j,k) += w*P(i,j)*P(i,k);
+            }
+         }
+         SmallCholesky<double,N> all,sub;
+         all(info);
+         if(!(wmin > 0.0)) {
+            SingularMatrixException e("Weights must be positive");
+            GPSTK_THROW(e);
+         }
+         const double wfac(1.0 + SQRT(wmax/wmin));
+
+         RMS.clear();
+         Err.clear();
+         Combinations Combo(nsv,stage);
+         do {
+            sub = all;
+            dX = b;
+            try {
+               for(j=0; j<size_t(stage); j++) {
+                  i = Combo.Selection(j);
+                  w = (W.size() > 0 ? W(i) : 1.0);
+                  for(k=0; k<N; k++) x(k) = SQRT(w)*P(i,k);
+                  sub.downdate(x);
+                  for(k=0; k<N; k++) dX(k) -= w*P(i,k)*R(i);
+               }
+               // e.g. all the satellites of one system are rejected
+               for(k=0; k<N; k++) if(sub.L(k,k) < 1.e-6*all.L(k,k)) {
+                  SingularMatrixException e("Downdate is nearly singular");
+                  GPSTK_THROW(e);
+               }
+            }
+            catch(SingularMatrixException& sme) {
+               RMS.push_back(-1.0);
+               Err.push_back(0.0);
+               continue;
+            }
+            sub.backSub(dX);
+
+            for(sum=0.0,i=0; i<nsv; i++) {
+               if(Combo.isSelected(i)) continue;
+               for(e=R(i),k=0; k<N; k++) e -= P(i,k)*dX(k);
+               sum += e*e;
+            }
+            rms = SQRT(sum/double(nsv-stage));
+            d = RSS(dX(0),dX(1),dX(2));
+            RMS.push_back(rms);
+            Err.push_back(2.0*(wfac*(d*d/3.8e7 + (1.e-5 + 2.e-2 + rms/1.9e7)*d)
+                               + SQRT(2.0)*conv));
+         } while(Combo.Next() != -1);
+      }
+
+      // Call smallScreenCombos() for solution dimensions 4 through 8; return
+      // false if the dimension is not one of these, or PT*W*P is singular.
+      bool screenCombos(const Matrix<double>& P, const Vector<double>& R,
+                        const Vector<double>& W, const int stage,
+                        const double conv,
+                        vector<double>& RMS, vector<double>& Err)
+      {
+         try {
+            switch(P.cols()) {
+               case 4: smallScreenCombos<4>(P,R,W,stage,conv,RMS,Err); break;
+               case 5: smallScreenCombos<5>(P,R,W,stage,conv,RMS,Err); break;
+               case 6: smallScreenCombos<6>(P,R,W,stage,conv,RMS,Err); break;
+               case 7: smallScreenCombos<7>(P,R,W,stage,conv,RMS,Err); break;
+               case 8: smallScreenCombos<8>(P,R,W,stage,conv,RMS,Err); break;
+               default: return false;
+            }
+         }
+         catch(SingularMatrixException& sme) { return false; }
+         return true;
+      }
+   }
  
    // -------------------------------------------------------------------------
    // Prepare for the autonomous solution by computing direction cosines,
@@ -71,10 +271,9 @@ namespace gpstk
    {
       LOG(DEBUG) << "PreparePRSolution at time " << printTime(Tr,timfmt);
 
-      int j,noeph(0),N,NSVS;
-      size_t i;
+      int noeph(0),N,NSVS;
+      size_t i,j;
       CommonTime tx;
-      Xvt PVT;
 
       // if necessary, define the SystemIDs vector (but NOT the member data one)
       if(Syss.size() == 0) {
@@ -99,11 +298,17 @@ namespace gpstk
       }
 
       LOG(DEBUG) << "Sats.size is " << Sats.size();
-      SVP = Matrix<double>(Sats.size(),4,0.0);        // define the matrix to return
+      SVP.resize(Sats.size(),4);                      // define the matrix to return
+      SVP = 0.0;
       if(N <= 0) return 0;                            // nothing to do
       NSVS = 0;                                       // count good sats w/ ephem
 
-      // loop over all satellites
+      // queries for the ephemeris at the first estimate of transmit time,
+      // made for all satellites at once
+      vector<XvtStore<SatID>::XvtQuery> queries;
+      vector<size_t> index;                           // index in Sats
+      vector<XvtStore<SatID>::XvtStatus> status;
+      vector<Xvt> PVTs;
       for(i=0; i<Sats.size(); i++) {
 
          // skip marked satellites
@@ -123,43 +328,52 @@ namespace gpstk
          // convert time system of tx to that of Sats[i]
 
          tx -= Pseudorange[i]/C_MPS;
-         try {
-            LOG(DEBUG) << " go to getXvt with time " << printTime(tx,timfmt);
-            PVT = pEph->getXvt(Sats[i], tx);          // get ephemeris range, etc
-            LOG(DEBUG) << " returned from getXvt";
-         }
-         catch(InvalidRequest& e) {
+         queries.push_back(XvtStore<SatID>::XvtQuery(Sats[i], tx));
+         index.push_back(i);
+      }
+
+      LOG(DEBUG) << " go to getXvts with " << queries.size() << " satellites";
+      pEph->getXvts(queries, PVTs, status);
+      LOG(DEBUG) << " returned from getXvts";
+
+      // update transmit times and get ephemeris range again
+      for(j=0,i=0; i<queries.size(); i++) {
+         if(status[i] != XvtStore<SatID>::Valid) {
             LOG(DEBUG) << "Warning - PRSolution ignores satellite (no ephemeris) "
-               << RinexSatID(Sats[i]) << " at time " << printTime(tx,timfmt)
-               << " [" << e.getText() << "]";
-            Sats[i].id = -::abs(Sats[i].id);
+               << RinexSatID(queries[i].first) << " at time "
+               << printTime(queries[i].second,timfmt)
+               << " [getXvts status " << status[i] << "]";
+            Sats[index[i]].id = -::abs(Sats[index[i]].id);
             ++noeph;
             continue;
          }
-         catch(Exception& e) {
-            LOG(DEBUG) << "Oops - Exception " << e.getText();
-         }
+         queries[j] = queries[i];
+         queries[j].second -= PVTs[i].clkbias + PVTs[i].relcorr;
+         index[j++] = index[i];
+      }
+      queries.resize(j);
+      index.resize(j);
+      pEph->getXvts(queries, PVTs, status);
 
-         // update transmit time and get ephemeris range again
-         tx -= PVT.clkbias + PVT.relcorr;
-         try {
-            PVT = pEph->getXvt(Sats[i], tx);
-         }
-         catch(InvalidRequest& e) {                   // unnecessary....you'd think!
+      for(i=0; i<queries.size(); i++) {
+         if(status[i] != XvtStore<SatID>::Valid) {    // unnecessary....you'd think!
             LOG(DEBUG) << "Warning - PRSolution ignores satellite (no ephemeris 2) "
-               << RinexSatID(Sats[i]) << " at time " << printTime(tx,timfmt)
-               << " [" << e.getText() << "]";
-            Sats[i].id = -::abs(Sats[i].id);
+               << RinexSatID(queries[i].first) << " at time "
+               << printTime(queries[i].second,timfmt)
+               << " [getXvts status " << status[i] << "]";
+            Sats[index[i]].id = -::abs(Sats[index[i]].id);
             ++noeph;
             continue;
          }
 
          // SVP = {SV position at transmit time}, raw range + clk + rel
-         for(j=0; j<3; j++) SVP(i,j) = PVT.x[j];
-         SVP(i,3) = Pseudorange[i] + C_MPS * (PVT.clkbias + PVT.relcorr);
+         const Xvt& PVT(PVTs[i]);
+         const size_t k(index[i]);
+         for(j=0; j<3; j++) SVP(k,j) = PVT.x[j];
+         SVP(k,3) = Pseudorange[k] + C_MPS * (PVT.clkbias + PVT.relcorr);
 
-         LOG(DEBUG) << "SVP: Sat " << RinexSatID(Sats[i])
-            << " PR " << fixed << setprecision(3) << Pseudorange[i]
+         LOG(DEBUG) << "SVP: Sat " << RinexSatID(Sats[k])
+            << " PR " << fixed << setprecision(3) << Pseudorange[k]
             << " clkbias " << C_MPS*PVT.clkbias
             << " relcorr " << C_MPS*PVT.relcorr;
 
@@ -216,10 +430,11 @@ namespace gpstk
       try {
          // -----------------------------------------------------------
          // counts, systems and dimensions
-         vector<SatID::SatelliteSystem> mySyss;
+         vector<SatID::SatelliteSystem>& mySyss(work.Syss);
          {
-            // define the Syss (system IDs) vector, and count good satellites
-            vector<SatID::SatelliteSystem> tempSyss;
+            // define the Syss (system IDs) vector, and count good satellites;
+            // mySyss is sorted as in Syss
+            mySyss.clear();
             for(Nsvs=0,i=0; i<Sats.size(); i++) {
                if(Sats[i].id <= 0)                          // reject marked sats
                   continue;
@@ -229,14 +444,14 @@ namespace gpstk
                   continue;
 
                Nsvs++;                                      // count it
-               if(vectorindex(tempSyss, sys) == -1)         // add unique system
-                  tempSyss.push_back(sys);
             }
 
-            // must sort as in Syss
-            for(i=0; i<Syss.size(); i++)
-               if(vectorindex(tempSyss, Syss[i]) != -1)
-                  mySyss.push_back(Syss[i]);
+            for(j=0; j<Syss.size(); j++) {
+               for(i=0; i<Sats.size(); i++)
+                  if(Sats[i].id > 0 && Sats[i].system == Syss[j]) break;
+               if(i < Sats.size())
+                  mySyss.push_back(Syss[j]);
+            }
          }
 
          // dimension of the solution vector (3 pos + 1 clk/sys)
@@ -248,10 +463,12 @@ namespace gpstk
 
          // -----------------------------------------------------------
          // build the measurement covariance matrix
-         Matrix<double> iMC;
+         Matrix<double>& iMC(work.iMC);
+         iMC.resize(0,0);
          if(invMC.rows() > 0) {
             LOG(DEBUG) << "Build inverse MCov";
-            iMC = Matrix<double>(Nsvs,Nsvs,0.0);
+            iMC.resize(Nsvs,Nsvs);
+            iMC = 0.0;
             for(n=0,i=0; i<Sats.size(); i++) {
                if(Sats[i].id <= 0) continue;
                for(k=0,j=0; j<Sats.size(); j++) {
@@ -265,9 +482,17 @@ namespace gpstk
          }
 
          // -----------------------------------------------------------
-         // define for computation
-         Vector<double> CRange(Nsvs),dX(dim);
-         Matrix<double> P(Nsvs,dim,0.0),PT,G(dim,Nsvs),PG(Nsvs,Nsvs),Rotation;
+         // define for computation; the work storage is reused from one call to
+         // the next, and resize() does not reallocate unless it must grow
+         Vector<double>& CRange(work.CRange);
+         Vector<double>& dX(work.dX);
+         Matrix<double>& P(work.P);
+         Matrix<double>& G(work.G);
+         CRange.resize(Nsvs);
+         dX.resize(dim);
+         P.resize(Nsvs,dim);
+         P = 0.0;
+         G.resize(dim,Nsvs);
          Triple dirCos;
          Xvt SV,RX;
 
@@ -393,35 +618,42 @@ namespace gpstk
                << fixed << setprecision(3) << Resids;
 
             // ------------------------------------------------------
-            // compute information matrix (inverse covariance) and generalized inverse
-            PT = transpose(P);
+            // compute covariance (inverse of information matrix) and generalized
+            // inverse; weight matrix = measurement covariance inverse.
+            // Solve with fixed-size LDLT, or if that is not possible, invert
+            // using SVD
+            bool solved;
+            try {
+               solved = normalSolve(P, iMC, Covariance, G);
+            }
+            catch(SingularMatrixException& sme) { solved = false; }
 
-            // weight matrix = measurement covariance inverse
-            if(invMC.rows() > 0) Covariance = PT * iMC * P;
-            else                 Covariance = PT * P;
+            if(!solved) {
+               Matrix<double> PT(transpose(P));
+               if(invMC.rows() > 0) Covariance = PT * iMC * P;
+               else                 Covariance = PT * P;
 
-            // invert using SVD
-            try {
-               Covariance = inverseSVD(Covariance);
+               try {
+                  Covariance = inverseSVD(Covariance, normalSolveTol);
+               }
+               catch(SingularMatrixException& sme) { return -2; }
+
+               if(invMC.rows() > 0) G = Covariance * PT * iMC;
+               else                 G = Covariance * PT;
             }
-            catch(SingularMatrixException& sme) { return -2; }
             LOG(DEBUG) << "InvCov (" << Covariance.rows() << "x" << Covariance.cols()
                << ")\n" << fixed << setprecision(4) << Covariance;
-
-            // generalized inverse
-            if(invMC.rows() > 0) G = Covariance * PT * iMC;
-            else                 G = Covariance * PT;
-
-            // PG is used for Slope computation
-            PG = P * G;
-            LOG(DEBUG) << "PG (" << PG.rows() << "x" << PG.cols()
-               << ")\n" << fixed << setprecision(4) << PG;
+            LOG(DEBUG) << "G (" << G.rows() << "x" << G.cols()
+               << ")\n" << fixed << setprecision(4) << G;
 
             n_iterate++;                        // increment number iterations
 
             // ------------------------------------------------------
             // compute solution
-            dX = G * Resids;
+            for(k=0; k<dim; k++) {
+               dX(k) = 0.0;
+               for(i=0; i<Nsvs; i++) dX(k) += G(k,i)*Resids(i);
+            }
             LOG(DEBUG) << "Computed dX(" << dX.size() << ")";
             Solution += dX;
 
@@ -449,12 +681,16 @@ namespace gpstk
          if(iret == 0) for(j=0,i=0; i<Sats.size(); i++) {
             if(Sats[i].id <= 0) continue;
 
+            // PG = P*G; only its diagonal is used, for the slopes
+            double PGjj(0.0);
+            for(k=0; k<dim; k++) PGjj += P(j,k)*G(k,j);
+
             // NB when one (few) sats have their own clock, PG(j,j) = 1 (nearly 1)
             // and slope is inf (large)
-            if(::fabs(1.0-PG(j,j)) < 1.e-8) continue;
+            if(::fabs(1.0-PGjj) < 1.e-8) continue;
 
-            for(int k=0; k<dim; k++) Slopes(j) += G(k,j)*G(k,j); // TD dim=4 here?
-            Slopes(j) = SQRT(Slopes(j)*double(n-dim)/(1.0-PG(j,j)));
+            for(k=0; k<dim; k++) Slopes(j) += G(k,j)*G(k,j); // TD dim=4 here?
+            Slopes(j) = SQRT(Slopes(j)*double(n-dim)/(1.0-PGjj));
             if(Slopes(j) > MaxSlope) MaxSlope = Slopes(j);
             j++;
          }
@@ -541,19 +777,30 @@ namespace gpstk
 
          int iret,N;
          size_t i,j;
-         vector<int> GoodIndexes;
+         vector<int>& GoodIndexes(work.GoodIndexes);
+         GoodIndexes.clear();
          // use these to save the 'best' solution within the loop.
-         // BestRMS marks the 'Best' set as unused.
+         // BestRMS marks the 'Best' set as unused. BestStage and BestCombo
+         // locate it, so that of equal RMS the first in order is kept, as when
+         // the combinations are solved in order.
+         // The matrices and vectors are work storage, reused from one call to
+         // the next, so that the loop over combinations does not allocate.
          bool BestTropFlag(false);
-         int BestNIter(0),BestIret(-5);
+         int BestNIter(0),BestIret(-5),BestStage(-1),BestCombo(-1);
          double BestRMS(-1.0),BestSL(0.0),BestConv(0.0);
-         Vector<double> BestSol(3,0.0),BestPFR;
-         vector<SatID> BestSats,SaveSats;
-         Matrix<double> SVP,BestCov,BestInvMCov,BestPartials;
-         vector<SatID::SatelliteSystem> BestSyss;
+         Vector<double>& BestSol(work.BestSol);
+         Vector<double>& BestPFR(work.BestPFR);
+         vector<SatID>& BestSats(work.BestSats);
+         vector<SatID>& SaveSats(work.SaveSats);
+         Matrix<double>& SVP(work.SVP);
+         Matrix<double>& BestCov(work.BestCov);
+         Matrix<double>& BestInvMCov(work.BestInvMCov);
+         Matrix<double>& BestPartials(work.BestPartials);
+         vector<SatID::SatelliteSystem>& BestSyss(work.BestSyss);
 
          // initialize
          Valid = false;
+         NCombos = 0;
          currTime = Tr;
          TropFlag = SlopeFlag = RMSFlag = false;
 
@@ -609,102 +856,180 @@ namespace gpstk
          // RAIM: reject 1 satellite at a time and try again, then 2, etc.
 
          // Slopes for each satellite are computed (cf. the RAIM algorithm)
-         Vector<double> Slopes;
+         Vector<double>& Slopes(work.Slopes);
          // Resids stores the post-fit data residuals.
-         Vector<double> Resids;
+         Vector<double>& Resids(work.Resids);
+
+         // The converged all-in-view partials, residuals and weights, used to
+         // screen the combinations of later stages: a combination is solved only
+         // if its screened RMS residual could be smaller than the best found.
+         Matrix<double>& ScreenP(work.ScreenP);
+         Vector<double>& ScreenR(work.ScreenR);
+         Vector<double>& ScreenW(work.ScreenW);
+         vector<double>& ScreenRMS(work.ScreenRMS);
+         vector<double>& ScreenErr(work.ScreenErr);
+         bool haveScreen(false);
 
          // stage is the number of satellites to reject.
          int stage(0);
 
          do {
-            // compute all the combinations of N satellites taken stage at a time
-            Combinations Combo(N,stage);
-
-            // compute a solution for each combination of marked satellites
-            do {
-               // Mark the satellites for this combination
-               Sats = SaveSats;
-               for(i=0; i<GoodIndexes.size(); i++)
-                  if(Combo.isSelected(i))
-                     Sats[GoodIndexes[i]].id = -::abs(Sats[GoodIndexes[i]].id);
-
-               if(LOGlevel >= ConfigureLOG::Level("DEBUG")) {
-                  ostringstream oss;
-                  oss << " RAIM: Try the combo ";
-                  for(i=0; i<Sats.size(); i++) {
-                     RinexSatID rs(::abs(Sats[i].id), Sats[i].system);
-                     oss << " " << (Sats[i].id < 0 ? "-" : " ") << rs;
-                  }
-                  LOG(DEBUG) << oss.str();
+            // screen the combinations; if this is not possible, solve them all
+            bool screen(false);
+            vector<bool>& Candidate(work.Candidate);
+            if(ScreenRAIM && haveScreen && stage > 0 &&
+               N-stage >= int(ScreenP.cols()))
+               screen = screenCombos(ScreenP, ScreenR, ScreenW, stage,
+                                     ConvergenceLimit, ScreenRMS, ScreenErr);
+            if(screen) {
+               double minUpper(-1.0);
+               for(i=0; i<ScreenRMS.size(); i++) {
+                  if(ScreenRMS[i] < 0.0) continue;
+                  if(minUpper < 0.0 || ScreenRMS[i]+ScreenErr[i] < minUpper)
+                     minUpper = ScreenRMS[i]+ScreenErr[i];
                }
+               // the last one is left to pass 1, which always solves it, so that
+               // it is solved last; it sets iret and the member data for after
+               // the loop, as when every combination is solved in order.
+               Candidate.resize(ScreenRMS.size());
+               for(i=0; i<ScreenRMS.size(); i++)
+                  Candidate[i] = (i < ScreenRMS.size()-1 && (ScreenRMS[i] < 0.0 ||
+                                  ScreenRMS[i]-ScreenErr[i] <= minUpper));
+            }
 
-               // ----------------------------------------------------------------
-               // Compute a solution given the data; ignore ranges for marked
-               // satellites. Fill Vector 'Slopes' with slopes for each unmarked
-               // satellite.
-               // Return 0  ok
-               //       -1  failed to converge
-               //       -2  singular problem
-               //       -3  not enough good data
-               //       -4  no ephemeris
-               iret = SimplePRSolution(Tr, Sats, SVP, invMC, pTropModel,
-                       MaxNIterations, ConvergenceLimit, Syss, Resids, Slopes);
-
-               LOG(DEBUG) << " RAIM: SimplePRS returns " << iret;
-               if(iret <= 0 && iret > BestIret) BestIret = iret;
-
-               // ----------------------------------------------------------------
-               // if error, either quit or continue with next combo (SPS sets Valid F)
-               if(iret < 0) {
-                  if(iret == -1) {
-                     LOG(DEBUG) << " SPS: Failed to converge - go on";
-                     continue;
+            // pass 0 solves the candidates. Pass 1 solves the rest that could
+            // still beat the best solution found, which is usually only the
+            // last; if any candidate failed, the screening is not to be trusted
+            // and pass 1 solves them all. Screening requires N-stage satellites
+            // enough for every system, so no combination returns -3 or -4.
+            bool failed(false);
+            for(int pass=0; pass < (screen ? 2 : 1); pass++) {
+
+               // compute all the combinations of N satellites taken stage at a time
+               Combinations Combo(N,stage);
+               size_t nCombo(0);
+
+               // compute a solution for each combination of marked satellites
+               do {
+                  const size_t iCombo(nCombo++);
+                  if(screen) {
+                     if(Candidate[iCombo] != (pass == 0))
+                        continue;
+                     if(pass == 1 && !failed && BestRMS >= 0.0 &&
+                        iCombo != Candidate.size()-1 &&
+                        ScreenRMS[iCombo]-ScreenErr[iCombo] > BestRMS)
+                        continue;
                   }
-                  else if(iret == -2) {
-                     LOG(DEBUG) << " SPS: singular - go on";
-                     continue;
+
+                  // Mark the satellites for this combination
+                  Sats = SaveSats;
+                  for(i=0; i<GoodIndexes.size(); i++)
+                     if(Combo.isSelected(i))
+                        Sats[GoodIndexes[i]].id = -::abs(Sats[GoodIndexes[i]].id);
+
+                  if(LOGlevel >= ConfigureLOG::Level("DEBUG")) {
+                     ostringstream oss;
+                     oss << " RAIM: Try the combo ";
+                     for(i=0; i<Sats.size(); i++) {
+                        RinexSatID rs(::abs(Sats[i].id), Sats[i].system);
+                        oss << " " << (Sats[i].id < 0 ? "-" : " ") << rs;
+                     }
+                     LOG(DEBUG) << oss.str();
                   }
-                  else if(iret == -3) {
-                     LOG(DEBUG) <<" SPS: not enough satellites: quit";
-                     break;
+
+                  // ----------------------------------------------------------------
+                  // Compute a solution given the data; ignore ranges for marked
+                  // satellites. Fill Vector 'Slopes' with slopes for each unmarked
+                  // satellite.
+                  // Return 0  ok
+                  //       -1  failed to converge
+                  //       -2  singular problem
+                  //       -3  not enough good data
+                  //       -4  no ephemeris
+                  iret = SimplePRSolution(Tr, Sats, SVP, invMC, pTropModel,
+                          MaxNIterations, ConvergenceLimit, Syss, Resids, Slopes);
+
+                  NCombos++;
+                  LOG(DEBUG) << " RAIM: SimplePRS returns " << iret;
+                  if(iret <= 0 && iret > BestIret) BestIret = iret;
+                  if(screen && iret < 0) failed = true;
+
+                  // ----------------------------------------------------------------
+                  // if error, either quit or continue with next combo (SPS sets Valid F)
+                  if(iret < 0) {
+                     if(iret == -1) {
+                        LOG(DEBUG) << " SPS: Failed to converge - go on";
+                        continue;
+                     }
+                     else if(iret == -2) {
+                        LOG(DEBUG) << " SPS: singular - go on";
+                        continue;
+                     }
+                     else if(iret == -3) {
+                        LOG(DEBUG) <<" SPS: not enough satellites: quit";
+                        break;
+                     }
+                     else if(iret == -4) {
+                        LOG(DEBUG) <<" SPS: no ephemeris: quit";
+                        break;
+                     }
                   }
-                  else if(iret == -4) {
-                     LOG(DEBUG) <<" SPS: no ephemeris: quit";
-                     break;
+
+                  // ----------------------------------------------------------------
+                  // print solution with diagnostic information
+                  LOG(DEBUG) << outputString(string("RPS"),iret);
+
+                  // do again for residuals
+                  // if memory exists, output residuals
+                  //if(hasMemory) LOG(DEBUG) << outputString(string("RAP"), -99,
+                        //(Solution-memory.APSolution));
+
+                  // deal with the results of SimplePRSolution()
+                  // save 'best' solution for later
+                  if(BestRMS < 0.0 || RMSResidual < BestRMS ||
+                     (RMSResidual == BestRMS && stage == BestStage &&
+                      int(iCombo) < BestCombo)) {
+                     BestStage = stage;
+                     BestCombo = iCombo;
+                     BestRMS = RMSResidual;
+                     BestSol = Solution;
+                     BestSats = SatelliteIDs;
+                     BestSyss = SystemIDs;
+                     BestSL = MaxSlope;
+                     BestConv = Convergence;
+                     BestNIter = NIterations;
+                     BestCov = Covariance;
+                     BestInvMCov = invMeasCov;
+                     BestPartials = Partials;
+                     BestPFR = PreFitResidual;
+                     BestTropFlag = TropFlag;
+                     BestIret = iret;
                   }
-               }
 
-               // ----------------------------------------------------------------
-               // print solution with diagnostic information
-               LOG(DEBUG) << outputString(string("RPS"),iret);
-
-               // do again for residuals
-               // if memory exists, output residuals
-               //if(hasMemory) LOG(DEBUG) << outputString(string("RAP"), -99,
-                     //(Solution-memory.APSolution));
-
-               // deal with the results of SimplePRSolution()
-               // save 'best' solution for later
-               if(BestRMS < 0.0 || RMSResidual < BestRMS) {
-                  BestRMS = RMSResidual;
-                  BestSol = Solution;
-                  BestSats = SatelliteIDs;
-                  BestSyss = SystemIDs;
-                  BestSL = MaxSlope;
-                  BestConv = Convergence;
-                  BestNIter = NIterations;
-                  BestCov = Covariance;
-                  BestInvMCov = invMeasCov;
-                  BestPartials = Partials;
-                  BestPFR = PreFitResidual;
-                  BestTropFlag = TropFlag;
-                  BestIret = iret;
-               }
+                  // save the all-in-view solution for screening
+                  if(stage == 0 && iret == 0 && Partials.rows() == size_t(N)) {
+                     ScreenP = Partials;
+                     ScreenR = Resids;
+                     ScreenW.resize(0);
+                     haveScreen = true;
+                     if(invMeasCov.rows() > 0) {
+                        ScreenW.resize(N);
+                        for(i=0; i<size_t(N); i++) {
+                           ScreenW(i) = invMeasCov(i,i);
+                           for(j=0; j<size_t(N); j++)
+                              if(j != i && invMeasCov(i,j) != 0.0)
+                                 haveScreen = false;
+                        }
+                     }
+                  }
 
-               if(stage==0 && RMSResidual < RMSLimit)
-                  break;
+                  if(stage==0 && RMSResidual < RMSLimit)
+                     break;
 
-            } while(Combo.Next() != -1);  // get the next combinations and repeat
+               } while(Combo.Next() != -1);  // get the next combinations and repeat
+
+               if(iret == -3 || iret == -4) break;
+            }  // end loop over passes
 
             // end of the stage
             if(BestRMS > 0.0 && BestRMS < RMSLimit) {          // success
@@ -825,8 +1150,20 @@ namespace gpstk
    int PRSolution::DOPCompute(void) throw(Exception)
    {
       try {
-         Matrix<double> PTP(transpose(Partials)*Partials);
-         Matrix<double> Cov(inverseLUD(PTP));
+         // use the fixed-size solver when possible, as SimplePRSolution() does
+         const Matrix<double> noWeights;
+         Matrix<double>& Cov(work.DOPCov);
+         Cov.resize(Partials.cols(),Partials.cols());
+         work.G.resize(Partials.cols(),Partials.rows());
+         bool solved;
+         try {
+            solved = normalSolve(Partials, noWeights, Cov, work.G);
+         }
+         catch(SingularMatrixException& sme) { solved = false; }
+         if(!solved) {
+            Matrix<double> PTP(transpose(Partials)*Partials);
+            Cov = inverseLUD(PTP);
+         }
          PDOP = SQRT(Cov(0,0)+Cov(1,1)+Cov(2,2));
          TDOP = 0.0;
          for(size_t i=3; i<Cov.rows(); i++) TDOP += Cov(i,i);
@@ -1045,6 +1382,7 @@ namespace gpstk
          << "\n   RAIM slope limit " << fixed << SlopeLimit << " meters"
          << "\n   Maximum number of satellites to reject is " << NSatsReject
          << "\n   Memory information IS " << (hasMemory ? "":"NOT ") << "stored"
+         << "\n   RAIM combinations ARE " << (ScreenRAIM ? "":"NOT ") << "screened"
          ;
 
       // TD output memory information
@@ -387,6 +387,8 @@ namespace gpstk
                              MaxNIterations(10),
                              ConvergenceLimit(3.e-7),
                              hasMemory(true),
+                             ScreenRAIM(true),
+                             NCombos(0),
                              Valid(false)
          {}
       /// Return the status of solution
@@ -430,6 +432,14 @@ namespace gpstk
       /// and a combined weighted average solution.
       bool hasMemory;
 
+      /// If true (the default), RAIMCompute() screens the combinations of
+      /// satellites of each stage after the first by linearizing about the
+      /// all-in-view solution, with a bound on the linearization error, and
+      /// solves only those that could give the smallest RMS residual. The
+      /// result is the same as with this false, when every combination is
+      /// solved.
+      bool ScreenRAIM;
+
       // input and output: -------------------------------------------------
 
       /// vector<SatID> containing satellite IDs for all the satellites input, with
@@ -490,6 +500,10 @@ namespace gpstk
       /// the number of good satellites used in the final computation
       int Nsvs;
 
+      /// the number of combinations of satellites solved by the last call to
+      /// RAIMCompute(); with ScreenRAIM this is usually far fewer than tried
+      int NCombos;
+
       /// if true, the solution was constructed from a mixed dataset, including
       /// both GPS and Glonass satellites. This means the Solution vector will have
       /// length 5, with the last element being the estimated GPS-GLO time offset.
@@ -681,6 +695,30 @@ namespace gpstk
       /// empty vector used to detect default
       static const Vector<double> PRSNullVector;
 
+      /// Storage used by SimplePRSolution(), RAIMCompute() and DOPCompute(),
+      /// kept from one call to the next so that, once sized by the first
+      /// epoch, the solution and RAIM loops do not allocate.
+      struct Workspace {
+         Matrix<double> P;             ///< partials
+         Matrix<double> G;             ///< generalized inverse
+         Matrix<double> iMC;           ///< inverse meas. covariance, good sats
+         Matrix<double> DOPCov;        ///< covariance for DOPs
+         Vector<double> CRange;        ///< corrected ranges
+         Vector<double> dX;            ///< solution update
+         std::vector<SatID::SatelliteSystem> Syss;    ///< systems used
+         // RAIMCompute
+         Matrix<double> SVP,BestCov,BestInvMCov,BestPartials;
+         Vector<double> BestSol,BestPFR,Resids,Slopes;
+         std::vector<SatID> BestSats,SaveSats;
+         std::vector<SatID::SatelliteSystem> BestSyss;
+         std::vector<int> GoodIndexes;
+         // RAIM screening
+         Matrix<double> ScreenP;
+         Vector<double> ScreenR,ScreenW;
+         std::vector<double> ScreenRMS,ScreenErr;
+         std::vector<bool> Candidate;
+      } work;
+
    }; // end class PRSolution
 
    //@}
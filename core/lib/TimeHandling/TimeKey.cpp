@@ -0,0 +1,166 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file TimeKey.cpp
+ * gpstk::TimeKey - compact integer time tag for keying containers.
+ */
+
+#include <cmath>
+#include <limits>
+#include "TimeKey.hpp"
+
+namespace gpstk
+{
+      // CommonTime day of the GPS epoch
+   const long TimeKey::REF_JDAY = GPS_EPOCH_MJD + MJD_JDAY;
+   const int64_t TimeKey::NS_PER_SEC = 1000000000LL;
+   const int64_t TimeKey::NS_PER_MS = 1000000LL;
+   const int64_t TimeKey::NS_PER_DAY = 86400LL * 1000000000LL;
+      // symmetric, so that negation of a saturated count stays saturated
+   const int64_t TimeKey::MAX_NS = std::numeric_limits<int64_t>::max();
+   const int64_t TimeKey::MIN_NS = -std::numeric_limits<int64_t>::max();
+
+
+   void TimeKey::convertFromCommonTime(const CommonTime& ct)
+      throw()
+   {
+         // one day short of the limit, so msod and fsod cannot overflow
+      static const int64_t maxDay = MAX_NS / NS_PER_DAY - 1;
+
+      long day, msod;
+      double fsod;
+      TimeSystem ts;
+      ct.getInternal(day, msod, fsod, ts);
+      m_timeSystem = ts.getTimeSystem();
+
+      int64_t dday = static_cast<int64_t>(day) - REF_JDAY;
+      if(dday > maxDay)
+         m_ns = MAX_NS;
+      else if(dday < -maxDay)
+         m_ns = MIN_NS;
+      else
+         m_ns = dday * NS_PER_DAY + static_cast<int64_t>(msod) * NS_PER_MS
+              + std::llround(fsod * NS_PER_SEC);
+   }
+
+
+   CommonTime TimeKey::convertToCommonTime() const
+      throw()
+   {
+      CommonTime ct;
+      if(m_ns == MAX_NS)
+         ct = CommonTime::END_OF_TIME;
+      else if(m_ns == MIN_NS)
+         ct = CommonTime::BEGINNING_OF_TIME;
+      else
+      {
+         int64_t day(m_ns / NS_PER_DAY), rem(m_ns % NS_PER_DAY);
+         if(rem < 0)
+         {
+            rem += NS_PER_DAY;
+            day--;
+         }
+         ct.setInternal(REF_JDAY + static_cast<long>(day),
+                        static_cast<long>(rem / NS_PER_MS),
+                        static_cast<double>(rem % NS_PER_MS) / NS_PER_SEC);
+      }
+      ct.setTimeSystem(getTimeSystem());
+      return ct;
+   }
+
+
+   void TimeKey::throwSystemMismatch(const TimeKey& right) const
+      throw(InvalidRequest)
+   {
+      InvalidRequest ir("TimeKey objects not in same time system,"
+                        " cannot be compared: " + getTimeSystem().asString()
+                        + " != " + right.getTimeSystem().asString());
+      GPSTK_THROW(ir);
+   }
+
+
+   double TimeKey::operator-(const TimeKey& right) const
+      throw(InvalidRequest)
+   {
+      checkSystem(right);
+
+         // the keys span more than the range of int64_t
+      if(isSaturated() || right.isSaturated() ||
+         (right.m_ns < 0 && m_ns > MAX_NS + right.m_ns) ||
+         (right.m_ns > 0 && m_ns < MIN_NS + right.m_ns))
+         return convertToCommonTime() - right.convertToCommonTime();
+
+      return static_cast<double>(m_ns - right.m_ns) / NS_PER_SEC;
+   }
+
+
+   TimeKey& TimeKey::addNanoseconds(int64_t ns)
+      throw()
+   {
+      if(isSaturated())
+         return *this;
+
+      if(ns > 0 && m_ns > MAX_NS - ns)
+         m_ns = MAX_NS;
+      else if(ns < 0 && m_ns < MIN_NS - ns)
+         m_ns = MIN_NS;
+      else
+         m_ns += ns;
+
+      return *this;
+   }
+
+
+   int64_t TimeKey::toNanoseconds(double seconds)
+      throw()
+   {
+      double ns(seconds * NS_PER_SEC);
+      if(ns >= static_cast<double>(MAX_NS))
+         return MAX_NS;
+      if(ns <= static_cast<double>(MIN_NS))
+         return MIN_NS;
+      return std::llround(ns);
+   }
+
+
+   std::ostream& operator<<(std::ostream& s, const TimeKey& t)
+   {
+      s << t.convertToCommonTime();
+      return s;
+   }
+
+} // namespace gpstk
@@ -0,0 +1,224 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file TimeKey.hpp
+ * gpstk::TimeKey - compact integer time tag for keying containers.
+ */
+
+#ifndef GPSTK_TIMEKEY_HPP
+#define GPSTK_TIMEKEY_HPP
+
+#include <cstddef>
+#include <functional>
+#include "gpstkplatform.h"
+#include <ostream>
+#include "CommonTime.hpp"
+
+namespace gpstk
+{
+      /// @ingroup TimeHandling
+      //@{
+
+      /**
+       * A compact time tag for use as the key of maps and hash tables
+       * of time-tagged data, e.g. the tables of the ephemeris stores.
+       * The time is held as a signed 64-bit count of nanoseconds from
+       * the GPS epoch (Jan. 6, 1980) plus the time system, so that
+       * comparisons and hashing are single integer operations rather
+       * than the day/msod/fsod comparisons of CommonTime.
+       *
+       * The count covers about +/- 292 years around the GPS epoch.
+       * Within that range, conversion from CommonTime rounds to the
+       * nearest nanosecond and conversion back to CommonTime is
+       * exact; a CommonTime outside the range (e.g.
+       * CommonTime::BEGINNING_OF_TIME or CommonTime::END_OF_TIME)
+       * saturates to the smallest or largest key, which still orders
+       * correctly against every other key and converts back to
+       * BEGINNING_OF_TIME or END_OF_TIME.
+       *
+       * The time system is checked in the same way as CommonTime:
+       * TimeSystem::Any matches every system, keys of two different
+       * systems are never equal, and ordering or differencing them
+       * throws InvalidRequest.  So a container keyed by TimeKey
+       * behaves like one keyed by CommonTime when searched with a
+       * time in the wrong system.
+       *
+       * TimeKey converts implicitly to and from CommonTime, so a
+       * std::map<TimeKey, T> can be searched with a CommonTime and its
+       * keys used wherever a CommonTime is expected.
+       */
+   class TimeKey
+   {
+   public:
+         /// 'Julian day' (as in CommonTime) of the zero of the key.
+      static const long REF_JDAY;
+         /// Nanoseconds per second.
+      static const int64_t NS_PER_SEC;
+         /// Nanoseconds per millisecond.
+      static const int64_t NS_PER_MS;
+         /// Nanoseconds per day.
+      static const int64_t NS_PER_DAY;
+
+         /// Default constructor, the GPS epoch in an unknown time system.
+      TimeKey() throw()
+            : m_ns(0), m_timeSystem(TimeSystem::Unknown)
+      {}
+
+         /// Construct from nanoseconds since the GPS epoch.
+      explicit TimeKey(int64_t ns,
+                       TimeSystem::Systems sys = TimeSystem::Unknown)
+         throw()
+            : m_ns(ns), m_timeSystem(sys)
+      {}
+
+         /** Construct from a CommonTime, rounding to the nearest
+          * nanosecond; deliberately not explicit.  Times outside the
+          * range of the key saturate, see above. */
+      TimeKey(const CommonTime& ct) throw()
+      { convertFromCommonTime(ct); }
+
+         /// Set from a CommonTime, rounding to the nearest nanosecond.
+      void convertFromCommonTime(const CommonTime& ct) throw();
+
+         /// @return this time as a CommonTime.
+      CommonTime convertToCommonTime() const throw();
+
+         /// Implicit conversion to CommonTime.
+      operator CommonTime() const throw()
+      { return convertToCommonTime(); }
+
+         /// @return nanoseconds since the GPS epoch.
+      int64_t getNanoseconds() const throw()
+      { return m_ns; }
+
+         /// @return the time system of this key.
+      TimeSystem getTimeSystem() const throw()
+      { return TimeSystem(m_timeSystem); }
+
+         /// @return true if this key is saturated at either end of its range.
+      bool isSaturated() const throw()
+      { return (m_ns == MIN_NS || m_ns == MAX_NS); }
+
+         /** Difference in seconds (this - right).
+          * @throw InvalidRequest if the time systems differ and
+          *   neither is TimeSystem::Any. */
+      double operator-(const TimeKey& right) const
+         throw(InvalidRequest);
+
+         /// Add (possibly negative) nanoseconds, saturating at the ends.
+      TimeKey& addNanoseconds(int64_t ns) throw();
+
+         /// @return this time plus seconds, rounded to the nanosecond.
+      TimeKey operator+(double seconds) const throw()
+      { return TimeKey(*this).addNanoseconds(toNanoseconds(seconds)); }
+
+         /// @return this time minus seconds, rounded to the nanosecond.
+      TimeKey operator-(double seconds) const throw()
+      { return TimeKey(*this).addNanoseconds(-toNanoseconds(seconds)); }
+
+         /// @name Comparison operators.
+         /// Equality is false, and the ordering operators throw
+         /// InvalidRequest, if the time systems differ and neither is
+         /// TimeSystem::Any.
+         //@{
+      bool operator==(const TimeKey& right) const throw()
+      { return m_ns == right.m_ns && sameSystem(right); }
+      bool operator!=(const TimeKey& right) const throw()
+      { return !operator==(right); }
+      bool operator<(const TimeKey& right) const throw(InvalidRequest)
+      { checkSystem(right); return m_ns < right.m_ns; }
+      bool operator>(const TimeKey& right) const throw(InvalidRequest)
+      { checkSystem(right); return m_ns > right.m_ns; }
+      bool operator<=(const TimeKey& right) const throw(InvalidRequest)
+      { checkSystem(right); return m_ns <= right.m_ns; }
+      bool operator>=(const TimeKey& right) const throw(InvalidRequest)
+      { checkSystem(right); return m_ns >= right.m_ns; }
+         //@}
+
+         /// Hash value, consistent with operator==.
+      std::size_t hash() const throw()
+      { return std::hash<int64_t>()(m_ns); }
+
+   private:
+         /// @return true if the time systems of this and right match.
+      bool sameSystem(const TimeKey& right) const throw()
+      {
+         return (m_timeSystem == right.m_timeSystem ||
+                 m_timeSystem == TimeSystem::Any ||
+                 right.m_timeSystem == TimeSystem::Any);
+      }
+
+         /// @throw InvalidRequest unless sameSystem(right).
+      void checkSystem(const TimeKey& right) const throw(InvalidRequest)
+      {
+         if(!sameSystem(right))
+            throwSystemMismatch(right);
+      }
+
+         /// Throw the InvalidRequest for keys in different time systems.
+      void throwSystemMismatch(const TimeKey& right) const
+         throw(InvalidRequest);
+
+         /// Seconds to nanoseconds, rounded and limited to the key range.
+      static int64_t toNanoseconds(double seconds) throw();
+
+         /// Smallest and largest counts, used for saturated keys.
+      static const int64_t MIN_NS;
+      static const int64_t MAX_NS;
+
+      int64_t m_ns;                        ///< nanoseconds since GPS epoch
+      TimeSystem::Systems m_timeSystem;    ///< time system of the key
+   };
+
+      /// Stream output, as the equivalent CommonTime.
+   std::ostream& operator<<(std::ostream& s, const TimeKey& t);
+
+      //@}
+
+} // namespace gpstk
+
+namespace std
+{
+      /// Hash support so that TimeKey can key std::unordered_map.
+   template<> struct hash<gpstk::TimeKey>
+   {
+      std::size_t operator()(const gpstk::TimeKey& t) const
+      { return t.hash(); }
+   };
+}
+
+#endif // GPSTK_TIMEKEY_HPP
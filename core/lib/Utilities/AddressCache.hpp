@@ -0,0 +1,120 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file AddressCache.hpp
+ * Thread-safe cache of values computed from objects, keyed by address.
+ */
+
+#ifndef GPSTK_ADDRESSCACHE_HPP
+#define GPSTK_ADDRESSCACHE_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace gpstk
+{
+      /** Values derived from objects held elsewhere, e.g. by a
+       * store, keyed by the address of the object.  The owner of
+       * the objects must erase() an entry when its object is
+       * deleted or changed, and clear() the cache when it replaces
+       * objects wholesale.
+       *
+       * Copies start empty, since the addresses are those of the
+       * objects in the original.  Values are shared, so one
+       * returned by get() stays valid after its entry is erased.
+       * @tparam Key type of the objects.
+       * @tparam Value type of the values computed from them. */
+   template <class Key, class Value>
+   class AddressCache
+   {
+   public:
+      typedef std::shared_ptr<const Value> ValuePtr;
+
+      AddressCache() {}
+      AddressCache(const AddressCache&) {}
+      AddressCache& operator=(const AddressCache&)
+      { clear(); return *this; }
+
+         /// Remove all entries.
+      void clear()
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         table.clear();
+      }
+
+         /// Remove the entry for one object, if any.
+      void erase(const Key* key)
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         table.erase(key);
+      }
+
+         /** Return the value for an object, computing it if needed.
+          * The computation runs without holding the lock, so that
+          * values for other objects can be looked up meanwhile; if
+          * two threads compute the value for the same object, the
+          * first one stored is returned to both.
+          * @param[in] key the object.
+          * @param[in] compute called as compute(value) to fill in a
+          *   default-constructed value for key. */
+      template <class Compute>
+      ValuePtr get(const Key* key, Compute compute)
+      {
+         {
+            std::lock_guard<std::mutex> lock(mutex);
+            typename Table::const_iterator it = table.find(key);
+            if(it != table.end())
+               return it->second;
+         }
+         std::shared_ptr<Value> value(new Value);
+         compute(*value);
+         std::lock_guard<std::mutex> lock(mutex);
+         return table.insert(std::make_pair(key, ValuePtr(value)))
+            .first->second;
+      }
+
+   private:
+      typedef std::map<const Key*, ValuePtr> Table;
+
+      std::mutex mutex;
+      Table table;
+   };
+
+} // namespace gpstk
+
+#endif // GPSTK_ADDRESSCACHE_HPP
@@ -0,0 +1,122 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file ParallelFor.hpp
+ * Run a loop body over a range of indexes on a set of threads.
+ */
+
+#ifndef GPSTK_PARALLELFOR_HPP
+#define GPSTK_PARALLELFOR_HPP
+
+#include <cstddef>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace gpstk
+{
+      /** Resolve a requested number of worker threads.
+       * @param[in] nthreads requested number of threads; 0 means one
+       *   per hardware thread.
+       * @param[in] n number of work items; no more threads than this
+       *   are used.
+       * @return the number of threads to use, at least 1. */
+   inline unsigned parallelThreadCount(unsigned nthreads, std::size_t n)
+   {
+      if(nthreads == 0)
+         nthreads = std::thread::hardware_concurrency();
+      if(nthreads == 0)
+         nthreads = 1;
+      if(n < nthreads)
+         nthreads = (n == 0 ? 1 : static_cast<unsigned>(n));
+      return nthreads;
+   }
+
+      /** Call func(i) for i = 0,...,n-1, distributing the indexes
+       * over up to nthreads threads.  Indexes are handed out in
+       * increasing order from a shared counter, so uneven work items
+       * balance across the threads.  With one thread the loop runs
+       * in the calling thread.  Calls for different i run
+       * concurrently, so func must only modify data private to its
+       * index.
+       *
+       * An exception escaping func does not stop the other threads;
+       * once all have finished, the exception from the lowest index
+       * is rethrown.
+       * @param[in] n number of work items.
+       * @param[in] nthreads number of threads, 0 for one per hardware
+       *   thread (see parallelThreadCount()).
+       * @param[in] func callable with signature void(std::size_t). */
+   template <class Func>
+   void parallelFor(std::size_t n, unsigned nthreads, Func func)
+   {
+      nthreads = parallelThreadCount(nthreads, n);
+      if(nthreads == 1)
+      {
+         for(std::size_t i=0; i<n; i++)
+            func(i);
+         return;
+      }
+
+      std::atomic<std::size_t> next(0);
+      std::vector<std::exception_ptr> errors(n);
+      std::vector<std::thread> threads;
+      threads.reserve(nthreads);
+      for(unsigned t=0; t<nthreads; t++)
+      {
+         threads.push_back(std::thread([&]()
+            {
+               std::size_t i;
+               while((i = next++) < n)
+               {
+                  try { func(i); }
+                  catch(...) { errors[i] = std::current_exception(); }
+               }
+            }));
+      }
+      for(unsigned t=0; t<nthreads; t++)
+         threads[t].join();
+
+      for(std::size_t i=0; i<n; i++)
+         if(errors[i])
+            std::rethrow_exception(errors[i]);
+   }
+
+} // namespace gpstk
+
+#endif // GPSTK_PARALLELFOR_HPP
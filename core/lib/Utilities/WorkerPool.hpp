@@ -0,0 +1,183 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file WorkerPool.hpp
+ * A set of persistent threads that run loop bodies over ranges of indexes.
+ */
+
+#ifndef GPSTK_WORKERPOOL_HPP
+#define GPSTK_WORKERPOOL_HPP
+
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ParallelFor.hpp"
+
+namespace gpstk
+{
+      /** Run loop bodies like parallelFor(), but on threads that are
+       * started once and kept waiting between calls of run().  This
+       * is for callers that run many small loops, e.g. once per
+       * epoch, where starting threads for each loop would cost more
+       * than the work itself.
+       *
+       * The thread calling run() takes part in the loop, so a pool
+       * of one thread starts no other threads.  run() must not be
+       * called concurrently or from within a loop body. */
+   class WorkerPool
+   {
+   public:
+         /** Start the worker threads.
+          * @param[in] nthreads number of threads including the
+          *   caller of run(), 0 for one per hardware thread. */
+      explicit WorkerPool(unsigned nthreads = 0)
+            : jobSize(0), next(0), busy(0), generation(0), stopping(false)
+      {
+         nthreads = parallelThreadCount(nthreads, std::size_t(-1));
+         for(unsigned t=1; t<nthreads; t++)
+            threads.push_back(std::thread(&WorkerPool::work, this));
+      }
+
+         /// Stop and join the worker threads.
+      ~WorkerPool()
+      {
+         {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+         }
+         wake.notify_all();
+         for(unsigned t=0; t<threads.size(); t++)
+            threads[t].join();
+      }
+
+         /// Return the number of threads, including the caller of run().
+      unsigned size() const throw()
+      { return threads.size() + 1; }
+
+         /** Call func(i) for i = 0,...,n-1 on the pool's threads,
+          * returning once all calls have finished.  Indexes and
+          * exceptions are handled as by parallelFor().
+          * @param[in] n number of work items.
+          * @param[in] func callable with signature void(std::size_t). */
+      template <class Func>
+      void run(std::size_t n, Func func)
+      {
+         if(threads.empty() || n < 2)
+         {
+            for(std::size_t i=0; i<n; i++)
+               func(i);
+            return;
+         }
+         {
+            std::lock_guard<std::mutex> lock(mtx);
+            job = func;
+            jobSize = n;
+            next = 0;
+            errors.assign(n, std::exception_ptr());
+            busy = threads.size();
+            generation++;
+         }
+         wake.notify_all();
+         drain();
+         std::unique_lock<std::mutex> lock(mtx);
+         done.wait(lock, [this]() { return busy == 0; });
+         job = nullptr;
+         for(std::size_t i=0; i<n; i++)
+            if(errors[i])
+               std::rethrow_exception(errors[i]);
+      }
+
+   private:
+      WorkerPool(const WorkerPool&);
+      WorkerPool& operator=(const WorkerPool&);
+
+         /// Body of the worker threads: wait for a job and help run it.
+      void work()
+      {
+         unsigned long seen = 0;
+         std::unique_lock<std::mutex> lock(mtx);
+         while(true)
+         {
+            wake.wait(lock,
+                      [&]() { return stopping || generation != seen; });
+            if(stopping)
+               return;
+            seen = generation;
+            lock.unlock();
+            drain();
+            lock.lock();
+            if(--busy == 0)
+               done.notify_one();
+         }
+      }
+
+         /// Run indexes of the current job until none are left.
+      void drain()
+      {
+         std::size_t i;
+         while((i = next++) < jobSize)
+         {
+            try { job(i); }
+            catch(...) { errors[i] = std::current_exception(); }
+         }
+      }
+
+      std::vector<std::thread> threads;
+      std::mutex mtx;
+         /// Signals a new job or shutdown to the workers.
+      std::condition_variable wake;
+         /// Signals run() that every worker is done with the job.
+      std::condition_variable done;
+      std::function<void(std::size_t)> job;
+      std::size_t jobSize;
+      std::atomic<std::size_t> next;
+      std::vector<std::exception_ptr> errors;
+         /// Number of workers that have not finished the current job.
+      unsigned busy;
+         /// Incremented for each job, so workers run each one once.
+      unsigned long generation;
+      bool stopping;
+   };
+
+} // namespace gpstk
+
+#endif // GPSTK_WORKERPOOL_HPP
@@ -0,0 +1,246 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <cstdio>
+#include <fstream>
+#include <list>
+#include <vector>
+
+#include "RinexObsStream.hpp"
+#include "RinexObsHeader.hpp"
+#include "RinexObsData.hpp"
+#include "RinexObsFilterOperators.hpp"
+#include "FileFilterFrameWithHeader.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+typedef FileFilterFrameWithHeader<RinexObsStream, RinexObsData,
+                                  RinexObsHeader> ObsFrame;
+
+   /** Compare the streaming merge of FileFilterFrame with sort() and
+    * unique() of the data in memory. */
+class FileFilterFrame_T
+{
+public:
+   FileFilterFrame_T()
+   {
+      dataPath = gpstk::getPathData() + gpstk::getFileSep();
+      tempPath = gpstk::getPathTestTemp() + gpstk::getFileSep();
+   }
+
+      /// setStreaming() and streamMerge() preconditions
+   int streamingTest();
+      /// streamMerge() and mergeFile() against sort() and unique()
+   int mergeTest();
+
+private:
+      /// Time order of RINEX obs data
+   struct TimeLess
+   {
+      bool operator()(const RinexObsData& l, const RinexObsData& r) const
+      { return l.time < r.time; }
+   };
+
+      /// Write the data of a RINEX obs file in reverse order.
+      /// @return the name of the new file
+   string reverseFile(const string& fn);
+
+   string dataPath, tempPath;
+}; // class FileFilterFrame_T
+
+
+string FileFilterFrame_T ::
+reverseFile(const string& fn)
+{
+   RinexObsStream in(fn.c_str());
+   RinexObsHeader hdr;
+   RinexObsData rod;
+   list<RinexObsData> data;
+   in >> hdr;
+   while(in >> rod)
+      data.push_front(rod);
+
+   string out(tempPath + "FileFilterFrame_T_reversed.15o");
+   RinexObsStream os(out.c_str(), ios::out|ios::trunc);
+   os << hdr;
+   for(list<RinexObsData>::const_iterator it = data.begin();
+       it != data.end(); it++)
+      os << *it;
+   return out;
+}
+
+
+int FileFilterFrame_T ::
+streamingTest()
+{
+   TUDEF("FileFilterFrame", "setStreaming");
+   vector<string> files(1, dataPath + "arlm200a.15o");
+
+   ObsFrame loaded(files);
+   TUASSERT(!loaded.isStreaming());
+   TUASSERT(!loaded.empty());
+   try
+   {
+      loaded.setStreaming(true);
+      TUFAIL("setStreaming() after loading did not throw");
+   }
+   catch(InvalidRequest& e)
+   {
+      TUPASS("setStreaming() after loading");
+   }
+
+   TUCSM("streamMerge");
+   try
+   {
+      loaded.streamMerge(TimeLess(), RinexObsDataOperatorEqualsSimple(),
+                         [](const RinexObsData&) {}, tempPath);
+      TUFAIL("streamMerge() when not streaming did not throw");
+   }
+   catch(InvalidRequest& e)
+   {
+      TUPASS("streamMerge() when not streaming");
+   }
+
+   ObsFrame streamed;
+   streamed.setStreaming(true);
+   streamed.newSource(files);
+   TUASSERT(streamed.isStreaming());
+   TUASSERT(streamed.empty());
+   TUASSERTE(size_t, 1, streamed.getHeaderCount());
+   TURETURN();
+}
+
+
+int FileFilterFrame_T ::
+mergeTest()
+{
+   TUDEF("FileFilterFrame", "streamMerge");
+      // one file twice, for duplicates, and one out of order
+   vector<string> files;
+   files.push_back(dataPath + "arlm200a.15o");
+   files.push_back(reverseFile(dataPath + "arlm200b.15o"));
+   files.push_back(dataPath + "arlm200a.15o");
+
+   ObsFrame loaded(files);
+   loaded.sort(TimeLess());
+   loaded.unique(RinexObsDataOperatorEqualsSimple());
+   list<RinexObsData> expected(loaded.getData());
+   TUASSERT(expected.size() > 100);
+
+      // small runs, so the reversed file is sorted in several, in a
+      // directory of their own that holds one file not to be touched
+   ObsFrame streamed;
+   streamed.setStreaming(true, 50);
+   streamed.newSource(files);
+   list<RinexObsData> merged;
+   string runDir(tempPath + "FileFilterFrame_T_runs");
+   FileUtils::makeDir(runDir, 0755);
+   string keep(runDir + getFileSep() + "keep");
+   {
+      ofstream ofs(keep.c_str());
+      ofs << "keep" << endl;
+   }
+   unsigned long n = streamed.streamMerge(
+      TimeLess(), RinexObsDataOperatorEqualsSimple(),
+      [&merged](const RinexObsData& rod) { merged.push_back(rod); },
+      runDir);
+   TUASSERTE(unsigned long, expected.size(), n);
+   TUASSERTE(size_t, expected.size(), merged.size());
+   TUASSERTE(int, loaded.getFiltered(), streamed.getFiltered());
+   string line;
+   {
+      ifstream ifs(keep.c_str());
+      getline(ifs, line);
+   }
+   TUASSERTE(string, "keep", line);
+      // the directory is empty once the file not ours is gone, so the
+      // runs were removed
+   std::remove(keep.c_str());
+   TUASSERTE(int, 0, std::remove(runDir.c_str()));
+
+   list<RinexObsData>::const_iterator eit = expected.begin(),
+      mit = merged.begin();
+   bool same = true;
+   for( ; eit != expected.end() && mit != merged.end(); eit++, mit++)
+   {
+      if(eit->time != mit->time || eit->obs.size() != mit->obs.size() ||
+         eit->clockOffset != mit->clockOffset)
+         same = false;
+   }
+   TUASSERT(same);
+
+   TUCSM("mergeFile");
+   string out(tempPath + "FileFilterFrame_T_merged.15o");
+   n = streamed.mergeFile(out, streamed.frontHeader(), TimeLess(),
+                          RinexObsDataOperatorEqualsSimple());
+   TUASSERTE(unsigned long, expected.size(), n);
+   RinexObsStream in(out.c_str());
+   RinexObsHeader hdr;
+   RinexObsData rod;
+   in >> hdr;
+   unsigned long count = 0;
+   CommonTime prev(CommonTime::BEGINNING_OF_TIME);
+   bool ordered = true;
+   while(in >> rod)
+   {
+      if(rod.time <= prev)
+         ordered = false;
+      prev = rod.time;
+      count++;
+   }
+   TUASSERTE(unsigned long, expected.size(), count);
+   TUASSERT(ordered);
+   TURETURN();
+}
+
+
+int main(int argc, char *argv[])
+{
+   int  errorTotal = 0;
+
+   FileFilterFrame_T  testClass;
+
+   errorTotal += testClass.streamingTest();
+   errorTotal += testClass.mergeTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return( errorTotal );
+
+} // main()
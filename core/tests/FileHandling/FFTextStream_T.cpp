@@ -0,0 +1,335 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include "FFTextStream.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+#include "RinexNavStream.hpp"
+#include "RinexNavHeader.hpp"
+#include "RinexNavData.hpp"
+#include "SP3Stream.hpp"
+#include "SP3Header.hpp"
+#include "SP3Data.hpp"
+#include <sstream>
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class FFTextStream_T
+{
+public:
+   FFTextStream_T()
+   {
+      init();
+   }
+
+      // initialize tests
+   void init();
+
+      /// compare line-by-line reads between fstream and memory map
+   int lineTest();
+      /// make sure the odd bits (CR, no trailing EOL) are handled alike
+   int edgeTest();
+      /// compare decoded RINEX 3 records between the two modes
+   int recordTest();
+      /// compare decoded RINEX nav records between the two modes
+   int navTest();
+      /// compare decoded SP3 records between the two modes
+   int sp3Test();
+
+      /** Read every record of \a fn both through the fstream and the
+       * memory map, with failbit exceptions enabled the way the
+       * ephemeris stores read, and compare the dump() output. */
+   template <class Stream, class Header, class Data>
+   void compareRecords(TestUtil& testFramework, const string& fn);
+
+   string obsFile;   ///< RINEX 3 obs input file
+   string navFile;   ///< RINEX 2 nav input file
+   string sp3File;   ///< SP3c input file
+   string edgeFile;  ///< Temporary file with CR/LF and no final EOL
+}; // class FFTextStream_T
+
+
+void FFTextStream_T ::
+init()
+{
+   string dp = gpstk::getPathData() + gpstk::getFileSep();
+   string op = gpstk::getPathTestTemp() + gpstk::getFileSep();
+   obsFile = dp + "test_input_rinex3_obs_RinexObsFile.15o";
+   edgeFile = op + "test_output_FFTextStream_edge.txt";
+   navFile = dp + "arlm2000.15n";
+   sp3File = dp + "test_input_SP3c.sp3";
+}
+
+
+int FFTextStream_T ::
+lineTest()
+{
+   TUDEF("FFTextStream", "memoryMap");
+   FFTextStream plain(obsFile.c_str(), ios::in);
+   FFTextStream mapped(obsFile.c_str(), ios::in);
+   TUASSERT(!mapped.isMemoryMapped());
+   TUASSERT(mapped.memoryMap());
+   TUASSERT(mapped.isMemoryMapped());
+   TUCSM("formattedGetLine");
+   string expLine, gotLine;
+   FFTextStream::LineView view;
+   bool expEOF = false, gotEOF = false;
+   unsigned count = 0;
+   while (!expEOF)
+   {
+      try
+      {
+         plain.formattedGetLine(expLine, true);
+      }
+      catch (EndOfFile& e)
+      {
+         expEOF = true;
+      }
+      try
+      {
+            // alternate between the two interfaces
+         if (count & 1)
+         {
+            mapped.formattedGetLine(view, true);
+            gotLine = view.str();
+         }
+         else
+         {
+            mapped.formattedGetLine(gotLine, true);
+         }
+      }
+      catch (EndOfFile& e)
+      {
+         gotEOF = true;
+      }
+      TUASSERTE(bool, expEOF, gotEOF);
+      if (!expEOF)
+      {
+         TUASSERTE(string, expLine, gotLine);
+      }
+      TUASSERTE(unsigned, plain.lineNumber, mapped.lineNumber);
+      count++;
+   }
+   TUASSERT(count > 1);
+      // re-opening the stream drops the memory map
+   mapped.open(obsFile.c_str(), ios::in);
+   TUASSERT(!mapped.isMemoryMapped());
+   TURETURN();
+}
+
+
+int FFTextStream_T ::
+edgeTest()
+{
+   TUDEF("FFTextStream", "formattedGetLine");
+   {
+      ofstream ofs(edgeFile.c_str(), ios::out|ios::binary);
+      ofs << "first line\r\n" << "\r\n" << "last line, no EOL";
+   }
+   FFTextStream::LineView view;
+   for (int mode = 0; mode < 2; mode++)
+   {
+      FFTextStream strm(edgeFile.c_str(), ios::in);
+      if (mode)
+      {
+         TUASSERT(strm.memoryMap());
+      }
+      strm.formattedGetLine(view);
+      TUASSERTE(string, "first line", view.str());
+      strm.formattedGetLine(view);
+      TUASSERTE(std::string::size_type, 0, view.size());
+      strm.formattedGetLine(view);
+      TUASSERTE(string, "last line, no EOL", view.str());
+      TUASSERTE(string, "line", view.substr(5,4));
+      TUASSERTE(string, "EOL", view.substr(14));
+      TUASSERTE(bool, true, strm.eof());
+      TUASSERTE(unsigned, 3, strm.lineNumber);
+         // clear EOF the way FFStream does before reading a record
+      strm.clear();
+      try
+      {
+         strm.formattedGetLine(view, false);
+         TUFAIL("Expected FFStreamError at EOF");
+      }
+      catch (EndOfFile& e)
+      {
+         TUFAIL("Unexpected EndOfFile");
+      }
+      catch (FFStreamError& e)
+      {
+         TUPASS("FFStreamError at EOF");
+      }
+   }
+   TURETURN();
+}
+
+
+int FFTextStream_T ::
+recordTest()
+{
+   TUDEF("FFTextStream", "tryFFStreamGet");
+   Rinex3ObsStream plain(obsFile.c_str());
+   Rinex3ObsStream mapped(obsFile.c_str());
+   TUASSERT(mapped.memoryMap());
+   Rinex3ObsHeader plainHdr, mappedHdr;
+   Rinex3ObsData plainData, mappedData;
+   plain >> plainHdr;
+   mapped >> mappedHdr;
+   TUASSERTE(unsigned, plain.lineNumber, mapped.lineNumber);
+   TUASSERTE(string, plainHdr.markerName, mappedHdr.markerName);
+   unsigned count = 0;
+   while (plain >> plainData)
+   {
+      TUASSERT(static_cast<bool>(mapped >> mappedData));
+      TUASSERTE(CommonTime, plainData.time, mappedData.time);
+      TUASSERTE(short, plainData.epochFlag, mappedData.epochFlag);
+      TUASSERTE(short, plainData.numSVs, mappedData.numSVs);
+      TUASSERTE(size_t, plainData.obs.size(), mappedData.obs.size());
+      Rinex3ObsData::DataMap::const_iterator pi, mi;
+      for (pi = plainData.obs.begin(), mi = mappedData.obs.begin();
+           (pi != plainData.obs.end()) && (mi != mappedData.obs.end());
+           ++pi, ++mi)
+      {
+         TUASSERTE(RinexSatID, pi->first, mi->first);
+         TUASSERTE(size_t, pi->second.size(), mi->second.size());
+         for (size_t i = 0;
+              (i < pi->second.size()) && (i < mi->second.size()); i++)
+         {
+            TUASSERTE(double, pi->second[i].data, mi->second[i].data);
+            TUASSERTE(short, pi->second[i].lli, mi->second[i].lli);
+            TUASSERTE(short, pi->second[i].ssi, mi->second[i].ssi);
+         }
+      }
+      count++;
+   }
+   TUASSERT(count > 0);
+   TUASSERT(!(mapped >> mappedData));
+   TUASSERTE(unsigned, plain.lineNumber, mapped.lineNumber);
+   TURETURN();
+}
+
+
+template <class Stream, class Header, class Data>
+void FFTextStream_T ::
+compareRecords(TestUtil& testFramework, const string& fn)
+{
+   Stream plain(fn.c_str());
+   Stream mapped(fn.c_str());
+   plain.exceptions(ios::failbit);
+   mapped.exceptions(ios::failbit);
+   TUASSERT(mapped.memoryMap());
+   Header plainHdr, mappedHdr;
+   Data plainData, mappedData;
+   plain >> plainHdr;
+   mapped >> mappedHdr;
+   TUASSERTE(unsigned, plain.lineNumber, mapped.lineNumber);
+   unsigned count = 0;
+   bool plainOK = true, mappedOK = true;
+   while (plainOK)
+   {
+      try
+      {
+         plainOK = static_cast<bool>(plain >> plainData) && !plain.eof();
+      }
+      catch (EndOfFile& e)
+      {
+         plainOK = false;
+      }
+      try
+      {
+         mappedOK = static_cast<bool>(mapped >> mappedData) && !mapped.eof();
+      }
+      catch (EndOfFile& e)
+      {
+         mappedOK = false;
+      }
+      TUASSERTE(bool, plainOK, mappedOK);
+      if (!plainOK || !mappedOK)
+         break;
+      ostringstream plainDump, mappedDump;
+      plainData.dump(plainDump);
+      mappedData.dump(mappedDump);
+      TUASSERTE(string, plainDump.str(), mappedDump.str());
+      count++;
+   }
+   TUASSERT(count > 0);
+   TUASSERTE(unsigned, plain.lineNumber, mapped.lineNumber);
+}
+
+
+int FFTextStream_T ::
+navTest()
+{
+   TUDEF("RinexNavData", "reallyGetRecord");
+   compareRecords<RinexNavStream, RinexNavHeader, RinexNavData>(
+      testFramework, navFile);
+   TURETURN();
+}
+
+
+int FFTextStream_T ::
+sp3Test()
+{
+   TUDEF("SP3Data", "reallyGetRecord");
+   compareRecords<SP3Stream, SP3Header, SP3Data>(testFramework, sp3File);
+   TURETURN();
+}
+
+
+   /** Run the program.
+    *
+    * @return Total error count for all tests
+    */
+int main(int argc, char *argv[])
+{
+   int  errorTotal = 0;
+
+   FFTextStream_T  testClass;
+
+   errorTotal += testClass.lineTest();
+   errorTotal += testClass.edgeTest();
+   errorTotal += testClass.recordTest();
+   errorTotal += testClass.navTest();
+   errorTotal += testClass.sp3Test();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return( errorTotal );
+
+} // main()
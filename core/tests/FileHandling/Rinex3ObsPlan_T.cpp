@@ -0,0 +1,209 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+#include "Rinex3ObsPlan.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+   /** Compare the values returned through a Rinex3ObsPlan with those
+    * returned by Rinex3ObsData::getObs(). */
+class Rinex3ObsPlan_T
+{
+public:
+   Rinex3ObsPlan_T()
+   {
+      dataPath = gpstk::getPathData() + gpstk::getFileSep();
+   }
+
+      /// construction and index resolution
+   int indexTest();
+      /// getData() and extract() against getObs(), for a mixed file
+   int extractTest();
+
+private:
+      /// getObs() for a 3- or 4-character type, zero if not available
+   static double expected(const Rinex3ObsData& rod, const RinexSatID& sat,
+                          const string& type, const Rinex3ObsHeader& hdr);
+
+   string dataPath;
+}; // class Rinex3ObsPlan_T
+
+
+double Rinex3ObsPlan_T ::
+expected(const Rinex3ObsData& rod, const RinexSatID& sat, const string& type,
+         const Rinex3ObsHeader& hdr)
+{
+   if(type.size() == 4 && type[0] != sat.systemChar())
+      return 0.0;
+   try
+   {
+      return rod.getObs(sat, type, hdr).data;
+   }
+   catch(Exception& e)
+   {
+      return 0.0;
+   }
+}
+
+
+int Rinex3ObsPlan_T ::
+indexTest()
+{
+   TUDEF("Rinex3ObsPlan", "Rinex3ObsPlan");
+   string fn(dataPath + "inputs" + getFileSep() + "igs" + getFileSep() +
+             "solo0150.16o");
+   Rinex3ObsStream strm(fn.c_str());
+   Rinex3ObsHeader hdr;
+   strm >> hdr;
+   TUASSERT(static_cast<bool>(strm));
+
+   vector<string> types;
+   types.push_back("C1C");          // G and R
+   types.push_back("GL2W");         // G only
+   types.push_back("C7I");          // C only
+   types.push_back("C1P");          // R only; not valid for E
+   types.push_back("D1C");          // nowhere
+   Rinex3ObsPlan plan(hdr, types);
+   TUASSERTE(size_t, 5, plan.size());
+   TUASSERTE(int, 0, plan.index('G', 0));
+   TUASSERTE(int, 0, plan.index('R', 0));
+   TUASSERTE(int, Rinex3ObsPlan::NONE, plan.index('E', 0));
+   TUASSERTE(int, 5, plan.index('G', 1));
+   TUASSERTE(int, Rinex3ObsPlan::NONE, plan.index('R', 1));
+   TUASSERTE(int, 1, plan.index('C', 2));
+   TUASSERTE(int, Rinex3ObsPlan::NONE, plan.index('G', 2));
+   TUASSERTE(int, 1, plan.index('R', 3));
+   TUASSERTE(int, Rinex3ObsPlan::NONE, plan.index('E', 3));
+   for(const char *s = "CEGRJS"; *s; s++)
+      TUASSERTE(int, Rinex3ObsPlan::NONE, plan.index(*s, 4));
+   TUASSERTE(int, Rinex3ObsPlan::NONE, plan.index('G', 5));
+   TUASSERTE(int, Rinex3ObsPlan::NONE, plan.index('?', 0));
+
+      // the same, from RinexObsIDs; GPS and GLONASS C/A codes differ
+   vector<RinexObsID> ids;
+   ids.push_back(RinexObsID("GC1C"));
+   ids.push_back(RinexObsID("GL2W"));
+   ids.push_back(RinexObsID("RC1C"));
+   Rinex3ObsPlan idplan(hdr, ids);
+   TUASSERTE(int, 0, idplan.index('G', 0));
+   TUASSERTE(int, Rinex3ObsPlan::NONE, idplan.index('R', 0));
+   TUASSERTE(int, 5, idplan.index('G', 1));
+   TUASSERTE(int, 0, idplan.index('R', 2));
+
+   types.push_back("CXC");
+   try
+   {
+      Rinex3ObsPlan bad(hdr, types);
+      TUFAIL("Invalid type did not throw");
+   }
+   catch(InvalidRequest& e)
+   {
+      TUPASS("Invalid type");
+   }
+   TURETURN();
+}
+
+
+int Rinex3ObsPlan_T ::
+extractTest()
+{
+   TUDEF("Rinex3ObsPlan", "extract");
+   string fn(dataPath + "inputs" + getFileSep() + "igs" + getFileSep() +
+             "solo0150.16o");
+   Rinex3ObsStream strm(fn.c_str());
+   Rinex3ObsHeader hdr;
+   Rinex3ObsData rod;
+   strm >> hdr;
+
+   vector<string> types;
+   types.push_back("C1C");
+   types.push_back("L1C");
+   types.push_back("S2W");
+   types.push_back("EC5X");
+   types.push_back("RL2P");
+   types.push_back("C7I");
+   types.push_back("D1C");
+   Rinex3ObsPlan plan(hdr, types);
+
+   vector<RinexSatID> sats;
+   vector<double> data;
+   unsigned epochs(0), nonzero(0);
+   while(strm >> rod)
+   {
+      epochs++;
+      plan.extract(rod, sats, data);
+      TUASSERTE(size_t, rod.obs.size(), sats.size());
+      TUASSERTE(size_t, sats.size()*types.size(), data.size());
+      for(size_t i=0; i<sats.size(); i++)
+      {
+         const vector<RinexDatum>& vrdata(rod.obs[sats[i]]);
+         for(size_t k=0; k<types.size(); k++)
+         {
+            double exp(expected(rod, sats[i], types[k], hdr));
+            TUASSERTFE(exp, data[i*types.size()+k]);
+            TUASSERTFE(exp, plan.getData(sats[i], vrdata, k));
+            RinexDatum rd;
+            TUASSERTE(bool, plan.index(sats[i].systemChar(), k) !=
+                      Rinex3ObsPlan::NONE, plan.getObs(sats[i], vrdata, k, rd));
+            if(exp != 0.0) nonzero++;
+         }
+      }
+   }
+   TUASSERT(epochs > 0);
+   TUASSERT(nonzero > 0);
+   TURETURN();
+}
+
+
+int main(int argc, char *argv[])
+{
+   int  errorTotal = 0;
+
+   Rinex3ObsPlan_T  testClass;
+
+   errorTotal += testClass.indexTest();
+   errorTotal += testClass.extractTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return( errorTotal );
+
+} // main()
@@ -0,0 +1,263 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <cstring>
+#include <ctime>
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+#include "RinexDatum.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+   /** Compare the fast RINEX 3 epoch decoder (the default) against
+    * the original decoder, and time the two. */
+class Rinex3Obs_FastDecode_T
+{
+public:
+   Rinex3Obs_FastDecode_T()
+   {
+      init();
+   }
+
+      // initialize tests
+   void init();
+
+      /// RinexDatum::fromString(const char*,size_type) vs. the original
+   int datumTest();
+      /// fast vs. original decoding of each input file
+   int decodeTest();
+      /// time fast vs. original decoding
+   int benchmark();
+
+private:
+      /// true if the two doubles have the same bit pattern
+   static bool sameBits(double a, double b)
+   { return memcmp(&a, &b, sizeof(double)) == 0; }
+
+      /// compare the decoding of \a fn, return number of records read.
+   unsigned compareFile(const string& fn, bool mapped,
+                        TestUtil& testFramework);
+
+      /// read every record of \a fn, return the number of records.
+   static unsigned readFile(const string& fn, bool fast, bool mapped);
+
+   string dataPath;
+   vector<string> inputFiles;
+}; // class Rinex3Obs_FastDecode_T
+
+
+void Rinex3Obs_FastDecode_T ::
+init()
+{
+   dataPath = gpstk::getPathData() + gpstk::getFileSep();
+   inputFiles.push_back("test_input_rinex3_76193040.14o");
+   inputFiles.push_back("test_input_rinex3_obs_RinexObsFile.15o");
+   inputFiles.push_back("test_input_rinex3_obs_SystemMixed.15o");
+   inputFiles.push_back("test_input_rinex3_obs_SystemGlonass.15o");
+   inputFiles.push_back("test_input_rinex3_obs_SystemGeosync.15o");
+   inputFiles.push_back("test_input_rinex3_obs_SystemTransit.15o");
+   inputFiles.push_back("test_input_rinex3_obs_FilterTest1.15o");
+   inputFiles.push_back("test_input_rinex3_obs_BadEpochFlag.15o");
+   inputFiles.push_back("test_input_rinex3_obs_BadLineSize.15o");
+   inputFiles.push_back("test_input_rinex3_obs_InvalidLineLength.15o");
+   inputFiles.push_back("test_input_rinex3_obs_InvalidTimeFormat.15o");
+}
+
+
+int Rinex3Obs_FastDecode_T ::
+datumTest()
+{
+   TUDEF("RinexDatum", "fromString");
+   static const char *fields[] =
+   {
+      "  23619095.450  ", "  23619095.450 7", "  -0.000    1  6",
+      "      -353.361 5", "           .5   ", "         12.     ",
+      "               ", "   1.2345E+03 1 ", "12345678901.123 ",
+      "     12 34     ", "  +123.4567  x9", "   -.25      -  ",
+      "999999999.99999", "   1.5D-01     ", "     nan       ",
+      "  - 5           ", "1234567890123456"
+   };
+   for (unsigned i = 0; i < sizeof(fields)/sizeof(fields[0]); i++)
+   {
+         // the original requires exactly 16 characters
+      string field(fields[i]);
+      field.resize(16, ' ');
+      RinexDatum exp(field), got;
+      got.fromString(fields[i], strlen(fields[i]));
+      TUASSERT(sameBits(exp.data, got.data) ||
+               (exp.data != exp.data && got.data != got.data));
+      TUASSERTE(bool, exp.dataBlank, got.dataBlank);
+      TUASSERTE(short, exp.lli, got.lli);
+      TUASSERTE(bool, exp.lliBlank, got.lliBlank);
+      TUASSERTE(short, exp.ssi, got.ssi);
+      TUASSERTE(bool, exp.ssiBlank, got.ssiBlank);
+   }
+   TURETURN();
+}
+
+
+unsigned Rinex3Obs_FastDecode_T ::
+compareFile(const string& fn, bool mapped, TestUtil& testFramework)
+{
+   Rinex3ObsStream orig(fn.c_str()), fast(fn.c_str());
+   orig.fastDecode = false;
+   TUASSERTE(bool, true, fast.fastDecode);
+   if (mapped)
+   {
+      TUASSERT(fast.memoryMap());
+   }
+   Rinex3ObsData od, fd;
+   unsigned count = 0;
+   while (true)
+   {
+      bool origOK = static_cast<bool>(orig >> od);
+      bool fastOK = static_cast<bool>(fast >> fd);
+      TUASSERTE(bool, origOK, fastOK);
+      TUASSERTE(unsigned, orig.lineNumber, fast.lineNumber);
+      TUASSERTE(bool, orig.eof(), fast.eof());
+      if (!origOK || !fastOK)
+         break;
+      count++;
+      TUASSERTE(CommonTime, od.time, fd.time);
+      TUASSERTE(short, od.epochFlag, fd.epochFlag);
+      TUASSERTE(short, od.numSVs, fd.numSVs);
+      TUASSERT(sameBits(od.clockOffset, fd.clockOffset));
+      TUASSERTE(int, od.auxHeader.valid, fd.auxHeader.valid);
+      TUASSERT(od.auxHeader.commentList == fd.auxHeader.commentList);
+      TUASSERTE(size_t, od.obs.size(), fd.obs.size());
+      if (od.obs.size() != fd.obs.size())
+         continue;
+      Rinex3ObsData::DataMap::const_iterator oi, fi;
+      for (oi = od.obs.begin(), fi = fd.obs.begin(); oi != od.obs.end();
+           ++oi, ++fi)
+      {
+         TUASSERTE(RinexSatID, oi->first, fi->first);
+         TUASSERTE(size_t, oi->second.size(), fi->second.size());
+         for (size_t i = 0;
+              (i < oi->second.size()) && (i < fi->second.size()); i++)
+         {
+            const RinexDatum &o(oi->second[i]), &f(fi->second[i]);
+            TUASSERT(sameBits(o.data, f.data));
+            TUASSERTE(bool, o.dataBlank, f.dataBlank);
+            TUASSERTE(short, o.lli, f.lli);
+            TUASSERTE(bool, o.lliBlank, f.lliBlank);
+            TUASSERTE(short, o.ssi, f.ssi);
+            TUASSERTE(bool, o.ssiBlank, f.ssiBlank);
+         }
+      }
+   }
+   return count;
+}
+
+
+int Rinex3Obs_FastDecode_T ::
+decodeTest()
+{
+   TUDEF("Rinex3ObsData", "reallyGetRecord");
+   for (unsigned i = 0; i < inputFiles.size(); i++)
+   {
+      string fn(dataPath + inputFiles[i]);
+      testFramework.changeSourceMethod("reallyGetRecord " + inputFiles[i]);
+      compareFile(fn, false, testFramework);
+      compareFile(fn, true, testFramework);
+   }
+      // make sure the comparison actually compared something
+   TUASSERT(compareFile(dataPath + inputFiles[0], false, testFramework) > 100);
+   TURETURN();
+}
+
+
+unsigned Rinex3Obs_FastDecode_T ::
+readFile(const string& fn, bool fast, bool mapped)
+{
+   Rinex3ObsStream strm(fn.c_str());
+   strm.fastDecode = fast;
+   if (mapped)
+      strm.memoryMap();
+   Rinex3ObsData rod;
+   unsigned count = 0;
+   while (strm >> rod)
+      count++;
+   return count;
+}
+
+
+int Rinex3Obs_FastDecode_T ::
+benchmark()
+{
+   TUDEF("Rinex3ObsData", "benchmark");
+   string fn(dataPath + inputFiles[0]);
+   const unsigned reps = 50;
+   const char *names[] = { "original", "fast", "fast+mmap" };
+   unsigned counts[3] = { 0, 0, 0 };
+   for (unsigned mode = 0; mode < 3; mode++)
+   {
+      clock_t start = clock();
+      for (unsigned rep = 0; rep < reps; rep++)
+         counts[mode] += readFile(fn, mode > 0, mode > 1);
+      double secs = double(clock() - start) / CLOCKS_PER_SEC;
+      cout << "Rinex3ObsData decode " << setw(9) << names[mode] << ": "
+           << counts[mode] << " epochs in " << fixed << setprecision(3)
+           << secs << " s" << endl;
+   }
+   TUASSERTE(unsigned, counts[0], counts[1]);
+   TUASSERTE(unsigned, counts[0], counts[2]);
+   TURETURN();
+}
+
+
+   /** Run the program.
+    *
+    * @return Total error count for all tests
+    */
+int main(int argc, char *argv[])
+{
+   int  errorTotal = 0;
+
+   Rinex3Obs_FastDecode_T  testClass;
+
+   errorTotal += testClass.datumTest();
+   errorTotal += testClass.decodeTest();
+   errorTotal += testClass.benchmark();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return( errorTotal );
+
+} // main()
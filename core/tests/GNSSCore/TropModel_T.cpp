@@ -34,18 +34,165 @@
 //
 //==============================================================================
 
+#include "TropModel.hpp"
+#include "SimpleTropModel.hpp"
+#include "NeillTropModel.hpp"
+#include "GlobalTropModel.hpp"
+#include "GCATTropModel.hpp"
+#include "MOPSTropModel.hpp"
+#include "Position.hpp"
+#include "CivilTime.hpp"
+
 #include "TestUtil.hpp"
 #include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace gpstk;
 
 class TropModel_T
 {
-        public: 
-		TropModel_T(){}// Default Constructor, set the precision value
-		~TropModel_T() {} // Default Desructor
+public:
+      /// Default Constructor, set the precision value
+   TropModel_T()
+         : eps(1E-12)
+   {
+      double el[] = { -5., 0., 2.5, 3., 5., 10., 20., 45., 75., 90. };
+      elev.assign(el, el + sizeof(el)/sizeof(el[0]));
+   }
+      /// Do-nothing Destructor
+   ~TropModel_T()
+   {}
+
+      /* Compare batch_correction() with the scalar functions of the model */
+   void compareBatch(TestUtil& testFramework, const TropModel& tm)
+   { compareBatch(testFramework, tm, elev); }
+
+      /* Compare batch_correction() with the scalar functions of the model
+       * at the given elevations */
+   void compareBatch(TestUtil& testFramework, const TropModel& tm,
+                     const vector<double>& elev)
+   {
+      vector<double> dry, wet, drymap, wetmap;
+      tm.batch_correction(elev, dry, wet, drymap, wetmap);
+      TUASSERTE(size_t, elev.size(), dry.size());
+      TUASSERTE(size_t, elev.size(), wetmap.size());
+      for(size_t i=0; i<elev.size(); i++) {
+         TUASSERTFEPS(tm.correction(elev[i]), dry[i]+wet[i], eps);
+         if(elev[i] < 3.0) continue;
+         TUASSERTFEPS(tm.dry_mapping_function(elev[i]), drymap[i], eps);
+         TUASSERTFEPS(tm.wet_mapping_function(elev[i]), wetmap[i], eps);
+         TUASSERTFEPS(tm.dry_zenith_delay()*drymap[i], dry[i], eps);
+      }
+   }
+
+      /* Tests batch_correction() of the base class and of the models that
+       * override it */
+   unsigned batchTest()
+   {
+      TUDEF("TropModel","batch_correction");
+
+      SimpleTropModel simple(20., 1013., 50.);
+      compareBatch(testFramework, simple);
+
+      NeillTropModel neill(150., 35.4, 200);
+      compareBatch(testFramework, neill);
+      NeillTropModel neillSouth(150., -62.1, 20);
+      compareBatch(testFramework, neillSouth);
+
+      GlobalTropModel global(150., 35.4, 262.3, 57000.5);
+      compareBatch(testFramework, global);
+
+         // GCAT and MOPS have no override, and return no delay below
+         // 5 degrees
+      vector<double> low;
+      for(double el=-0.25; el<=5.5; el+=0.25)
+         low.push_back(el);
+      GCATTropModel gcat(150.);
+      compareBatch(testFramework, gcat);
+      compareBatch(testFramework, gcat, low);
+      MOPSTropModel mops(150., 35.4, 200);
+      compareBatch(testFramework, mops);
+      compareBatch(testFramework, mops, low);
+
+      GlobalTropModel invalid;
+      vector<double> dry, wet, drymap, wetmap;
+      try {
+         invalid.batch_correction(elev, dry, wet, drymap, wetmap);
+         TUFAIL("batch_correction of invalid model did not throw");
+      }
+      catch(InvalidTropModel& e) {
+         TUPASS("batch_correction of invalid model");
+      }
+
+      TURETURN();
+   }
+
+      /* Tests that the per-position coefficients of GlobalTropModel are the
+       * same when set directly and when taken from its cache */
+   unsigned globalCacheTest()
+   {
+      TUDEF("GlobalTropModel","setParameters");
+
+      CommonTime t1(CivilTime(2015,3,10,0,0,0.0));
+      CommonTime t2(CivilTime(2015,8,21,12,0,0.0));
+      Position p1(30.1, 262.3, 210., Position::Geodetic);
+      Position p2(-42.8, 147.4, 40., Position::Geodetic);
+
+      GlobalTropModel ref1, ref2, gtm;
+      ref1.setParameters(t1, p1);
+      ref2.setParameters(t2, p2);
+
+      gtm.setParameters(t1, p1);
+      TUASSERTFEPS(ref1.correction(20.), gtm.correction(20.), eps);
+      gtm.setParameters(t2, p2);
+      TUASSERTFEPS(ref2.correction(20.), gtm.correction(20.), eps);
+      gtm.setParameters(t1, p1);
+      TUASSERTFEPS(ref1.correction(20.), gtm.correction(20.), eps);
+      TUASSERTFEPS(ref1.dry_zenith_delay(), gtm.dry_zenith_delay(), eps);
+      TUASSERTFEPS(ref1.wet_mapping_function(7.), gtm.wet_mapping_function(7.),
+                   eps);
+      TUASSERTE(size_t, 2, gtm.cacheSize());
+
+      gtm.clearCache();
+      TUASSERTE(size_t, 0, gtm.cacheSize());
+      TUASSERTFEPS(ref1.correction(20.), gtm.correction(20.), eps);
+
+      TURETURN();
+   }
+
+      /* Tests that setAllParameters sets the height and latitude */
+   unsigned neillParametersTest()
+   {
+      TUDEF("NeillTropModel","setAllParameters");
+
+      CommonTime t(CivilTime(2015,7,19,0,0,0.0));   // day of year 200
+      Position p(35.4, 262.3, 1500., Position::Geodetic);
+
+      NeillTropModel ref(p.getHeight(), p.getGeodeticLatitude(), 200), ntm;
+      ntm.setAllParameters(t, p);
+      TUASSERTFEPS(ref.dry_zenith_delay(), ntm.dry_zenith_delay(), eps);
+      TUASSERTFEPS(ref.correction(15.), ntm.correction(15.), eps);
+
+      TURETURN();
+   }
+
+private:
+   double eps;
+   vector<double> elev;
 };
 
 
 int main() //Main function to initialize and run all tests above
 {
-	return 0; //Return the total number of errors
+   unsigned errorTotal = 0;
+   TropModel_T testClass;
+
+   errorTotal += testClass.batchTest();
+   errorTotal += testClass.globalCacheTest();
+   errorTotal += testClass.neillParametersTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; //Return the total number of errors
 }
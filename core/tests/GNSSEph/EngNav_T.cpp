@@ -35,10 +35,12 @@
 //==============================================================================
 
 #include "EngNav.hpp"
+#include "PackedNavBits.hpp"
 #include "TestUtil.hpp"
 #include "TimeString.hpp"
 #include "GPSWeekSecond.hpp"
 #include <math.h>
+#include <cstdlib>
 #include <iostream>
 
 using namespace std;
@@ -180,6 +182,95 @@ public:
    }
 
 
+   unsigned batchParityTest(void)
+   {
+      TUDEF("EngNav", "checkParity");
+
+      const uint32_t subframe1P[10] =
+         { 0x22c000e4, 0x215ba160, 0x00180012, 0x1fffffc0, 0x3fffffc3,
+           0x3fffffff, 0x3fffc035, 0x16d904f3, 0x003fdb90, 0x247c1339 };
+      const uint32_t subframe2P[10] =
+         { 0x22c000e4, 0x215bc2f0, 0x16c2eb4d, 0x032c41a3, 0x26abc7dc,
+           0x0289c0dd, 0x0d5ecc3b, 0x0036b67f, 0x034f4de5, 0x1904c0a1 };
+      const uint32_t subframe3P[10] =
+         { 0x22c000e4, 0x215be378, 0x3ffcc344, 0x1a8441f1, 0x3ff80b61,
+           0x1c8deb4b, 0x0a34d530, 0x14a50138, 0x3fee8c2f, 0x16c35c83 };
+
+         // the table driven parity against the ICD equations
+      const uint32_t bmask[6] = { 0x3B1F3480, 0x1D8F9A40, 0x2EC7CD00,
+                                  0x1763E680, 0x2BB1F340, 0x0B7A89C0 };
+      const uint32_t prev[6] = { 0, 1, 2, 3, 0x2aaaaaaa, 0x15555555 };
+      srand(16);
+      bool allMatch = true;
+      for (unsigned i = 0; i < 5000; i++)
+      {
+         uint32_t w = (uint32_t(rand()) << 15) ^ uint32_t(rand());
+         uint32_t p = prev[i % 6];
+         for (int upright = 0; upright < 2; upright++)
+         {
+            uint32_t d = (p & 1) && !upright ? ~w : w;
+            uint32_t D29 = (p >> 1) & 1, D30 = p & 1;
+            uint32_t D = 0;
+            D |= ((D29 + gpstk::BinUtils::countBits(bmask[0] & d)) % 2) << 5;
+            D |= ((D30 + gpstk::BinUtils::countBits(bmask[1] & d)) % 2) << 4;
+            D |= ((D29 + gpstk::BinUtils::countBits(bmask[2] & d)) % 2) << 3;
+            D |= ((D30 + gpstk::BinUtils::countBits(bmask[3] & d)) % 2) << 2;
+            D |= ((D30 + gpstk::BinUtils::countBits(bmask[4] & d)) % 2) << 1;
+            D |= ((D29 + gpstk::BinUtils::countBits(bmask[5] & d)) % 2);
+            allMatch &= (D == gpstk::EngNav::computeParity(w, p, upright));
+         }
+      }
+      TUASSERT(allMatch);
+
+         // a batch with corrupted subframes in it
+      uint32_t bad[3][10];
+      std::copy(subframe1P, subframe1P+10, bad[0]);
+      std::copy(subframe2P, subframe2P+10, bad[1]);
+      std::copy(subframe3P, subframe3P+10, bad[2]);
+      bad[0][0] ^= 0x00100000;
+      bad[1][9] ^= 0x00000001;
+      bad[2][5] ^= 0x20000000;
+      const uint32_t *batch[70];
+      uint64_t expected = 0;
+      for (unsigned i = 0; i < 70; i++)
+      {
+         switch (i % 6)
+         {
+            case 0: batch[i] = subframe1P; break;
+            case 1: batch[i] = subframe2P; break;
+            case 2: batch[i] = subframe3P; break;
+            default: batch[i] = bad[i % 6 - 3]; break;
+         }
+         if (i < 64 && i % 6 < 3)
+            expected |= uint64_t(1) << i;
+      }
+      TUASSERTE(uint64_t, 7, gpstk::EngNav::checkParity(batch, 6, false));
+      TUASSERTE(uint64_t, 0, gpstk::EngNav::checkParity(batch+3, 3, false));
+      TUASSERTE(uint64_t, 0, gpstk::EngNav::checkParity(batch, 0, false));
+         // no more than parityBatchMax subframes are checked
+      TUASSERTE(uint64_t, expected,
+                gpstk::EngNav::checkParity(batch, 70, false));
+      for (unsigned i = 0; i < 6; i++)
+      {
+         TUASSERTE(bool, i < 3, gpstk::EngNav::checkParity(batch[i], false));
+      }
+
+         // a subframe as PackedNavBits
+      gpstk::PackedNavBits pnb;
+      for (unsigned i = 0; i < 9; i++)
+         pnb.addUnsignedLong(subframe2P[i], 30, 1);
+      TUASSERT(!gpstk::EngNav::checkParity(pnb, false));
+      pnb.addUnsignedLong(subframe2P[9], 30, 1);
+      TUASSERT(gpstk::EngNav::checkParity(pnb, false));
+      gpstk::PackedNavBits pnbBad;
+      for (unsigned i = 0; i < 10; i++)
+         pnbBad.addUnsignedLong(bad[1][i], 30, 1);
+      TUASSERT(!gpstk::EngNav::checkParity(pnbBad, false));
+
+      TURETURN();
+   }
+
+
    unsigned getHOWTimeTest(void)
    {
          //wrong, fix later
@@ -452,6 +543,7 @@ int main() //Main function to initialize and run all tests above
    errorTotal += testClass.getHOWTimeTest();
    errorTotal += testClass.getSFIDTest();
    errorTotal += testClass.checkParityTest();
+   errorTotal += testClass.batchParityTest();
    errorTotal += testClass.getSubframePatternTest();
    errorTotal += testClass.subframeConvertTest();
    errorTotal += testClass.nmctValidityTest();
@@ -35,9 +35,15 @@
 //==============================================================================
 
 #include "GPSEphemerisStore.hpp"
+#include "EphemerisCache.hpp"
+#include "RinexNavStream.hpp"
+#include "RinexNavHeader.hpp"
 #include "CivilTime.hpp"
 #include "TimeString.hpp"
 #include "TestUtil.hpp"
+#include <cstdio>
+#include <list>
+#include <sstream>
 
 using namespace std;
 
@@ -270,6 +276,81 @@ public:
 
       TURETURN();
    }
+
+
+      /** An ephemeris cache written by writeCache() and read back by
+       * readCache() holds the same ephemerides and time limits. */
+   unsigned cacheTest()
+   {
+      TUDEF("GPSEphemerisStore","readCache");
+      std::string fs(gpstk::getFileSep());
+      std::string navFile(gpstk::getPathData() + fs +
+                          "test_input_rinex_nav_ephemerisData.031");
+      std::string cacheFile(gpstk::getPathTestTemp() + fs +
+                            "GPSEphemerisStore_T.cache");
+      try
+      {
+         gpstk::GPSEphemerisStore saved, restored;
+         gpstk::RinexNavStream strm(navFile.c_str());
+         gpstk::RinexNavHeader head;
+         gpstk::RinexNavData rec;
+         strm >> head;
+         while (strm >> rec)
+            saved.addEphemeris(rec);
+         TUASSERT(saved.size() > 0);
+
+         gpstk::EphemerisCacheWriter cw("GPSEphemerisStore");
+         saved.writeCache(cw);
+         cw.write(cacheFile);
+         gpstk::EphemerisCacheReader cr;
+         TUASSERT(cr.open(cacheFile, "GPSEphemerisStore",
+                          std::vector<std::string>()));
+         restored.readCache(cr);
+         TUASSERT(cr.atEnd());
+         cr.close();
+
+         std::ostringstream savedDump, restoredDump;
+         saved.dump(savedDump, 2);
+         restored.dump(restoredDump, 2);
+         TUASSERT(savedDump.str() == restoredDump.str());
+         TUASSERTE(unsigned, saved.size(), restored.size());
+         TUASSERTE(gpstk::CommonTime, saved.getInitialTime(),
+                   restored.getInitialTime());
+         TUASSERTE(gpstk::CommonTime, saved.getFinalTime(),
+                   restored.getFinalTime());
+
+            // the restored tables find the same ephemerides
+         std::list<gpstk::GPSEphemeris> ephs;
+         saved.addToList(ephs);
+         bool same = true;
+         std::list<gpstk::GPSEphemeris>::const_iterator ei;
+         for (ei = ephs.begin(); ei != ephs.end(); ei++)
+         {
+            gpstk::CommonTime t(ei->ctToe + 600.);
+            gpstk::Xvt x0(saved.getXvt(ei->satID, t));
+            gpstk::Xvt x1(restored.getXvt(ei->satID, t));
+            if (!(x0.x == x1.x) || x0.clkbias != x1.clkbias)
+               same = false;
+         }
+         TUASSERT(same);
+
+            // a cache of another kind of store is refused
+         TUASSERT(!cr.open(cacheFile, "RinexEphemerisStore",
+                           std::vector<std::string>()));
+      }
+      catch (gpstk::Exception &exc)
+      {
+         cerr << exc << endl;
+         TUFAIL("Unexpected exception");
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+      std::remove(cacheFile.c_str());
+
+      TURETURN();
+   }
 };
 
 
@@ -278,6 +359,7 @@ int main(int argc, char *argv[])
    unsigned total = 0;
    GPSEphemerisStore_T testClass;
    total += testClass.doGetPrnXvtTests();
+   total += testClass.cacheTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << total << endl;
    return total;
@@ -42,6 +42,7 @@
 #include "GPSWeekSecond.hpp"
 #include "Rinex3NavStream.hpp"
 #include "Rinex3NavData.hpp"
+#include <list>
 
 using namespace std;
 
@@ -185,6 +186,90 @@ public:
    }
 
 
+   unsigned trajectoryTest()
+   {
+      TUDEF("GloEphemerisStore", "setTrajectoryCache");
+      try
+      {
+         gpstk::GloEphemerisStore plain, cached, adaptive;
+         loadNav(plain, testFramework, false);
+         loadNav(cached, testFramework, false);
+         loadNav(adaptive, testFramework, false);
+         cached.setTrajectoryCache(true);
+         TUASSERT(cached.getTrajectoryCache());
+         adaptive.setIntegrator(gpstk::GloEphemeris::DormandPrince54);
+         TUASSERTE(gpstk::GloEphemeris::Integrator,
+                   gpstk::GloEphemeris::DormandPrince54,
+                   adaptive.getIntegrator());
+
+         std::list<gpstk::GloEphemeris> ephs;
+         plain.addToList(ephs);
+         TUASSERT(!ephs.empty());
+         const double offsets[] = { -899.5, -613.25, -60.0, -1.0, 0.0, 0.5,
+                                    37.3, 120.0, 444.4, 899.0 };
+         double maxPos = 0, maxVel = 0, maxClk = 0, maxAdapt = 0;
+         unsigned count = 0;
+         std::list<gpstk::GloEphemeris>::const_iterator ei;
+         for (ei = ephs.begin(); ei != ephs.end(); ei++)
+         {
+            gpstk::SatID sat(ei->getPRNID(), gpstk::SatID::systemGlonass);
+            for (unsigned k = 0; k < sizeof(offsets)/sizeof(double); k++)
+            {
+               gpstk::CommonTime t(ei->getEphemerisEpoch() + offsets[k]);
+               gpstk::Xvt x0, x1, x2;
+               try
+               {
+                  x0 = plain.getXvt(sat, t);
+               }
+               catch (gpstk::InvalidRequest&)
+               {
+                  continue;
+               }
+               x1 = cached.getXvt(sat, t);
+               x2 = adaptive.getXvt(sat, t);
+               maxPos = std::max(maxPos, range(x0.x, x1.x));
+               maxVel = std::max(maxVel, range(x0.v, x1.v));
+               maxClk = std::max(maxClk, std::fabs(x0.clkbias - x1.clkbias));
+               maxAdapt = std::max(maxAdapt, range(x0.x, x2.x));
+               count++;
+            }
+         }
+         TUASSERT(count > 10);
+         testFramework.changeSourceMethod("getXvt");
+            // interpolation stays within the RK4 integration error
+         TUASSERT(maxPos < 1e-6);
+         TUASSERT(maxVel < 1e-8);
+         TUASSERT(maxClk < 1e-15);
+         testFramework.changeSourceMethod("setIntegrator");
+         TUASSERT(maxAdapt < 1e-3);
+
+            // the cache follows edits of the store
+         testFramework.changeSourceMethod("edit");
+         gpstk::CommonTime tmid(ephs.back().getEphemerisEpoch());
+         cached.edit(tmid);
+         gpstk::SatID sat(ephs.back().getPRNID(),
+                          gpstk::SatID::systemGlonass);
+         gpstk::Xvt x0(plain.getXvt(sat, tmid + 100.0));
+         gpstk::Xvt x1(cached.getXvt(sat, tmid + 100.0));
+         TUASSERT(range(x0.x, x1.x) < 1e-4);
+      }
+      catch (gpstk::Exception &exc)
+      {
+         cerr << exc << endl;
+         TUFAIL("Unexpected exception");
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+
+   static double range(const gpstk::Triple& a, const gpstk::Triple& b)
+   { return (a - b).mag(); }
+
+
    gpstk::Rinex3NavData loadNav(gpstk::GloEphemerisStore& store,
                                 gpstk::TestUtil& testFramework,
                                 bool firstOnly)
@@ -234,6 +319,7 @@ int main(int argc, char *argv[])
    total += testClass.doFindEphEmptyTests();
    total += testClass.computeXvtTest();
    total += testClass.getSVHealthTest();
+   total += testClass.trajectoryTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << total << endl;
    return total;
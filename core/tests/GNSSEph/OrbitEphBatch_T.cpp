@@ -0,0 +1,272 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "OrbitEphBatch.hpp"
+#include "GPSEphemeris.hpp"
+#include "Rinex3NavStream.hpp"
+#include "Rinex3NavHeader.hpp"
+#include "Rinex3NavData.hpp"
+#include "GNSSconstants.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class OrbitEphBatch_T
+{
+public:
+   OrbitEphBatch_T() {}
+
+   void init()
+   {
+      std::string dataFilePath = gpstk::getPathData();
+      std::string fileSep = gpstk::getFileSep();
+
+      inputNav = dataFilePath + fileSep + "test_input_rinex3_76193040.14n";
+   }
+
+      /// Read the GPS ephemerides in the test file.
+   void loadEphs(TestUtil& testFramework)
+   {
+      ephs.clear();
+      try
+      {
+         Rinex3NavStream strm(inputNav.c_str());
+         Rinex3NavHeader head;
+         Rinex3NavData data;
+         strm >> head;
+         while(strm >> data)
+         {
+            if(data.sat.system == SatID::systemGPS)
+               ephs.push_back(GPSEphemeris(data));
+         }
+      }
+      catch(Exception& e)
+      {
+         TUFAIL("Failed to read " + inputNav + ": " + e.what());
+      }
+      TUASSERT(ephs.size() > 0);
+
+         // more eccentric orbits than GPS, like QZSS and Galileo E14
+      double eccs[] = { 0.075, 0.16, 0.3 };
+      for(int i=0; i<3 && ephs.size() > 0; i++)
+      {
+         GPSEphemeris eph(ephs[0]);
+         eph.ecc = eccs[i];
+         ephs.push_back(eph);
+      }
+   }
+
+      /// Maximum differences of the batch from OrbitEph::svXvt().
+   struct MaxDiff
+   {
+      MaxDiff() : pos(0), vel(0), clk(0), drift(0), rel(0) {}
+      void update(const OrbitEph& eph, const CommonTime& t, const Xvt& bat)
+      {
+         Xvt ref(eph.svXvt(t));
+         double rel0(eph.svRelativity(t));
+         pos = max(pos, range(ref.x - bat.x));
+         vel = max(vel, range(ref.v - bat.v));
+         clk = max(clk, fabs(ref.clkbias - bat.clkbias));
+         drift = max(drift, fabs(ref.clkdrift - bat.clkdrift));
+         rel = max(rel, fabs(rel0 - bat.relcorr));
+      }
+      static double range(const Triple& d)
+      { return ::sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]); }
+      double pos, vel, clk, drift, rel;
+   };
+
+      /** Test the accuracy of all three forms of
+       * OrbitEphBatch::svXvt() against OrbitEph::svXvt(), to
+       * sub-millimeter, over +/- 4 hours around Toe. */
+   unsigned accuracyTest()
+   {
+      TUDEF("OrbitEphBatch", "svXvt");
+
+      loadEphs(testFramework);
+      OrbitEphBatch batch;
+      for(size_t k=0; k<ephs.size(); k++)
+         TUASSERTE(size_t, k, batch.addEphemeris(ephs[k]));
+      TUASSERTE(size_t, ephs.size(), batch.size());
+
+      const double dt(30.0);
+      const size_t n(961);                // -4h to +4h
+      MaxDiff grid, pairs, snap;
+      vector<Xvt> xvts;
+      vector<size_t> index;
+      vector<CommonTime> times;
+      for(size_t k=0; k<ephs.size(); k++)
+      {
+         CommonTime t0(ephs[k].ctToe - 14400.);
+         batch.svXvt(k, t0, dt, n, xvts);
+         TUASSERTE(size_t, n, xvts.size());
+         for(size_t i=0; i<n; i++)
+         {
+            grid.update(ephs[k], t0 + i*dt, xvts[i]);
+            if(i % 7 == k % 7)
+            {
+               index.push_back(k);
+               times.push_back(t0 + i*dt + 0.25);
+            }
+         }
+      }
+
+      batch.svXvt(index, times, xvts);
+      TUASSERTE(size_t, index.size(), xvts.size());
+      for(size_t i=0; i<index.size(); i++)
+         pairs.update(ephs[index[i]], times[i], xvts[i]);
+
+      CommonTime tsnap(ephs[0].ctToe + 1234.5);
+      batch.svXvt(tsnap, xvts);
+      TUASSERTE(size_t, ephs.size(), xvts.size());
+      for(size_t k=0; k<ephs.size(); k++)
+         snap.update(ephs[k], tsnap, xvts[k]);
+
+      MaxDiff *md[] = { &grid, &pairs, &snap };
+      for(int i=0; i<3; i++)
+      {
+         TUASSERT(md[i]->pos < 1.e-4);             // m
+         TUASSERT(md[i]->vel < 1.e-7);             // m/s
+         TUASSERT(md[i]->clk < 1.e-15);            // s
+         TUASSERT(md[i]->drift < 1.e-18);          // s/s
+         TUASSERT(md[i]->rel * C_MPS < 1.e-4);     // m
+      }
+      cout << "OrbitEphBatch max difference from OrbitEph::svXvt(): "
+           << scientific << grid.pos << " m, " << grid.vel << " m/s, "
+           << grid.rel * C_MPS << " m (relativity)" << endl;
+
+         // invalid input
+      try
+      {
+         batch.svXvt(batch.size(), tsnap, dt, 1, xvts);
+         TUFAIL("Expected InvalidRequest for a bad index");
+      }
+      catch(InvalidRequest&)
+      {
+         TUPASS("InvalidRequest for a bad index");
+      }
+      index.pop_back();
+      try
+      {
+         batch.svXvt(index, times, xvts);
+         TUFAIL("Expected InvalidRequest for inputs of different lengths");
+      }
+      catch(InvalidRequest&)
+      {
+         TUPASS("InvalidRequest for inputs of different lengths");
+      }
+
+      OrbitEph empty;
+      try
+      {
+         batch.addEphemeris(empty);
+         TUFAIL("Expected InvalidRequest for an empty OrbitEph");
+      }
+      catch(InvalidRequest&)
+      {
+         TUPASS("InvalidRequest for an empty OrbitEph");
+      }
+
+      batch.clear();
+      TUASSERTE(size_t, 0, batch.size());
+
+      TURETURN();
+   }
+
+      /// Time the batch against the scalar path on a grid of times.
+   unsigned timingTest()
+   {
+      TUDEF("OrbitEphBatch", "svXvt timing");
+
+      loadEphs(testFramework);
+      OrbitEphBatch batch;
+      for(size_t k=0; k<ephs.size(); k++)
+         batch.addEphemeris(ephs[k]);
+
+      const double dt(1.0);
+      const size_t n(14400);
+      double sum1(0), sum2(0);
+      clock_t start(clock());
+      for(size_t k=0; k<ephs.size(); k++)
+      {
+         CommonTime t0(ephs[k].ctToe - 7200.);
+         for(size_t i=0; i<n; i++)
+            sum1 += ephs[k].svXvt(t0 + i*dt).x[0];
+      }
+      double tscalar(double(clock()-start)/CLOCKS_PER_SEC);
+
+      vector<Xvt> xvts;
+      start = clock();
+      for(size_t k=0; k<ephs.size(); k++)
+      {
+         batch.svXvt(k, ephs[k].ctToe - 7200., dt, n, xvts);
+         for(size_t i=0; i<n; i++)
+            sum2 += xvts[i].x[0];
+      }
+      double tbatch(double(clock()-start)/CLOCKS_PER_SEC);
+
+      cout << "Timing " << ephs.size()*n << " evaluations: OrbitEph::svXvt "
+           << fixed << tscalar << " s, OrbitEphBatch " << tbatch << " s"
+           << endl;
+      TUASSERTFEPS(sum1, sum2, 1.e-3 * ephs.size() * n);
+
+      TURETURN();
+   }
+
+private:
+   std::string inputNav;
+   std::vector<GPSEphemeris> ephs;
+};
+
+
+int main() // Main function to initialize and run all tests above
+{
+   unsigned errorTotal = 0;
+   OrbitEphBatch_T testClass;
+   testClass.init();
+
+   errorTotal += testClass.accuracyTest();
+   errorTotal += testClass.timingTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; // Return the total number of errors
+}
@@ -0,0 +1,345 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "OrbitEphFit.hpp"
+#include "OrbitEphStore.hpp"
+#include "GPSEphemeris.hpp"
+#include "Rinex3NavStream.hpp"
+#include "Rinex3NavHeader.hpp"
+#include "Rinex3NavData.hpp"
+#include "GNSSconstants.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class OrbitEphFit_T
+{
+public:
+   OrbitEphFit_T() {}
+
+   void init()
+   {
+      std::string dataFilePath = gpstk::getPathData();
+      std::string fileSep = gpstk::getFileSep();
+
+      inputNav = dataFilePath + fileSep + "test_input_rinex3_76193040.14n";
+   }
+
+      /// Read the GPS ephemerides in the test file.
+   void loadEphs(TestUtil& testFramework)
+   {
+      ephs.clear();
+      try
+      {
+         Rinex3NavStream strm(inputNav.c_str());
+         Rinex3NavHeader head;
+         Rinex3NavData data;
+         strm >> head;
+         while(strm >> data)
+         {
+            if(data.sat.system == SatID::systemGPS)
+               ephs.push_back(GPSEphemeris(data));
+         }
+      }
+      catch(Exception& e)
+      {
+         TUFAIL("Failed to read " + inputNav + ": " + e.what());
+      }
+      TUASSERT(ephs.size() > 0);
+   }
+
+      /// Maximum differences of a fit from OrbitEph::svXvt().
+   struct MaxDiff
+   {
+      MaxDiff() : pos(0), vel(0), clk(0), drift(0), rel(0) {}
+      void update(const Xvt& ref, const Xvt& fit)
+      {
+         pos = max(pos, range(ref.x - fit.x));
+         vel = max(vel, range(ref.v - fit.v));
+         clk = max(clk, fabs(ref.clkbias - fit.clkbias));
+         drift = max(drift, fabs(ref.clkdrift - fit.clkdrift));
+         rel = max(rel, fabs(ref.relcorr - fit.relcorr));
+      }
+      static double range(const Triple& d)
+      { return ::sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]); }
+      double pos, vel, clk, drift, rel;
+   };
+
+      /** Compare OrbitEphFit::svXvt() with OrbitEph::svXvt() every
+       * 10 seconds over the interval of validity of each
+       * ephemeris. */
+   unsigned accuracyTest()
+   {
+      TUDEF("OrbitEphFit", "svXvt");
+
+      loadEphs(testFramework);
+      MaxDiff md;
+      bool allUsable(true), outside(false);
+      for(size_t k=0; k<ephs.size(); k++)
+      {
+         OrbitEphFit fit;
+         fit.fit(ephs[k]);
+         if(fit.numSegments() == 0 || fit.numUsable() != fit.numSegments())
+            allUsable = false;
+
+         double length(ephs[k].endValid - ephs[k].beginValid);
+         Xvt xvt;
+         for(double dt=0.0; dt<=length; dt+=10.0)
+         {
+            CommonTime t(ephs[k].beginValid + dt);
+            if(fit.svXvt(t, xvt))
+               md.update(ephs[k].svXvt(t), xvt);
+         }
+         if(fit.svXvt(ephs[k].beginValid - 1.0, xvt) ||
+            fit.svXvt(ephs[k].endValid + 1.0, xvt))
+            outside = true;
+      }
+      TUASSERT(allUsable);
+      TUASSERT(!outside);
+      TUASSERT(md.pos < 1.e-4);             // m
+      TUASSERT(md.vel < 1.e-6);             // m/s
+      TUASSERT(md.clk < 1.e-15);            // s
+      TUASSERT(md.drift < 1.e-18);          // s/s
+      TUASSERT(md.rel * C_MPS < 1.e-4);     // m
+      cout << "OrbitEphFit max difference from OrbitEph::svXvt(): "
+           << scientific << md.pos << " m, " << md.vel << " m/s, "
+           << md.rel * C_MPS << " m (relativity)" << endl;
+
+         // segments outside a tolerance that cannot be met are not used
+      OrbitEphFit coarse;
+      coarse.fit(ephs[0], 1.e-3, 7200.0, 2);
+      TUASSERT(coarse.numSegments() > 0);
+      TUASSERTE(size_t, 0, coarse.numUsable());
+      TUASSERT(coarse.maxError() > 1.e-3);
+      Xvt xvt;
+      TUASSERT(!coarse.svXvt(ephs[0].ctToe, xvt));
+
+         // no fit, no results
+      OrbitEphFit none;
+      TUASSERTE(size_t, 0, none.numSegments());
+      TUASSERT(!none.svXvt(ephs[0].ctToe, xvt));
+
+         // invalid input
+      try
+      {
+         OrbitEph empty;
+         none.fit(empty);
+         TUFAIL("Expected InvalidRequest for an empty OrbitEph");
+      }
+      catch(InvalidRequest&)
+      {
+         TUPASS("InvalidRequest for an empty OrbitEph");
+      }
+      try
+      {
+         none.fit(ephs[0], 1.e-3, 3600.0, OrbitEphFit::MaxDegree+1);
+         TUFAIL("Expected InvalidParameter for a bad degree");
+      }
+      catch(InvalidParameter&)
+      {
+         TUPASS("InvalidParameter for a bad degree");
+      }
+
+      TURETURN();
+   }
+
+      /** Compare OrbitEphStore results with and without orbit fits,
+       * for every satellite every 30 seconds over the day. */
+   unsigned storeTest()
+   {
+      TUDEF("OrbitEphStore", "setOrbitFit");
+
+      loadEphs(testFramework);
+      OrbitEphStore exact, fitted;
+      for(size_t k=0; k<ephs.size(); k++)
+      {
+         exact.addEphemeris(&ephs[k]);
+         fitted.addEphemeris(&ephs[k]);
+      }
+      TUASSERT(!fitted.getOrbitFit());
+      fitted.setOrbitFit(true);
+      TUASSERT(fitted.getOrbitFit());
+      TUASSERTFE(0.001, fitted.getOrbitFitTolerance());
+
+      std::set<SatID> sats(exact.getIndexSet());
+      CommonTime t0(exact.getInitialTime());
+      vector<XvtStore<SatID>::XvtQuery> queries;
+      MaxDiff md, mdc;
+      unsigned nfound(0), nmismatch(0);
+      for(double dt=0.0; dt<86400.0; dt+=30.0)
+      {
+         CommonTime t(t0 + dt);
+         for(std::set<SatID>::const_iterator it = sats.begin();
+             it != sats.end(); ++it)
+         {
+            queries.push_back(make_pair(*it, t));
+            Xvt ref(exact.computeXvt(*it, t)), xvt(fitted.computeXvt(*it, t));
+            if(ref.health != xvt.health)
+               nmismatch++;
+            if(ref.health == Xvt::HealthStatus::Unavailable)
+               continue;
+            nfound++;
+            md.update(ref, xvt);
+            mdc.update(ref, fitted.getXvt(*it, t));
+         }
+      }
+      TUASSERT(nfound > 0);
+      TUASSERTE(unsigned, 0, nmismatch);
+      TUASSERT(md.pos < 1.e-4);
+      TUASSERT(md.vel < 1.e-6);
+      TUASSERT(mdc.pos < 1.e-4);
+
+      vector<Xvt> ref, xvts;
+      vector<XvtStore<SatID>::XvtStatus> refStatus, status;
+      TUASSERTE(unsigned, exact.getXvts(queries, ref, refStatus),
+                fitted.getXvts(queries, xvts, status));
+      MaxDiff mdb;
+      for(size_t i=0; i<queries.size(); i++)
+      {
+         if(refStatus[i] != status[i])
+            nmismatch++;
+         else if(status[i] == XvtStore<SatID>::Valid)
+            mdb.update(ref[i], xvts[i]);
+      }
+      TUASSERTE(unsigned, 0, nmismatch);
+      TUASSERT(mdb.pos < 1.e-4);
+
+         // replacing an ephemeris with a different one of the same
+         // Toe drops its fit
+      GPSEphemeris moved(ephs[0]);
+      fitted.computeXvt(moved.satID, moved.ctToe);
+      moved.beginValid = moved.beginValid - 30.0;
+      moved.M0 += 1.e-6;
+      TUASSERT(exact.addEphemeris(&moved) != nullptr);
+      TUASSERT(fitted.addEphemeris(&moved) != nullptr);
+      Xvt xm1(exact.computeXvt(moved.satID, moved.ctToe)),
+         xm2(fitted.computeXvt(moved.satID, moved.ctToe));
+      TUASSERTE(Xvt::HealthStatus, xm1.health, xm2.health);
+      TUASSERT(MaxDiff::range(xm1.x - xm2.x) < 1.e-4);
+
+         // fits are dropped with the ephemerides
+      fitted.edit(t0 + 43200.0);
+      exact.edit(t0 + 43200.0);
+      CommonTime t(t0 + 50000.0);
+      const SatID& sat(*sats.begin());
+      Xvt x1(exact.computeXvt(sat, t)), x2(fitted.computeXvt(sat, t));
+      TUASSERTE(Xvt::HealthStatus, x1.health, x2.health);
+      if(x1.health != Xvt::HealthStatus::Unavailable)
+         TUASSERT(MaxDiff::range(x1.x - x2.x) < 1.e-4);
+
+      try
+      {
+         fitted.setOrbitFit(true, 1.e-3, 0.0);
+         TUFAIL("Expected InvalidParameter for a bad segment length");
+      }
+      catch(InvalidParameter&)
+      {
+         TUPASS("InvalidParameter for a bad segment length");
+      }
+
+      TURETURN();
+   }
+
+      /** Time a store with and without fits, every second for a
+       * day, at the times each satellite has an ephemeris. */
+   unsigned timingTest()
+   {
+      TUDEF("OrbitEphStore", "setOrbitFit timing");
+
+      loadEphs(testFramework);
+      OrbitEphStore store;
+      for(size_t k=0; k<ephs.size(); k++)
+         store.addEphemeris(&ephs[k]);
+      std::set<SatID> sats(store.getIndexSet());
+      CommonTime t0(store.getInitialTime());
+
+      vector<XvtStore<SatID>::XvtQuery> queries;
+      for(double dt=0.0; dt<86400.0; dt+=1.0)
+      {
+         CommonTime t(t0 + dt);
+         for(std::set<SatID>::const_iterator it = sats.begin();
+             it != sats.end(); ++it)
+            if(store.findOrbitEph(*it, t))
+               queries.push_back(make_pair(*it, t));
+      }
+      TUASSERT(queries.size() > 0);
+
+      double sum[2] = { 0.0, 0.0 }, secs[2];
+      vector<Xvt> xvts;
+      vector<XvtStore<SatID>::XvtStatus> status;
+      for(int pass=0; pass<2; pass++)
+      {
+         store.setOrbitFit(pass == 1);
+         clock_t start(clock());
+         store.getXvts(queries, xvts, status);
+         secs[pass] = double(clock()-start)/CLOCKS_PER_SEC;
+         for(size_t i=0; i<xvts.size(); i++)
+            sum[pass] += xvts[i].x[0];
+      }
+
+      cout << "Timing getXvts() of " << queries.size() << " queries: exact "
+           << fixed << secs[0] << " s, fitted " << secs[1] << " s" << endl;
+      TUASSERTFEPS(sum[0], sum[1], 1.e-3 * queries.size());
+
+      TURETURN();
+   }
+
+private:
+   std::string inputNav;
+   std::vector<GPSEphemeris> ephs;
+};
+
+
+int main() // Main function to initialize and run all tests above
+{
+   unsigned errorTotal = 0;
+   OrbitEphFit_T testClass;
+   testClass.init();
+
+   errorTotal += testClass.accuracyTest();
+   errorTotal += testClass.storeTest();
+   errorTotal += testClass.timingTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; // Return the total number of errors
+}
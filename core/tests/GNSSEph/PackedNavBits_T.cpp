@@ -48,6 +48,8 @@
 #include "TimeString.hpp"
 #include "TimeSystem.hpp"
 
+#include <cstdlib>
+
 using namespace std;
 using namespace gpstk;
 
@@ -62,8 +64,42 @@ public:
    unsigned realDataTest();
    unsigned equalityTest();
    unsigned ancillaryMethods();
+   unsigned wordPackingTest();
 
    double eps; 
+
+private:
+      // The bit-by-bit std::vector<bool> packing that PackedNavBits
+      // used before it stored 64-bit words; the reference for
+      // wordPackingTest().
+   class BitVectorRef
+   {
+   public:
+      BitVectorRef() : bits(900), bits_used(0) {}
+      void add(uint64_t value, int numBits)
+      {
+         uint64_t mask = uint64_t(1) << (numBits-1);
+         for (int i=0; i<numBits; ++i, mask >>= 1)
+            bits[bits_used++] = (value & mask) != 0;
+      }
+      uint64_t get(int startBit, int numBits) const
+      {
+         uint64_t temp = 0;
+         for (int i=startBit; i<startBit+numBits; ++i)
+         {
+            temp <<= 1;
+            if (bits[i]) temp++;
+         }
+         return temp;
+      }
+      std::vector<bool> bits;
+      int bits_used;
+   };
+
+      // Fill a reference and a PackedNavBits with the same random fields
+      // of 1 to 32 bits, totalling at least numBits bits.
+   static void fillRandom(BitVectorRef& ref, PackedNavBits& pnb,
+                          std::vector<int>& widths, int numBits);
 };
 
 PackedNavBits_T ::
@@ -834,6 +870,107 @@ ancillaryMethods()
    TURETURN();
 }
 
+void PackedNavBits_T ::
+fillRandom(BitVectorRef& ref, PackedNavBits& pnb, std::vector<int>& widths,
+           int numBits)
+{
+   widths.clear();
+   int total = 0;
+   while (total < numBits)
+   {
+      int n = 1 + std::rand() % 32;
+      unsigned long value = ((unsigned long)std::rand() << 16) ^ std::rand();
+      value &= (n == 32) ? 0xFFFFFFFFUL : ((1UL << n) - 1);
+      ref.add(value, n);
+      pnb.addUnsignedLong(value, n, 1);
+      widths.push_back(n);
+      total += n;
+   }
+}
+
+   // Fields that cross word boundaries, and the bit-array operations,
+   // against the original bit-by-bit packing.
+unsigned PackedNavBits_T ::
+wordPackingTest()
+{
+   TUDEF("PackedNavBits", "asUnsignedLong");
+   std::srand(20190101);
+   BitVectorRef ref;
+   PackedNavBits pnb;
+   std::vector<int> widths;
+   fillRandom(ref, pnb, widths, 800);
+   TUASSERTE(size_t, ref.bits_used, pnb.getNumBits());
+
+      // every field as added, and arbitrary fields up to 64 bits
+   bool same = true;
+   int start = 0;
+   for (size_t i=0; i<widths.size(); i++)
+   {
+      if (pnb.asUnsignedLong(start, widths[i], 1) != ref.get(start, widths[i]))
+         same = false;
+      start += widths[i];
+   }
+   TUASSERT(same);
+   same = true;
+   for (int i=0; i<2000; i++)
+   {
+      int n = 1 + std::rand() % 32;
+      int first = std::rand() % (ref.bits_used - n);
+      if (pnb.asUnsignedLong(first, n, 1) != ref.get(first, n))
+         same = false;
+      int64_t sref = (int64_t)(ref.get(first, n) << (64-n)) >> (64-n);
+      if (pnb.asLong(first, n, 1) != (long)sref)
+         same = false;
+      if (pnb.asBool(first) != ref.bits[first])
+         same = false;
+   }
+   TUASSERT(same);
+   TUASSERT(pnb.getBits() == ref.bits);
+
+   TUCSM("insertUnsignedLong");
+   pnb.insertUnsignedLong(0x2AAAAAAUL, 50, 26, 1);
+   ref.bits_used = 50;
+   ref.add(0x2AAAAAAUL, 26);
+   ref.bits_used = pnb.getNumBits();
+   TUASSERTE(unsigned long, 0x2AAAAAAUL, pnb.asUnsignedLong(50, 26, 1));
+   TUASSERT(pnb.getBits() == ref.bits);
+
+   TUCSM("addPackedNavBits");
+   PackedNavBits head, tail;
+   BitVectorRef href, tref;
+   fillRandom(href, head, widths, 100);
+   fillRandom(tref, tail, widths, 150);
+   head.trimsize();
+   head.addPackedNavBits(tail);
+   href.bits.resize(href.bits_used);
+   for (int i=0; i<tref.bits_used; i++)
+      href.bits.push_back(tref.bits[i]);
+   TUASSERT(head.getBits() == href.bits);
+
+   TUCSM("operator<");
+   PackedNavBits a(pnb), b(pnb);
+   TUASSERTE(bool, false, a<b);
+   TUASSERTE(bool, false, b<a);
+   TUASSERTE(size_t, a.hash(), b.hash());
+   b.insertUnsignedLong(1 - pnb.asUnsignedLong(700, 1, 1), 700, 1, 1);
+   TUASSERT((a<b) != (b<a));
+   TUASSERTE(bool, pnb.asBool(700) == false, a<b);
+   TUASSERT(a.hash() != b.hash());
+   TUASSERTE(bool, false, a.matchBits(b));
+   TUASSERTE(bool, true, a.matchBits(b, 0, 699));
+   TUASSERTE(bool, true, a.matchBits(b, 701));
+
+   TUCSM("invert");
+      // inverting twice restores the bits, and the unused bits stay clear
+   b = a;
+   b.invert();
+   TUASSERTE(bool, false, a.matchBits(b, 0, 0));
+   b.invert();
+   TUASSERTE(bool, true, a.matchBits(b));
+   TUASSERTE(size_t, a.hash(), b.hash());
+   TURETURN();
+}
+
 int main()
 {
    unsigned errorTotal = 0;
@@ -844,6 +981,7 @@ int main()
    errorTotal += testClass.realDataTest();
    errorTotal += testClass.equalityTest();
    errorTotal += testClass.ancillaryMethods();
+   errorTotal += testClass.wordPackingTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
 
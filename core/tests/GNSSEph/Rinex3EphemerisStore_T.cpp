@@ -0,0 +1,129 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TestUtil.hpp"
+#include "Rinex3EphemerisStore.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class Rinex3EphemerisStore_T
+{
+public:
+   Rinex3EphemerisStore_T() {}
+
+   void init()
+   {
+      dataFilePath = gpstk::getPathData() + gpstk::getFileSep();
+   }
+
+      /** Test that loadFiles() builds the same store as loadFile()
+       * on each file in turn, and stops at the same place, with the
+       * same return, when a file cannot be read. */
+   unsigned loadFilesTest()
+   {
+      TUDEF("Rinex3EphemerisStore", "loadFiles");
+
+      vector<string> files;
+      files.push_back(dataFilePath + "mixed.06n");
+      files.push_back(dataFilePath + "test_input_rinex3_76193040.14n");
+      files.push_back(dataFilePath + "test_input_rinex3_nav_RinexNavExample.15n");
+      files.push_back(dataFilePath + "test_input_rinex3_nav_FilterTest1.15n");
+      files.push_back(dataFilePath + "test_input_rinex3_nav_FilterTest2.15n");
+      files.push_back(dataFilePath + "arlm2000.15n");
+      files.push_back(dataFilePath + "arlm2001.15n");
+
+      vector<string> badFiles(files.begin(), files.begin()+3);
+      badFiles.push_back(dataFilePath + "NotaFILE");
+      badFiles.push_back(files[3]);
+
+      vector<string>* lists[] = { &files, &badFiles };
+      for(int k=0; k<2; k++)
+      {
+            // loadFile() on each until one fails, as an application would
+         Rinex3EphemerisStore seqStore;
+         int nseq(0);
+         for(unsigned i=0; i<lists[k]->size(); i++)
+         {
+            int n = seqStore.loadFile((*lists[k])[i]);
+            if(n < 0)
+            {
+               nseq = n;
+               break;
+            }
+            nseq += n;
+         }
+         TUASSERTE(bool, (k == 1), nseq < 0);
+         ostringstream seqDump;
+         seqStore.dump(seqDump, 2);
+
+         for(unsigned nthreads=1; nthreads<=4; nthreads+=3)
+         {
+            Rinex3EphemerisStore parStore;
+            TUASSERTE(int, nseq, parStore.loadFiles(*lists[k], nthreads));
+            TUASSERTE(string, seqStore.what, parStore.what);
+            TUASSERTE(int, seqStore.size(), parStore.size());
+            ostringstream parDump;
+            parStore.dump(parDump, 2);
+            TUASSERT(seqDump.str() == parDump.str());
+         }
+      }
+
+      TURETURN();
+   }
+
+private:
+   std::string dataFilePath;
+};
+
+
+int main() // Main function to initialize and run all tests above
+{
+   unsigned errorTotal = 0;
+   Rinex3EphemerisStore_T testClass;
+   testClass.init();
+
+   errorTotal += testClass.loadFilesTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; // Return the total number of errors
+}
@@ -35,6 +35,7 @@
 //==============================================================================
 
 #include <list>
+#include <vector>
 #include <string>
 #include <iostream>
 #include <fstream>
@@ -51,6 +52,7 @@
 #include "GPSEphemerisStore.hpp"
 #include "SatID.hpp"
 #include "RinexNavStream.hpp"
+#include "EphemerisCache.hpp"
 #include "TestUtil.hpp"
 
 
@@ -1535,6 +1537,118 @@ public:
       return testFramework.countFails();
    }
 
+//=============================================================================
+//      Test that loadFiles() builds the same store as loadFile() on each
+//      file in turn, including overlapping files and a failure part way
+//=============================================================================
+   unsigned loadFilesTest()
+   {
+      TUDEF("RinexEphemerisStore", "loadFiles");
+
+      string dataFilePath = gpstk::getPathData() + "/";
+      vector<string> files;
+      files.push_back(inputRinexNavData);
+      files.push_back(dataFilePath + "arlm2000.15n");
+      files.push_back(dataFilePath + "arlm2001.15n");
+      files.push_back(dataFilePath + "arlm200a.15n");
+      files.push_back(dataFilePath + "arlm200b.15n");
+      files.push_back(dataFilePath + "arlm200z.15n");
+      files.push_back(dataFilePath + "nga002.15n");
+      files.push_back(dataFilePath + "nga003.15n");
+
+      RinexEphemerisStore seqStore;
+      for(unsigned i=0; i<files.size(); i++)
+         seqStore.loadFile(files[i]);
+      ostringstream seqDump;
+      seqStore.dump(seqDump, 2);
+
+      for(unsigned nthreads=1; nthreads<=4; nthreads+=3)
+      {
+         RinexEphemerisStore parStore;
+         parStore.loadFiles(files, nthreads);
+         ostringstream parDump;
+         parStore.dump(parDump, 2);
+         TUASSERTE(unsigned, seqStore.gpstk::OrbitEphStore::size(),
+                   parStore.gpstk::OrbitEphStore::size());
+         TUASSERT(seqDump.str() == parDump.str());
+      }
+
+         // a missing file stops the load where loadFile() would
+      vector<string> badFiles(files.begin(), files.begin()+3);
+      badFiles.push_back(inputNotaFile);
+      badFiles.push_back(files[4]);
+      RinexEphemerisStore seqBad, parBad;
+      try
+      {
+         for(unsigned i=0; i<badFiles.size(); i++)
+            seqBad.loadFile(badFiles[i]);
+         TUFAIL("loadFile() of a missing file should throw");
+      }
+      catch(FileMissingException& e)
+      {
+         TUPASS("loadFile() threw FileMissingException");
+      }
+      try
+      {
+         parBad.loadFiles(badFiles, 4);
+         TUFAIL("loadFiles() with a missing file should throw");
+      }
+      catch(FileMissingException& e)
+      {
+         TUPASS("loadFiles() threw FileMissingException");
+      }
+      ostringstream seqBadDump, parBadDump;
+      seqBad.dump(seqBadDump, 2);
+      parBad.dump(parBadDump, 2);
+      TUASSERT(seqBadDump.str() == parBadDump.str());
+      TUASSERTE(unsigned, 3, parBad.getFileNames().size());
+
+      TURETURN();
+   }
+
+//=============================================================================
+//      Test that loadCache() restores the store written by saveCache(),
+//      and only from the same files in the same order
+//=============================================================================
+   unsigned cacheTest()
+   {
+      TUDEF("RinexEphemerisStore", "loadCache");
+
+      string dataFilePath = gpstk::getPathData() + "/";
+      string cacheFile = gpstk::getPathTestTemp() + "/" +
+                         "RinexEphemerisStore_T.cache";
+      vector<string> files;
+      files.push_back(dataFilePath + "arlm200a.15n");
+      files.push_back(dataFilePath + "arlm200b.15n");
+      files.push_back(inputRinexNavData);
+
+      RinexEphemerisStore saved, restored;
+      saved.loadFiles(files, 1);
+      saved.saveCache(cacheFile);
+      TUASSERT(restored.loadCache(cacheFile, files));
+      ostringstream savedDump, restoredDump;
+      saved.dump(savedDump, 2);
+      restored.dump(restoredDump, 2);
+      TUASSERT(savedDump.str() == restoredDump.str());
+      TUASSERTE(unsigned, saved.gpstk::OrbitEphStore::size(),
+                restored.gpstk::OrbitEphStore::size());
+      TUASSERT(files == restored.getFileNamesInOrder());
+
+         // the same files in another order
+      vector<string> reversed(files.rbegin(), files.rend());
+      RinexEphemerisStore other;
+      TUASSERT(!other.loadCache(cacheFile, reversed));
+      TUASSERTE(unsigned, 0, other.gpstk::OrbitEphStore::size());
+      TUASSERTE(unsigned, 0, other.getFileNames().size());
+         // another search method
+      RinexEphemerisStore near;
+      near.SearchNear();
+      TUASSERT(!near.loadCache(cacheFile, files));
+
+      remove(cacheFile.c_str());
+      TURETURN();
+   }
+
 //=============================================================================
 //      Initialize Test Data Filenames
 //=============================================================================
@@ -1660,6 +1774,8 @@ int main() // Main function to initialize and run all tests above
    errorTotal += testClass.clearTest();
    errorTotal += testClass.findUserOrbEphTest();
    errorTotal += testClass.findNearOrbEphTest();
+   errorTotal += testClass.loadFilesTest();
+   errorTotal += testClass.cacheTest();
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
 
    return errorTotal; // Return the total number of errors
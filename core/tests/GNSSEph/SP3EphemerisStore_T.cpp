@@ -35,6 +35,7 @@
 //==============================================================================
 
 #include <list>
+#include <vector>
 #include <string>
 #include <iostream>
 #include <fstream>
@@ -682,6 +683,276 @@ public:
       TURETURN();
    }
 
+//=============================================================================
+// Test that compact() does not change the results of any query: every
+// interpolation from a compacted store (and a copy of it) must agree
+// exactly with the original, including the exceptions thrown at the
+// ends of the data, at gaps and for intervals that are too large.
+//=============================================================================
+   unsigned compactTest()
+   {
+      TUDEF("SP3EphemerisStore", "compact");
+
+      std::string files[] = { inputSP3Data, inputSixNinesData };
+      for(int f=0; f<2; f++)
+      {
+         for(int checks=0; checks<2; checks++)
+         {
+            SP3EphemerisStore store;
+            store.loadFile(files[f]);
+            if(checks)
+            {
+               store.setPosGapInterval(901.);
+               store.setPosMaxInterval(8101.);
+            }
+            SP3EphemerisStore cstore(store);
+            cstore.compact();
+            TUASSERT(cstore.isCompacted());
+            TUASSERT(!store.isCompacted());
+            SP3EphemerisStore ccopy(cstore);
+            TUASSERT(ccopy.isCompacted());
+
+            unsigned nquery(0), nthrow(0), nbad(0);
+            std::vector<SatID> sats(store.getSatList());
+            sats.push_back(SatID(33, SatID::systemGPS));
+            CommonTime t0(store.getInitialTime()), t1(store.getFinalTime());
+            for(size_t i=0; i<sats.size(); i++)
+            {
+               for(double dt=-1800.; t0+dt <= t1+1800.; dt += 150.)
+               {
+                  for(int off=0; off<2; off++)
+                  {
+                     CommonTime t(t0 + dt + (off ? 37.5 : 0.0));
+                     Xvt xvt, cxvt, yxvt;
+                     Triple pos, cpos;
+                     int thr(0), cthr(0), ythr(0);
+                     try { xvt = store.getXvt(sats[i], t);
+                        pos = store.getPosition(sats[i], t); }
+                     catch(InvalidRequest&) { thr = 1; }
+                     try { cxvt = cstore.getXvt(sats[i], t);
+                        cpos = cstore.getPosition(sats[i], t); }
+                     catch(InvalidRequest&) { cthr = 1; }
+                     try { yxvt = ccopy.getXvt(sats[i], t); }
+                     catch(InvalidRequest&) { ythr = 1; }
+
+                     nquery++;
+                     nthrow += thr;
+                     if(thr != cthr || thr != ythr)
+                        nbad++;
+                     else if(!thr)
+                     {
+                        for(int j=0; j<3; j++)
+                        {
+                           if(xvt.x[j] != cxvt.x[j] || xvt.v[j] != cxvt.v[j] ||
+                              xvt.x[j] != yxvt.x[j] || pos[j] != cpos[j])
+                              nbad++;
+                        }
+                        if(xvt.clkbias != cxvt.clkbias ||
+                           xvt.clkdrift != cxvt.clkdrift)
+                           nbad++;
+                     }
+                  }
+               }
+            }
+            TUASSERTE(unsigned, 0, nbad);
+            TUASSERT(nthrow > 0 && nthrow < nquery);
+         }
+      }
+
+         // adding data discards the flat index, results are still right
+      SP3EphemerisStore store;
+      store.loadFile(inputSP3Data);
+      store.compact();
+      store.loadFile(inputSixNinesData);
+      TUASSERT(!store.isCompacted());
+      store.compact();
+      store.edit(store.getInitialTime() + 3600.);
+      TUASSERT(!store.isCompacted());
+
+      TURETURN();
+   }
+
+//=============================================================================
+// Test that loadFiles() builds the same store as loadFile() on each file in
+// turn: with overlapping SP3 files, with RINEX clock files, and when a file
+// fails part way through the list.
+//=============================================================================
+      /// Load files one at a time, @return the error text, if any.
+   static string loadEach(SP3EphemerisStore& store, const vector<string>& files)
+   {
+      try
+      {
+         for(unsigned i=0; i<files.size(); i++)
+            store.loadFile(files[i]);
+      }
+      catch(Exception& e)
+      {
+         return e.getText();
+      }
+      return string();
+   }
+
+      /// Load files with loadFiles(), @return the error text, if any.
+   static string loadAll(SP3EphemerisStore& store, const vector<string>& files,
+                         unsigned nthreads)
+   {
+      try
+      {
+         store.loadFiles(files, nthreads);
+      }
+      catch(Exception& e)
+      {
+         return e.getText();
+      }
+      return string();
+   }
+
+   unsigned loadFilesTest()
+   {
+      TUDEF("SP3EphemerisStore", "loadFiles");
+
+      string dataFilePath = gpstk::getPathData() + gpstk::getFileSep();
+      vector<string> sp3Files, clkFiles, badFiles;
+      sp3Files.push_back(inputSixNinesData);
+      sp3Files.push_back(inputAPCData);
+      sp3Files.push_back(dataFilePath + "test_input_SP3a.sp3");   // overlaps
+      sp3Files.push_back(dataFilePath + "test_input_SP3b.sp3");
+      sp3Files.push_back(inputSP3Data);
+      sp3Files.push_back(dataFilePath + "test_input_sp3_nav_2015_200.sp3");
+
+      clkFiles.push_back(inputSP3Data);
+      clkFiles.push_back(dataFilePath +
+                         "test_input_rinex3_clock_RinexClockExample.96c");
+      clkFiles.push_back(dataFilePath +
+                         "test_input_rinex2_clock_RinexClockExample.96c");
+
+      badFiles.push_back(inputSP3Data);
+      badFiles.push_back(inputAPCData);
+      badFiles.push_back(inputNotaFile);
+      badFiles.push_back(dataFilePath + "test_input_SP3b.sp3");
+
+      vector<string>* lists[] = { &sp3Files, &clkFiles, &badFiles };
+      for(int k=0; k<3; k++)
+      {
+         for(unsigned nthreads=1; nthreads<=4; nthreads+=3)
+         {
+            SP3EphemerisStore seqStore, parStore;
+            if(k == 1)
+            {
+               seqStore.useRinexClockData();
+               parStore.useRinexClockData();
+            }
+            string seqErr(loadEach(seqStore, *lists[k]));
+            string parErr(loadAll(parStore, *lists[k], nthreads));
+            TUASSERTE(string, seqErr, parErr);
+            TUASSERTE(bool, (k == 2), !parErr.empty());
+
+            ostringstream seqDump, parDump;
+            seqStore.dump(seqDump, 2);
+            parStore.dump(parDump, 2);
+            TUASSERT(seqDump.str() == parDump.str());
+            TUASSERTE(int, seqStore.ndataPosition(), parStore.ndataPosition());
+            TUASSERTE(int, seqStore.ndataClock(), parStore.ndataClock());
+         }
+      }
+
+      TURETURN();
+   }
+
+      /** Test that a store restored by loadCache() matches the store
+       * that was saved, and that a cache is refused when the files,
+       * a source file or the settings differ. */
+   unsigned cacheTest()
+   {
+      TUDEF("SP3EphemerisStore", "loadCache");
+
+      string dataFilePath = gpstk::getPathData() + gpstk::getFileSep();
+      string tempFilePath = gpstk::getPathTestTemp() + gpstk::getFileSep();
+      string cacheFile = tempFilePath + "SP3EphemerisStore_T.cache";
+      string copyFile = tempFilePath + "SP3EphemerisStore_T.sp3";
+
+         // a copy of one file, to change later
+      {
+         ifstream ifs(inputAPCData.c_str(), ios::binary);
+         ofstream ofs(copyFile.c_str(), ios::binary);
+         ofs << ifs.rdbuf();
+      }
+
+      vector<string> sp3Files, clkFiles;
+      sp3Files.push_back(inputSP3Data);
+      sp3Files.push_back(copyFile);
+      clkFiles.push_back(inputSP3Data);
+      clkFiles.push_back(dataFilePath +
+                         "test_input_rinex3_clock_RinexClockExample.96c");
+
+      vector<string>* lists[] = { &sp3Files, &clkFiles };
+      for(int k=0; k<2; k++)
+      {
+         SP3EphemerisStore saved, restored;
+         if(k == 1)
+         {
+            saved.useRinexClockData();
+            restored.useRinexClockData();
+         }
+         saved.loadFiles(*lists[k], 1);
+         saved.saveCache(cacheFile);
+
+         TUASSERT(restored.loadCache(cacheFile, *lists[k]));
+         ostringstream savedDump, restoredDump;
+         saved.dump(savedDump, 2);
+         restored.dump(restoredDump, 2);
+         TUASSERT(savedDump.str() == restoredDump.str());
+         TUASSERTE(int, saved.ndataPosition(), restored.ndataPosition());
+         TUASSERTE(int, saved.ndataClock(), restored.ndataClock());
+         TUASSERTE(int, saved.nfiles(), restored.nfiles());
+         TUASSERT(saved.getTimeSystem() == restored.getTimeSystem());
+
+         SatID sat(1, SatID::systemGPS);
+         CommonTime t(saved.getPositionInitialTime() + 6*3600.);
+         TUASSERTE(Triple, saved.getPosition(sat, t),
+                   restored.getPosition(sat, t));
+
+            // the same files in another order
+         vector<string> reversed(lists[k]->rbegin(), lists[k]->rend());
+         SP3EphemerisStore other;
+         if(k == 1)
+            other.useRinexClockData();
+         TUASSERT(!other.loadCache(cacheFile, reversed));
+         TUASSERTE(int, 0, other.ndataPosition());
+         TUASSERTE(int, 0, other.nfiles());
+      }
+
+         // not the same set of files
+      vector<string> fewer(1, inputSP3Data);
+      SP3EphemerisStore store;
+      TUASSERT(!store.loadCache(cacheFile, fewer));
+         // not the same settings
+      store.useRinexClockData();
+      store.rejectPredPositions(true);
+      TUASSERT(!store.loadCache(cacheFile, clkFiles));
+      store.rejectPredPositions(false);
+      TUASSERT(store.loadCache(cacheFile, clkFiles));
+         // no cache, or not a cache
+      SP3EphemerisStore empty;
+      TUASSERT(!empty.loadCache(inputNotaFile, sp3Files));
+      TUASSERT(!empty.loadCache(inputSP3Data, sp3Files));
+         // a source file has changed
+      empty.loadFiles(sp3Files, 1);
+      empty.saveCache(cacheFile);
+      {
+         ofstream ofs(copyFile.c_str(), ios::app);
+         ofs << "EOF" << endl;
+      }
+      SP3EphemerisStore stale;
+      TUASSERT(!stale.loadCache(cacheFile, sp3Files));
+      TUASSERTE(int, 0, stale.ndataPosition());
+      TUASSERTE(int, 0, stale.nfiles());
+
+      remove(cacheFile.c_str());
+      remove(copyFile.c_str());
+      TURETURN();
+   }
+
 private:
    double epsilon; // Floating point error threshold
    std::string dataFilePath;
@@ -714,6 +985,9 @@ int main() // Main function to initialize and run all tests above
    errorTotal += testClass.getFinalTimeTest();
    errorTotal += testClass.getPositionTest();
    errorTotal += testClass.getVelocityTest();
+   errorTotal += testClass.compactTest();
+   errorTotal += testClass.loadFilesTest();
+   errorTotal += testClass.cacheTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
 
@@ -34,18 +34,280 @@
 //
 //==============================================================================
 
-#include "TestUtil.hpp"
 #include <iostream>
+#include <vector>
+
+#include "TestUtil.hpp"
+#include "XvtStore.hpp"
+#include "Rinex3EphemerisStore.hpp"
+#include "Rinex3NavStream.hpp"
+#include "SP3EphemerisStore.hpp"
+#include "TimeString.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+typedef XvtStore<SatID>::XvtQuery XvtQuery;
+typedef XvtStore<SatID>::XvtStatus XvtStatus;
 
 class XvtStore_T
 {
 public:
    XvtStore_T() {} // Default Constructor, set the precision value
    ~XvtStore_T() {} // Default Desructor
+
+   void init()
+   {
+      std::string dataFilePath = gpstk::getPathData();
+      std::string fileSep = gpstk::getFileSep();
+
+      inputMixedNav = dataFilePath + fileSep + "mixed.06n";
+      inputGPSNav = dataFilePath + fileSep + "test_input_rinex3_76193040.14n";
+      inputSP3 = dataFilePath + fileSep + "test_input_sp3_nav_ephemerisData.sp3";
+   }
+
+      /** Compare getXvts() on the given store against getXvt() for
+       * every satellite in sats at times from t0 to t1 at step dt.
+       * The queries are made satellite by satellite, then epoch by
+       * epoch (as PRSolution does), and each is repeated once.
+       * @return the number of valid results */
+   unsigned compareBatch(TestUtil& testFramework,
+                         const XvtStore<SatID>& store,
+                         const vector<SatID>& sats,
+                         const CommonTime& t0, const CommonTime& t1,
+                         double dt)
+   {
+      vector<XvtQuery> bySat, byTime;
+      for(size_t i=0; i<sats.size(); i++)
+      {
+         for(CommonTime t(t0); t <= t1; t += dt)
+         {
+            bySat.push_back(XvtQuery(sats[i], t));
+            bySat.push_back(XvtQuery(sats[i], t));
+         }
+      }
+      for(CommonTime t(t0); t <= t1; t += dt)
+      {
+         for(size_t i=0; i<sats.size(); i++)
+            byTime.push_back(XvtQuery(sats[i], t));
+      }
+
+      unsigned nvalid(0);
+      for(int order=0; order<2; order++)
+      {
+         const vector<XvtQuery>& queries(order ? byTime : bySat);
+         vector<Xvt> xvts;
+         vector<XvtStatus> status;
+         unsigned nret = store.getXvts(queries, xvts, status);
+         TUASSERTE(size_t, queries.size(), xvts.size());
+         TUASSERTE(size_t, queries.size(), status.size());
+
+         unsigned nbad(0), ngood(0);
+         for(size_t k=0; k<queries.size(); k++)
+         {
+            Xvt xvt;
+            bool valid(true);
+            try { xvt = store.getXvt(queries[k].first, queries[k].second); }
+            catch(Exception&) { valid = false; }
+
+            if(valid != (status[k] == XvtStore<SatID>::Valid))
+            {
+               nbad++;
+               continue;
+            }
+            if(!valid)
+            {
+               if(xvts[k].health != Xvt::HealthStatus::Unavailable)
+                  nbad++;
+               continue;
+            }
+            ngood++;
+            for(int j=0; j<3; j++)
+            {
+               if(xvt.x[j] != xvts[k].x[j] || xvt.v[j] != xvts[k].v[j])
+                  nbad++;
+            }
+            if(xvt.clkbias != xvts[k].clkbias ||
+               xvt.clkdrift != xvts[k].clkdrift ||
+               xvt.relcorr != xvts[k].relcorr ||
+               xvt.health != xvts[k].health)
+               nbad++;
+         }
+         TUASSERTE(unsigned, 0, nbad);
+         TUASSERTE(unsigned, ngood, nret);
+         nvalid = ngood;
+      }
+      return nvalid;
+   }
+
+      /// Test getXvts() against getXvt() for RINEX 3 navigation data.
+   unsigned rinex3Test()
+   {
+      TUDEF("Rinex3EphemerisStore", "getXvts");
+
+      string files[] = { inputMixedNav, inputGPSNav };
+      for(int f=0; f<2; f++)
+      {
+         Rinex3EphemerisStore store;
+         TUASSERT(loadMarked(store, files[f]) > 0);
+
+         std::set<SatID> satset(store.getIndexSet());
+         vector<SatID> sats(satset.begin(), satset.end());
+         sats.push_back(SatID(32, SatID::systemGPS));
+         sats.push_back(SatID(24, SatID::systemGlonass));
+         sats.push_back(SatID(1, SatID::systemLEO));
+
+         CommonTime t0(store.getInitialTime()), t1(store.getFinalTime());
+         t0.setTimeSystem(TimeSystem::GPS);
+         t1.setTimeSystem(TimeSystem::GPS);
+         unsigned n = compareBatch(testFramework, store, sats,
+                                   t0 - 7200., t1 + 7200., 300.);
+         TUASSERT(n > 0);
+      }
+
+      TURETURN();
+   }
+
+      /// Test getXvts() against getXvt() for SP3 data.
+   unsigned sp3Test()
+   {
+      TUDEF("SP3EphemerisStore", "getXvts");
+
+      SP3EphemerisStore store;
+      store.loadFile(inputSP3);
+
+      vector<SatID> sats(store.getSatList());
+      sats.push_back(SatID(33, SatID::systemGPS));
+      CommonTime t0(store.getInitialTime()), t1(store.getFinalTime());
+      unsigned n = compareBatch(testFramework, store, sats,
+                                t0 - 3600., t1 + 3600., 450.);
+      TUASSERT(n > 0);
+
+      TURETURN();
+   }
+
+      /** Compare the status returned by the XvtStore implementation
+       * of getXvts() with the store's own override for every
+       * satellite in sats at times from t0 to t1 at step dt.
+       * @return the number of Unhealthy results */
+   unsigned compareStatus(TestUtil& testFramework,
+                          const XvtStore<SatID>& store,
+                          const vector<SatID>& sats,
+                          const CommonTime& t0, const CommonTime& t1,
+                          double dt)
+   {
+      vector<XvtQuery> queries;
+      for(size_t i=0; i<sats.size(); i++)
+         for(CommonTime t(t0); t <= t1; t += dt)
+            queries.push_back(XvtQuery(sats[i], t));
+
+      vector<Xvt> baseXvts, xvts;
+      vector<XvtStatus> baseStatus, status;
+      unsigned nbase = store.XvtStore<SatID>::getXvts(queries, baseXvts,
+                                                      baseStatus);
+      unsigned nret = store.getXvts(queries, xvts, status);
+      TUASSERTE(unsigned, nret, nbase);
+
+      unsigned nbad(0), nunhealthy(0);
+      for(size_t k=0; k<queries.size(); k++)
+      {
+         if(baseStatus[k] != status[k])
+            nbad++;
+         if(status[k] == XvtStore<SatID>::Unhealthy)
+            nunhealthy++;
+      }
+      TUASSERTE(unsigned, 0, nbad);
+      return nunhealthy;
+   }
+
+      /** Load a RINEX nav file into store as loadFile() does, but
+       * mark every third record unhealthy, since the test data are
+       * all healthy.
+       * @return the number of records marked unhealthy */
+   unsigned loadMarked(Rinex3EphemerisStore& store, const string& file)
+   {
+      Rinex3NavStream strm(file.c_str());
+      Rinex3NavHeader head;
+      Rinex3NavData data;
+      strm >> head;
+      map<string, TimeSystemCorrection>::const_iterator it;
+      for(it = head.mapTimeCorr.begin(); it != head.mapTimeCorr.end(); ++it)
+         store.addTimeCorr(it->second);
+      unsigned n(0), nmarked(0);
+      while(strm >> data)
+      {
+         if(n++ % 3 == 1)
+         {
+            data.health = 1;
+            nmarked++;
+         }
+         store.addEphemeris(data);
+      }
+      return nmarked;
+   }
+
+      /// Test that the default getXvts() reports the same status as
+      /// the stores' overrides, including NotFound and Unhealthy.
+   unsigned statusTest()
+   {
+      TUDEF("XvtStore", "getXvts");
+
+      unsigned nunhealthy(0);
+      string files[] = { inputMixedNav, inputGPSNav };
+      for(int f=0; f<2; f++)
+      {
+         Rinex3EphemerisStore store;
+         TUASSERT(loadMarked(store, files[f]) > 0);
+
+         std::set<SatID> satset(store.getIndexSet());
+         vector<SatID> sats(satset.begin(), satset.end());
+         sats.push_back(SatID(32, SatID::systemGPS));
+
+         CommonTime t0(store.getInitialTime()), t1(store.getFinalTime());
+         t0.setTimeSystem(TimeSystem::GPS);
+         t1.setTimeSystem(TimeSystem::GPS);
+         for(int healthy=0; healthy<2; healthy++)
+         {
+            store.setOnlyHealthyFlag(healthy == 1);
+            unsigned n = compareStatus(testFramework, store, sats,
+                                       t0 - 7200., t1 + 7200., 900.);
+            if(healthy == 0)
+            {
+               TUASSERTE(unsigned, 0, n);
+            }
+            nunhealthy += n;
+         }
+      }
+      TUASSERT(nunhealthy > 0);
+
+      SP3EphemerisStore sp3;
+      sp3.loadFile(inputSP3);
+      vector<SatID> sats(sp3.getSatList());
+      sats.push_back(SatID(33, SatID::systemGPS));
+      CommonTime t0(sp3.getInitialTime()), t1(sp3.getFinalTime());
+      compareStatus(testFramework, sp3, sats, t0 - 3600., t1 + 3600., 450.);
+
+      TURETURN();
+   }
+
+private:
+   std::string inputMixedNav;
+   std::string inputGPSNav;
+   std::string inputSP3;
 };
 
 
 int main() //Main function to initialize and run all tests above
 {
-   return 0; //Return the total number of errors
+   unsigned errorTotal = 0;
+   XvtStore_T testClass;
+   testClass.init();
+
+   errorTotal += testClass.rinex3Test();
+   errorTotal += testClass.sp3Test();
+   errorTotal += testClass.statusTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; //Return the total number of errors
 }
@@ -0,0 +1,210 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <iostream>
+
+#include "SmallMatrix.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+
+   // A symmetric positive definite 4x4, a right hand side, and the solution
+static double a44[16] = {2,-1,0,0,-1,2,-1,0,0,-1,2,-1,0,0,-1,2};
+static double b4[4] = {5,1,-2,6};
+static double bs4[4] = {5,5,4,5};
+
+unsigned conversionTest()
+{
+   TUDEF("SmallMatrix", "conversion");
+   double eps = DBL_EPSILON;
+   gpstk::Matrix<double> A(4,4);
+   A = a44;
+
+   gpstk::SmallMatrix<double,4,4> S(A);
+   TUASSERTE(size_t, 4, S.rows());
+   TUASSERTE(size_t, 4, S.cols());
+   TUASSERTE(size_t, 16, S.size());
+   TUASSERTFE(-1.0, S(1,0));
+   gpstk::Matrix<double> B(S);
+   TUASSERTFEPS(A, B, eps);
+
+   gpstk::SmallMatrix<double,3,4> W;
+   try { W = A; TUFAIL("Assignment of a 4x4 to a 3x4 did not throw"); }
+   catch(gpstk::MatrixException& e) { TUPASS("Assignment of a 4x4 to a 3x4"); }
+
+   gpstk::Vector<double> b(4);
+   b = b4;
+   gpstk::SmallVector<double,4> v(b);
+   gpstk::Vector<double> c(v);
+   TUASSERTFEPS(b, c, eps);
+   gpstk::SmallVector<double,3> w;
+   try { w = b; TUFAIL("Assignment of a 4-vector to a 3-vector did not throw"); }
+   catch(gpstk::VectorException& e) { TUPASS("Assignment of a 4-vector to a 3-vector"); }
+
+   TURETURN();
+}
+
+unsigned operatorTest()
+{
+   TUDEF("SmallMatrix", "operator*");
+   double eps = 10*DBL_EPSILON;
+   double a23[6] = {1,2,3,4,5,6};
+   double a32[6] = {-1,0.5,2,3,0.25,-4};
+   gpstk::Matrix<double> A(2,3), B(3,2);
+   A = a23;
+   B = a32;
+   gpstk::SmallMatrix<double,2,3> SA(A);
+   gpstk::SmallMatrix<double,3,2> SB(B);
+
+   gpstk::Matrix<double> AB(SA*SB);
+   TUASSERTFEPS(A*B, AB, eps);
+   gpstk::Matrix<double> AT(transpose(SA));
+   TUASSERTFEPS(transpose(A), AT, eps);
+
+   gpstk::Vector<double> x(3);
+   x(0) = 1.5; x(1) = -2; x(2) = 0.5;
+   gpstk::SmallVector<double,3> sx(x);
+   gpstk::Vector<double> Ax(SA*sx);
+   TUASSERTFEPS(A*x, Ax, eps);
+
+   TURETURN();
+}
+
+unsigned choleskyTest()
+{
+   TUDEF("SmallCholesky", "operator()");
+   double eps = 20*DBL_EPSILON;
+   gpstk::Matrix<double> A(4,4);
+   A = a44;
+   gpstk::SmallMatrix<double,4,4> SA(A);
+
+   gpstk::SmallCholesky<double,4> C;
+   C(SA);
+   gpstk::Matrix<double> L(C.L);
+   TUASSERTFEPS(A, L*transpose(L), eps);
+
+   TUCSM("backSub");
+   gpstk::Vector<double> b(4), bs(4);
+   b = b4;
+   bs = bs4;
+   gpstk::SmallVector<double,4> x(b);
+   C.backSub(x);
+   gpstk::Vector<double> X(x);
+   TUASSERTFEPS(bs, X, eps);
+
+   TUCSM("inverse");
+   gpstk::Matrix<double> Ainv(C.inverse());
+   TUASSERTFEPS(inverseLUD(A), Ainv, eps);
+
+   TUCSM("operator()");
+   gpstk::SmallMatrix<double,4,4> Z(1.0);
+   try { C(Z); TUFAIL("Singular matrix did not throw"); }
+   catch(gpstk::SingularMatrixException& e) { TUPASS("Singular matrix"); }
+
+      // A + x*xT, updated and downdated
+   TUCSM("update");
+   gpstk::Vector<double> v(4);
+   v(0) = 0.5; v(1) = -1; v(2) = 0.25; v(3) = 2;
+   gpstk::SmallVector<double,4> sv(v);
+   gpstk::Matrix<double> Axx(A + outer(v,v));
+   C(SA);
+   C.update(sv);
+   L = C.L;
+   TUASSERTFEPS(Axx, L*transpose(L), eps);
+
+   TUCSM("downdate");
+   C.downdate(sv);
+   L = C.L;
+   TUASSERTFEPS(A, L*transpose(L), eps);
+   gpstk::SmallCholesky<double,4> D;
+   D(SA);
+   gpstk::Matrix<double> LD(D.L);
+   TUASSERTFEPS(LD, L, eps);
+   for(size_t i=0; i<4; i++) sv(i) = 2.0;
+   try { C.downdate(sv); TUFAIL("Downdate to a singular matrix did not throw"); }
+   catch(gpstk::SingularMatrixException& e) { TUPASS("Downdate to a singular matrix"); }
+
+   TURETURN();
+}
+
+unsigned ldltTest()
+{
+   TUDEF("SmallLDLT", "operator()");
+   double eps = 20*DBL_EPSILON;
+   gpstk::Matrix<double> A(4,4);
+   A = a44;
+   gpstk::SmallMatrix<double,4,4> SA(A);
+
+   gpstk::SmallLDLT<double,4> C;
+   C(SA);
+   gpstk::Matrix<double> L(C.L), D(4,4,0.0);
+   for(size_t i=0; i<4; i++) D(i,i) = C.D(i);
+   TUASSERTFEPS(A, L*D*transpose(L), eps);
+
+   TUCSM("backSub");
+   gpstk::Vector<double> b(4), bs(4);
+   b = b4;
+   bs = bs4;
+   gpstk::SmallVector<double,4> x(b);
+   C.backSub(x);
+   gpstk::Vector<double> X(x);
+   TUASSERTFEPS(bs, X, eps);
+
+   TUCSM("inverse");
+   gpstk::Matrix<double> Ainv(C.inverse());
+   TUASSERTFEPS(inverseLUD(A), Ainv, eps);
+
+   TUCSM("operator()");
+   gpstk::SmallMatrix<double,4,4> Z(1.0);
+   try { C(Z); TUFAIL("Singular matrix did not throw"); }
+   catch(gpstk::SingularMatrixException& e) { TUPASS("Singular matrix"); }
+
+   TURETURN();
+}
+
+int main()
+{
+   unsigned errorTotal = 0;
+
+   errorTotal += conversionTest();
+   errorTotal += operatorTest();
+   errorTotal += choleskyTest();
+   errorTotal += ldltTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -36,6 +36,7 @@
 
 #include "TestUtil.hpp"
 #include "NavFilterMgr.hpp"
+#include "ShardedNavFilterMgr.hpp"
 #include "LNavFilterData.hpp"
 #include "LNavParityFilter.hpp"
 #include "LNavCookFilter.hpp"
@@ -46,6 +47,7 @@
 #include "NavOrderFilter.hpp"
 #include "CommonTime.hpp"
 #include "TimeString.hpp"
+#include <thread>
 
 using namespace std;
 using namespace gpstk;
@@ -68,6 +70,9 @@ unsigned long expLNavEphs = 5210;
 
 typedef std::set<gpstk::CommonTime> TimeSet;
 
+// a list that is destroyed at exit after the free list of NavPoolAllocator
+NavFilter::NavMsgList exitList;
+
 // define some classes for exercising NavFilterMgr
 class BunkFilterData : public NavFilterKey
 {
@@ -129,6 +134,15 @@ public:
    NavMsgList cache;
 };
 
+// add up the messages rejected by the filters in a rejected set
+void countRejects(const NavFilterMgr::FilterSet& rejected,
+                   unsigned long& count)
+{
+   NavFilterMgr::FilterSet::const_iterator fsi;
+   for (fsi = rejected.begin(); fsi != rejected.end(); fsi++)
+      count += (*fsi)->rejected.size();
+}
+
 class NavFilterMgr_T
 {
 public:
@@ -166,6 +180,15 @@ public:
    unsigned testBunk1();
       /// test a filter with behavior like multiple input epochs
    unsigned testBunk2();
+      /// Test that ShardedNavFilterMgr gives the same results
+   unsigned testSharded();
+      /// Test NavPoolAllocator
+   unsigned testPoolAllocator();
+      /// Test NavFilterKeyPool
+   unsigned testKeyPool();
+      /** Split the LNAV data into lists of messages with the same
+       * time stamp. */
+   vector<NavFilter::NavMsgList> epochLists();
 
    string inputFileLNAV;
    string inputFileBunk;
@@ -795,6 +818,241 @@ testBunk2()
 }
 
 
+vector<NavFilter::NavMsgList> NavFilterMgr_T ::
+epochLists()
+{
+   vector<NavFilter::NavMsgList> rv;
+   for (unsigned i = 0; i < dataIdxLNAV; i++)
+   {
+      if (rv.empty() || (rv.back().back()->timeStamp != dataLNAV[i].timeStamp))
+         rv.push_back(NavFilter::NavMsgList());
+      rv.back().push_back(&dataLNAV[i]);
+   }
+   return rv;
+}
+
+
+unsigned NavFilterMgr_T ::
+testSharded()
+{
+   TUDEF("ShardedNavFilterMgr", "validate");
+
+   vector<NavFilter::NavMsgList> epochs(epochLists());
+   NavFilter::NavMsgList l;
+   NavFilter::NavMsgList::iterator nmli;
+
+      // same filters as testLNavCombined
+   ShardedNavFilterMgr smgr(4, 3);
+   smgr.addFilter([]() { return new LNavParityFilter; });
+   smgr.addFilter([]() { return new LNavEmptyFilter; });
+   smgr.addFilter([]() { return new LNavTLMHOWFilter; });
+   TUASSERTE(unsigned, 4, smgr.numShards());
+   TUASSERTE(unsigned, 1, smgr.processingDepth());
+   unsigned long acceptCount = 0, rejectCount = 0;
+   bool ordered = true;
+   for (unsigned e = 0; e < epochs.size(); e++)
+   {
+      l = smgr.validate(epochs[e]);
+      acceptCount += l.size();
+      countRejects(smgr.rejected, rejectCount);
+      for (nmli = l.begin(); nmli != l.end(); nmli++)
+         ordered &= ((*nmli)->timeStamp == epochs[e].front()->timeStamp);
+   }
+   TUASSERT(ordered);
+   TUASSERTE(unsigned long, expLNavCombined, rejectCount);
+   TUASSERTE(unsigned long, dataIdxLNAV - expLNavCombined, acceptCount);
+   testFramework.changeSourceMethod("finalize");
+   TUASSERT(smgr.finalize().empty());
+
+      // cross-source voting must see every source of a PRN together
+   testFramework.changeSourceMethod("validate");
+   NavFilterMgr mgr;
+   LNavCrossSourceFilter filtXSrc;
+   mgr.addFilter(&filtXSrc);
+   ShardedNavFilterMgr xmgr(5, 2);
+   xmgr.addFilter([]() { return new LNavCrossSourceFilter; });
+   xmgr.addFilter([]() { return new LNavEmptyFilter; });
+   LNavEmptyFilter filtEmpty;
+   mgr.addFilter(&filtEmpty);
+   set<NavFilterKey*> expAccepted, gotAccepted;
+   unsigned long expRejected = 0, gotRejected = 0;
+   for (unsigned e = 0; e < epochs.size(); e++)
+   {
+      l = mgr.validate(epochs[e]);
+      expAccepted.insert(l.begin(), l.end());
+      countRejects(mgr.rejected, expRejected);
+      l = xmgr.validate(epochs[e]);
+      gotAccepted.insert(l.begin(), l.end());
+      countRejects(xmgr.rejected, gotRejected);
+   }
+   l = mgr.finalize();
+   expAccepted.insert(l.begin(), l.end());
+   l = xmgr.finalize();
+   gotAccepted.insert(l.begin(), l.end());
+   TUASSERT(!expAccepted.empty());
+   TUASSERT(expAccepted == gotAccepted);
+   TUASSERTE(unsigned long, expRejected, gotRejected);
+
+      // The order filter compares messages with the newest of all
+      // PRNs, so it runs after the shards, on their merged output.
+      // Epochs are given out of order so that it has something to
+      // reorder and, with a depth of 1, something to reject.
+   NavFilterMgr omgr;
+   LNavParityFilter filtParity;
+   NavOrderFilter filtOrder(1);
+   LNavEmptyFilter filtEmpty2;
+   omgr.addFilter(&filtParity);
+   omgr.addFilter(&filtOrder);
+   omgr.addFilter(&filtEmpty2);
+   ShardedNavFilterMgr somgr(4, 3);
+   somgr.addFilter([]() { return new LNavParityFilter; });
+   somgr.addFilter([]() { return new NavOrderFilter(1); });
+   somgr.addFilter([]() { return new LNavEmptyFilter; });
+   TUASSERTE(unsigned, omgr.processingDepth(), somgr.processingDepth());
+   static const unsigned shuffle[] = { 0, 3, 1, 4, 2 };
+   NavFilter::NavMsgList expOrdered, gotOrdered;
+   unsigned long orderRejected = 0;
+   expRejected = gotRejected = 0;
+   for (unsigned e = 0; e < epochs.size(); e++)
+   {
+         // leave a partial block at the end in order
+      unsigned se = e;
+      if (e - e % 5 + 5 <= epochs.size())
+         se = e - e % 5 + shuffle[e % 5];
+      l = omgr.validate(epochs[se]);
+      expOrdered.splice(expOrdered.end(), l);
+      countRejects(omgr.rejected, expRejected);
+      orderRejected += filtOrder.rejected.size();
+      l = somgr.validate(epochs[se]);
+      gotOrdered.splice(gotOrdered.end(), l);
+      countRejects(somgr.rejected, gotRejected);
+   }
+   testFramework.changeSourceMethod("finalize");
+   l = omgr.finalize();
+   expOrdered.splice(expOrdered.end(), l);
+   l = somgr.finalize();
+   gotOrdered.splice(gotOrdered.end(), l);
+   TUASSERT(!expOrdered.empty());
+   TUASSERT(expOrdered == gotOrdered);
+   TUASSERT(orderRejected > 0);
+   TUASSERTE(unsigned long, expRejected, gotRejected);
+
+      // each filter instance belongs to one shard
+   testFramework.changeSourceMethod("getFilter");
+   TUASSERT(xmgr.getFilter(0,0) != xmgr.getFilter(1,0));
+   TUASSERTE(std::string, "Empty", xmgr.getFilter(4,1)->filterName());
+   try
+   {
+      xmgr.getFilter(5,0);
+      TUFAIL("getFilter did not throw for a bad shard");
+   }
+   catch (InvalidParameter&)
+   {
+      TUPASS("getFilter");
+   }
+
+      // filters must be shardable and added before validate
+   testFramework.changeSourceMethod("addFilter");
+   try
+   {
+      xmgr.addFilter([]() { return new LNavParityFilter; });
+      TUFAIL("addFilter did not throw after validate");
+   }
+   catch (InvalidRequest&)
+   {
+      TUPASS("addFilter");
+   }
+      // filters from the first non-shardable one on are not sharded
+   ShardedNavFilterMgr bmgr(2);
+   bmgr.addFilter([]() { return new LNavEmptyFilter; });
+   bmgr.addFilter([]() { return new BunkFilter1; });
+   bmgr.addFilter([]() { return new LNavParityFilter; });
+   TUASSERT(bmgr.getFilter(0,0) != bmgr.getFilter(1,0));
+   TUASSERT(bmgr.getFilter(0,1) == bmgr.getFilter(1,1));
+   TUASSERT(bmgr.getFilter(0,2) == bmgr.getFilter(1,2));
+   TUASSERTE(std::string, "Parity", bmgr.getFilter(1,2)->filterName());
+
+   TURETURN();
+}
+
+
+unsigned NavFilterMgr_T ::
+testPoolAllocator()
+{
+   TUDEF("NavPoolAllocator", "allocate");
+
+      // a freed node is handed out again
+   NavPoolAllocator<double> alloc;
+   double *d1 = alloc.allocate(1);
+   alloc.deallocate(d1, 1);
+   double *d2 = alloc.allocate(1);
+   TUASSERT(d1 == d2);
+   double *darr = alloc.allocate(3);
+   darr[2] = 1.5;
+   alloc.deallocate(darr, 3);
+   alloc.deallocate(d2, 1);
+   NavPoolAllocator<int> ialloc(alloc);
+   TUASSERT(ialloc == alloc);
+
+      // lists keep working with recycled nodes
+   NavFilter::NavMsgList l1, l2;
+   for (unsigned i = 0; i < 100; i++)
+      l1.push_back(&dataLNAV[i]);
+   l2 = l1;
+   l1.clear();
+   for (unsigned i = 100; i < 150; i++)
+      l1.push_back(&dataLNAV[i]);
+   TUASSERTE(size_t, 100, l2.size());
+   TUASSERT(l2.back() == &dataLNAV[99]);
+   TUASSERT(l1.front() == &dataLNAV[100]);
+
+      // lists that outlive the free list at thread and program exit
+   testFramework.changeSourceMethod("deallocate");
+   unsigned long tlSize = 0;
+   std::thread t([this, &tlSize]()
+   {
+      static thread_local NavFilter::NavMsgList tl;
+      for (unsigned i = 0; i < 10; i++)
+         tl.push_back(&dataLNAV[i]);
+      tl.pop_front();
+      tlSize = tl.size();
+   });
+   t.join();
+   TUASSERTE(unsigned long, 9, tlSize);
+   exitList = l1;
+   TUASSERTE(size_t, 50, exitList.size());
+
+   TURETURN();
+}
+
+
+unsigned NavFilterMgr_T ::
+testKeyPool()
+{
+   TUDEF("NavFilterKeyPool", "get");
+
+   NavFilterKeyPool<LNavFilterData> pool(4);
+   TUASSERTE(size_t, 0, pool.capacity());
+   vector<LNavFilterData*> got;
+   for (unsigned i = 0; i < 6; i++)
+      got.push_back(pool.get());
+   TUASSERTE(size_t, 8, pool.capacity());
+   TUASSERTE(size_t, 6, pool.inUse());
+   set<LNavFilterData*> unique(got.begin(), got.end());
+   TUASSERTE(size_t, 6, unique.size());
+   testFramework.changeSourceMethod("put");
+   got[3]->prn = 17;
+   pool.put(got[3]);
+   TUASSERTE(size_t, 5, pool.inUse());
+   LNavFilterData *again = pool.get();
+   TUASSERT(again == got[3]);
+   TUASSERTE(uint32_t, 17, again->prn);
+   TUASSERTE(size_t, 8, pool.capacity());
+
+   TURETURN();
+}
+
+
 int main()
 {
    unsigned errorTotal = 0;
@@ -809,6 +1067,10 @@ int main()
    errorTotal += testClass.testLNavTLMHOW();
    errorTotal += testClass.testLNavEphMaker();
    errorTotal += testClass.testLNavCombined();
+      // before testProcessingDepths, which cooks the data again
+   errorTotal += testClass.testSharded();
+   errorTotal += testClass.testPoolAllocator();
+   errorTotal += testClass.testKeyPool();
    errorTotal += testClass.testProcessingDepths();
    errorTotal += testClass.testBunk1();
    errorTotal += testClass.testBunk2();
@@ -0,0 +1,410 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "TestUtil.hpp"
+#include "PRSolution.hpp"
+#include "TropModel.hpp"
+#include "SimpleTropModel.hpp"
+#include "XvtStore.hpp"
+#include "Position.hpp"
+#include "GPSEllipsoid.hpp"
+#include "GPSWeekSecond.hpp"
+#include "Matrix.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+   /// An XvtStore of satellites fixed in ECEF, with no clock.
+class FixedXvtStore : public XvtStore<SatID>
+{
+public:
+   Xvt getXvt(const SatID& id, const CommonTime& t) const
+   {
+      std::map<SatID,Triple>::const_iterator it(pos.find(id));
+      if(it == pos.end())
+      {
+         InvalidRequest e("No position for the satellite");
+         GPSTK_THROW(e);
+      }
+      Xvt xvt;
+      xvt.x = it->second;
+      xvt.health = Xvt::HealthStatus::Healthy;
+      return xvt;
+   }
+   Xvt computeXvt(const SatID& id, const CommonTime& t) const throw()
+   {
+      Xvt xvt;
+      xvt.health = Xvt::HealthStatus::Unavailable;
+      std::map<SatID,Triple>::const_iterator it(pos.find(id));
+      if(it != pos.end())
+      {
+         xvt.x = it->second;
+         xvt.health = Xvt::HealthStatus::Healthy;
+      }
+      return xvt;
+   }
+   Xvt::HealthStatus getSVHealth(const SatID& id, const CommonTime& t)
+      const throw()
+   { return computeXvt(id,t).health; }
+   void dump(std::ostream& s, short detail) const {}
+   void edit(const CommonTime& tmin, const CommonTime& tmax) {}
+   void clear(void) { pos.clear(); }
+   TimeSystem getTimeSystem(void) const { return TimeSystem::Any; }
+   CommonTime getInitialTime(void) const
+   { return CommonTime::BEGINNING_OF_TIME; }
+   CommonTime getFinalTime(void) const { return CommonTime::END_OF_TIME; }
+   bool hasVelocity(void) const { return false; }
+   bool isPresent(const SatID& id) const { return pos.count(id) > 0; }
+   std::set<SatID> getIndexSet() const
+   {
+      std::set<SatID> rv;
+      for(std::map<SatID,Triple>::const_iterator it = pos.begin();
+          it != pos.end(); it++)
+         rv.insert(it->first);
+      return rv;
+   }
+
+   std::map<SatID,Triple> pos;
+};
+
+
+class PRSolution_T
+{
+public:
+   PRSolution_T()
+         : rxClock(1234.5),
+           ttag(GPSWeekSecond(1900, 345600.0, TimeSystem::GPS))
+   {
+      rx.setGeodetic(30.2, -97.7, 200.0);
+   }
+
+      /** Build the SVP matrix for satellites at the given azimuths and
+       * elevations (degrees), 22000km from the receiver rx, with
+       * pseudoranges that include the receiver clock rxClock.  The
+       * positions are rotated back over the time of flight, so that
+       * the earth rotation correction of SimplePRSolution() brings
+       * them to the given directions. */
+   Matrix<double> makeSVP(const vector<double>& az,
+                          const vector<double>& el)
+   {
+      GPSEllipsoid ellip;
+      const double range(22.e6);
+      const double lat(rx.geodeticLatitude()*DEG_TO_RAD);
+      const double lon(rx.longitude()*DEG_TO_RAD);
+      Matrix<double> SVP(az.size(),4);
+      for(size_t i=0; i<az.size(); i++) {
+         const double a(az[i]*DEG_TO_RAD), e(el[i]*DEG_TO_RAD);
+         const double east(::cos(e)*::sin(a)), north(::cos(e)*::cos(a));
+         const double up(::sin(e));
+         double sv[3];
+         sv[0] = rx.X() + range*(-::sin(lon)*east
+                          - ::sin(lat)*::cos(lon)*north
+                          + ::cos(lat)*::cos(lon)*up);
+         sv[1] = rx.Y() + range*(::cos(lon)*east
+                          - ::sin(lat)*::sin(lon)*north
+                          + ::cos(lat)*::sin(lon)*up);
+         sv[2] = rx.Z() + range*(::cos(lat)*north + ::sin(lat)*up);
+
+            // undo the rotation, with the time of flight that
+            // SimplePRSolution() computes from the unrotated position
+         double x(sv[0]), y(sv[1]);
+         for(int iter=0; iter<3; iter++) {
+            const double rho(RSS(x-rx.X(), y-rx.Y(), sv[2]-rx.Z()));
+            const double wt(ellip.angVelocity()*rho/ellip.c());
+            x = ::cos(wt)*sv[0] - ::sin(wt)*sv[1];
+            y = ::sin(wt)*sv[0] + ::cos(wt)*sv[1];
+         }
+         SVP(i,0) = x;
+         SVP(i,1) = y;
+         SVP(i,2) = sv[2];
+         SVP(i,3) = range + rxClock;
+      }
+      return SVP;
+   }
+
+      /** Solve with SimplePRSolution() and check that the covariance
+       * is the inverseSVD() of the final information matrix, as it
+       * was before the fixed-size solver was introduced.
+       * @return the return value of SimplePRSolution() */
+   int checkSolve(TestUtil& testFramework, const vector<double>& az,
+                  const vector<double>& el)
+   {
+      Matrix<double> SVP(makeSVP(az, el));
+      vector<SatID> sats;
+      for(size_t i=0; i<az.size(); i++)
+         sats.push_back(SatID(i+1, SatID::systemGPS));
+      vector<SatID::SatelliteSystem> syss(1, SatID::systemGPS);
+      Matrix<double> invMC;
+      Vector<double> resids, slopes;
+
+      PRSolution prs;
+      prs.hasMemory = false;
+      int iret = prs.SimplePRSolution(ttag, sats, SVP, invMC, &trop,
+                                      prs.MaxNIterations,
+                                      prs.ConvergenceLimit, syss,
+                                      resids, slopes);
+      if(iret == -2)
+         return iret;
+
+      Matrix<double> PT(transpose(prs.Partials));
+      Matrix<double> ref(inverseSVD(Matrix<double>(PT*prs.Partials)));
+      TUASSERTE(size_t, ref.rows(), prs.Covariance.rows());
+      TUASSERTE(size_t, ref.cols(), prs.Covariance.cols());
+      double big(0.0), diff(0.0);
+      for(size_t i=0; i<ref.rows(); i++) {
+         for(size_t j=0; j<ref.cols(); j++) {
+            big = max(big, ::fabs(ref(i,j)));
+            diff = max(diff, ::fabs(ref(i,j) - prs.Covariance(i,j)));
+         }
+      }
+      TUASSERT(diff <= 1.e-6*big);
+      return iret;
+   }
+
+      /// SimplePRSolution() with good and degenerate geometry
+   unsigned degenerateTest()
+   {
+      TUDEF("PRSolution", "SimplePRSolution");
+
+      vector<double> az, el;
+      const double azs[] = { 10., 65., 130., 190., 250., 310., 355. };
+      const double els[] = { 75., 20., 45., 15., 60., 30., 8. };
+      az.assign(azs, azs+7);
+      el.assign(els, els+7);
+      TUASSERTE(int, 0, checkSolve(testFramework, az, el));
+
+         // satellites all (nearly) on one cone about the vertical, so
+         // that height and clock are (nearly) inseparable
+      const double dels[] = { 1., 1.e-1, 1.e-2, 1.e-3, 1.e-4, 1.e-6, 0. };
+      for(int k=0; k<7; k++) {
+         for(size_t i=0; i<el.size(); i++)
+            el[i] = 40. + (i % 2 ? dels[k] : -dels[k]);
+         checkSolve(testFramework, az, el);
+      }
+
+      TURETURN();
+   }
+
+      /** RAIMCompute() with screening of the combinations must give
+       * the same solution as without, for random geometry, noise,
+       * weights and blunders. */
+   unsigned screenTest()
+   {
+      TUDEF("PRSolution", "RAIMCompute");
+
+      std::mt19937 gen(20190917);
+      std::uniform_real_distribution<double> uni(0.0,1.0);
+      std::normal_distribution<double> gauss(0.0,1.0);
+      SimpleTropModel simple(20.0, 1013.0, 50.0);
+      Position rxPos(rx);
+      rxPos.transformTo(Position::Cartesian);
+      unsigned nrejected(0), nstage2(0);
+
+      for(int trial=0; trial<200; trial++) {
+         const int n(6 + trial % 5), nbad(trial % 3);
+         const bool weighted(trial % 2 == 1);
+         TropModel *pTrop(trial % 4 < 2 ? (TropModel*)(&trop)
+                                        : (TropModel*)(&simple));
+
+         vector<double> az(n), el(n);
+         for(int i=0; i<n; i++) {
+            az[i] = 360.0*uni(gen);
+            el[i] = 5.0 + 80.0*uni(gen);
+         }
+         Matrix<double> SVP(makeSVP(az, el));
+
+         FixedXvtStore store;
+         vector<SatID> sats;
+         vector<double> pr(n);
+         Matrix<double> invMC;
+         if(weighted) {
+            invMC.resize(n,n);
+            invMC = 0.0;
+         }
+         vector<int> bad(n);
+         for(int i=0; i<n; i++) bad[i] = i;
+         std::shuffle(bad.begin(), bad.end(), gen);
+         bad.resize(nbad);
+
+         for(int i=0; i<n; i++) {
+            SatID sat(i+1, SatID::systemGPS);
+            sats.push_back(sat);
+            store.pos[sat] = Triple(SVP(i,0), SVP(i,1), SVP(i,2));
+            const double sigma(0.5/::sin(el[i]*DEG_TO_RAD));
+            pr[i] = SVP(i,3) + sigma*gauss(gen);
+            if(pTrop == &simple) {
+               Position sv(SVP(i,0), SVP(i,1), SVP(i,2));
+               pr[i] += simple.correction(rxPos, sv, ttag);
+            }
+            if(std::find(bad.begin(), bad.end(), i) != bad.end())
+               pr[i] += (uni(gen) < 0.5 ? -1.0 : 1.0)*(20.0 + 480.0*uni(gen));
+            if(weighted)
+               invMC(i,i) = 1.0/(sigma*sigma);
+         }
+
+         PRSolution prs[2];
+         vector<SatID> used[2];
+         int iret[2];
+         for(int k=0; k<2; k++) {
+            prs[k].hasMemory = false;
+            prs[k].ScreenRAIM = (k == 0);
+               // a tight limit sometimes, to go through more stages
+            if(trial % 7 == 3) prs[k].RMSLimit = 0.5;
+            used[k] = sats;
+            vector<SatID::SatelliteSystem> syss;
+            iret[k] = prs[k].RAIMCompute(ttag, used[k], syss, pr, invMC,
+                                         &store, pTrop);
+         }
+
+         TUASSERTE(int, iret[1], iret[0]);
+         TUASSERT(prs[0].NCombos <= prs[1].NCombos);
+            // the satellites marked by the last combination, or used
+         TUASSERTE(size_t, used[1].size(), used[0].size());
+         for(size_t i=0; i<used[0].size() && i<used[1].size(); i++)
+            TUASSERTE(int, used[1][i].id, used[0][i].id);
+         TUASSERTE(size_t, prs[1].SatelliteIDs.size(),
+                   prs[0].SatelliteIDs.size());
+         if(prs[0].SatelliteIDs.size() != prs[1].SatelliteIDs.size())
+            continue;
+         int nrej(0);
+         for(size_t i=0; i<prs[0].SatelliteIDs.size(); i++) {
+            TUASSERTE(int, prs[1].SatelliteIDs[i].id,
+                      prs[0].SatelliteIDs[i].id);
+            if(prs[0].SatelliteIDs[i].id <= 0) nrej++;
+         }
+         if(nrej > 0) nrejected++;
+         if(nrej > 1) nstage2++;
+         TUASSERTFEPS(prs[1].RMSResidual, prs[0].RMSResidual, 1.e-9);
+         TUASSERTE(size_t, prs[1].Solution.size(), prs[0].Solution.size());
+         for(size_t i=0; i<prs[0].Solution.size() &&
+                        i<prs[1].Solution.size(); i++)
+            TUASSERTFEPS(prs[1].Solution(i), prs[0].Solution(i), 1.e-6);
+      }
+
+         // the later stages, where screening is done, were reached
+      TUASSERT(nrejected > 0);
+      TUASSERT(nstage2 > 0);
+
+      TURETURN();
+   }
+
+      /** Two blunders in ten satellites, so that RAIMCompute() goes to
+       * the second stage; screening must skip most of the combinations
+       * of both stages and still find the same solution. */
+   unsigned screenRejectTest()
+   {
+      TUDEF("PRSolution", "RAIMCompute");
+
+      const double azs[] = { 5., 40., 80., 115., 150., 190., 225., 260.,
+                             300., 335. };
+      const double els[] = { 70., 25., 50., 12., 35., 62., 18., 44., 28.,
+                             8. };
+      vector<double> az(azs, azs+10), el(els, els+10);
+      Matrix<double> SVP(makeSVP(az, el));
+
+      FixedXvtStore store;
+      vector<SatID> sats;
+      vector<double> pr(10);
+      for(int i=0; i<10; i++) {
+         SatID sat(i+1, SatID::systemGPS);
+         sats.push_back(sat);
+         store.pos[sat] = Triple(SVP(i,0), SVP(i,1), SVP(i,2));
+         pr[i] = SVP(i,3) + 0.3*::sin(1.7*i);
+      }
+      pr[2] += 150.0;
+      pr[7] -= 80.0;
+
+      PRSolution prs[2];
+      vector<SatID> used[2];
+      int iret[2];
+      for(int k=0; k<2; k++) {
+         prs[k].hasMemory = false;
+         prs[k].ScreenRAIM = (k == 0);
+         used[k] = sats;
+         vector<SatID::SatelliteSystem> syss;
+         iret[k] = prs[k].RAIMCompute(ttag, used[k], syss, pr, Matrix<double>(),
+                                      &store, &trop);
+      }
+
+      TUASSERTE(int, 0, iret[0]);
+      TUASSERTE(int, iret[1], iret[0]);
+         // all in view, 10 leave-one-out and 45 leave-two-out
+      TUASSERTE(int, 56, prs[1].NCombos);
+      TUASSERT(prs[0].NCombos < prs[1].NCombos);
+      TUASSERTE(size_t, 10, prs[0].SatelliteIDs.size());
+      TUASSERTE(size_t, 10, prs[1].SatelliteIDs.size());
+      for(size_t i=0; i<prs[0].SatelliteIDs.size() &&
+                     i<prs[1].SatelliteIDs.size(); i++) {
+         TUASSERTE(int, prs[1].SatelliteIDs[i].id, prs[0].SatelliteIDs[i].id);
+         TUASSERTE(bool, (i == 2 || i == 7), prs[0].SatelliteIDs[i].id <= 0);
+      }
+      TUASSERTFEPS(prs[1].RMSResidual, prs[0].RMSResidual, 1.e-9);
+      for(size_t i=0; i<prs[0].Solution.size() &&
+                     i<prs[1].Solution.size(); i++)
+         TUASSERTFEPS(prs[1].Solution(i), prs[0].Solution(i), 1.e-6);
+
+      TURETURN();
+   }
+
+private:
+   Position rx;
+   double rxClock;
+   CommonTime ttag;
+   ZeroTropModel trop;
+};
+
+
+int main() // Main function to initialize and run all tests above
+{
+   unsigned errorTotal = 0;
+   PRSolution_T testClass;
+
+   errorTotal += testClass.degenerateTest();
+   errorTotal += testClass.screenTest();
+   errorTotal += testClass.screenRejectTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; // Return the total number of errors
+}
@@ -0,0 +1,241 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <iostream>
+
+#include "TimeKey.hpp"
+#include "CivilTime.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class TimeKey_T
+{
+public:
+   TimeKey_T()
+   {
+      times.push_back(CivilTime(1980, 1, 6, 0, 0, 0.0, TimeSystem::GPS));
+      times.push_back(CivilTime(1980, 1, 5, 23, 59, 59.5, TimeSystem::GPS));
+      times.push_back(CivilTime(1900, 3, 1, 12, 0, 0.000000001,
+                                TimeSystem::GPS));
+      times.push_back(CivilTime(2014, 10, 31, 1, 59, 44.0, TimeSystem::GPS));
+      times.push_back(CivilTime(2020, 2, 29, 23, 59, 59.999999999,
+                                TimeSystem::GPS));
+      times.push_back(CivilTime(2200, 7, 4, 6, 30, 15.123456789,
+                                TimeSystem::GPS));
+   }
+
+      /// Conversion to and from CommonTime.
+   unsigned conversionTest()
+   {
+      TUDEF("TimeKey", "convertToCommonTime");
+
+      TUASSERTE(long long, 0LL,
+                TimeKey(times[0]).getNanoseconds());
+      TUASSERTE(long long, -500000000LL,
+                TimeKey(times[1]).getNanoseconds());
+      TUASSERTE(TimeSystem, TimeSystem(TimeSystem::GPS),
+                TimeKey(times[0]).getTimeSystem());
+
+      for(unsigned i=0; i<times.size(); i++)
+      {
+         TimeKey key(times[i]);
+         CommonTime ct(key);
+            // CivilTime itself keeps fractional seconds only to ~1e-11 s
+         TUASSERTFEPS(0.0, ct - times[i], 0.5e-9);
+         TUASSERTE(TimeSystem, times[i].getTimeSystem(), ct.getTimeSystem());
+         TUASSERT(!key.isSaturated());
+            // round trip of the key is exact
+         TUASSERTE(long long, key.getNanoseconds(),
+                   TimeKey(key.convertToCommonTime()).getNanoseconds());
+      }
+
+         // sub-nanosecond is rounded
+      CommonTime t(times[3]);
+      t += 0.4e-9;
+      TUASSERTE(long long, TimeKey(times[3]).getNanoseconds(),
+                TimeKey(t).getNanoseconds());
+      t += 0.2e-9;
+      TUASSERTE(long long, TimeKey(times[3]).getNanoseconds()+1,
+                TimeKey(t).getNanoseconds());
+
+         // the ends of time saturate and convert back
+      TimeKey beg(CommonTime::BEGINNING_OF_TIME), end(CommonTime::END_OF_TIME);
+      TUASSERT(beg.isSaturated());
+      TUASSERT(end.isSaturated());
+      TUASSERTE(CommonTime, CommonTime::BEGINNING_OF_TIME, CommonTime(beg));
+      TUASSERTE(CommonTime, CommonTime::END_OF_TIME, CommonTime(end));
+      TUASSERT(beg < TimeKey(times[2]));
+      TUASSERT(end > TimeKey(times[5]));
+      end.addNanoseconds(-1);
+      TUASSERT(end.isSaturated());
+
+      TURETURN();
+   }
+
+      /// Comparison, arithmetic and ordering against CommonTime.
+   unsigned arithmeticTest()
+   {
+      TUDEF("TimeKey", "operator-");
+
+      for(unsigned i=0; i<times.size(); i++)
+      {
+         for(unsigned j=0; j<times.size(); j++)
+         {
+            TimeKey a(times[i]), b(times[j]);
+            TUASSERTE(bool, times[i] < times[j], a < b);
+            TUASSERTE(bool, times[i] == times[j], a == b);
+            TUASSERTE(bool, times[i] >= times[j], a >= b);
+            TUASSERTFEPS(times[i] - times[j], a - b, 1.e-6);
+         }
+      }
+
+      TimeKey key(times[3]);
+      TUASSERTE(long long, key.getNanoseconds() + 900000000000LL,
+                (key + 900.0).getNanoseconds());
+      TUASSERTE(long long, key.getNanoseconds() - 1500000LL,
+                (key - 0.0015).getNanoseconds());
+      TUASSERTFE(900.0, (key + 900.0) - key);
+      TUASSERTE(CommonTime, times[3] + 900.0, CommonTime(key + 900.0));
+
+         // time systems are checked when differencing, as in CommonTime
+      CommonTime utc(times[3]), any(times[3]);
+      utc.setTimeSystem(TimeSystem::UTC);
+      any.setTimeSystem(TimeSystem::Any);
+      try
+      {
+         TimeKey(utc) - key;
+         TUFAIL("Expected InvalidRequest for different time systems");
+      }
+      catch(InvalidRequest&)
+      {
+         TUPASS("InvalidRequest for different time systems");
+      }
+      TUASSERTFE(0.0, TimeKey(any) - key);
+
+         // and when comparing
+      TUASSERT(TimeKey(utc) != key);
+      TUASSERT(TimeKey(any) == key);
+      TUASSERT(!(TimeKey(any) < key));
+      try
+      {
+         TimeKey(utc) < key;
+         TUFAIL("Expected InvalidRequest for different time systems");
+      }
+      catch(InvalidRequest&)
+      {
+         TUPASS("InvalidRequest for different time systems");
+      }
+
+      TURETURN();
+   }
+
+      /// TimeKey as the key of ordered and hashed containers.
+   unsigned containerTest()
+   {
+      TUDEF("TimeKey", "hash");
+
+      map<TimeKey, int> tmap;
+      unordered_map<TimeKey, int> hmap;
+      for(unsigned i=0; i<times.size(); i++)
+      {
+         tmap[times[i]] = i;
+         hmap[times[i]] = i;
+      }
+      TUASSERTE(size_t, times.size(), tmap.size());
+      TUASSERTE(size_t, times.size(), hmap.size());
+
+         // searched with CommonTime, keys usable as CommonTime
+      for(unsigned i=0; i<times.size(); i++)
+      {
+         TUASSERTE(int, i, tmap.find(times[i])->second);
+         TUASSERTE(int, i, hmap.find(times[i])->second);
+         TUASSERTE(size_t, TimeKey(times[i]).hash(),
+                   hash<TimeKey>()(TimeKey(times[i])));
+      }
+      CommonTime prev(CommonTime::BEGINNING_OF_TIME);
+      prev.setTimeSystem(TimeSystem::GPS);
+      for(map<TimeKey, int>::const_iterator it = tmap.begin();
+          it != tmap.end(); ++it)
+      {
+         TUASSERT(prev < it->first);
+         prev = it->first;
+      }
+      map<TimeKey, int>::const_iterator it = tmap.lower_bound(times[3]+1.0);
+      TUASSERTE(int, 4, it->second);
+
+         // searching in another time system fails as with CommonTime
+      CommonTime utc(times[3]), any(times[3]);
+      utc.setTimeSystem(TimeSystem::UTC);
+      any.setTimeSystem(TimeSystem::Any);
+      TUASSERTE(int, 3, tmap.find(any)->second);
+      TUASSERTE(int, 3, hmap.find(any)->second);
+      TUASSERT(hmap.find(utc) == hmap.end());
+      try
+      {
+         tmap.find(utc);
+         TUFAIL("Expected InvalidRequest for different time systems");
+      }
+      catch(InvalidRequest&)
+      {
+         TUPASS("InvalidRequest for different time systems");
+      }
+
+      TURETURN();
+   }
+
+private:
+   vector<CommonTime> times;
+};
+
+
+int main() // Main function to initialize and run all tests above
+{
+   unsigned errorTotal = 0;
+   TimeKey_T testClass;
+
+   errorTotal += testClass.conversionTest();
+   errorTotal += testClass.arithmeticTest();
+   errorTotal += testClass.containerTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; // Return the total number of errors
+}
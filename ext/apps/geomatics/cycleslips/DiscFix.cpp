@@ -76,6 +76,7 @@
 #include "SatPass.hpp"
 #include "SatPassUtilities.hpp"
 #include "DiscCorr.hpp"
+#include "ParallelFor.hpp"
 
 using namespace std;
 using namespace gpstk;
@@ -122,6 +123,7 @@ typedef struct configuration {
    bool smoothPR,smoothPH,smooth;
    int debug;
    bool verbose,DChelp;
+   int threads;            // number of threads for the passes, 0 for all cores
    vector<string> DCcmds;        // all the --DC... on the cmd line
       // estimate dt from data
    double estdt[9];
@@ -154,6 +156,14 @@ typedef struct configuration {
    GDCconfiguration GDConfig;       // the discontinuity corrector configuration
 } DFConfig;
 
+// results of processing one pass, kept so that the output is written in pass order
+typedef struct passResult {
+   int iret;
+   string msg;
+   vector<string> EditCmds;
+   ostringstream debug;             // GDC debug output for this pass
+} PassResult;
+
 // declare (one only) global configuration object
 DFConfig cfg;
 
@@ -310,14 +320,44 @@ int main(int argc, char **argv)
          cfg.GDConfig.DisplayParameterUsage(LOGstrm,(cfg.DChelp && cfg.verbose));
          LOG(INFO) << "";
 
-         // -------------------------------- call the GDC, output results and smooth
+         // -------------------------------- call the GDC
+         // The passes are independent, and are processed on cfg.threads threads.
+         // Each keeps its results and GDC debug output, which are written below
+         // in pass order, so the output does not depend on the number of threads.
+         // Anything that writes to the LOG is done in that loop too: smooth(),
+         // and, at DEBUG, the GDC of Glonass passes, which logs the search for
+         // the frequency channel.
+         vector<PassResult> results(cfg.SPList.size());
+         auto correct = [&](size_t n)
+         {
+            PassResult& res(results[n]);
+            GDCconfiguration gdconfig(cfg.GDConfig);
+            gdconfig.setDebugStream(res.debug);
+            res.iret = DiscontinuityCorrector(cfg.SPList[n], gdconfig,
+                                              res.EditCmds, res.msg, -99, n+1);
+         };
+         auto logsGDC = [&](size_t n)
+         {
+            return (LOGlevel >= ConfigureLOG::Level("DEBUG") &&
+                    cfg.SPList[n].getSat().system == SatID::systemGlonass);
+         };
+         parallelFor(cfg.SPList.size(), cfg.threads, [&](size_t n)
+         {
+            if(!logsGDC(n)) correct(n);
+         });
+
+         // -------------------------------- output results
          for(npass=0; npass<cfg.SPList.size(); npass++) {
+            PassResult& res(results[npass]);
 
             LOG(INFO) << "Proc " << setw(2) << npass+1 << " " << cfg.SPList[npass];
+            if(logsGDC(npass)) correct(npass);
             //cfg.SPList[npass].dump(*pLOGstrm,"RAW");      // temp
+            cfg.oflog << res.debug.str();
 
-            msg = "";
-            iret=DiscontinuityCorrector(cfg.SPList[npass],cfg.GDConfig,EditCmds,msg);
+            iret = res.iret;
+            msg = res.msg;
+            EditCmds = res.EditCmds;
             if(iret != 0) {
                cfg.SPList[npass].status() = -1;         // failed
                LOG(ERROR) << "GDC failed (" << iret << " "
@@ -826,6 +866,7 @@ try {
    cfg.smoothPR = false;
    cfg.smoothPH = false;
    cfg.smooth = false;
+   cfg.threads = 1;
 
    for(i=0; i<9; i++) cfg.ndt[i]=-1;
 
@@ -914,6 +955,9 @@ try {
             "Set DC parameter <param> to <value>");
    opts.Add(0, "DChelp", "", false, false, &cfg.DChelp, "",
             "Print list of DC parameters (all if -v) and their defaults, then quit");
+   opts.Add(0, "threads", "n", false, false, &cfg.threads, "",
+            "Process the passes on n threads, 0 for one per core ("
+               + asString(cfg.threads) + ")");
 
    opts.Add(0, "log", "file", false, false, &cfg.LogFile, "# Output:",
             "Output log file name (" + cfg.LogFile + ")");
@@ -0,0 +1,144 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file bench_nutation.cpp Compare class NutationSeries with the scalar series
+/// of class EarthOrientation, and time both.
+/// Usage: bench_nutation [number of epochs (default 20000)]
+
+// system includes
+#include <string>
+#include <vector>
+#include <ctime>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+// gpstk
+#include "Exception.hpp"
+// geomatics
+#include "EarthOrientation.hpp"
+#include "NutationSeries.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+//------------------------------------------------------------------------------------
+static const string benchVersion("1.0 10/17/26");
+
+// required agreement, radians
+static const double TOLERANCE(1.e-12);
+
+//------------------------------------------------------------------------------------
+// Print max difference and timing of one series; return true if within tolerance.
+static bool report(const string& label, double maxdiff,
+                   double tscalar, double tbatch, int n)
+{
+   bool ok(maxdiff <= TOLERANCE);
+   cout << setw(18) << left << label << right
+        << " max diff " << scientific << setprecision(2) << maxdiff << " rad"
+        << fixed << setprecision(3)
+        << "  scalar " << setw(8) << 1.e6*tscalar/n << " us"
+        << "  batch " << setw(8) << 1.e6*tbatch/n << " us"
+        << "  speedup " << setprecision(1) << setw(5) << tscalar/tbatch
+        << (ok ? "" : "  FAILED") << endl;
+   return ok;
+}
+
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+try {
+   int i, n(20000);
+   if(argc > 1) n = atoi(argv[1]);
+   if(n < 1) { cerr << "Usage: bench_nutation [number of epochs]" << endl; return 1; }
+   cout << "bench_nutation version " << benchVersion << ", " << n << " epochs"
+        << endl;
+
+   // epochs spread over 1980-2040, in Julian centuries from J2000
+   vector<double> T(n);
+   for(i=0; i<n; i++) T[i] = -0.2 + 0.6*double(i)/double(n);
+
+   bool ok(true);
+   clock_t t0;
+   double ts,tb,maxdiff;
+   vector<double> a(n),b(n),c(n),d(n);
+
+   // nutation angles, IERS 2003 and 2010
+   for(int which=2003; which<=2010; which+=7) {
+      t0 = clock();
+      for(i=0; i<n; i++) {
+         if(which == 2003) EarthOrientation::NutationAngles2003(T[i],a[i],b[i]);
+         else              EarthOrientation::NutationAngles2010(T[i],a[i],b[i]);
+      }
+      ts = double(clock()-t0)/CLOCKS_PER_SEC;
+
+      t0 = clock();
+      if(which == 2003) NutationSeries::NutationAngles2003(T,c,d);
+      else              NutationSeries::NutationAngles2010(T,c,d);
+      tb = double(clock()-t0)/CLOCKS_PER_SEC;
+
+      for(maxdiff=0.0,i=0; i<n; i++) {
+         maxdiff = max(maxdiff, ::fabs(a[i]-c[i]));
+         maxdiff = max(maxdiff, ::fabs(b[i]-d[i]));
+      }
+      ok &= report(which == 2003 ? "NutationAngles2003" : "NutationAngles2010",
+                   maxdiff, ts, tb, n);
+   }
+
+   // CIP coordinates X,Y
+   t0 = clock();
+   for(i=0; i<n; i++) {
+      double t(T[i]);
+      EarthOrientation::XYCIO(t,a[i],b[i]);
+   }
+   ts = double(clock()-t0)/CLOCKS_PER_SEC;
+
+   t0 = clock();
+   NutationSeries::XYCIO(T,c,d);
+   tb = double(clock()-t0)/CLOCKS_PER_SEC;
+
+   for(maxdiff=0.0,i=0; i<n; i++) {
+      maxdiff = max(maxdiff, ::fabs(a[i]-c[i]));
+      maxdiff = max(maxdiff, ::fabs(b[i]-d[i]));
+   }
+   ok &= report("XYCIO", maxdiff, ts, tb, n);
+
+   return (ok ? 0 : 1);
+}
+catch(Exception& e) { cerr << "Exception: " << e; }
+catch (...) { cerr << "Unknown exception.  Abort." << endl; }
+   return 1;
+}   // end main()
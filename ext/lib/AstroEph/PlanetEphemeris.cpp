@@ -662,6 +662,13 @@ namespace gpstk
 
          readBinaryHeader(filename);
          iret = readBinaryData(false);    // false: don't store data in map
+
+         // from here on, records are read from the mapped file, not the stream
+         istrm.clear();
+         istrm.close();
+         records.close();
+         if(iret == 0) records.open(filename, Ncoeff);
+
          if(iret == 0) 
          {
             // EphemerisNumber == -1 means the header has not been read
@@ -691,82 +698,129 @@ namespace gpstk
                                       PlanetEphemeris::Planet center,
                                       double PV[6],
                                       bool kilometers) 
-      throw(Exception)
+      const throw(Exception)
    {
       try 
       {
-         int iret,i;
+         // trivial; return
+         if(target == center)
+         {
+            for(int i=0; i<6; i++) PV[i] = 0.0;
+            return 0;
+         }
 
-         // initialize
-         for(i=0; i<6; i++) PV[i] = 0.0;
+         return computeState(tt, &target, 1, center, PV, kilometers);
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+      catch(std::exception& e) { Exception E("std except: "+string(e.what())); GPSTK_THROW(E); }
+      catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
 
-         // trivial; return
-         if(target == center) return 0;
+   }  // End of method 'PlanetEphemeris::computeState()'
+
+
+   int PlanetEphemeris::computeState( double tt,
+                                      const PlanetEphemeris::Planet targets[],
+                                      int n,
+                                      PlanetEphemeris::Planet center,
+                                      double PV[],
+                                      bool kilometers) 
+      const throw(Exception)
+   {
+      try 
+      {
+         int iret,i,k;
+
+         // initialize
+         for(i=0; i<6*n; i++) PV[i] = 0.0;
 
          // get the right record from the file
-         iret = seekToJD(tt);
+         BinaryRecordCache::Record rec;
+         iret = seekToJD(tt, rec);
          if(iret) return iret;
+         const vector<double>& coefficients(*rec);
+
+         // states of the bodies, computed as needed, shared by all targets
+         double states[LIBRATIONS+1][6];
+         bool have[LIBRATIONS+1];
+         for(i=0; i<=LIBRATIONS; i++) have[i] = false;
+
+         map<string,double>::const_iterator cit;
+         double EMRAT = ((cit = constants.find("EMRAT")) != constants.end() ?
+                         cit->second : 0.0);
+         double AU = ((cit = constants.find("AU")) != constants.end() ?
+                      cit->second : 0.0);
 
-         // compute Nutations or Librations
-         if(target == Nutations || target == Librations) 
+         for(k=0; k<n; k++)
          {
-            computeState(tt, target==Nutations ? NUTATIONS : LIBRATIONS, PV);
-            return 0;
-         }
+            const Planet target(targets[k]);
+            double *pv = PV + 6*k;
+
+            // trivial; leave zero
+            if(target == center) continue;
+
+            // compute Nutations or Librations
+            if(target == Nutations || target == Librations) 
+            {
+               const double *ps = bodyState(tt, coefficients,
+                        target==Nutations ? NUTATIONS : LIBRATIONS, states, have);
+               for(i=0; i<6; i++) pv[i] = ps[i];
+               continue;
+            }
 
-         // define computeID's for target and center
-         computeID TARGET = NONE, CENTER = NONE;
+            // define computeID's for target and center
+            computeID TARGET = NONE, CENTER = NONE;
 
-         if(target <= Sun)                        TARGET = computeID(target-1);
-         else if(target == SolarSystemBarycenter) TARGET = NONE;
-         else if(target == EarthMoonBarycenter)   TARGET = EMBARY;
-         // (Nutations and Librations are done above)
-         if(center <= Sun)                        CENTER = computeID(center-1);
-         else if(center == SolarSystemBarycenter) CENTER = NONE;
-         else if(center == EarthMoonBarycenter)   CENTER = EMBARY;
+            if(target <= Sun)                        TARGET = computeID(target-1);
+            else if(target == SolarSystemBarycenter) TARGET = NONE;
+            else if(target == EarthMoonBarycenter)   TARGET = EMBARY;
+            // (Nutations and Librations are done above)
+            if(center <= Sun)                        CENTER = computeID(center-1);
+            else if(center == SolarSystemBarycenter) CENTER = NONE;
+            else if(center == EarthMoonBarycenter)   CENTER = EMBARY;
 
-         // Earth and Moon need special treatment
-         double PVMOON[6], PVEMBARY[6], Eratio, Mratio=0.0;
+            // Earth and Moon need special treatment
+            const double *PVMOON = 0, *PVEMBARY = 0;
+            double Eratio = 0.0, Mratio = 0.0;
 
-         // special cases of Earth AND Moon: Moon result is always geocentric
-         if(target == Earth && center == Moon)    TARGET = NONE;
-         if(center == Earth && target == Moon)    CENTER = NONE;
+            // special cases of Earth AND Moon: Moon result is always geocentric
+            if(target == Earth && center == Moon)    TARGET = NONE;
+            if(center == Earth && target == Moon)    CENTER = NONE;
 
-         // special cases of Earth OR Moon, but not both:
-         if((target == Earth && center != Moon) || (center == Earth && target != Moon)) 
-         {
-            Eratio = 1.0/(1.0 + constants["EMRAT"]);
-            computeState(tt, MOON, PVMOON);
-         }
-         if((target == Moon && center != Earth) || (center == Moon && target != Earth)) 
-         {
-            Mratio = constants["EMRAT"]/(1.0 + constants["EMRAT"]);
-            computeState(tt, EMBARY, PVEMBARY);
-         }
+            // special cases of Earth OR Moon, but not both:
+            if((target == Earth && center != Moon) || (center == Earth && target != Moon)) 
+            {
+               Eratio = 1.0/(1.0 + EMRAT);
+               PVMOON = bodyState(tt, coefficients, MOON, states, have);
+            }
+            if((target == Moon && center != Earth) || (center == Moon && target != Earth)) 
+            {
+               Mratio = EMRAT/(1.0 + EMRAT);
+               PVEMBARY = bodyState(tt, coefficients, EMBARY, states, have);
+            }
 
-         // compute states for target and center
-         double PVTARGET[6] = {0.0}, PVCENTER[6] = {0.0};
-         computeState(tt, TARGET, PVTARGET);
-         computeState(tt, CENTER, PVCENTER);
-
-         // handle the Earth/Moon special cases
-         // convert from E-M barycenter to Earth
-         if(target == Earth && center != Moon)
-            for(i=0; i<6; i++) PVTARGET[i] -= PVMOON[i]*Eratio;
-         if(center == Earth && target != Moon)
-            for(i=0; i<6; i++) PVCENTER[i] -= PVMOON[i]*Eratio;
-
-         if(target == Moon && center != Earth)
-            for(i=0; i<6; i++) PVTARGET[i] = PVEMBARY[i] + PVTARGET[i]*Mratio;
-         if(center == Moon && target != Earth)
-            for(i=0; i<6; i++) PVCENTER[i] = PVEMBARY[i] + PVCENTER[i]*Mratio;
-
-         // final result
-         for(i=0; i<6; i++) PV[i] = PVTARGET[i] - PVCENTER[i];
-
-         if(!kilometers) {
-            double AU = constants["AU"];
-            for(i=0; i<6; i++) PV[i] /= AU;
+            // compute states for target and center
+            double PVTARGET[6], PVCENTER[6];
+            const double *pt = bodyState(tt, coefficients, TARGET, states, have);
+            const double *pc = bodyState(tt, coefficients, CENTER, states, have);
+            for(i=0; i<6; i++) { PVTARGET[i] = pt[i]; PVCENTER[i] = pc[i]; }
+
+            // handle the Earth/Moon special cases
+            // convert from E-M barycenter to Earth
+            if(target == Earth && center != Moon)
+               for(i=0; i<6; i++) PVTARGET[i] -= PVMOON[i]*Eratio;
+            if(center == Earth && target != Moon)
+               for(i=0; i<6; i++) PVCENTER[i] -= PVMOON[i]*Eratio;
+
+            if(target == Moon && center != Earth)
+               for(i=0; i<6; i++) PVTARGET[i] = PVEMBARY[i] + PVTARGET[i]*Mratio;
+            if(center == Moon && target != Earth)
+               for(i=0; i<6; i++) PVCENTER[i] = PVEMBARY[i] + PVCENTER[i]*Mratio;
+
+            // final result
+            for(i=0; i<6; i++) pv[i] = PVTARGET[i] - PVCENTER[i];
+
+            if(!kilometers)
+               for(i=0; i<6; i++) pv[i] /= AU;
          }
 
          return 0;
@@ -975,10 +1029,6 @@ namespace gpstk
             if(save)
                store[data_vector[0]] = data_vector;
 
-            // put the first record in coefficients array
-            if(nrec == 1)
-               coefficients = data_vector;
-
             // build the positions map
             fileposMap[data_vector[0]] = filepos;
 
@@ -1047,16 +1097,15 @@ namespace gpstk
       // -3 stream is not open or not good, or EOF was found prematurely
       // -4 EphemerisNumber is not defined
       // For -3,-4 : initializeWithBinaryFile() has not been called, or reading failed.
-   int PlanetEphemeris::seekToJD(double JD) 
+   int PlanetEphemeris::seekToJD(double JD, BinaryRecordCache::Record& rec) const
       throw(Exception)
    {
       try 
       {
-         if(!istrm) return -3;
-         if(istrm.eof() || !istrm.good()) return -3;
-         if(EphemerisNumber != int(constants["DENUM"])) return -4;
-
-         if(coefficients[0] <= JD && JD <= coefficients[1]) return 0;
+         if(!records.isOpen()) return -3;
+         map<string,double>::const_iterator cit = constants.find("DENUM");
+         if(cit == constants.end() || EphemerisNumber != int(cit->second)) return -4;
+         if(fileposMap.empty()) return -1;
 
          map<double,long>::const_iterator it; // key >= input
          it = fileposMap.lower_bound(JD); // it points to first element with JD <= time
@@ -1067,12 +1116,11 @@ namespace gpstk
          if(it == fileposMap.end()        // if beyond the found record, go to previous;
             || JD < it->first) it--;   // but beware the "lower_bound found the =" case
 
-         istrm.seekg(it->second,ios_base::beg);         // get the record
-         int iret = readBinaryRecord(coefficients);
-         if(iret == -2) iret = -3;        // this means EOF during data read
-         if(iret) return iret;            // reading failed
+         rec = records.get(it->second);   // get the record
+         if(!rec || rec->size() < 2)
+            return -3;                    // this means EOF during data read
 
-         if(JD > coefficients[1])
+         if(JD > (*rec)[1])
             return -2;                    // failure: JD is after the last record, or
          // JD is in a gap between records
          return 0;
@@ -1083,11 +1131,31 @@ namespace gpstk
 
    }  // End of method 'PlanetEphemeris::seekToJD()'
 
+
+   const double *PlanetEphemeris::bodyState(double tt,
+                                            const vector<double>& coefficients,
+                                            PlanetEphemeris::computeID which,
+                                            double states[][6],
+                                            bool have[])
+      const throw(Exception)
+   {
+      static const double zero[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+      if(which == NONE) return zero;
+      if(!have[which])
+      {
+         computeState(tt, coefficients, which, states[which]);
+         have[which] = true;
+      }
+      return states[which];
+
+   }  // End of method 'PlanetEphemeris::bodyState()'
+
  
    void PlanetEphemeris::computeState(double tt, 
+                                      const vector<double>& coefficients,
                                       PlanetEphemeris::computeID which, 
                                       double PV[6])
-      throw(Exception)
+      const throw(Exception)
    {
       try {
          int i,j,i0,ncomp;
@@ -1119,30 +1187,34 @@ namespace gpstk
          // normalized time
          T = 2.0*(tt-Tbeg)/Tspan - 1.0;
 
+         // generate the Chebyshevs and their derivatives, once for all components
+         int N=c_ncoeff[which];
+         double Cbuf[32], Ubuf[32];
+         vector<double> Cvec, Uvec;
+         double *C(Cbuf), *U(Ubuf);
+         if(N > 32)
+         {
+            Cvec.resize(N); Uvec.resize(N);
+            C = &Cvec[0]; U = &Uvec[0];
+         }
+         C[0] = 1; C[1] = T;
+         U[0] = 0; U[1] = 1;
+         for(int k=2; k<N; k++) 
+         {
+            C[k] = 2*T*C[k-1] - C[k-2];
+            U[k] = 2*T*U[k-1] + 2*C[k-1] - U[k-2];
+         }
+
          // interpolate
-         unsigned int N=c_ncoeff[which];
-         vector<double> C(N,0.0);     // Chebyshev
-         vector<double> U(N,0.0);     // derivative of Chebyshev
+         const double *coef = &coefficients[0];
          for(i=0; i<ncomp; i++)      // loop over components
          {
-
-            // seed the Chebyshev recursions
-            C[0] = 1; C[1] = T; //C[2] = 2*T*T-1;
-            U[0] = 0; U[1] = 1; //U[2] = 4*T;
-
-            // generate the Chebyshevs
-            for(unsigned int k=2; k<N; k++) 
-            {
-               C[k] = 2*T*C[k-1] - C[k-2];
-               U[k] = 2*T*U[k-1] + 2*C[k-1] - U[k-2];
-            }
-
             // compute P and V
             // done above PV[i] = PV[i+3] = 0.0;
             for(j=N-1; j>-1; j--)                              // POS
-               PV[i] += coefficients[i0+j+i*N] * C[j];
+               PV[i] += coef[i0+j+i*N] * C[j];
             for(j=N-1; j>0; j--) // j>0 b/c U[0]=0             // VEL
-               PV[i+ncomp] += coefficients[i0+j+i*N] * U[j];
+               PV[i+ncomp] += coef[i0+j+i*N] * U[j];
 
             // convert velocity to 'per day'
             PV[i+ncomp] *= 2*double(c_nsets[which])/Tspan0;
@@ -52,11 +52,17 @@
 #include "Exception.hpp"
 #include "CommonTime.hpp" 
 #include "MJD.hpp"
+#include "BinaryRecordCache.hpp"
 //#include "Position.hpp"           
 
 namespace gpstk
 {
       /** This class Handle planet ephemeris from JPL.
+       *
+       * After initializeWithBinaryFile(), the binary file is memory
+       * mapped and the most recently used records are kept decoded
+       * (see setRecordCacheSize()), and the const computeState() may
+       * be called from several threads at once.
        *
        * @WARNING It's just a copy class of SolarSystem.
        */
@@ -159,7 +165,8 @@ namespace gpstk
 
          /// Open the given binary file, read the header and prepare for reading data
          /// records at random using seekToJD() and computing positions and velocities
-         /// with computeState(). Does not store the data.
+         /// with computeState(). Does not store the data; the file is memory mapped
+         /// and records are decoded as they are used.
          /// @param filename  name of binary file to be read.
          /// @return 0 success,
          ///        -3 input stream is not open or not valid
@@ -201,7 +208,38 @@ namespace gpstk
          Planet center,
          double PV[6],
          bool kilometers = true)
-         throw(gpstk::Exception);
+         const throw(gpstk::Exception);
+
+         /// Compute position and velocity of several target bodies relative to
+         /// the same center body, at one time; see the single-target version for
+         /// details. The data record is looked up once, and the state of each
+         /// body needed is computed once.
+         /// @param tt      Time (Julian Date) of interest.
+         /// @param targets array of n bodies for which results are computed.
+         /// @param n       number of targets.
+         /// @param center  Body relative to which the results apply.
+         /// @param PV      array of 6*n doubles; results for targets[i] are returned
+         ///                  in PV[6*i] to PV[6*i+5], as PV in the single-target
+         ///                  version.
+         /// @param km      boolean: if true (default), units are km, km/day;
+         ///                  else AU, AU/day.
+         /// @return as the single-target version.
+      int computeState(double tt,
+         const Planet targets[],
+         int n,
+         Planet center,
+         double PV[],
+         bool kilometers = true)
+         const throw(gpstk::Exception);
+
+         /// Set the number of data records kept decoded after
+         /// initializeWithBinaryFile(); the default is 16.
+      void setRecordCacheSize(size_t n) throw()
+      { records.setCapacity(n); }
+
+         /// Return the number of data records kept decoded.
+      size_t getRecordCacheSize(void) const throw()
+      { return records.getCapacity(); }
 
          /// Return the value of 1 AU (Astronomical Unit) in km. If the file header has not
          /// been read, return -1.0.
@@ -249,7 +287,7 @@ namespace gpstk
       void readBinaryHeader(std::string filename) throw(gpstk::Exception);
 
          /// Read data from a binary file, already opened by readBinaryHeader.
-         /// Build the file position map, and store the first set of coefficients.
+         /// Build the file position map.
          /// If calling argument is true, save all the coefficient data in a map.
          /// @param save if true, save all the data in store, else clear the store.
          /// @return 0 success,
@@ -288,19 +326,21 @@ namespace gpstk
       };
 
          /// Search the data records of the file opened by initializeWithBinaryFile() and
-         /// read the one whose time limits include the given time. May be called only
-         /// after initializeWithBinaryFile().
+         /// get the one whose time limits include the given time, from the record
+         /// cache. May be called only after initializeWithBinaryFile().
          /// @param JD the time (Julian Date) of interest
+         /// @param rec the record found
          /// @return 0 success, or
          ///        -1 given time is before the first record in the file,
          ///        -2 given time is after the last record, or in a gap between records,
          ///        -3 input stream is not open or not valid, or EOF was found prematurely,
          ///        -4 ephemeris (binary file) is not initialized
          /// -3 or -4 => initializeWithBinaryFile() has not been called, or reading failed.
-      int seekToJD(double JD) throw(gpstk::Exception);
+      int seekToJD(double JD, BinaryRecordCache::Record& rec) const
+         throw(gpstk::Exception);
 
-         /// Compute position and velocity of given body at given time, using the current
-         /// coefficient array. NB caller MUST call seekToJD(time) BEFORE calling this.
+         /// Compute position and velocity of given body at given time, using the given
+         /// coefficient array. NB caller MUST get the array from seekToJD(time).
          /// On successful return, PV[0-2] contains the three position components, in km,
          /// and PV[3-5] the velocity components in km/day (for regular bodies), relative
          /// to the solar system barycenter, except for the moon, which is relative to
@@ -308,10 +348,19 @@ namespace gpstk
          /// nutations (components 0-3 only) are longitude and obliquity, and librations
          /// are the three euler angles.
          /// @param  tt     Time (Julian Date) of interest.
+         /// @param  coefficients  data record including tt.
          /// @param  which  computeID of the body of interest.
          /// @param  PV     double(6) array containing the output position and velocity.
-      void computeState(double tt, computeID which, double PV[6])
-         throw(gpstk::Exception);
+      void computeState(double tt, const std::vector<double>& coefficients,
+                        computeID which, double PV[6])
+         const throw(gpstk::Exception);
+
+         /// Return the state of body 'which' computed by computeState(), computing
+         /// it only if have[which] is false; zero for NONE. For use by the public
+         /// computeState().
+      const double *bodyState(double tt, const std::vector<double>& coefficients,
+                              computeID which, double states[][6], bool have[])
+         const throw(gpstk::Exception);
 
       // member data ---------------------------------------------------------
 
@@ -376,9 +425,10 @@ namespace gpstk
          /// used by seekToJD() to read records in random order.
       std::map<double, long> fileposMap;
 
-         /// One complete data record (Ncoeff doubles) consisting of times and coefficients.
-         /// seekToJD() stores the current record here, and computeState() makes use of it.
-      std::vector<double> coefficients;
+         /// The binary file opened by initializeWithBinaryFile(), with the most
+         /// recently used data records (Ncoeff doubles each, consisting of times and
+         /// coefficients). seekToJD() gets records from here.
+      BinaryRecordCache records;
 
    }; // end class PlanetEphemeris
  
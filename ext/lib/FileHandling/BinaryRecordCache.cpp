@@ -0,0 +1,153 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file BinaryRecordCache.cpp
+/// Random access to the fixed-length records of a binary file of doubles.
+
+#include <cstring>
+#include "BinaryRecordCache.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   BinaryRecordCache::BinaryRecordCache(size_t cap) throw()
+         : recordSize(0),
+           capacity(cap > 0 ? cap : 1)
+   {
+   }
+
+
+   BinaryRecordCache::~BinaryRecordCache() throw()
+   {
+      close();
+   }
+
+
+   void BinaryRecordCache::open(const string& filename, size_t ndouble)
+      throw(Exception)
+   {
+      close();
+      if(!file.open(filename))
+      {
+         Exception e("Failed to open file " + filename);
+         GPSTK_THROW(e);
+      }
+      recordSize = ndouble;
+   }
+
+
+   void BinaryRecordCache::close() throw()
+   {
+      {
+         lock_guard<std::mutex> lock(mutex);
+         lru.clear();
+         index.clear();
+      }
+      file.close();
+   }
+
+
+   BinaryRecordCache::Record BinaryRecordCache::get(long offset) const throw()
+   {
+      if(!file.isOpen() || offset < 0 ||
+         static_cast<size_t>(offset) + recordSize*sizeof(double) > file.size())
+         return Record();
+
+      {
+         lock_guard<std::mutex> lock(mutex);
+         map<long, RecordList::iterator>::iterator it = index.find(offset);
+         if(it != index.end())
+         {
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+         }
+      }
+
+         // copy the doubles without holding the lock; a concurrent
+         // get() of the same offset may have added it meanwhile, in
+         // which case that record is returned and this copy dropped
+      try
+      {
+         std::shared_ptr<vector<double> > rec(new vector<double>(recordSize));
+         if(recordSize > 0)
+            memcpy(&(*rec)[0], file.data() + offset,
+                   recordSize*sizeof(double));
+
+         lock_guard<std::mutex> lock(mutex);
+         map<long, RecordList::iterator>::iterator it = index.find(offset);
+         if(it != index.end())
+         {
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+         }
+         lru.push_front(make_pair(offset, Record(rec)));
+         index[offset] = lru.begin();
+         trim();
+         return lru.front().second;
+      }
+      catch(...)
+      {
+         return Record();
+      }
+   }
+
+
+   void BinaryRecordCache::setCapacity(size_t n) throw()
+   {
+      lock_guard<std::mutex> lock(mutex);
+      capacity = (n > 0 ? n : 1);
+      trim();
+   }
+
+
+   size_t BinaryRecordCache::size() const throw()
+   {
+      lock_guard<std::mutex> lock(mutex);
+      return lru.size();
+   }
+
+
+   void BinaryRecordCache::trim() const throw()
+   {
+      while(lru.size() > capacity)
+      {
+         index.erase(lru.back().first);
+         lru.pop_back();
+      }
+   }
+
+} // end namespace
@@ -0,0 +1,145 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/** @file BinaryRecordCache.hpp
+ * Random access to the fixed-length records of a binary file of
+ * doubles, through a memory mapping of the file and a cache of the
+ * most recently used records. */
+
+#ifndef GPSTK_BINARYRECORDCACHE_HPP
+#define GPSTK_BINARYRECORDCACHE_HPP
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Exception.hpp"
+#include "MappedFile.hpp"
+
+namespace gpstk
+{
+      /// @ingroup formattedfile
+      //@{
+
+      /** Read-only random access to records of a fixed number of
+       * doubles, in native byte order, at arbitrary offsets in a
+       * binary file, such as the coefficient records of a JPL
+       * ephemeris (see SolarSystemEphemeris and PlanetEphemeris).
+       * The file is read through a MappedFile, and the most recently used records are kept
+       * decoded, up to a fixed number, so that queries that hop
+       * between a few records neither seek nor copy.
+       *
+       * get() may be called from several threads at once; the
+       * records it returns stay valid as long as the caller holds
+       * them, even if they are dropped from the cache or the file
+       * is closed. */
+   class BinaryRecordCache
+   {
+   public:
+         /// A decoded record.
+      typedef std::shared_ptr<const std::vector<double> > Record;
+
+         /** Constructor.
+          * @param[in] capacity largest number of decoded records kept */
+      BinaryRecordCache(size_t capacity = 16) throw();
+
+         /// Destructor, closes the file.
+      ~BinaryRecordCache() throw();
+
+         /** Open a file, closing any file already open.
+          * @param[in] filename name of the file
+          * @param[in] ndouble number of doubles in each record
+          * @throw Exception if the file cannot be read. */
+      void open(const std::string& filename, size_t ndouble)
+         throw(Exception);
+
+         /// Close the file and empty the cache.
+      void close() throw();
+
+         /// Return true if a file is open.
+      bool isOpen() const throw()
+      { return file.isOpen(); }
+
+         /** Return the record starting at a byte offset in the file.
+          * @param[in] offset offset of the record from the start
+          *   of the file
+          * @return the record, or a null pointer if no file is open
+          *   or the record does not fit in the file */
+      Record get(long offset) const throw();
+
+         /// Set the largest number of decoded records kept (at least 1).
+      void setCapacity(size_t n) throw();
+
+         /// Return the largest number of decoded records kept.
+      size_t getCapacity() const throw()
+      { return capacity; }
+
+         /// Return the number of decoded records currently kept.
+      size_t size() const throw();
+
+   private:
+         /// Not copyable; the mapping is owned.
+      BinaryRecordCache(const BinaryRecordCache&);
+      BinaryRecordCache& operator=(const BinaryRecordCache&);
+
+         /// Drop the least recently used records beyond capacity.
+         /// Call with the mutex locked.
+      void trim() const throw();
+
+      MappedFile file;           ///< the file contents
+      size_t recordSize;         ///< number of doubles per record
+      size_t capacity;           ///< see getCapacity()
+
+         /// Decoded records, most recently used first
+      typedef std::list<std::pair<long, Record> > RecordList;
+      mutable RecordList lru;
+
+         /// Records in lru by file offset
+      mutable std::map<long, RecordList::iterator> index;
+
+         /// Guards lru and index
+      mutable std::mutex mutex;
+
+   }; // end class BinaryRecordCache
+
+      //@}
+
+} // end namespace
+
+#endif // GPSTK_BINARYRECORDCACHE_HPP
@@ -42,6 +42,8 @@
  */
 
 
+#include <algorithm>
+
 #include "IonexStore.hpp"
 
 using namespace gpstk::StringUtils;
@@ -55,6 +57,13 @@ namespace gpstk
       // 2nd edition, Walter de Gruyter, p.52-54.
    static const double C2_FACT   = 40.3e+16;
 
+      // Earth's semi-major axis, consistent with
+      // Position::getIonosphericPiercePoint() and IonexData::getValue()
+   static const double AEarth = WGS84Ellipsoid().a();
+
+      // marks an undefined TEC/RMS value in IonexData
+   static const double UNDEFINED_VALUE = 999.9;
+
 
       // Load the given IONEX file
    void IonexStore::loadFile( const std::string& filename )
@@ -100,9 +109,11 @@ namespace gpstk
          IonexData iod;
          while ( strm >> iod && iod.isValid() )
          {
-            addMap(iod);
+            insertMap(iod);
          }
 
+         buildArrays();
+
       }
       catch (gpstk::Exception& e)
       {
@@ -118,6 +129,18 @@ namespace gpstk
       throw()
    {
 
+      insertMap(iod);
+      buildArrays();
+
+   }  // End of method 'IonexStore::addMap()'
+
+
+
+      // Insert an IonexData object, without rebuilding the array
+   void IonexStore::insertMap(const IonexData& iod)
+      throw()
+   {
+
       CommonTime t(iod.time);
       IonexData::IonexValType type(iod.type);
 
@@ -135,7 +158,80 @@ namespace gpstk
          finalTime = t;
       }
 
-   }  // End of method 'IonexStore::addMap()'
+   }  // End of method 'IonexStore::insertMap()'
+
+
+
+      // Rebuild epochs, grids and values from inxMaps
+   void IonexStore::buildArrays(void)
+      throw()
+   {
+
+      epochs.clear();
+      tecGrid.clear();
+      rmsGrid.clear();
+      sameGrid.clear();
+      values.clear();
+
+      IonexMap::const_iterator it;
+      for (it = inxMaps.begin(); it != inxMaps.end(); it++)
+      {
+
+         GridMap grid[2];
+         const IonexData::IonexValType types[2] = { IonexData::TEC,
+                                                    IonexData::RMS };
+
+         for (int k = 0; k < 2; k++)
+         {
+
+            IonexValTypeMap::const_iterator jt( it->second.find(types[k]) );
+            if ( jt == it->second.end() )
+            {
+               grid[k].offset = -1;
+               continue;
+            }
+
+            const IonexData& iod(jt->second);
+            grid[k].lat0 = iod.lat[0];
+            grid[k].dlat = iod.lat[2];
+            grid[k].lon0 = iod.lon[0];
+            grid[k].dlon = iod.lon[2];
+            grid[k].hgt0 = iod.hgt[0];
+            grid[k].dhgt = iod.hgt[2];
+            grid[k].nlat = iod.dim[0];
+            grid[k].nlon = iod.dim[1];
+            grid[k].nhgt = iod.dim[2];
+            grid[k].ncyc = static_cast<int>(
+                              ( 360.0 / std::abs(iod.lon[2]) ) + 0.5 );
+            grid[k].offset = values.size();
+
+               // values, padded if the map is short
+            size_t n( iod.dim[0] * iod.dim[1] * std::max(iod.dim[2],1) );
+            for (size_t i = 0; i < n; i++)
+            {
+               values.push_back( i < iod.data.size() ? iod.data[i]
+                                                     : UNDEFINED_VALUE );
+            }
+
+         }  // End of 'for (int k = 0; k < 2; k++)...'
+
+         epochs.push_back(it->first);
+         tecGrid.push_back(grid[0]);
+         rmsGrid.push_back(grid[1]);
+         sameGrid.push_back( grid[0].offset >= 0 && grid[1].offset >= 0 &&
+                             grid[0].lat0 == grid[1].lat0 &&
+                             grid[0].dlat == grid[1].dlat &&
+                             grid[0].lon0 == grid[1].lon0 &&
+                             grid[0].dlon == grid[1].dlon &&
+                             grid[0].hgt0 == grid[1].hgt0 &&
+                             grid[0].dhgt == grid[1].dhgt &&
+                             grid[0].nlat == grid[1].nlat &&
+                             grid[0].nlon == grid[1].nlon &&
+                             grid[0].nhgt == grid[1].nhgt );
+
+      }  // End of 'for (it = inxMaps.begin(); it != inxMaps.end(); it++)...'
+
+   }  // End of method 'IonexStore::buildArrays()'
 
 
 
@@ -243,6 +339,7 @@ namespace gpstk
    {
 
       inxMaps.clear();
+      buildArrays();
 
       initialTime = CommonTime::END_OF_TIME;
       finalTime = CommonTime::BEGINNING_OF_TIME;
@@ -281,9 +378,54 @@ namespace gpstk
       throw(InvalidRequest)
    {
 
-         // Here we store the necessary IONEX-extracted values 
-         // (i.e, TEC, RMS, ionosphere height)
-      Triple tecval(0.0,0.0,0.0);
+      size_t im[2];
+      double f[2];
+      int nmap( findMaps(t, strategy, im, f) );
+
+      return getValue(t, RX, strategy, nmap, im, f);
+
+   }  // End of method 'IonexStore::getIonexValue()'
+
+
+
+      /** Get IONEX TEC, RMS and ionosphere height values at one epoch for
+       * many positions.
+       *
+       * @param t          Time tag of signal (CommonTime object)
+       * @param RX         Positions, in GEOCENTRIC coordinates
+       * @param values     Output TEC, RMS and ionosphere height values,
+       *                   one Triple per position
+       * @param strategy   Interpolation strategy, as in getIonexValue()
+       */
+   void IonexStore::getIonexValues( const CommonTime& t,
+                                    const std::vector<Position>& RX,
+                                    std::vector<Triple>& values,
+                                    int strategy ) const
+      throw(InvalidRequest)
+   {
+
+      size_t im[2];
+      double f[2];
+      int nmap( findMaps(t, strategy, im, f) );
+
+      values.resize(RX.size());
+      for (size_t i = 0; i < RX.size(); i++)
+      {
+         values[i] = getValue(t, RX[i], strategy, nmap, im, f);
+      }
+
+   }  // End of method 'IonexStore::getIonexValues()'
+
+
+
+      // Find the epochs of the maps and the interpolation factors for time t
+      // and the given strategy. Returns the number of maps to use.
+   int IonexStore::findMaps( const CommonTime& t,
+                             int strategy,
+                             size_t im[2],
+                             double f[2] ) const
+      throw(InvalidRequest)
+   {
 
          // current time check
       if (t < getInitialTime())
@@ -296,17 +438,6 @@ namespace gpstk
       {
          InvalidRequest e("Inadequate data after requested time");
          GPSTK_THROW(e);
-      }
-
-         // this never should happen but just in case
-      Position pos(RX);
-      if ( pos.getSystemName() != "Geocentric" )
-      {
-
-         InvalidRequest e("Position object is not in GEOCENTRIC coordinates");
-
-         GPSTK_THROW(e);
-
       }
 
          //let's define the number of maps to be considered
@@ -321,46 +452,41 @@ namespace gpstk
          GPSTK_THROW(e);
       }
 
-         // let's look for valid Ionex maps
-      CommonTime T[2];
-         // iterator
-      IonexMap::const_iterator itm = inxMaps.find(t);
-      try
+         // the first map after t; the map at or before t precedes it
+      size_t next( std::upper_bound(epochs.begin(), epochs.end(), t)
+                   - epochs.begin() );
+      if (next == 0)
       {
+         InvalidRequest e("IonexStore::getIonexValue() ... Invalid time!");
+         GPSTK_THROW(e);
+      }
 
-         if( itm != inxMaps.end() )              // exact match of t
-         {
-
-               // get the current map
-            itm = inxMaps.lower_bound(t);
-               // store current and next epoch
-            T[0] = itm->first;
-            T[1] = (++itm)->first;
+      if (epochs.size() == 1)                   // t is the only map
+      {
+         im[0] = im[1] = 0;
+         f[0] = 1.0;
+         f[1] = 0.0;
+      }
+      else
+      {
 
-         }
-         else                                   // t is between two maps
+            // t at the last map: interpolate to the end of the last interval
+         if (next == epochs.size())
          {
+            next--;
+         }
 
-               // get the next valid map
-            itm = inxMaps.lower_bound(t);
-               // store the next and previous epoch
-            T[1] = itm->first;
-            T[0] = (--itm)->first;
+         im[0] = next-1;
+         im[1] = next;
 
-         }  // end of 'if( itm != inxMaps.end() ) ... else ... '' 
+         const CommonTime& T0(epochs[im[0]]);
+         const CommonTime& T1(epochs[im[1]]);
 
-      }
-      catch (...)
-      {
-         InvalidRequest e("IonexStore::getIonexValue() ... Invalid time!");
-         GPSTK_THROW(e);
-      }
+            // factors (As in Eq.(3), pag.2 of the manual)
+         f[0] = (T1-t ) / (T1-T0);
+         f[1] = (t -T0) / (T1-T0);
 
-
-         // factors (As in Eq.(3), pag.2 of the manual)
-      double f[2];
-      f[0] = (T[1]-t   ) / (T[1]-T[0]);
-      f[1] = (t   -T[0]) / (T[1]-T[0]);
+      }
 
          // if only one map, then we have to use the neareast
       if( nmap == 1 )
@@ -369,7 +495,7 @@ namespace gpstk
             // closer to the next map
          if( f[1] > f[0] )
          {
-            T[0] = T[1];
+            im[0] = im[1];
          }
 
             // than the factor is unit
@@ -377,68 +503,206 @@ namespace gpstk
 
       }  // if( nmap == 1 )
 
-         // loop over the number of maps considered
-      for(int imap = 0; imap < nmap; imap++)
+      return nmap;
+
+   }  // End of method 'IonexStore::findMaps()'
+
+
+
+      // Find the grid cell of a point; cf. IonexData::getIndex() and
+      // IonexData::getValue(), which this follows step for step.
+   void IonexStore::findCell( const GridMap& grid,
+                              double beta,
+                              double lambda,
+                              double height,
+                              GridCell& cell )
+      throw(InvalidRequest)
+   {
+
+         // in IONEX files longitude takes values within [-180 180]
+      if (lambda > 180.0)
       {
+         lambda = lambda - 360.0;
+      }
 
-            // now let's determine if we keep fixed position or 
-            // take into account the rotation around the Sun
-         Position pos;
-         if (strategy == 1 || strategy == 2)    // fixed position
-         {
+         // lower left hand grid point E00
+      int ilat( static_cast<int>( (beta - grid.lat0) / grid.dlat + 1.0 ) );
+      if (ilat < 1 || ilat > grid.nlat)
+      {
+         InvalidRequest e( "Irregular latitude. Latitude "
+                           + asString(beta) + " DEG" );
+         GPSTK_THROW(e);
+      }
 
-            pos = RX;
+      int ilon( static_cast<int>( (lambda - grid.lon0) / grid.dlon + 1.0 ) );
+      if (ilon < 1)
+      {
+         ilon = ilon + grid.ncyc;
+      }
+      else if (ilon > grid.nlon)
+      {
+         ilon = ilon - grid.ncyc;
+      }
+      if (ilon < 1 || ilon > grid.nlon)
+      {
+         InvalidRequest e( "Irregular longitude. Longitude: "
+                           + asString(lambda) + " DEG" );
+         GPSTK_THROW(e);
+      }
 
-         }
-         else                                   // rotate the position
+      int ihgt(1);
+      if (grid.dhgt != 0)
+      {
+         ihgt = static_cast<int>( (height/1000.0 - grid.hgt0) / grid.dhgt
+                                  + 1.0 );
+         if (ihgt < 1 || ihgt > grid.nhgt)
          {
+            InvalidRequest e( "Irregular height. Height: "
+                              + asString( height/1000.0 ) + " km.");
+            GPSTK_THROW(e);
+         }
+      }
 
-               // seconds of time to degree (360.0 / 86400.0)
-            double sec2deg( 4.16666666666667e-3 );
+         // compute factors P and Q
+      cell.xp = (lambda - (grid.lon0 + (ilon-1)*grid.dlon)) / grid.dlon;
+      cell.xq = (beta - (grid.lat0 + (ilat-1)*grid.dlat)) / grid.dlat;
 
-               // count the rotation
-            pos = RX;
-            pos.theArray[1] = pos.theArray[1] + ( t - T[imap] ) * sec2deg;
+         // this never should happen but just in case
+      if ( (cell.xp < 0) || (cell.xp > 1) || (cell.xq < 0) || (cell.xq > 1) )
+      {
+         InvalidRequest e("IonexStore: Wrong xp and xq factors!!!");
+         GPSTK_THROW(e);
+      }
 
-         }  // End of 'if (strategy == 1 || strategy == 2)...'
+         // neighbours E10, E01 and E11
+      int ilon1(ilon+1), ilat1(ilat+1);
+      if (ilon1 > grid.nlon)
+      {
+         ilon1 = ilon1 - grid.ncyc;
+      }
+      if (ilon1 < 1 || ilon1 > grid.nlon)
+      {
+         InvalidRequest e( "Irregular longitude. Longitude: "
+                           + asString(lambda + grid.dlon) + " DEG" );
+         GPSTK_THROW(e);
+      }
+      if (ilat1 > grid.nlat)
+      {
+         InvalidRequest e( "Irregular latitude. Latitude "
+                           + asString(beta + grid.dlat) + " DEG" );
+         GPSTK_THROW(e);
+      }
 
+      long base( long(ihgt-1)*grid.nlon*grid.nlat );
+      cell.index[0] = base + (ilon -1) + long(ilat -1)*grid.nlon;
+      cell.index[1] = base + (ilon1-1) + long(ilat -1)*grid.nlon;
+      cell.index[2] = base + (ilon -1) + long(ilat1-1)*grid.nlon;
+      cell.index[3] = base + (ilon1-1) + long(ilat1-1)*grid.nlon;
 
-            // iterator to the current map
-         itm = inxMaps.find(T[imap]);
+   }  // End of method 'IonexStore::findCell()'
 
-            // map to hold the IONEX types for the current map
-         IonexValTypeMap ivtm = (*itm).second;
 
-            // object to hold the corresponding data to the current map
-         IonexData iod;
 
-            // Compute TEC value
-         if ( ivtm.find(IonexData::TEC) != ivtm.end() )
+      // Bilinear interpolation of a map within a grid cell
+   double IonexStore::interpolate( const GridMap& grid,
+                                   const GridCell& cell ) const
+      throw(InvalidRequest)
+   {
+
+         // the cell indexes are relative to the first value of the map
+      const double *data( &values[grid.offset] );
+      double pntval[4];
+      for (int i = 0; i < 4; i++)
+      {
+         pntval[i] = data[cell.index[i]];
+      }
+
+      if ( pntval[0] == UNDEFINED_VALUE || pntval[1] == UNDEFINED_VALUE ||
+           pntval[2] == UNDEFINED_VALUE || pntval[3] == UNDEFINED_VALUE )
+      {
+         InvalidRequest e("Undefined TEC/RMS value(s).");
+         GPSTK_THROW(e);
+      }
+
+         // bivariate interpolation (pag.3, IONEX manual)
+      const double xp(cell.xp), xq(cell.xq);
+      return (1.0-xp) * (1.0-xq) * pntval[0] +
+                  xp  * (1.0-xq) * pntval[1] +
+             (1.0-xp) *      xq  * pntval[2] +
+                  xp  *      xq  * pntval[3];
+
+   }  // End of method 'IonexStore::interpolate()'
+
+
+
+      // TEC, RMS and height at one position, given the maps from findMaps()
+   Triple IonexStore::getValue( const CommonTime& t,
+                                const Position& RX,
+                                int strategy,
+                                int nmap,
+                                const size_t im[2],
+                                const double f[2] ) const
+      throw(InvalidRequest)
+   {
+
+         // this never should happen but just in case
+      if ( RX.getCoordinateSystem() != Position::Geocentric )
+      {
+         InvalidRequest e("Position object is not in GEOCENTRIC coordinates");
+         GPSTK_THROW(e);
+      }
+
+         // Here we store the necessary IONEX-extracted values
+         // (i.e, TEC, RMS, ionosphere height)
+      Triple tecval(0.0,0.0,0.0);
+
+      const double beta(RX.theArray[0]);
+      const double height(RX.theArray[2] - AEarth);
+
+         // loop over the number of maps considered
+      for(int imap = 0; imap < nmap; imap++)
+      {
+
+            // now let's determine if we keep fixed position or
+            // take into account the rotation around the Sun
+         double lambda(RX.theArray[1]);
+         if (strategy == 3 || strategy == 4)    // rotate the position
          {
+               // seconds of time to degree (360.0 / 86400.0)
+            double sec2deg( 4.16666666666667e-3 );
+
+            lambda = lambda + ( t - epochs[im[imap]] ) * sec2deg;
+         }
 
-            iod = ivtm[IonexData::TEC];
-            tecval[0] = tecval[0] + f[imap]*iod.getValue(pos);
+         const GridMap& tec(tecGrid[im[imap]]);
+         const GridMap& rms(rmsGrid[im[imap]]);
+         GridCell cell;
 
+            // Compute TEC value
+         if (tec.offset >= 0)
+         {
+            findCell(tec, beta, lambda, height, cell);
+            tecval[0] = tecval[0] + f[imap]*interpolate(tec, cell);
          }
 
             // Compute RMS value
-         if ( ivtm.find(IonexData::RMS) != ivtm.end() )
+         if (rms.offset >= 0)
          {
-
-            iod = ivtm[IonexData::RMS];
-            tecval[1] = tecval[1] + f[imap]*iod.getValue(pos);
-
+            if (!sameGrid[im[imap]])
+            {
+               findCell(rms, beta, lambda, height, cell);
+            }
+            tecval[1] = tecval[1] + f[imap]*interpolate(rms, cell);
          }
 
       }  // End of 'for(int imap = 0; imap < nmap; imap++)...'
 
-
          // ionosphere height in meters
       tecval[2] = RX.theArray[2];
 
       return tecval;
 
-   }  // End of method 'IonexStore::getIonexValue()'
+   }  // End of method 'IonexStore::getValue()'
 
 
 
@@ -45,6 +45,7 @@
 #define GPSTK_IONEXSTORE_HPP
 
 #include <map>
+#include <vector>
 
 #include "FileStore.hpp"
 #include "IonexData.hpp"
@@ -67,6 +68,14 @@ namespace gpstk
        *
        * @sa test ionex store.cpp for an example
        *
+       * Besides the IonexData objects, the store keeps the values of all the
+       * maps in one contiguous array, in time order, with the grid of each map
+       * and the list of epochs; for maps on a common grid this is a dense
+       * (time, height, latitude, longitude) cube. getIonexValue() and
+       * getIonexValues() interpolate directly in this array. The array is
+       * rebuilt by loadFile() and addMap(), so several files are best loaded
+       * with loadFile() rather than map by map.
+       *
        *
        * @warning The first IONEX map refers to 00:00 UT, the last map
        *          to 24:00 UT. The time spacing of the maps (snapshots) is 2
@@ -96,7 +105,8 @@ namespace gpstk
          throw(FileMissingException);
 
 
-         /// Insert a new IonexData object into the store
+         /// Insert a new IonexData object into the store, and rebuild the
+         /// array of map values.
       void addMap(const IonexData& iod)
          throw();
 
@@ -147,6 +157,29 @@ namespace gpstk
          throw(InvalidRequest);
 
 
+         /** Get IONEX TEC, RMS and ionosphere height values at one epoch for
+          *  many positions, e.g. the ionospheric pierce points of all the
+          *  satellites seen by the stations of a network.
+          *
+          * The result for each position is the same as getIonexValue(), but
+          * the maps and the interpolation factors in time are found only once.
+          *
+          * @param t          Time tag of signal (CommonTime object)
+          * @param RX         Positions, in GEOCENTRIC coordinates
+          * @param values     Output TEC, RMS and ionosphere height values,
+          *                   one Triple per position
+          * @param strategy   Interpolation strategy, as in getIonexValue()
+          *
+          * @throw InvalidRequest as getIonexValue(), for the first position
+          *        that cannot be interpolated
+          */
+      void getIonexValues( const CommonTime& t,
+                           const std::vector<Position>& RX,
+                           std::vector<Triple>& values,
+                           int strategy = 3 ) const
+         throw(InvalidRequest);
+
+
 
       /** Get slant total electron content (STEC) in TECU
        *
@@ -370,6 +403,95 @@ namespace gpstk
       IonexDCBMap inxDCBMap;
 
 
+         /// Grid of one TEC or RMS map, and the position of its values
+         /// in the array 'values'
+      struct GridMap
+      {
+         double lat0, dlat;      ///< first latitude and spacing, degrees
+         double lon0, dlon;      ///< first longitude and spacing, degrees
+         double hgt0, dhgt;      ///< first height and spacing, km
+         int nlat, nlon, nhgt;   ///< number of grid points
+         int ncyc;               ///< number of longitudes in 360 degrees
+         long offset;            ///< index of first value, or -1 if no map
+      };
+
+
+         /// Index of the four grid points around a point, relative to the
+         /// first value of a map, and the interpolation factors
+      struct GridCell
+      {
+         long index[4];          ///< E00, E10, E01, E11
+         double xp, xq;          ///< factors in longitude and latitude
+      };
+
+
+         /// Epochs of the maps, in time order
+      std::vector<CommonTime> epochs;
+
+
+         /// TEC and RMS grids of each epoch
+      std::vector<GridMap> tecGrid, rmsGrid;
+
+
+         /// true if the TEC and RMS grids of an epoch are the same
+      std::vector<bool> sameGrid;
+
+
+         /// Values of all the maps
+      std::vector<double> values;
+
+
+         /// Insert an IonexData object, without rebuilding the array
+      void insertMap(const IonexData& iod)
+         throw();
+
+
+         /// Rebuild epochs, grids and values from inxMaps
+      void buildArrays(void)
+         throw();
+
+
+         /** Find the epochs of the maps and the interpolation factors for
+          *  time t and the given strategy.
+          *
+          * @return  number of maps to use (1 or 2); their indexes into
+          *          epochs are im[0], im[1], with factors f[0], f[1]
+          */
+      int findMaps( const CommonTime& t,
+                    int strategy,
+                    size_t im[2],
+                    double f[2] ) const
+         throw(InvalidRequest);
+
+
+         /// Find the grid cell of a point, given geocentric latitude and
+         /// longitude in degrees and height above the ellipsoid in meters;
+         /// the same as IonexData::getIndex() and IonexData::getValue().
+      static void findCell( const GridMap& grid,
+                            double beta,
+                            double lambda,
+                            double height,
+                            GridCell& cell )
+         throw(InvalidRequest);
+
+
+         /// Bilinear interpolation of a map within a grid cell
+      double interpolate( const GridMap& grid,
+                          const GridCell& cell ) const
+         throw(InvalidRequest);
+
+
+         /// TEC, RMS and height at one position, given the maps from
+         /// findMaps()
+      Triple getValue( const CommonTime& t,
+                       const Position& RX,
+                       int strategy,
+                       int nmap,
+                       const size_t im[2],
+                       const double f[2] ) const
+         throw(InvalidRequest);
+
+
    }; // End of class 'IonexStore'
 
       //@}
@@ -44,6 +44,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "Exception.hpp"
 #include "ClockSatStore.hpp"
@@ -51,6 +52,8 @@
 #include "RinexClockStream.hpp"
 #include "RinexClockHeader.hpp"
 #include "RinexClockData.hpp"
+#include "RinexSatID.hpp"
+#include "TimeString.hpp"
 
 namespace gpstk
 {
@@ -101,8 +104,8 @@ namespace gpstk
                finalTime == CommonTime::BEGINNING_OF_TIME)
                   os << "(there are no time limits)" << std::endl;
             else
-               os << initialTime.printf(fmt) << " TO "
-                  << finalTime.printf(fmt) << std::endl;
+               os << printTime(initialTime,fmt) << " TO "
+                  << printTime(finalTime,fmt) << std::endl;
 
             os << " This store contains:"
                << (haveClockBias ? "":" not") << " bias,"
@@ -138,7 +141,7 @@ namespace gpstk
                os << "  Data:" << std::endl;
                DataTable::const_iterator jt;
                for(jt=it->second.begin(); jt!=it->second.end(); jt++) {
-                  os << " " << jt->first.printf(fmt)
+                  os << " " << printTime(jt->first,fmt)
                      << " " << it->first
                      << std::scientific << std::setprecision(12)
                      << " " << std::setw(19) << jt->second.bias
@@ -192,13 +195,18 @@ namespace gpstk
             while(strm >> data) {
                //data.dump(cout);
 
-               if(data.datatype == std::string("AS")) {
-                  // add this data
+               if(data.type == RinexClockBase::AS) {
+                  // add this data; values past dvCount are not in the record
+                  double v[6];
+                  for(int i=0; i<6; i++)
+                     v[i] = (i < data.dvCount ? data.clockData[i] : 0.0);
                   ClockRecord rec;
-                  rec.bias = data.bias; rec.sig_bias = data.sig_bias,
-                  rec.drift = data.drift; rec.sig_drift = data.sig_drift,
-                  rec.accel = data.accel; rec.sig_accel = data.sig_accel;
-                  addClockRecord(data.sat, data.time, rec);
+                  rec.bias = v[0]; rec.sig_bias = v[1];
+                  rec.drift = v[2]; rec.sig_drift = v[3];
+                  rec.accel = v[4]; rec.sig_accel = v[5];
+                  CommonTime ttag(data.epochTime);
+                  ttag.setTimeSystem(TimeSystem::GPS);
+                  addClockRecord(RinexSatID(data.name), ttag, rec);
                }
             }
          }
@@ -213,8 +221,75 @@ namespace gpstk
       }
       catch(Exception& e) { GPSTK_RETHROW(e); }
 
+         return true;
+
       }  // end RinexClockStore::loadFile()
 
+      /// Save the loaded data to a binary cache file, so that a later run
+      /// can restore the store with loadCache() instead of reading the RINEX
+      /// clock files again.
+      /// @param[in] filename name of the cache file, replaced if it exists
+      /// @throw Exception if a loaded file cannot be found or the cache
+      ///    cannot be written
+      void saveCache(const std::string& filename) const throw(Exception)
+      {
+      try {
+         EphemerisCacheWriter cw("RinexClockStore");
+         const std::vector<std::string>& names(clkFiles.getFileNamesInOrder());
+         for(size_t i=0; i<names.size(); i++)
+            cw.addSource(names[i]);
+         cw.put(rejectBadClockFlag);
+         writeCache(cw);
+         cw.write(filename);
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+      }  // end RinexClockStore::saveCache()
+
+      /// Replace the data and the file list with those of a cache file
+      /// written by saveCache(), if it was written from exactly these files in
+      /// the order they were loaded, none of which has changed since, with
+      /// the same reject flag; otherwise the store is not changed. The file
+      /// headers are read again.
+      /// @param[in] filename name of the cache file
+      /// @param[in] filenames the RINEX clock files the store would
+      ///    otherwise be loaded from
+      /// @return true if the store was loaded from the cache
+      /// @throw Exception if a valid cache cannot be read
+      bool loadCache(const std::string& filename,
+                     const std::vector<std::string>& filenames)
+         throw(Exception)
+      {
+         EphemerisCacheReader cr;
+         if(!cr.open(filename, "RinexClockStore", filenames))
+            return false;
+
+      try {
+         bool reject;
+         cr.get(reject);
+         if(reject != rejectBadClockFlag)
+            return false;
+
+         // headers, from the files
+         const std::vector<std::string>& names(cr.getSources());
+         FileStore<RinexClockHeader> fs;
+         for(size_t i=0; i<names.size(); i++) {
+            RinexClockStream strm(names[i].c_str());
+            RinexClockHeader head;
+            strm.exceptions(std::ios::failbit);
+            try { strm >> head; }
+            catch(Exception&) { return false; }
+            catch(std::exception&) { return false; }
+            fs.addFile(names[i], head);
+         }
+
+         readCache(cr);
+         clkFiles = fs;
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+
+         return true;
+      }  // end RinexClockStore::loadCache()
+
    }; // end class RinexClockStore
 
       //@}
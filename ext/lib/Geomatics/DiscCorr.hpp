@@ -81,18 +81,23 @@ namespace gpstk {
       void setParameter(std::string label, double value) throw(gpstk::Exception);
 
          /// Get the parameter in the configuration corresponding to label
-      double getParameter(std::string label) throw()
+         /// This does not modify the configuration, so a configuration
+         /// may be read by several threads at once.
+      double getParameter(std::string label) const throw()
       {
-         if(CFG.find(label) == CFG.end()) return 0.0;    // TD throw?
-         return CFG[label];
+         std::map<std::string,double>::const_iterator it(CFG.find(label));
+         if(it == CFG.end()) return 0.0;    // TD throw?
+         return it->second;
       }
 
          /// Get the description of a parameter
-      std::string getDescription(std::string label) throw()
+      std::string getDescription(std::string label) const throw()
       {
-         if(CFGdescription.find(label) == CFGdescription.end())
+         std::map<std::string,std::string>::const_iterator
+            it(CFGdescription.find(label));
+         if(it == CFGdescription.end())
             return std::string("Invalid label");
-         return CFGdescription[label];
+         return it->second;
       }
 
          /// Tell GDCconfiguration to which stream to send debugging output.
@@ -258,11 +263,23 @@ namespace gpstk {
    /// const int FatalProblem = -3  DT is not set, or memory problem
    /// const int Singularity = -1   polynomial fit fails
    /// const int ReturnOK = 0       normal return
+   ///
+   /// Separate passes may be processed by concurrent calls on several threads,
+   /// provided each call has its own SatPass, EditCmds and retMsg. The calls
+   /// may share one configuration, which is only read, unless its ResetUnique
+   /// parameter is set; debug output then goes to its one debug stream, so
+   /// give each call its own copy of the configuration to keep that output
+   /// apart.
+   /// @param unique   if positive, the number that identifies this call in the
+   ///                 output (e.g. the pass number); otherwise the next number
+   ///                 from a counter shared by all calls, which depends on the
+   ///                 order of the calls.
    int DiscontinuityCorrector(SatPass& SP,
                               GDCconfiguration& config,
                               std::vector<std::string>& EditCmds,
                               std::string& retMsg,
-                              int GLOn=-99)
+                              int GLOn=-99,
+                              int unique=0)
       throw(Exception);
 
    //@}
@@ -1604,10 +1604,23 @@ namespace gpstk
    // param t EphTime epoch of interest
    // return the ee in radians
    // throw if the TimeSystem conversion fails (if t.system==TimeSystem::Unknown)
-   // Based on IERS function EECT2000.f; all planets but Venus dropped b/c their
-   // contribution is zero.
    double EarthOrientation::EquationOfEquinoxes2003(EphTime t)
       throw(Exception)
+   {
+      try {
+         return EquationOfEquinoxes2003(CoordTransTime(t));
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //------------------------------------------------------------------------------
+   // Equation of the equinoxes complementary terms, IAU 2000 (IERS 2003)
+   // param T coordinate transformation time at the epoch of interest
+   // return the ee in radians
+   // Based on IERS function EECT2000.f; all planets but Venus dropped b/c their
+   // contribution is zero.
+   double EarthOrientation::EquationOfEquinoxes2003(double T)
+      throw()
    {
       // first define the coefficients
 
@@ -1674,50 +1687,45 @@ namespace gpstk
       const int n0 = int(sizeof Czero / sizeof(Coeffs));
       //const int n1 = int(sizeof C1 / sizeof(Coeffs));
 
-      try {
-         // coordinate transformation time
-         double T(CoordTransTime(t));
-         // fundamental arguments l   lp  f   d   o   lme lv  le  pa
-         double farg[N];
-
-         LOG(DEBUG7) << "\nT = " << fixed << setprecision(15) << T;
-         farg[0] = L(T);     // mean anomaly of the moon
-         LOG(DEBUG7) << "L(T) = " << fixed << setprecision(15) << farg[0];
-         farg[1] = Lp(T);    // mean anomaly of the sun
-         LOG(DEBUG7) << "Lp(T) = " << fixed << setprecision(15) << farg[1];
-         farg[2] = F(T);     // mean longitude of the moon - Omega
-         LOG(DEBUG7) << "F(T) = " << fixed << setprecision(15) << farg[2];
-         farg[3] = D(T);     // mean elongation of the moon from the sun
-         LOG(DEBUG7) << "D(T) = " << fixed << setprecision(15) << farg[3];
-         farg[4] = Omega2003(T); // mean longitude of lunar ascending node
-         LOG(DEBUG7) << "Omega2003(T) = " << fixed << setprecision(15) << farg[4];
-         farg[5] = LV(T);    // mean longitude of Venus
-         LOG(DEBUG7) << "LV(T) = " << fixed << setprecision(15) << farg[5];
-         farg[6] = LE(T);    // mean longitude of Earth
-         LOG(DEBUG7) << "LE(T) = " << fixed << setprecision(15) << farg[6];
-         farg[7] = Pa(T);    // general precession in longitude
-         LOG(DEBUG7) << "Pa(T) = " << fixed << setprecision(15) << farg[7];
-
-         // do the sums
-         double ee(0.0);
-         for(int i=n0-1; i>=0; --i) {            // order 0
-            double arg(0.0);
-            for(int j=0; j<N; ++j)
-               if(Czero[i].coeff[j])
-                  arg += Czero[i].coeff[j] * farg[j];
-            ee += Czero[i].sincoeff * ::sin(arg);
-            if(Czero[i].coscoeff) ee += Czero[i].coscoeff * ::cos(arg);
-         }
-
-         // the T^1 term
-         ee += -0.87e-6 * ::sin(farg[4]) * T;
+      // fundamental arguments l   lp  f   d   o   lme lv  le  pa
+      double farg[N];
 
-         // convert to radians
-         ee *= ARCSEC_TO_RAD;
+      LOG(DEBUG7) << "\nT = " << fixed << setprecision(15) << T;
+      farg[0] = L(T);     // mean anomaly of the moon
+      LOG(DEBUG7) << "L(T) = " << fixed << setprecision(15) << farg[0];
+      farg[1] = Lp(T);    // mean anomaly of the sun
+      LOG(DEBUG7) << "Lp(T) = " << fixed << setprecision(15) << farg[1];
+      farg[2] = F(T);     // mean longitude of the moon - Omega
+      LOG(DEBUG7) << "F(T) = " << fixed << setprecision(15) << farg[2];
+      farg[3] = D(T);     // mean elongation of the moon from the sun
+      LOG(DEBUG7) << "D(T) = " << fixed << setprecision(15) << farg[3];
+      farg[4] = Omega2003(T); // mean longitude of lunar ascending node
+      LOG(DEBUG7) << "Omega2003(T) = " << fixed << setprecision(15) << farg[4];
+      farg[5] = LV(T);    // mean longitude of Venus
+      LOG(DEBUG7) << "LV(T) = " << fixed << setprecision(15) << farg[5];
+      farg[6] = LE(T);    // mean longitude of Earth
+      LOG(DEBUG7) << "LE(T) = " << fixed << setprecision(15) << farg[6];
+      farg[7] = Pa(T);    // general precession in longitude
+      LOG(DEBUG7) << "Pa(T) = " << fixed << setprecision(15) << farg[7];
 
-         return ee;
+      // do the sums
+      double ee(0.0);
+      for(int i=n0-1; i>=0; --i) {            // order 0
+         double arg(0.0);
+         for(int j=0; j<N; ++j)
+            if(Czero[i].coeff[j])
+               arg += Czero[i].coeff[j] * farg[j];
+         ee += Czero[i].sincoeff * ::sin(arg);
+         if(Czero[i].coscoeff) ee += Czero[i].coscoeff * ::cos(arg);
       }
-      catch(Exception& e) { GPSTK_RETHROW(e); }
+
+      // the T^1 term
+      ee += -0.87e-6 * ::sin(farg[4]) * T;
+
+      // convert to radians
+      ee *= ARCSEC_TO_RAD;
+
+      return ee;
    }
 
    //------------------------------------------------------------------------------
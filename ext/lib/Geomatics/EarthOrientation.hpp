@@ -75,7 +75,8 @@ namespace gpstk {
    /// is a simple class that enforces this requirement (plus TDB), transformation to
    /// and from CommonTime should be automatic. (TT is terrestrial and TDB is
    /// barycentric dynamic time, which is the time of SolarSystemEphemeris.)
-   /// Also cf. classes EOPStore and SolarSystem.
+   /// Also cf. classes EOPStore and SolarSystem, and EarthOrientationCache, which
+   /// interpolates the transformation in a table.
    /// References:
    /// IERS1996: IERS Technical Note 21, "IERS Conventions (1996),"
    ///   Dennis D. McCarthy, U.S. Naval Observatory, 1996.
@@ -384,7 +385,37 @@ namespace gpstk {
       Matrix<double> ECEFtoJ2000(const EphTime& t, bool reduced=false)
          throw(Exception);
 
+      //------------------------------------------------------------------------------
+      /// coordinates X,Y of the Celestial Intermediate Origin (CIO) using
+      /// a series based on IAU 2006 precession and IAU 2000A nutation (IERS 2010).
+      /// The coordinates form a unit vector that points towards the CIO; they include
+      /// the effects of frame bias, precession and nutation. cf. sofa xy06
+      /// @param T, the coordinate transformation time at the time of interest
+      /// @param X, x coordinate of CIO
+      /// @param Y, y coordinate of CIO
+      static void XYCIO(double& T, double& X, double& Y)
+         throw();
+
+      //------------------------------------------------------------------------------
+      /// Nutation of the obliquity (deps) and of the longitude (dpsi), IERS 2003
+      /// @param T,    the coordinate transformation time at the time of interest
+      /// @param deps, nutation of the obliquity (output) in radians
+      /// @param dpsi, nutation of the longitude (output) in radians
+      static void NutationAngles2003(double T, double& deps, double& dpsi)
+         throw();
+
+      //------------------------------------------------------------------------------
+      /// Nutation of the obliquity (deps) and of the longitude (dpsi), IERS 2010
+      /// @param T,    the coordinate transformation time at the time of interest
+      /// @param deps, nutation of the obliquity (output) in radians
+      /// @param dpsi, nutation of the longitude (output) in radians
+      static void NutationAngles2010(double T, double& deps, double& dpsi)
+         throw();
+
    private:
+      /// EarthOrientationCache tabulates the private series below
+      friend class EarthOrientationCache;
+
       //------------------------------------------------------------------------------
       /// locator s which gives the position of the CIO on the equator of
       /// the CIP, given the coordinate transformation time T and the coordinates X,Y
@@ -415,17 +446,6 @@ namespace gpstk {
       static double Sprime(EphTime t) throw()
          { return Sprime(CoordTransTime(t)); }
 
-      //------------------------------------------------------------------------------
-      /// coordinates X,Y of the Celestial Intermediate Origin (CIO) using
-      /// a series based on IAU 2006 precession and IAU 2000A nutation (IERS 2010).
-      /// The coordinates form a unit vector that points towards the CIO; they include
-      /// the effects of frame bias, precession and nutation. cf. sofa xy06
-      /// @param T, the coordinate transformation time at the time of interest
-      /// @param X, x coordinate of CIO
-      /// @param Y, y coordinate of CIO
-      static void XYCIO(double& T, double& X, double& Y)
-         throw();
-
       //------------------------------------------------------------------------------
       /// Starting with 2003 conventions a new method for computing the transformation
       /// fron ITRS to GCRS is provided by the Celestial Ephemeris Origin (CEO) which
@@ -447,6 +467,12 @@ namespace gpstk {
       static double EquationOfEquinoxes2003(EphTime t)
          throw(Exception);
 
+      /// EquationOfEquinoxes2003 with T input; cf. (EphTime t) version
+      /// @param T coordinate transformation time at the epoch of interest
+      /// @return the ee in radians
+      static double EquationOfEquinoxes2003(double T)
+         throw();
+
       //------------------------------------------------------------------------------
       /// Zonal tide terms for corrections of UT1mUTC when that quantity does not
       /// include tides (e.g. NGA EOP), ref. IERS 1996 Ch. 8, table 8.1 pg 74.
@@ -641,22 +667,6 @@ namespace gpstk {
       static void NutationAngles1996(double T, double& deps, double& dpsi, double& om)
          throw();
 
-      //------------------------------------------------------------------------------
-      /// Nutation of the obliquity (deps) and of the longitude (dpsi), IERS 2003
-      /// @param T,    the coordinate transformation time at the time of interest
-      /// @param deps, nutation of the obliquity (output) in radians
-      /// @param dpsi, nutation of the longitude (output) in radians
-      static void NutationAngles2003(double T, double& deps, double& dpsi)
-         throw();
-
-      //------------------------------------------------------------------------------
-      /// Nutation of the obliquity (deps) and of the longitude (dpsi), IERS 2010
-      /// @param T,    the coordinate transformation time at the time of interest
-      /// @param deps, nutation of the obliquity (output) in radians
-      /// @param dpsi, nutation of the longitude (output) in radians
-      static void NutationAngles2010(double T, double& deps, double& dpsi)
-         throw();
-
       //------------------------------------------------------------------------------
       /// nutation matrix, a 3x3 rotation matrix, given
       /// @param eps, Obliquity(T), the obliquity of the ecliptic, in radians,
@@ -0,0 +1,452 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file EarthOrientationCache.cpp
+/// class EarthOrientationCache tabulates, on a grid in time, the parts of the
+/// terrestrial-to-celestial transformation of class EarthOrientation that depend
+/// only on time, and interpolates them.
+
+//------------------------------------------------------------------------------------
+// system includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+// GPSTk
+#include "Matrix.hpp"
+
+#include "EarthOrientationCache.hpp"
+
+//------------------------------------------------------------------------------------
+using namespace std;
+
+namespace gpstk
+{
+   //---------------------------------------------------------------------------------
+   // 3x3 rotation about axis (1,2,3) by angle radians; cf. rotation() for Matrix
+   static SmallMatrix<double,3,3> rotate(double angle, int axis) throw()
+   {
+      SmallMatrix<double,3,3> R;
+      int i1(axis-1), i2((i1+1)%3), i3((i2+1)%3);
+      R(i1,i1) = 1.0;
+      R(i2,i2) = R(i3,i3) = ::cos(angle);
+      R(i3,i2) = -(R(i2,i3) = ::sin(angle));
+      return R;
+   }
+
+   //---------------------------------------------------------------------------------
+   // precession-nutation-bias matrix from the pole coordinates X,Y and the origin
+   // angle s; cf. sofa c2ixys, and EarthOrientation::ECEFtoInertial2010()
+   static SmallMatrix<double,3,3> poleMatrix(double X, double Y, double s) throw()
+   {
+      double r2(X*X+Y*Y);                          // squared radius
+      double e(r2 != 0.0 ? ::atan2(Y, X) : 0.0);   // spherical angles
+      double d(::atan(::sqrt(r2/(1.0-r2))));       //
+      return rotate(-(e+s),3) * rotate(d,2) * rotate(e,3);
+   }
+
+   //---------------------------------------------------------------------------------
+   // angle s such that poleMatrix(Q(2,0),Q(2,1),s) == Q for the rotation Q;
+   // cf. sofa eors, and EarthOrientation::GAST2010()
+   static double originAngle(const Matrix<double>& Q) throw()
+   {
+      double X(Q(2,0)), Y(Q(2,1));
+      double ax(X / (1.0 + Q(2,2)));
+      double xs(1.0 - ax * X), ys(-ax * Y), zs(-X);
+      double p(Q(0,0)*xs + Q(0,1)*ys + Q(0,2)*zs);
+      double q(Q(1,0)*xs + Q(1,1)*ys + Q(1,2)*zs);
+      return ((p != 0) || (q != 0)) ? ::atan2(q,p) : 0.0;
+   }
+
+   //---------------------------------------------------------------------------------
+   // barycentric weights for Lagrange interpolation on n evenly spaced nodes:
+   // w[j] = (-1)^j * binomial(n-1,j)
+   static void lagrangeWeights(int n, double w[]) throw()
+   {
+      w[0] = 1.0;
+      for(int j=1; j<n; j++)
+         w[j] = -w[j-1] * double(n-j) / double(j);
+   }
+
+   //---------------------------------------------------------------------------------
+   EarthOrientationCache::EarthOrientationCache(IERSConvention conv) throw()
+      : convention(conv), step(0.25), stepT(0.25/36525.0), order(10),
+        tolerance(1.e-12), maxError(0.0), ndirect(0)
+   {
+      lagrangeWeights(order, weight);
+   }
+
+   //---------------------------------------------------------------------------------
+   EarthOrientationCache::EarthOrientationCache(const EarthOrientationCache& right)
+      throw()
+      : convention(right.convention), step(right.step), stepT(right.stepT),
+        order(right.order), tolerance(right.tolerance), maxError(0.0), ndirect(0)
+   {
+      lagrangeWeights(order, weight);
+   }
+
+   //---------------------------------------------------------------------------------
+   EarthOrientationCache& EarthOrientationCache::operator=(
+                                       const EarthOrientationCache& right) throw()
+   {
+      if(this == &right) return *this;
+      clear();
+      convention = right.convention;
+      step = right.step;
+      stepT = right.stepT;
+      order = right.order;
+      tolerance = right.tolerance;
+      lagrangeWeights(order, weight);
+      return *this;
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthOrientationCache::setConvention(IERSConvention conv) throw()
+   {
+      clear();
+      convention = conv;
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthOrientationCache::setInterpolation(double st, int n, double tol)
+      throw(Exception)
+   {
+      if(st <= 0.0 || st > 2.0 || n < 2 || n > MAXORDER || n % 2 != 0
+                                                         || !(tol > 0.0)) {
+         Exception e("Invalid EarthOrientationCache interpolation parameters");
+         GPSTK_THROW(e);
+      }
+      clear();
+      step = st;
+      stepT = st/36525.0;
+      order = n;
+      tolerance = tol;
+      lagrangeWeights(order, weight);
+   }
+
+   //---------------------------------------------------------------------------------
+   double EarthOrientationCache::getMaxError(void) const throw()
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      return maxError;
+   }
+
+   //---------------------------------------------------------------------------------
+   int EarthOrientationCache::size(void) const throw()
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      return intervals.size();
+   }
+
+   //---------------------------------------------------------------------------------
+   int EarthOrientationCache::numDirect(void) const throw()
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      return ndirect;
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthOrientationCache::clear(void) throw()
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      nodes.clear();
+      intervals.clear();
+      maxError = 0.0;
+      ndirect = 0;
+   }
+
+   //---------------------------------------------------------------------------------
+   SmallMatrix<double,3,3> EarthOrientationCache::ECEFtoInertial(
+                        const EarthOrientation& eo, const EphTime& t, bool reduced)
+      throw(Exception)
+   {
+      try {
+         checkConvention(eo);
+
+         double T(EarthOrientation::CoordTransTime(t));
+         double q[NQ];
+         quantities(T,q);
+
+         double xp(eo.xp * EarthOrientation::ARCSEC_TO_RAD);
+         double yp(eo.yp * EarthOrientation::ARCSEC_TO_RAD);
+         SmallMatrix<double,3,3> W;
+         double theta;
+
+         if(convention == IERSConvention::IERS1996) {
+            // GAST = GMST + g; cf. ECEFtoInertial1996()
+            double UT1mUTC(eo.UT1mUTC);
+            if(reduced) {
+               double UT1mUT1R,dlodR,domegaR;
+               EarthOrientation::UT1mUTCTidalCorrections(T,UT1mUT1R,dlodR,domegaR);
+               UT1mUTC = UT1mUT1R - UT1mUTC;
+            }
+            theta = EarthOrientation::GMST1996(t,UT1mUTC,false) + q[3];
+            W = rotate(-xp,2) * rotate(-yp,1);
+         }
+         else {
+            // ERA; cf. ECEFtoInertial2003(), ECEFtoInertial2010()
+            theta = EarthOrientation::EarthRotationAngle(t,eo.UT1mUTC);
+            W = rotate(-yp,1) * rotate(-xp,2)
+                              * rotate(EarthOrientation::Sprime(T),3);
+         }
+
+         return transpose(W * rotate(theta,3) * poleMatrix(q[0],q[1],q[2]));
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   double EarthOrientationCache::GAST(const EarthOrientation& eo,
+                                      const EphTime& t, bool reduced)
+      throw(Exception)
+   {
+      try {
+         checkConvention(eo);
+
+         double T(EarthOrientation::CoordTransTime(t));
+         double q[NQ];
+         quantities(T,q);
+
+         if(convention == IERSConvention::IERS1996) {
+            // cf. GAST1996()
+            double UT1mUTC(eo.UT1mUTC);
+            if(reduced) {
+               double UT1mUT1R,dlodR,domegaR;
+               EarthOrientation::UT1mUTCTidalCorrections(T,UT1mUT1R,dlodR,domegaR);
+               UT1mUTC = UT1mUT1R - UT1mUTC;
+            }
+            return EarthOrientation::GMST1996(t,UT1mUTC,false) + q[3];
+         }
+
+         // cf. GAST2003(), GAST2010()
+         return ::fmod(EarthOrientation::EarthRotationAngle(t,eo.UT1mUTC) + q[3],
+                       EarthOrientation::TWOPI);
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthOrientationCache::PoleCoordinates(const EphTime& t,
+                                               double& X, double& Y, double& s)
+      throw(Exception)
+   {
+      try {
+         double q[NQ];
+         quantities(EarthOrientation::CoordTransTime(t),q);
+         X = q[0];
+         Y = q[1];
+         s = q[2];
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   // private functions
+   //---------------------------------------------------------------------------------
+
+   //---------------------------------------------------------------------------------
+   // Compute X,Y,s and g from the series of EarthOrientation, just as
+   // ECEFtoInertial and GAST do for the convention.
+   void EarthOrientationCache::series(double T, double q[NQ]) const
+      throw(Exception)
+   {
+      typedef EarthOrientation EO;
+
+      if(convention == IERSConvention::IERS1996) {
+         // cf. ECEFtoInertial1996() and gast1996()
+         double eps(EO::Obliquity1996(T)),deps,dpsi,om;
+         EO::NutationAngles1996(T,deps,dpsi,om);
+         Matrix<double> Q(EO::NutationMatrix(eps,dpsi,deps)
+                                                   * EO::PrecessionMatrix1996(T));
+         q[0] = Q(2,0);
+         q[1] = Q(2,1);
+         q[2] = originAngle(Q);
+         q[3] = dpsi * ::cos(eps)
+               + (0.00264 * ::sin(om) + 0.000063 * ::sin(2.0*om)) * EO::ARCSEC_TO_RAD;
+      }
+      else if(convention == IERSConvention::IERS2003) {
+         // cf. ECEFtoInertial2003(), GMST2003() and GAST2003()
+         double deps,dpsi,dpsipr,depspr;
+         EO::NutationAngles2003(T,deps,dpsi);
+         EO::PrecessionRateCorrections2003(T,dpsipr,depspr);
+         double eps(EO::Obliquity1996(T) + depspr);
+         Matrix<double> Q(EO::NutationMatrix(eps,dpsi,deps)
+                                                   * EO::PrecessionMatrix2003(T));
+         q[0] = Q(2,0);
+         q[1] = Q(2,1);
+         q[2] = originAngle(Q);
+         q[3] = (0.014506 + (4612.15739966 + (1.39667721 + (-0.00009344
+                         + 0.00001882*T)*T)*T)*T)*EO::ARCSEC_TO_RAD
+               + dpsi * ::cos(eps) + EO::EquationOfEquinoxes2003(T);
+      }
+      else if(convention == IERSConvention::IERS2010) {
+         // cf. ECEFtoInertial2010()
+         double X,Y;
+         EO::XYCIO(T,X,Y);
+         q[0] = X;
+         q[1] = Y;
+         q[2] = EO::S(T,X,Y,IERSConvention::IERS2010);
+
+         // g = -(equation of the origins); cf. GAST2010()
+         Matrix<double> NPB(EO::PreciseEarthRotation2010(T));
+         X = NPB(2,0);
+         Y = NPB(2,1);
+         q[3] = originAngle(NPB) - EO::S(T,X,Y,IERSConvention::IERS2010);
+      }
+      else {
+         Exception e("IERS convention is not defined");
+         GPSTK_THROW(e);
+      }
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthOrientationCache::quantities(double T, double q[NQ])
+      throw(Exception)
+   {
+      try {
+         double u(T/stepT), fk(::floor(u));
+         long k = long(fk);
+         Interval iv;
+
+         bool found(false);
+         {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::map<long, Interval>::const_iterator it = intervals.find(k);
+            if(it != intervals.end()) {
+               iv.direct = it->second.direct;
+               if(!iv.direct)
+                  memcpy(iv.q, it->second.q, order*sizeof(iv.q[0]));
+               found = true;
+            }
+         }
+         if(!found) build(k, iv);
+
+         if(iv.direct)
+            series(T,q);
+         else
+            interpolate(iv.q, u-fk, q);
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   // Lagrange interpolation in barycentric form; node j is at j-(order/2-1)
+   // relative to the start of the interval.
+   void EarthOrientationCache::interpolate(const double nq[][NQ], double x,
+                                           double q[NQ]) const throw()
+   {
+      int i,j;
+      const int j0(order/2-1);
+
+      if(x == 0.0) {
+         for(i=0; i<NQ; i++) q[i] = nq[j0][i];
+         return;
+      }
+
+      double sum(0.0);
+      for(i=0; i<NQ; i++) q[i] = 0.0;
+      for(j=0; j<order; j++) {
+         double c(weight[j] / (x + double(j0 - j)));
+         sum += c;
+         for(i=0; i<NQ; i++) q[i] += c * nq[j][i];
+      }
+      for(i=0; i<NQ; i++) q[i] /= sum;
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthOrientationCache::build(long k, Interval& iv)
+      throw(Exception)
+   {
+      try {
+         int i,j;
+         const long kfirst(k - order/2 + 1);
+         bool have[MAXORDER];
+
+         // copy the nodes already computed
+         {
+            std::lock_guard<std::mutex> lock(mutex);
+            for(j=0; j<order; j++) {
+               std::map<long, Node>::const_iterator it = nodes.find(kfirst+j);
+               have[j] = (it != nodes.end());
+               if(have[j]) memcpy(iv.q[j], it->second.q, sizeof(iv.q[j]));
+            }
+         }
+
+         // compute the others, and check the center of the interval
+         for(j=0; j<order; j++)
+            if(!have[j]) series(double(kfirst+j)*stepT, iv.q[j]);
+
+         double qs[NQ],qi[NQ],err(0.0);
+         series((double(k)+0.5)*stepT, qs);
+         interpolate(iv.q, 0.5, qi);
+         for(i=0; i<NQ; i++)
+            err = std::max(err, ::fabs(qi[i]-qs[i]));
+         iv.direct = (err > tolerance);
+
+         // store; the lock was released while the series were evaluated, so
+         // another call may have built nodes or this interval meanwhile, and
+         // insert() keeps those, leaving maxError and ndirect counted once
+         std::lock_guard<std::mutex> lock(mutex);
+         for(j=0; j<order; j++) {
+            if(have[j]) continue;
+            Node node;
+            memcpy(node.q, iv.q[j], sizeof(node.q));
+            nodes.insert(std::make_pair(kfirst+j, node));
+         }
+         if(intervals.insert(std::make_pair(k, iv)).second) {
+            if(iv.direct) ndirect++;
+            else if(err > maxError) maxError = err;
+         }
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------------
+   void EarthOrientationCache::checkConvention(const EarthOrientation& eo) const
+      throw(Exception)
+   {
+      if(convention == IERSConvention::NONE) {
+         Exception e("IERS convention is not defined");
+         GPSTK_THROW(e);
+      }
+      if(eo.convention != convention) {
+         Exception e("EarthOrientation convention " + eo.convention.asString()
+                     + " differs from EarthOrientationCache convention "
+                     + convention.asString());
+         GPSTK_THROW(e);
+      }
+   }
+
+} // end namespace gpstk
@@ -0,0 +1,254 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file EarthOrientationCache.hpp
+/// class EarthOrientationCache tabulates, on a grid in time, the parts of the
+/// terrestrial-to-celestial transformation of class EarthOrientation that depend
+/// only on time, and interpolates them, so that the nutation and CIO series need
+/// not be evaluated at every epoch.
+
+#ifndef CLASS_EARTHORIENTCACHE_INCLUDE
+#define CLASS_EARTHORIENTCACHE_INCLUDE
+
+//------------------------------------------------------------------------------------
+// system includes
+#include <map>
+#include <mutex>
+// GPSTk
+#include "Exception.hpp"
+#include "SmallMatrix.hpp"
+// geomatics
+#include "EphTime.hpp"
+#include "IERSConvention.hpp"
+#include "EarthOrientation.hpp"
+
+//------------------------------------------------------------------------------------
+namespace gpstk {
+
+   /// class EarthOrientationCache replaces the series evaluations in
+   /// EarthOrientation::ECEFtoInertial() and GAST() with interpolation in a table.
+   /// The transformation is written as
+   ///    ECEFtoInertial = transpose(W * R3(theta) * Q)
+   /// where W is the polar motion matrix and theta the Earth rotation angle (ERA,
+   /// IERS2003 and IERS2010) or GAST (IERS1996); these depend on the EOPs and are
+   /// cheap, and are computed at every call. Q, the precession-nutation-bias matrix,
+   /// depends only on the time and is expensive; it is stored as the coordinates
+   /// X,Y of the celestial pole and an angle s giving the origin on the equator of
+   /// the pole (the CIO locator for IERS2010), so that
+   ///    Q = R3(-(E+s)) * R2(d) * R3(E), E = atan2(Y,X), d = asin(sqrt(X*X+Y*Y)).
+   /// A fourth quantity g, with GAST = ERA + g (IERS2003, IERS2010) or
+   /// GAST = GMST + g (IERS1996), is stored for GAST().
+   ///
+   /// The four quantities are computed from the series of EarthOrientation at nodes
+   /// spaced evenly in the coordinate transformation time T, and interpolated by
+   /// Lagrange interpolation over the nodes centered on the interval that contains
+   /// the time of interest. Nodes and intervals are filled in as they are needed.
+   /// The first time an interval is used, the interpolated quantities at its center,
+   /// where the interpolation error is largest, are compared to the series; if any
+   /// differs by more than the tolerance, the interval is marked and the series are
+   /// used for every time within it. The endpoints of an interval are nodes, and
+   /// the error of interpolation over nodes centered on the interval is largest
+   /// at its center as long as the derivatives of the series vary little over the
+   /// nodes, which the periods of the terms, days and longer, ensure. Thus the
+   /// tolerance bounds the error of each quantity at any time, apart from rounding.
+   ///
+   /// Results are returned as fixed-size SmallMatrix<double,3,3>, which do not
+   /// allocate. The public functions may be called from several threads.
+   class EarthOrientationCache
+   {
+   public:
+      /// Constructor
+      /// @param conv IERS convention of the EarthOrientation objects to be used
+      EarthOrientationCache(IERSConvention conv=IERSConvention::IERS2010) throw();
+
+      /// Copy constructor; the copy starts with an empty table
+      EarthOrientationCache(const EarthOrientationCache& right) throw();
+
+      /// Assignment; the table is cleared
+      EarthOrientationCache& operator=(const EarthOrientationCache& right) throw();
+
+      /// Choose the IERS convention; the table is cleared.
+      void setConvention(IERSConvention conv) throw();
+
+      /// Get the IERS convention.
+      IERSConvention getConvention(void) const throw()
+         { return convention; }
+
+      /// Choose the grid and the tolerance; the table is cleared.
+      /// @param step spacing of the nodes in days, 0 < step <= 2
+      /// @param order number of nodes used in the interpolation, even, 2 to 16
+      /// @param tol largest allowed interpolation error, in radians
+      /// @throw Exception if a parameter is out of range
+      void setInterpolation(double step, int order, double tol)
+         throw(Exception);
+
+      /// Get the spacing of the nodes in days.
+      double getStep(void) const throw()
+         { return step; }
+
+      /// Get the number of nodes used in the interpolation.
+      int getOrder(void) const throw()
+         { return order; }
+
+      /// Get the tolerance in radians.
+      double getTolerance(void) const throw()
+         { return tolerance; }
+
+      /// Get the largest difference, in radians, between the cache and the series,
+      /// as found in the check of each interval that passed the check.
+      double getMaxError(void) const throw();
+
+      /// Get the number of intervals in the table.
+      int size(void) const throw();
+
+      /// Get the number of intervals in the table that failed the check, and in
+      /// which the series are used.
+      int numDirect(void) const throw();
+
+      /// Empty the table.
+      void clear(void) throw();
+
+      /// Generate the full transformation matrix (3x3 rotation) relating the ECEF
+      /// frame to the conventional inertial frame; the same as
+      /// eo.ECEFtoInertial(t,reduced) to within the tolerance.
+      /// @param eo EarthOrientation with the EOPs at t; its convention must match
+      /// @param t EphTime epoch of the rotation
+      /// @param reduced, bool true when UT1mUTC is 'reduced', meaning assumes
+      ///                 'no tides', as is the case with the NGA EOPs (default=F).
+      /// @return 3x3 rotation matrix
+      /// @throw if the conventions differ or are not defined
+      /// @throw if the TimeSystem conversion fails (if TimeSystem is Unknown)
+      SmallMatrix<double,3,3> ECEFtoInertial(const EarthOrientation& eo,
+                                             const EphTime& t, bool reduced=false)
+         throw(Exception);
+
+      /// Compute Greenwich Apparent Sidereal Time in radians; the same as
+      /// eo.GAST(t,reduced) to within the tolerance.
+      /// @param eo EarthOrientation with the EOPs at t; its convention must match
+      /// @param t EphTime epoch of interest
+      /// @param reduced, bool true when UT1mUTC is 'reduced' (IERS1996 only)
+      /// @return GAST in radians
+      /// @throw if the conventions differ or are not defined
+      /// @throw if the TimeSystem conversion fails (if TimeSystem is Unknown)
+      double GAST(const EarthOrientation& eo, const EphTime& t, bool reduced=false)
+         throw(Exception);
+
+      /// Get the interpolated coordinates of the celestial pole and the angle
+      /// of the origin, all in radians; cf. the class description.
+      /// @param t EphTime epoch of interest
+      /// @param X x coordinate of the pole
+      /// @param Y y coordinate of the pole
+      /// @param s angle giving the origin on the equator; for IERS2010 this is
+      ///          the CIO locator s
+      /// @throw if the convention is not defined
+      /// @throw if the TimeSystem conversion fails (if TimeSystem is Unknown)
+      void PoleCoordinates(const EphTime& t, double& X, double& Y, double& s)
+         throw(Exception);
+
+   private:
+      /// number of quantities stored at each node: X, Y, s and g
+      static const int NQ = 4;
+
+      /// largest number of nodes in the interpolation
+      static const int MAXORDER = 16;
+
+      /// the quantities at one node
+      struct Node {
+         double q[NQ];
+      };
+
+      /// the nodes used by one interval, or none if the series are used
+      struct Interval {
+         bool direct;
+         double q[MAXORDER][NQ];
+      };
+
+      /// Compute the quantities X,Y,s,g from the series at T.
+      void series(double T, double q[NQ]) const throw(Exception);
+
+      /// Compute the quantities at T, by interpolation or from the series.
+      void quantities(double T, double q[NQ]) throw(Exception);
+
+      /// Interpolate the nodes of an interval at fraction x of it, 0 <= x < 1.
+      void interpolate(const double nq[][NQ], double x, double q[NQ]) const throw();
+
+      /// Fill interval k, computing any nodes it needs from the series, check it,
+      /// and store it and the nodes; the lock must not be held.
+      /// @param k index of the interval
+      /// @param iv the interval, as stored
+      void build(long k, Interval& iv) throw(Exception);
+
+      /// Throw if eo does not use the convention of the cache.
+      void checkConvention(const EarthOrientation& eo) const throw(Exception);
+
+      /// IERS convention
+      IERSConvention convention;
+
+      /// spacing of the nodes in days
+      double step;
+
+      /// spacing of the nodes in T (centuries)
+      double stepT;
+
+      /// number of nodes in the interpolation
+      int order;
+
+      /// tolerance in radians
+      double tolerance;
+
+      /// barycentric weights of the Lagrange interpolation
+      double weight[MAXORDER];
+
+      /// nodes, key = index k with T = k*stepT
+      std::map<long, Node> nodes;
+
+      /// intervals, key = index k of the interval [k*stepT, (k+1)*stepT)
+      std::map<long, Interval> intervals;
+
+      /// largest error found in the intervals that passed the check
+      double maxError;
+
+      /// number of intervals that failed the check
+      int ndirect;
+
+      /// guards the nodes, the intervals and the statistics
+      mutable std::mutex mutex;
+
+   }; // end class EarthOrientationCache
+
+}  // end namespace gpstk
+
+#endif // CLASS_EARTHORIENTCACHE_INCLUDE
@@ -0,0 +1,428 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file NutationSeries.cpp
+/// class NutationSeries evaluates the IERS 2003/2010 nutation series and the
+/// IERS 2010 CIO series of class EarthOrientation at many epochs at once.
+
+//------------------------------------------------------------------------------------
+// system includes
+#include <cmath>
+#include <cstdlib>
+// geomatics
+#include "EarthOrientation.hpp"
+
+#include "NutationSeries.hpp"
+
+//------------------------------------------------------------------------------------
+using namespace std;
+
+namespace gpstk
+{
+   // number of epochs in a block
+   static const int NB = NutationSeries::BLOCK;
+
+   //---------------------------------------------------------------------------------
+   // A series of terms a * T^p * sin(arg) or a * T^p * cos(arg), where
+   // arg = sum over k of n_k * A_k for fundamental arguments A_k, and the terms
+   // that share an argument may contribute to different outputs. Each argument is
+   // stored as its list of non-zero multipliers n_k, and each term as its output,
+   // sin or cos, power p and amplitude a, all in parallel arrays.
+   class TrigSeries
+   {
+   public:
+      // Constructor, for series in nargs fundamental arguments
+      TrigSeries(int nargs) : maxmul(nargs,0), hoff(nargs+1,0)
+         { mulbeg.push_back(0); }
+
+      // Start a new argument, given its nargs multipliers.
+      void addArgument(const int mul[]) throw()
+      {
+         for(size_t k=0; k<maxmul.size(); k++) {
+            if(mul[k] == 0) continue;
+            mulk.push_back(k);
+            muln.push_back(mul[k]);
+            if(::abs(mul[k]) > maxmul[k]) maxmul[k] = ::abs(mul[k]);
+         }
+         mulbeg.push_back(mulk.size());
+         ampbeg.push_back(ampa.size());
+      }
+
+      // Add a term a * T^p * (cosine ? cos : sin)(arg) of the last argument to
+      // output out; zero amplitudes are dropped.
+      void addTerm(int out, bool cosine, int p, double a) throw()
+      {
+         if(a == 0.0) return;
+         ampout.push_back(out);
+         ampcos.push_back(cosine);
+         amppow.push_back(p);
+         ampa.push_back(a);
+      }
+
+      // Call after the last term; fixes the layout of the harmonics.
+      void finish() throw()
+      {
+         ampbeg.push_back(ampa.size());
+         for(size_t k=0; k<maxmul.size(); k++)
+            hoff[k+1] = hoff[k] + maxmul[k] + 1;
+      }
+
+      // Number of doubles needed for the harmonics of a block of epochs.
+      size_t workSize() const throw()
+         { return NB * hoff.back(); }
+
+      // Add the series, for a block of epochs, to out[output][epoch].
+      // @param fa fundamental arguments fa[k][epoch], radians
+      // @param powT powers of T, powT[p][epoch]
+      // @param out outputs, to which the series is added
+      // @param hc,hs workspace of workSize() doubles each
+      void evaluate(const double fa[][NB], const double powT[][NB],
+                    double out[][NB], double *hc, double *hs) const throw()
+      {
+         int e;
+         size_t i,j,k;
+
+         // cos and sin of m*A_k, m=0..maxmul[k], by angle addition
+         for(k=0; k<maxmul.size(); k++) {
+            double *c(hc + NB*hoff[k]), *s(hs + NB*hoff[k]);
+            for(e=0; e<NB; e++) { c[e] = 1.0; s[e] = 0.0; }
+            if(maxmul[k] == 0) continue;
+            double c1[NB],s1[NB];
+            for(e=0; e<NB; e++) { c1[e] = ::cos(fa[k][e]); s1[e] = ::sin(fa[k][e]); }
+            for(int m=1; m<=maxmul[k]; m++) {
+               c += NB; s += NB;
+               for(e=0; e<NB; e++) {
+                  c[e] = c[e-NB]*c1[e] - s[e-NB]*s1[e];
+                  s[e] = s[e-NB]*c1[e] + c[e-NB]*s1[e];
+               }
+            }
+         }
+
+         // each argument, as the product of exp(i*n_k*A_k)
+         double re[NB],im[NB];
+         for(i=0; i+1<mulbeg.size(); i++) {
+            for(e=0; e<NB; e++) { re[e] = 1.0; im[e] = 0.0; }
+            for(j=mulbeg[i]; j<mulbeg[i+1]; j++) {
+               const int n(muln[j]);
+               const double *c(hc + NB*(hoff[mulk[j]] + ::abs(n)));
+               const double *s(hs + NB*(hoff[mulk[j]] + ::abs(n)));
+               const double sg(n < 0 ? -1.0 : 1.0);
+               for(e=0; e<NB; e++) {
+                  double r(re[e]*c[e] - sg*im[e]*s[e]);
+                  im[e] = sg*re[e]*s[e] + im[e]*c[e];
+                  re[e] = r;
+               }
+            }
+
+            // the terms with this argument
+            for(j=ampbeg[i]; j<ampbeg[i+1]; j++) {
+               const double a(ampa[j]);
+               const double *sc(ampcos[j] ? re : im);
+               const double *p(powT[amppow[j]]);
+               double *o(out[ampout[j]]);
+               for(e=0; e<NB; e++) o[e] += a * sc[e] * p[e];
+            }
+         }
+      }
+
+   private:
+      std::vector<int> maxmul;      // largest |n_k| for each k
+      std::vector<size_t> hoff;     // offset of the harmonics of A_k, in blocks
+      std::vector<size_t> mulbeg;   // multipliers of argument i: [mulbeg[i],mulbeg[i+1])
+      std::vector<int> mulk, muln;  // index k and value n_k of the multipliers
+      std::vector<size_t> ampbeg;   // terms of argument i: [ampbeg[i],ampbeg[i+1])
+      std::vector<int> ampout;      // output of each term
+      std::vector<bool> ampcos;     // cos (true) or sin (false)
+      std::vector<int> amppow;      // power of T
+      std::vector<double> ampa;     // amplitude
+   };
+
+   //---------------------------------------------------------------------------------
+   // the IAU 2000A nutation series, from the tables of
+   // EarthOrientation::NutationAngles2003(); outputs 0 = deps, 1 = dpsi, in units
+   // of 0.1 microarcsec
+   struct NutationTables
+   {
+      TrigSeries lunisolar, planetary;
+
+      NutationTables() : lunisolar(5), planetary(13)
+      {
+         #include "IERS2003NutationData.hpp"
+
+         int i;
+         for(i=0; i<NLS; i++) {
+            const int mul[5] = { LSCoeff[i].nl, LSCoeff[i].nlp, LSCoeff[i].nf,
+                                 LSCoeff[i].nd, LSCoeff[i].nom };
+            lunisolar.addArgument(mul);
+            lunisolar.addTerm(0, true,  0, LSCoeff[i].ce);
+            lunisolar.addTerm(0, true,  1, LSCoeff[i].cet);
+            lunisolar.addTerm(0, false, 0, LSCoeff[i].se);
+            lunisolar.addTerm(1, false, 0, LSCoeff[i].sp);
+            lunisolar.addTerm(1, false, 1, LSCoeff[i].spt);
+            lunisolar.addTerm(1, true,  0, LSCoeff[i].cp);
+         }
+         lunisolar.finish();
+
+         for(i=0; i<NP; i++) {
+            const int mul[13] = { PCoeff[i].nl, PCoeff[i].nf, PCoeff[i].nd,
+                                  PCoeff[i].nom, PCoeff[i].nme, PCoeff[i].nve,
+                                  PCoeff[i].nea, PCoeff[i].nma, PCoeff[i].nju,
+                                  PCoeff[i].nsa, PCoeff[i].nur, PCoeff[i].nne,
+                                  PCoeff[i].npa };
+            planetary.addArgument(mul);
+            planetary.addTerm(0, true,  0, PCoeff[i].ce);
+            planetary.addTerm(0, false, 0, PCoeff[i].se);
+            planetary.addTerm(1, false, 0, PCoeff[i].sp);
+            planetary.addTerm(1, true,  0, PCoeff[i].cp);
+         }
+         planetary.finish();
+      }
+   };
+
+   //---------------------------------------------------------------------------------
+   // the IAU 2006/2000A series for the CIP, from the tables of
+   // EarthOrientation::XYCIO(); outputs 0 = X, 1 = Y, in microarcsec
+   struct CIOTables
+   {
+      TrigSeries lunisolar, planetary;
+      double poly[2][6];            // polynomial part, arcsec
+
+      CIOTables() : lunisolar(5), planetary(14)
+      {
+         #include "IERS2010CIOSeriesData.hpp"
+
+         int i,j,f;
+         for(i=0; i<2; i++)
+            for(j=0; j<=MAXPT; j++)
+               poly[i][j] = XYcoeff[i][j];
+
+         // amplitudes of frequency f are amp[i-1], i = iamp[f] .. iamp[f+1]-1
+         for(f=0; f<NFALS+NFAP; f++) {
+            TrigSeries& ts(f < NFALS ? lunisolar : planetary);
+            ts.addArgument(f < NFALS ? nFAlunarsolar[f] : nFAplanetary[f-NFALS]);
+            int iend(f+1 < NFALS+NFAP ? iamp[f+1] : NAmp+1);
+            for(i=iamp[f]; i<iend; i++) {
+               j = i - iamp[f];
+               ts.addTerm(jaxy[j], jasc[j] == 1, japt[j], amp[i-1]);
+            }
+         }
+         lunisolar.finish();
+         planetary.finish();
+      }
+   };
+
+   //---------------------------------------------------------------------------------
+   // The tables are built on first use.
+   static const NutationTables& nutationTables(void) throw()
+   {
+      static const NutationTables tables;
+      return tables;
+   }
+
+   static const CIOTables& cioTables(void) throw()
+   {
+      static const CIOTables tables;
+      return tables;
+   }
+
+   //---------------------------------------------------------------------------------
+   // Copy block b of T into Tb, padding a short last block with its last epoch;
+   // return the number of epochs in the block.
+   static int getBlock(const std::vector<double>& T, size_t b, double Tb[NB])
+      throw()
+   {
+      int e, ne(int(std::min(size_t(NB), T.size()-b*NB)));
+      for(e=0; e<NB; e++)
+         Tb[e] = T[b*NB + (e < ne ? e : ne-1)];
+      return ne;
+   }
+
+   //---------------------------------------------------------------------------------
+   void NutationSeries::NutationAngles2003(const std::vector<double>& T,
+                                           std::vector<double>& deps,
+                                           std::vector<double>& dpsi)
+      throw()
+   {
+      typedef EarthOrientation EO;
+      const double ARCSEC_TO_RAD(EO::ARCSEC_TO_RAD);
+      const double ARCSEC_PER_CIRCLE(EO::ARCSEC_PER_CIRCLE);
+      const double TWOPI(EO::TWOPI);
+      // sin and cos coefficients have units 0.1 microarcsec = 1e-7as
+      const double COEFF_TO_RAD(ARCSEC_TO_RAD*1.0e-7);
+
+      const NutationTables& tab(nutationTables());
+      std::vector<double> hc(std::max(tab.lunisolar.workSize(),
+                                      tab.planetary.workSize()));
+      std::vector<double> hs(hc.size());
+
+      deps.resize(T.size());
+      dpsi.resize(T.size());
+
+      int e;
+      double Tb[NB], powT[2][NB], fa[13][NB], out[2][NB];
+      for(size_t b=0; b*NB<T.size(); b++) {
+         int ne(getBlock(T,b,Tb));
+         for(e=0; e<NB; e++) {
+            powT[0][e] = 1.0;
+            powT[1][e] = Tb[e];
+            out[0][e] = out[1][e] = 0.0;
+         }
+
+         // Lunar-Solar nutation; arguments as in EarthOrientation
+         for(e=0; e<NB; e++) {
+            const double t(Tb[e]);
+            fa[0][e] = EO::L(t);          // mean anomaly of the moon
+            fa[1][e] = ::fmod(  1287104.79305    // mean anomaly of the sun MHB2000
+                        + t*(129596581.0481
+                        + t*(       -0.5532
+                        + t*(        0.000136
+                        + t*(       -0.00001149)))), ARCSEC_PER_CIRCLE) * ARCSEC_TO_RAD;
+            fa[2][e] = ::fmod(    335779.526232  // mean longitude of moon - Omega
+                        + t*(1739527262.8478
+                        + t*(       -12.7512
+                        + t*(        -0.001037
+                        + t*(         0.00000417)))), ARCSEC_PER_CIRCLE) * ARCSEC_TO_RAD;
+            fa[3][e] = ::fmod(   1072260.70369   // mean elongation moon from sun
+                        + t*(1602961601.2090
+                        + t*(        -6.3706
+                        + t*(         0.006593
+                        + t*(        -0.00003169)))), ARCSEC_PER_CIRCLE) * ARCSEC_TO_RAD;
+            fa[4][e] = EO::Omega2003(t);  // mean longitude of lunar ascending node
+         }
+         tab.lunisolar.evaluate(fa, powT, out, &hc[0], &hs[0]);
+
+         // Planetary nutation; MHB2000 arguments as in EarthOrientation
+         for(e=0; e<NB; e++) {
+            const double t(Tb[e]);
+            fa[0][e] = ::fmod(2.35555598 + 8328.6914269554 * t, TWOPI);
+            fa[1][e] = ::fmod(1.627905234 + 8433.466158131 * t, TWOPI);
+            fa[2][e] = ::fmod(5.198466741 + 7771.3771468121 * t, TWOPI);
+            fa[3][e] = ::fmod(2.18243920 - 33.757045 * t, TWOPI);
+            fa[4][e] = EO::LMe(t);
+            fa[5][e] = EO::LV(t);
+            fa[6][e] = EO::LE(t);
+            fa[7][e] = EO::LMa(t);
+            fa[8][e] = EO::LJ(t);
+            fa[9][e] = EO::LS(t);
+            fa[10][e] = EO::LU(t);
+            fa[11][e] = ::fmod(5.321159000 + 3.8127774000 * t, TWOPI);
+            fa[12][e] = EO::Pa(t);
+         }
+         tab.planetary.evaluate(fa, powT, out, &hc[0], &hs[0]);
+
+         for(e=0; e<ne; e++) {
+            deps[b*NB+e] = out[0][e] * COEFF_TO_RAD;
+            dpsi[b*NB+e] = out[1][e] * COEFF_TO_RAD;
+         }
+      }
+   }
+
+   //---------------------------------------------------------------------------------
+   void NutationSeries::NutationAngles2010(const std::vector<double>& T,
+                                           std::vector<double>& deps,
+                                           std::vector<double>& dpsi)
+      throw()
+   {
+      NutationAngles2003(T,deps,dpsi);
+      for(size_t i=0; i<T.size(); i++) {
+         double fj2(-2.7774e-6 * T[i]);
+         dpsi[i] *= (1.0+0.4697e-6 + fj2);
+         deps[i] *= (1.0+fj2);
+      }
+   }
+
+   //---------------------------------------------------------------------------------
+   void NutationSeries::XYCIO(const std::vector<double>& T,
+                              std::vector<double>& X, std::vector<double>& Y)
+      throw()
+   {
+      typedef EarthOrientation EO;
+      const double ARCSEC_TO_RAD(EO::ARCSEC_TO_RAD);
+
+      const CIOTables& tab(cioTables());
+      std::vector<double> hc(std::max(tab.lunisolar.workSize(),
+                                      tab.planetary.workSize()));
+      std::vector<double> hs(hc.size());
+
+      X.resize(T.size());
+      Y.resize(T.size());
+
+      int e,i,j;
+      double Tb[NB], powT[6][NB], fa[14][NB], out[2][NB];
+      for(size_t b=0; b*NB<T.size(); b++) {
+         int ne(getBlock(T,b,Tb));
+         for(e=0; e<NB; e++) {
+            powT[0][e] = 1.0;
+            for(j=1; j<6; j++) powT[j][e] = powT[j-1][e] * Tb[e];
+            out[0][e] = out[1][e] = 0.0;
+         }
+
+         // fundamental arguments, as in EarthOrientation::XYCIO()
+         for(e=0; e<NB; e++) {
+            const double t(Tb[e]);
+            fa[0][e] = EO::L(t);
+            fa[1][e] = EO::Lp(t);
+            fa[2][e] = EO::F(t);
+            fa[3][e] = EO::D(t);
+            fa[4][e] = EO::Omega2003(t);
+            fa[5][e] = EO::LMe(t);
+            fa[6][e] = EO::LV(t);
+            fa[7][e] = EO::LE(t);
+            fa[8][e] = EO::LMa(t);
+            fa[9][e] = EO::LJ(t);
+            fa[10][e] = EO::LS(t);
+            fa[11][e] = EO::LU(t);
+            fa[12][e] = EO::LN(t);
+            fa[13][e] = EO::Pa(t);
+         }
+         tab.lunisolar.evaluate(fa, powT, out, &hc[0], &hs[0]);
+         tab.planetary.evaluate(fa, powT, out, &hc[0], &hs[0]);
+
+         for(e=0; e<ne; e++) {
+            double xy[2];
+            for(i=0; i<2; i++) {
+               xy[i] = 0.0;
+               for(j=5; j>=0; j--)
+                  xy[i] += tab.poly[i][j] * powT[j][e];
+               xy[i] = (xy[i] + out[i][e]*1.e-6) * ARCSEC_TO_RAD;
+            }
+            X[b*NB+e] = xy[0];
+            Y[b*NB+e] = xy[1];
+         }
+      }
+   }
+
+} // end namespace gpstk
@@ -0,0 +1,106 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file NutationSeries.hpp
+/// class NutationSeries evaluates the IERS 2003/2010 nutation series and the
+/// IERS 2010 CIO series of class EarthOrientation at many epochs at once.
+
+#ifndef CLASS_NUTATIONSERIES_INCLUDE
+#define CLASS_NUTATIONSERIES_INCLUDE
+
+//------------------------------------------------------------------------------------
+// system includes
+#include <vector>
+
+//------------------------------------------------------------------------------------
+namespace gpstk {
+
+   /// class NutationSeries evaluates the nutation angles of the IAU 2000A model
+   /// (EarthOrientation::NutationAngles2003() and NutationAngles2010()) and the
+   /// coordinates X,Y of the CIP (EarthOrientation::XYCIO()) for a list of epochs.
+   /// The coefficient tables are the same, but are rearranged once, on first use,
+   /// into parallel arrays with the zero multipliers and amplitudes removed. The
+   /// epochs are processed in blocks; for each block the sine and cosine of every
+   /// multiple of each fundamental argument needed by the series are computed once
+   /// by the angle addition formulas, and the sine and cosine of the argument of
+   /// each term are formed as products of these, rather than calling sin() and
+   /// cos() for every term. Each step is a simple loop over the epochs of the
+   /// block that the compiler can vectorize.
+   ///
+   /// Results agree with the EarthOrientation functions to rounding, about 1e-18
+   /// radians; the test NutationSeries_T requires 1e-12 radians, and the timing is
+   /// in bench_nutation in apps/geomatics/iers_test. All functions are static and
+   /// may be called from several threads.
+   class NutationSeries
+   {
+   public:
+      /// Nutation of the obliquity (deps) and of the longitude (dpsi), IERS 2003
+      /// (IAU 2000A); cf. EarthOrientation::NutationAngles2003().
+      /// @param T coordinate transformation times of interest
+      /// @param deps nutation of the obliquity in radians, resized to T.size()
+      /// @param dpsi nutation of the longitude in radians, resized to T.size()
+      static void NutationAngles2003(const std::vector<double>& T,
+                                     std::vector<double>& deps,
+                                     std::vector<double>& dpsi)
+         throw();
+
+      /// Nutation of the obliquity (deps) and of the longitude (dpsi), IERS 2010
+      /// (IAU 2000A with P03 adjustments); cf. EarthOrientation::NutationAngles2010()
+      /// @param T coordinate transformation times of interest
+      /// @param deps nutation of the obliquity in radians, resized to T.size()
+      /// @param dpsi nutation of the longitude in radians, resized to T.size()
+      static void NutationAngles2010(const std::vector<double>& T,
+                                     std::vector<double>& deps,
+                                     std::vector<double>& dpsi)
+         throw();
+
+      /// Coordinates X,Y of the CIP from the IAU 2006/2000A series of IERS 2010;
+      /// cf. EarthOrientation::XYCIO().
+      /// @param T coordinate transformation times of interest
+      /// @param X x coordinate of the CIP in radians, resized to T.size()
+      /// @param Y y coordinate of the CIP in radians, resized to T.size()
+      static void XYCIO(const std::vector<double>& T,
+                        std::vector<double>& X, std::vector<double>& Y)
+         throw();
+
+      /// Number of epochs evaluated together
+      static const int BLOCK = 8;
+
+   }; // end class NutationSeries
+
+}  // end namespace gpstk
+
+#endif // CLASS_NUTATIONSERIES_INCLUDE
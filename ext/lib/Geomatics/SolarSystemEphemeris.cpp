@@ -627,6 +627,13 @@ try {
 
    readBinaryHeader(filename);
    iret = readBinaryData(false);    // false: don't store data in map
+
+   // from here on, records are read from the mapped file, not the stream
+   istrm.clear();
+   istrm.close();
+   records.close();
+   if(iret == 0) records.open(filename, Ncoeff);
+
    if(iret == 0) {
       // EphemerisNumber == -1 means the header has not been read
       // EphemerisNumber ==  0 means the fileposMap has not been read (binary)
@@ -649,20 +656,41 @@ void SolarSystemEphemeris::RelativeInertialPositionVelocity(const double MJD,
                                                 SolarSystemEphemeris::Planet target,
                                                 SolarSystemEphemeris::Planet center,
                                                 double pv[6], bool kilometers)
-   throw(Exception)
+   const throw(Exception)
 {
 try {
-   int iret,i;
-   
-   // initialize
-   for(i=0; i<6; i++) pv[i] = 0.0;
-
    // trivial; return
-   if(target == center) return;
+   if(target == center) {
+      for(int i=0; i<6; i++) pv[i] = 0.0;
+      return;
+   }
+
+   RelativeInertialPositionVelocity(MJD, &target, 1, center, pv, kilometers);
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+catch(exception& e) { Exception E("std except: "+string(e.what())); GPSTK_THROW(E); }
+catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
+}
+
+//------------------------------------------------------------------------------------
+// get inertial positions of several bodies relative to one other.
+void SolarSystemEphemeris::RelativeInertialPositionVelocity(const double MJD,
+                                          const SolarSystemEphemeris::Planet targets[],
+                                          int n,
+                                          SolarSystemEphemeris::Planet center,
+                                          double PV[], bool kilometers)
+   const throw(Exception)
+{
+try {
+   int iret,i,k;
+
+   // initialize
+   for(i=0; i<6*n; i++) PV[i] = 0.0;
 
    // get the right record from the file
    double JD(MJD + MJD_TO_JD);
-   iret = seekToJD(JD);
+   BinaryRecordCache::Record rec;
+   iret = seekToJD(JD, rec);
    // -1 out of range : input time is before the first time in file
    // -2 out of range : input time is after the last time in file, or in a gap
    // -3 stream is not open or not good, or EOF was found prematurely
@@ -687,64 +715,86 @@ try {
          GPSTK_THROW(e);
       }
    }
+   const vector<double>& coefficients(*rec);
+
+   // states of the bodies, computed as needed, shared by all targets
+   double states[LIBRATIONS+1][6];
+   bool have[LIBRATIONS+1];
+   for(i=0; i<=LIBRATIONS; i++) have[i] = false;
+
+   map<string,double>::const_iterator cit;
+   double EMRAT = ((cit = constants.find("EMRAT")) != constants.end() ?
+                   cit->second : 0.0);
+   double AU = ((cit = constants.find("AU")) != constants.end() ?
+                cit->second : 0.0);
+
+   for(k=0; k<n; k++) {
+      const Planet target(targets[k]);
+      double *pv = PV + 6*k;
+
+      // trivial; leave zero
+      if(target == center) continue;
+
+      // compute Nutations or Librations
+      if(target == idNutations || target == idLibrations) {
+         const double *ps = bodyState(MJD, coefficients,
+                     target==idNutations ? NUTATIONS : LIBRATIONS, states, have);
+         for(i=0; i<6; i++) pv[i] = ps[i];
+         continue;
+      }
 
-   // compute Nutations or Librations
-   if(target == idNutations || target == idLibrations) {
-      InertialPositionVelocity(MJD, target==idNutations ? NUTATIONS : LIBRATIONS, pv);
-      return;
-   }
-
-   // define computeID's for target and center
-   computeID TARGET,CENTER;
-
-   if(target <= idSun)                        TARGET = computeID(target-1);
-   else if(target == idSolarSystemBarycenter) TARGET = NONE;
-   else if(target == idEarthMoonBarycenter)   TARGET = EMBARY;
-   // (Nutations and Librations are done above)
-   if(center <= idSun)                        CENTER = computeID(center-1);
-   else if(center == idSolarSystemBarycenter) CENTER = NONE;
-   else if(center == idEarthMoonBarycenter)   CENTER = EMBARY;
-
-   // Earth and Moon need special treatment - get moon and Earth-moon barycenter
-   double pvmoon[6],pvembary[6],Eratio,Mratio;
-
-   // special cases of Earth AND Moon: Moon result is always geocentric
-   if(target == idEarth && center == idMoon)  TARGET = NONE;
-   if(center == idEarth && target == idMoon)  CENTER = NONE;
-
-   // special cases of Earth OR Moon, but not both:
-   if((target==idEarth && center!=idMoon) || (center==idEarth && target!=idMoon)) {
-      Eratio = 1.0/(1.0 + constants["EMRAT"]);
-      InertialPositionVelocity(MJD, MOON, pvmoon);
-   }
-   if((target==idMoon && center!=idEarth) || (center==idMoon && target!=idEarth)) {
-      Mratio = constants["EMRAT"]/(1.0 + constants["EMRAT"]);
-      InertialPositionVelocity(MJD, EMBARY, pvembary);
-   }
+      // define computeID's for target and center
+      computeID TARGET(NONE),CENTER(NONE);
+
+      if(target <= idSun)                        TARGET = computeID(target-1);
+      else if(target == idSolarSystemBarycenter) TARGET = NONE;
+      else if(target == idEarthMoonBarycenter)   TARGET = EMBARY;
+      // (Nutations and Librations are done above)
+      if(center <= idSun)                        CENTER = computeID(center-1);
+      else if(center == idSolarSystemBarycenter) CENTER = NONE;
+      else if(center == idEarthMoonBarycenter)   CENTER = EMBARY;
+
+      // Earth and Moon need special treatment - get moon and Earth-moon barycenter
+      const double *pvmoon=0,*pvembary=0;
+      double Eratio=0.0,Mratio=0.0;
+
+      // special cases of Earth AND Moon: Moon result is always geocentric
+      if(target == idEarth && center == idMoon)  TARGET = NONE;
+      if(center == idEarth && target == idMoon)  CENTER = NONE;
+
+      // special cases of Earth OR Moon, but not both:
+      if((target==idEarth && center!=idMoon) || (center==idEarth && target!=idMoon)) {
+         Eratio = 1.0/(1.0 + EMRAT);
+         pvmoon = bodyState(MJD, coefficients, MOON, states, have);
+      }
+      if((target==idMoon && center!=idEarth) || (center==idMoon && target!=idEarth)) {
+         Mratio = EMRAT/(1.0 + EMRAT);
+         pvembary = bodyState(MJD, coefficients, EMBARY, states, have);
+      }
 
-   // compute states for target and center
-   double pvtarget[6],pvcenter[6];
-   InertialPositionVelocity(MJD, TARGET, pvtarget);
-   InertialPositionVelocity(MJD, CENTER, pvcenter);
-
-   // handle the Earth/Moon special cases
-   // convert from E-M barycenter to Earth
-   if(target == idEarth && center != idMoon)
-      for(i=0; i<6; i++) pvtarget[i] -= pvmoon[i]*Eratio;
-   if(center == idEarth && target != idMoon)
-      for(i=0; i<6; i++) pvcenter[i] -= pvmoon[i]*Eratio;
-
-   if(target == idMoon && center != idEarth)
-      for(i=0; i<6; i++) pvtarget[i] = pvembary[i] + pvtarget[i]*Mratio;
-   if(center == idMoon && target != idEarth)
-      for(i=0; i<6; i++) pvcenter[i] = pvembary[i] + pvcenter[i]*Mratio;
-   
-   // final relative result
-   for(i=0; i<6; i++) pv[i] = pvtarget[i] - pvcenter[i];
-   
-   if(!kilometers) {
-      double AU = constants["AU"];
-      for(i=0; i<6; i++) pv[i] /= AU;
+      // compute states for target and center
+      double pvtarget[6],pvcenter[6];
+      const double *pt = bodyState(MJD, coefficients, TARGET, states, have);
+      const double *pc = bodyState(MJD, coefficients, CENTER, states, have);
+      for(i=0; i<6; i++) { pvtarget[i] = pt[i]; pvcenter[i] = pc[i]; }
+
+      // handle the Earth/Moon special cases
+      // convert from E-M barycenter to Earth
+      if(target == idEarth && center != idMoon)
+         for(i=0; i<6; i++) pvtarget[i] -= pvmoon[i]*Eratio;
+      if(center == idEarth && target != idMoon)
+         for(i=0; i<6; i++) pvcenter[i] -= pvmoon[i]*Eratio;
+
+      if(target == idMoon && center != idEarth)
+         for(i=0; i<6; i++) pvtarget[i] = pvembary[i] + pvtarget[i]*Mratio;
+      if(center == idMoon && target != idEarth)
+         for(i=0; i<6; i++) pvcenter[i] = pvembary[i] + pvcenter[i]*Mratio;
+
+      // final relative result
+      for(i=0; i<6; i++) pv[i] = pvtarget[i] - pvcenter[i];
+
+      if(!kilometers)
+         for(i=0; i<6; i++) pv[i] /= AU;
    }
 }
 catch(Exception& e) { GPSTK_RETHROW(e); }
@@ -956,10 +1006,6 @@ try {
       if(save)
          store[data_vector[0]] = data_vector;
 
-      // put the first record in coefficients array
-      if(nrec == 1)
-         coefficients = data_vector;
-
       // build the positions map
       fileposMap[data_vector[0]] = filepos;
 
@@ -1026,14 +1072,14 @@ catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
 // -3 stream is not open or not good, or EOF was found prematurely
 // -4 EphemerisNumber is not defined
 // For -3,-4 : initializeWithBinaryFile() has not been called, or reading failed.
-int SolarSystemEphemeris ::seekToJD(double JD) throw(Exception)
+int SolarSystemEphemeris::seekToJD(double JD, BinaryRecordCache::Record& rec) const
+   throw(Exception)
 {
 try {
-   if(!istrm) return -3;
-   if(istrm.eof() || !istrm.good()) return -3;
-   if(EphemerisNumber != int(constants["DENUM"])) return -4;
-
-   if(coefficients[0] <= JD && JD <= coefficients[1]) return 0;
+   if(!records.isOpen()) return -3;
+   map<string,double>::const_iterator cit = constants.find("DENUM");
+   if(cit == constants.end() || EphemerisNumber != int(cit->second)) return -4;
+   if(fileposMap.empty()) return -1;
 
    map<double,long>::const_iterator it; // key >= input
    it = fileposMap.lower_bound(JD); // it points to first element with JD <= time
@@ -1044,12 +1090,11 @@ try {
    if(it == fileposMap.end()        // if beyond the found record, go to previous;
          || JD < it->first) it--;   // but beware the "lower_bound found the =" case
 
-   istrm.seekg(it->second,ios_base::beg);         // get the record
-   int iret = readBinaryRecord(coefficients);
-   if(iret == -2) iret = -3;        // this means EOF during data read
-   if(iret) return iret;            // reading failed
+   rec = records.get(it->second);   // get the record
+   if(!rec || rec->size() < 2)
+      return -3;                    // this means EOF during data read
 
-   if(JD > coefficients[1])
+   if(JD > (*rec)[1])
       return -2;                    // failure: JD is after the last record, or
                                     // JD is in a gap between records
    return 0;
@@ -1059,14 +1104,32 @@ catch(exception& e) { Exception E("std except: "+string(e.what())); GPSTK_THROW(
 catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
 }
 
+//------------------------------------------------------------------------------------
+// private
+const double *SolarSystemEphemeris::bodyState(const double MJD,
+                                              const vector<double>& coefficients,
+                                              SolarSystemEphemeris::computeID which,
+                                              double states[][6], bool have[])
+   const throw(Exception)
+{
+   static const double zero[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+   if(which == NONE) return zero;
+   if(!have[which]) {
+      InertialPositionVelocity(MJD, coefficients, which, states[which]);
+      have[which] = true;
+   }
+   return states[which];
+}
+
 //------------------------------------------------------------------------------------
 // private
 void SolarSystemEphemeris::InertialPositionVelocity(const double MJD,
+                                  const vector<double>& coefficients,
                                   SolarSystemEphemeris::computeID which, double PV[6])
-   throw(Exception)
+   const throw(Exception)
 {
 try {
-   int i,j,i0,ncomp,offset;
+   int i,j,i0,ncomp;
 
    for(i=0; i<6; i++) PV[i]=0.0;
    if(which == NONE) return;
@@ -1094,28 +1157,31 @@ try {
    // normalized time
    T = 2.0*(MJD-(Tbeg-MJD_TO_JD))/Tspan - 1.0;
 
+   // generate the Chebyshevs and their derivatives, once for all components
+   int N=c_ncoeff[which];
+   double Cbuf[32],Ubuf[32];
+   vector<double> Cvec,Uvec;
+   double *C(Cbuf),*U(Ubuf);
+   if(N > 32) {
+      Cvec.resize(N); Uvec.resize(N);
+      C = &Cvec[0]; U = &Uvec[0];
+   }
+   C[0] = 1; C[1] = T;
+   U[0] = 0; U[1] = 1;
+   for(j=2; j<N; j++) {
+      C[j] = 2*T*C[j-1] - C[j-2];
+      U[j] = 2*T*U[j-1] + 2*C[j-1] - U[j-2];
+   }
+
    // interpolate
-   unsigned int N=c_ncoeff[which];
-   vector<double> C(N,0.0);     // Chebyshev
-   vector<double> U(N,0.0);     // derivative of Chebyshev
+   const double *coef = &coefficients[0];
    for(i=0; i<ncomp; i++) {     // loop over components
-
-      // seed the Chebyshev recursions
-      C[0] = 1; C[1] = T; //C[2] = 2*T*T-1;
-      U[0] = 0; U[1] = 1; //U[2] = 4*T;
-
-      // generate the Chebyshevs
-      for(j=2; j<N; j++) {
-         C[j] = 2*T*C[j-1] - C[j-2];
-         U[j] = 2*T*U[j-1] + 2*C[j-1] - U[j-2];
-      }
-
       // compute P and V
       // done above PV[i] = PV[i+3] = 0.0;
       for(j=N-1; j>-1; j--)                              // POS
-         PV[i] += coefficients[i0+j+i*N] * C[j];
+         PV[i] += coef[i0+j+i*N] * C[j];
       for(j=N-1; j>0; j--) // j>0 b/c U[0]=0             // VEL
-         PV[i+ncomp] += coefficients[i0+j+i*N] * U[j];
+         PV[i+ncomp] += coef[i0+j+i*N] * U[j];
 
       // convert velocity to 'per day'
       PV[i+ncomp] *= 2*double(c_nsets[which])/Tspan0;
@@ -58,6 +58,7 @@
 // GPSTk
 #include "Exception.hpp"
 #include "TimeConstants.hpp"
+#include "BinaryRecordCache.hpp"
 
 namespace gpstk {
 
@@ -86,6 +87,10 @@ namespace gpstk {
 /// RelativeInertialPositionVelocity() any number of times, passing it the time and
 /// Planet of interest.
 /// Time for this class is always Barycentric Dynamic Time (TDB), always as MJD.
+/// After initializeWithBinaryFile(), the binary file is memory mapped and the
+/// most recently used records are kept decoded (see setRecordCacheSize()), so
+/// that queries hopping between times do not re-read the file, and the const
+/// RelativeInertialPositionVelocity() may be called from several threads at once.
 class SolarSystemEphemeris {
 public:
    /// These are indexes used by the caller of InertialPositionVelocity().
@@ -190,7 +195,8 @@ public:
 
    /// Open the given binary file, read the header and prepare for reading data
    /// records at random using seekToJD() and computing positions and velocities
-   /// with InertialPositionVelocity(). Does not store the data.
+   /// with InertialPositionVelocity(). Does not store the data; the file is
+   /// memory mapped and records are decoded as they are used.
    /// @param filename  name of binary file to be read.
    /// @return 0 success,
    ///        -3 input stream is not open or not valid
@@ -231,7 +237,34 @@ public:
    /// initializeWithBinaryFile() has not been called, or reading failed.
    void RelativeInertialPositionVelocity(const double MJD,
                   Planet target, Planet center, double PV[6], bool kilometers = true)
-      throw(Exception);
+      const throw(Exception);
+
+   /// Compute inertial frame position and velocity of several target bodies
+   /// relative to the same center body, at one time; see the single-target
+   /// version for details. The data record is looked up once, and the state of
+   /// each body needed is computed once.
+   /// @param  MJD     time (Modified Julian Date) of interest, in TDB system.
+   /// @param targets  array of n bodies for which results are computed.
+   /// @param n        number of targets.
+   /// @param center   Body relative to which the results apply.
+   /// @param PV       array of 6*n doubles; results for targets[i] are returned in
+   ///                   PV[6*i] to PV[6*i+5], as PV in the single-target version.
+   /// @param km       boolean: if true (default), units are km, km/day;
+   ///                   else AU, AU/day.
+   /// @throw as the single-target version.
+   void RelativeInertialPositionVelocity(const double MJD,
+                  const Planet targets[], int n, Planet center, double PV[],
+                  bool kilometers = true)
+      const throw(Exception);
+
+   /// Set the number of data records kept decoded after
+   /// initializeWithBinaryFile(); the default is 16.
+   void setRecordCacheSize(size_t n) throw()
+      { records.setCapacity(n); }
+
+   /// Return the number of data records kept decoded.
+   size_t getRecordCacheSize(void) const throw()
+      { return records.getCapacity(); }
 
    /// Return the value of 1 AU (Astronomical Unit) in km. If the file header has not
    /// been read, return -1.0.
@@ -297,7 +330,7 @@ private:
    void readBinaryHeader(std::string filename) throw(Exception);
 
    /// Read data from a binary file, already opened by readBinaryHeader.
-   /// Build the file position map, and store the first set of coefficients.
+   /// Build the file position map.
    /// If calling argument is true, save all the coefficient data in a map.
    /// @param save if true, save all the data in store, else clear the store.
    /// @return 0 success,
@@ -315,16 +348,17 @@ private:
    int readBinaryRecord(std::vector<double>& data_vector) throw(Exception);
 
    /// Search the data records of the file opened by initializeWithBinaryFile() and
-   /// read the one whose time limits include the given time. May be called only
-   /// after initializeWithBinaryFile().
+   /// get the one whose time limits include the given time, from the record cache.
+   /// May be called only after initializeWithBinaryFile().
    /// @param JD the time (Julian Date) of interest
+   /// @param rec the record found
    /// @return 0 success, or
    ///        -1 given time is before the first record in the file,
    ///        -2 given time is after the last record, or in a gap between records,
    ///        -3 input stream is not open or not valid, or EOF was found prematurely,
    ///        -4 ephemeris (binary file) is not initialized
    /// -3 or -4 => initializeWithBinaryFile() has not been called, or reading failed.
-   int seekToJD(double JD) throw(Exception);
+   int seekToJD(double JD, BinaryRecordCache::Record& rec) const throw(Exception);
 
    //------------------------------------------------------------------
    // define here for use in next function
@@ -350,8 +384,8 @@ private:
    };
 
    /// Compute inertial position and velocity of given body at given time, relative
-   /// to the solar system barycenter, using the current coefficient array.
-   /// NB caller MUST call seekToJD(time) BEFORE calling this.
+   /// to the solar system barycenter, using the given coefficient array.
+   /// NB caller MUST get the array from seekToJD(time).
    /// On successful return, PV[0-2] contains the three position components, in km,
    /// and PV[3-5] the velocity components in km/day (for regular bodies), relative
    /// to the solar system barycenter, except for the moon, which is relative to
@@ -359,11 +393,21 @@ private:
    /// nutations (components 0-3 only) are longitude and obliquity, and librations
    /// are the three euler angles.
    /// @param  MJD    time (Modified Julian Date) of interest (system TDB).
+   /// @param  coefficients  data record including MJD.
    /// @param  which  computeID of the body of interest.
    /// @param  PV     double(6) array containing the inertial position and velocity
    ///                 relative to the solar system barycenter.
-   void InertialPositionVelocity(const double MJD, computeID which, double PV[6])
-      throw(Exception);
+   void InertialPositionVelocity(const double MJD,
+                                 const std::vector<double>& coefficients,
+                                 computeID which, double PV[6])
+      const throw(Exception);
+
+   /// Return the state of body 'which' computed by InertialPositionVelocity(),
+   /// computing it only if have[which] is false; zero for NONE.
+   /// For use by RelativeInertialPositionVelocity().
+   const double *bodyState(const double MJD, const std::vector<double>& coefficients,
+                           computeID which, double states[][6], bool have[])
+      const throw(Exception);
 
    //------------------------------------------------------------------
    // member data
@@ -432,10 +476,10 @@ private:
    /// used by seekToJD() to read records in random order.
    std::map<double, long> fileposMap;
 
-   /// One complete data record (Ncoeff doubles) consisting of times and coefficients.
-   /// seekToJD() stores the current record here, and InertialPositionVelocity()
-   /// uses it.
-   std::vector<double> coefficients;
+   /// The binary file opened by initializeWithBinaryFile(), with the most
+   /// recently used data records (Ncoeff doubles each, consisting of times and
+   /// coefficients). seekToJD() gets records from here.
+   BinaryRecordCache records;
 
 }; // end class SolarSystemEphemeris
 
@@ -0,0 +1,252 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S.
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file BinaryRecordCache_T.cpp  Test the record cache of BinaryRecordCache.
+
+#include "BinaryRecordCache.hpp"
+
+#include "TestUtil.hpp"
+#include "build_config.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace gpstk;
+
+class BinaryRecordCache_T
+{
+public:
+      /** Write a file of nrec records of ndbl doubles, after a
+       * header of hdrSize bytes, so that no record is aligned to
+       * its size. */
+   BinaryRecordCache_T()
+   {
+      fileName = getPathTestTemp() + getFileSep()
+         + "BinaryRecordCache_T.bin";
+      ofstream ofs(fileName.c_str(), ios::out|ios::binary);
+      for(int i=0; i<hdrSize; i++)
+         ofs.put(static_cast<char>(i));
+      for(int r=0; r<nrec; r++)
+         for(int i=0; i<ndbl; i++)
+         {
+            double d(value(r,i));
+            ofs.write(reinterpret_cast<const char*>(&d), sizeof(d));
+         }
+   }
+
+   ~BinaryRecordCache_T()
+   {
+      std::remove(fileName.c_str());
+   }
+
+      /// Byte offset of record r.
+   static long offset(int r)
+   { return hdrSize + r*ndbl*long(sizeof(double)); }
+
+      /// Value of double i of record r.
+   static double value(int r, int i)
+   { return r*1000. + i + 1./(i+3); }
+
+      /** Read record r with a seek and read of the file, the way the
+       * ephemeris readers did before the cache. */
+   vector<double> seekRead(long off)
+   {
+      vector<double> rec(ndbl);
+      ifstream ifs(fileName.c_str(), ios::in|ios::binary);
+      ifs.seekg(off);
+      ifs.read(reinterpret_cast<char*>(&rec[0]), ndbl*sizeof(double));
+      return rec;
+   }
+
+      /** Records returned by get(), whether decoded or cached, equal
+       * those read with seek and read, and out-of-range offsets give
+       * null records. */
+   unsigned equalTest()
+   {
+      TUDEF("BinaryRecordCache", "get");
+      BinaryRecordCache cache(4);
+      TUASSERT(!cache.get(offset(0)));
+      cache.open(fileName, ndbl);
+      TUASSERT(cache.isOpen());
+         // twice, so that the second pass reads some records from
+         // the cache and, having evicted them, decodes others again
+      for(int pass=0; pass<2; pass++)
+      {
+         for(int r=0; r<nrec; r+=3)
+         {
+            BinaryRecordCache::Record rec(cache.get(offset(r)));
+            TUASSERT(bool(rec));
+            if(!rec)
+               continue;
+            TUASSERT(seekRead(offset(r)) == *rec);
+            BinaryRecordCache::Record again(cache.get(offset(r)));
+            TUASSERT(rec == again);
+         }
+      }
+         // misaligned offsets are allowed, and read what is there
+      BinaryRecordCache::Record odd(cache.get(offset(5)+8));
+      TUASSERT(bool(odd));
+      if(odd)
+         TUASSERT(seekRead(offset(5)+8) == *odd);
+      TUASSERT(!cache.get(-1));
+      TUASSERT(!cache.get(offset(nrec-1)+1));
+      TUASSERT(bool(cache.get(offset(nrec-1))));
+      TUASSERT(!cache.get(offset(nrec)));
+
+         // records held by the caller outlive the file
+      BinaryRecordCache::Record held(cache.get(offset(7)));
+      cache.close();
+      TUASSERT(!cache.isOpen());
+      TUASSERTE(size_t, 0, cache.size());
+      TUASSERT(!cache.get(offset(7)));
+      TUASSERTFE(value(7,ndbl-1), (*held)[ndbl-1]);
+
+      try
+      {
+         cache.open(fileName + ".missing", ndbl);
+         TUFAIL("open of a missing file did not throw");
+      }
+      catch(Exception& e)
+      {
+         TUPASS("open of a missing file");
+      }
+      TURETURN();
+   }
+
+      /** The least recently used record is the one dropped when the
+       * cache is full, and a cache hit makes a record most recent. */
+   unsigned lruTest()
+   {
+      TUDEF("BinaryRecordCache", "setCapacity");
+      BinaryRecordCache cache(3);
+      cache.open(fileName, ndbl);
+      TUASSERTE(size_t, 3, cache.getCapacity());
+      BinaryRecordCache::Record r0(cache.get(offset(0)));
+      BinaryRecordCache::Record r1(cache.get(offset(1)));
+      BinaryRecordCache::Record r2(cache.get(offset(2)));
+      TUASSERTE(size_t, 3, cache.size());
+         // hit on 0 leaves 1 as the least recent, so 3 evicts 1
+      TUASSERT(r0 == cache.get(offset(0)));
+      BinaryRecordCache::Record r3(cache.get(offset(3)));
+      TUASSERTE(size_t, 3, cache.size());
+      TUASSERT(r0 == cache.get(offset(0)));
+      TUASSERT(r2 == cache.get(offset(2)));
+      TUASSERT(r3 == cache.get(offset(3)));
+         // 1 was dropped, so it is decoded again into a new record
+      BinaryRecordCache::Record r1b(cache.get(offset(1)));
+      TUASSERT(r1 != r1b);
+      TUASSERT(*r1 == *r1b);
+         // ... which evicted 0, the least recent after the hits above
+      TUASSERT(r0 != cache.get(offset(0)));
+      TUASSERTE(size_t, 3, cache.size());
+
+         // shrinking drops the least recent: the order is now 0,1,3
+      cache.setCapacity(2);
+      TUASSERTE(size_t, 2, cache.getCapacity());
+      TUASSERTE(size_t, 2, cache.size());
+      TUASSERT(r1b == cache.get(offset(1)));
+      TUASSERT(r3 != cache.get(offset(3)));
+      cache.setCapacity(0);
+      TUASSERTE(size_t, 1, cache.getCapacity());
+      TUASSERTE(size_t, 1, cache.size());
+      TURETURN();
+   }
+
+      /** Several threads get() overlapping sets of records from a
+       * cache too small to hold them all; every record must still
+       * equal the file contents. */
+   unsigned threadTest()
+   {
+      TUDEF("BinaryRecordCache", "get");
+      const int nthread = 4, niter = 2000;
+      BinaryRecordCache cache(5);
+      cache.open(fileName, ndbl);
+      vector<unsigned> bad(nthread, 0);
+      vector<thread> threads;
+      for(int t=0; t<nthread; t++)
+      {
+         threads.push_back(thread([&cache, &bad, t, niter]()
+         {
+            for(int k=0; k<niter; k++)
+            {
+               int r = (k*(t+1) + t*7) % nrec;
+               BinaryRecordCache::Record rec(cache.get(offset(r)));
+               if(!rec || rec->size() != size_t(ndbl))
+               {
+                  bad[t]++;
+                  continue;
+               }
+               for(int i=0; i<ndbl; i++)
+                  if((*rec)[i] != value(r,i))
+                  {
+                     bad[t]++;
+                     break;
+                  }
+            }
+         }));
+      }
+      for(int t=0; t<nthread; t++)
+         threads[t].join();
+      for(int t=0; t<nthread; t++)
+         TUASSERTE(unsigned, 0, bad[t]);
+      TUASSERT(cache.size() <= cache.getCapacity());
+      TURETURN();
+   }
+
+private:
+   static const int hdrSize = 13;   ///< bytes before the first record
+   static const int nrec = 40;      ///< number of records
+   static const int ndbl = 11;      ///< doubles in each record
+   string fileName;
+};
+
+
+int main() //Main function to initialize and run all tests above
+{
+   unsigned errorTotal = 0;
+   BinaryRecordCache_T testClass;
+
+   errorTotal += testClass.equalTest();
+   errorTotal += testClass.lruTest();
+   errorTotal += testClass.threadTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; //Return the total number of errors
+}
@@ -0,0 +1,235 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file IonexStore_T.cpp  Test the interpolation of IonexStore.
+
+#include "IonexStore.hpp"
+#include "CivilTime.hpp"
+#include "Position.hpp"
+
+#include "TestUtil.hpp"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace gpstk;
+
+class IonexStore_T
+{
+public:
+      /** Fill the store with three TEC and RMS maps, two hours apart,
+       * on the usual 2.5 by 5 degree global grid.  The values are
+       * linear in latitude, longitude and map number, so that the
+       * interpolation between maps (strategy 2) is exact. */
+   IonexStore_T()
+   {
+      for(int m=0; m<3; m++)
+      {
+         epoch[m] = CivilTime(2019,1,1,2*m,0,0.,TimeSystem::GPS);
+         for(int k=0; k<2; k++)
+         {
+            IonexData iod;
+            iod.mapID = m+1;
+            iod.time = epoch[m];
+            iod.type = (k == 0 ? IonexData::TEC : IonexData::RMS);
+            iod.exponent = -1;
+            iod.lat[0] = 87.5;  iod.lat[1] = -87.5; iod.lat[2] = -2.5;
+            iod.lon[0] = -180.; iod.lon[1] = 180.;  iod.lon[2] = 5.;
+            iod.hgt[0] = 450.;  iod.hgt[1] = 450.;  iod.hgt[2] = 0.;
+            iod.dim[0] = 71;
+            iod.dim[1] = 73;
+            iod.dim[2] = 1;
+            iod.data.resize(iod.dim[0]*iod.dim[1]);
+            for(int i=0; i<iod.dim[0]; i++)
+               for(int j=0; j<iod.dim[1]; j++)
+                  iod.data[j + i*iod.dim[1]] =
+                     field(k, m, iod.lat[0] + i*iod.lat[2],
+                           iod.lon[0] + j*iod.lon[2]);
+            iod.valid = true;
+            store.addMap(iod);
+         }
+      }
+
+         // points at and next to the edges of the grid, where
+         // getIonexValue() either wraps in longitude or throws, and
+         // in between
+      double lats[] = { 87.5, 87.49, 60.3, 1.25, 0., -33.3, -85., -87.49,
+                        -87.5 };
+      double lons[] = { 0., 2.5, 97.1, 179.99, 180., 182.5, 270., 357.5,
+                        359.99 };
+      for(unsigned i=0; i<sizeof(lats)/sizeof(lats[0]); i++)
+         for(unsigned j=0; j<sizeof(lons)/sizeof(lons[0]); j++)
+            points.push_back(Position(lats[i], lons[j], radius,
+                                      Position::Geocentric));
+
+         // times at, between and either side of the maps, and outside
+         // the span of the store
+      double secs[] = { -1., 0., 1., 3600., 7199., 7199.999, 7200., 7200.001,
+                        7201., 12345.6, 14399., 14400., 14401. };
+      for(unsigned i=0; i<sizeof(secs)/sizeof(secs[0]); i++)
+         times.push_back(epoch[0] + secs[i]);
+   }
+
+      /// TEC (k=0) or RMS (k=1) of map m at a grid point
+   static double field(int k, int m, double lat, double lon)
+   {
+      if(k == 0)
+         return 100. + 0.5*lat + 0.1*lon + 20.*m;
+      return 10. + 0.05*lat - 0.01*lon + 2.*m;
+   }
+
+      /** Each value returned by getIonexValues() must equal, bit for
+       * bit, the value getIonexValue() returns for the same point, and
+       * getIonexValues() must throw when getIonexValue() does. */
+   unsigned batchTest()
+   {
+      TUDEF("IonexStore", "getIonexValues");
+      unsigned nvalid(0), ninvalid(0);
+      for(int strategy=1; strategy<=4; strategy++)
+      {
+         for(unsigned it=0; it<times.size(); it++)
+         {
+            vector<Position> good;
+            vector<Triple> expect;
+            for(unsigned ip=0; ip<points.size(); ip++)
+            {
+               vector<Position> one(1, points[ip]);
+               vector<Triple> got;
+               Triple val;
+               bool ok(true);
+               try
+               {
+                  val = store.getIonexValue(times[it], points[ip], strategy);
+               }
+               catch(InvalidRequest&)
+               {
+                  ok = false;
+               }
+               if(!ok)
+               {
+                  ninvalid++;
+                  try
+                  {
+                     store.getIonexValues(times[it], one, got, strategy);
+                     TUFAIL("getIonexValues() did not throw");
+                  }
+                  catch(InvalidRequest&)
+                  {
+                     TUPASS("getIonexValues() threw");
+                  }
+                  continue;
+               }
+               nvalid++;
+               store.getIonexValues(times[it], one, got, strategy);
+               TUASSERTE(size_t, 1, got.size());
+               for(int k=0; k<3; k++)
+                  TUASSERTE(double, val[k], got[0][k]);
+               good.push_back(points[ip]);
+               expect.push_back(val);
+            }
+
+               // and all the valid points at once
+            if(good.empty())
+               continue;
+            vector<Triple> got;
+            store.getIonexValues(times[it], good, got, strategy);
+            TUASSERTE(size_t, expect.size(), got.size());
+            for(unsigned i=0; i<got.size(); i++)
+               for(int k=0; k<3; k++)
+                  TUASSERTE(double, expect[i][k], got[i][k]);
+         }
+      }
+         // both kinds of point must have been tried
+      TUASSERT(nvalid > 0);
+      TUASSERT(ninvalid > 0);
+      TURETURN();
+   }
+
+      /** Interpolating between maps without rotation, the linear
+       * field is reproduced exactly, up to rounding. */
+   unsigned valueTest()
+   {
+      TUDEF("IonexStore", "getIonexValue");
+      const double span(epoch[1] - epoch[0]);
+      for(unsigned it=1; it+1<times.size(); it++)
+      {
+         double x((times[it] - epoch[0]) / span);
+         for(unsigned ip=0; ip<points.size(); ip++)
+         {
+            double lat(points[ip].theArray[0]), lon(points[ip].theArray[1]);
+            if(lat < -85.)
+               continue;
+            if(lon > 180.)
+               lon -= 360.;
+            Triple val(store.getIonexValue(times[it], points[ip], 2));
+            for(int k=0; k<2; k++)
+            {
+                  // field() is linear in the map number
+               double exp(field(k,0,lat,lon)
+                          + x*(field(k,1,lat,lon) - field(k,0,lat,lon)));
+               TUASSERTFEPS(exp, val[k], 1.e-9);
+            }
+            TUASSERTFEPS(radius, val[2], 1.e-6);
+         }
+      }
+      TURETURN();
+   }
+
+private:
+      /// radius of the points: 450 km above the equatorial radius
+   static const double radius;
+   CommonTime epoch[3];
+   IonexStore store;
+   vector<Position> points;
+   vector<CommonTime> times;
+};
+
+const double IonexStore_T::radius = 6378137. + 450.e3;
+
+
+int main() //Main function to initialize and run all tests above
+{
+   unsigned errorTotal = 0;
+   IonexStore_T testClass;
+
+   errorTotal += testClass.batchTest();
+   errorTotal += testClass.valueTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; //Return the total number of errors
+}
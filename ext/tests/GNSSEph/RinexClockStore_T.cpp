@@ -0,0 +1,139 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/// @file RinexClockStore_T.cpp  Test the cache of RinexClockStore.
+
+#include "RinexClockStore.hpp"
+
+#include "TestUtil.hpp"
+#include "build_config.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace gpstk;
+
+class RinexClockStore_T
+{
+public:
+   RinexClockStore_T()
+   {
+      string fs(getFileSep());
+      clockFile = getPathData() + fs +
+         "test_input_rinex2_clock_RinexClockExample.96c";
+      copyFile = getPathTestTemp() + fs + "RinexClockStore_T.96c";
+      cacheFile = getPathTestTemp() + fs + "RinexClockStore_T.cache";
+   }
+
+      /** loadCache() restores the store written by saveCache(), and
+       * only from the same files in the same order, unchanged, with
+       * the same reject flag. */
+   unsigned cacheTest()
+   {
+      TUDEF("RinexClockStore", "loadCache");
+
+         // a copy of the file, to change later
+      {
+         ifstream ifs(clockFile.c_str(), ios::binary);
+         ofstream ofs(copyFile.c_str(), ios::binary);
+         ofs << ifs.rdbuf();
+      }
+      vector<string> files;
+      files.push_back(clockFile);
+      files.push_back(copyFile);
+
+      try
+      {
+         RinexClockStore saved, restored;
+         for(size_t i=0; i<files.size(); i++)
+            saved.loadFile(files[i]);
+         TUASSERT(saved.ndata() > 0);
+         saved.saveCache(cacheFile);
+
+         TUASSERT(restored.loadCache(cacheFile, files));
+         ostringstream savedDump, restoredDump;
+         saved.dump(savedDump, 2);
+         restored.dump(restoredDump, 2);
+         TUASSERT(savedDump.str() == restoredDump.str());
+         TUASSERTE(int, saved.ndata(), restored.ndata());
+         TUASSERTE(int, saved.nsats(), restored.nsats());
+
+            // the same files in another order
+         vector<string> reversed(files.rbegin(), files.rend());
+         RinexClockStore other;
+         TUASSERT(!other.loadCache(cacheFile, reversed));
+         TUASSERTE(int, 0, other.ndata());
+            // another reject flag
+         other.rejectBadClocks(false);
+         TUASSERT(!other.loadCache(cacheFile, files));
+            // a source file has changed
+         {
+            ofstream ofs(copyFile.c_str(), ios::app);
+            ofs << endl;
+         }
+         RinexClockStore stale;
+         TUASSERT(!stale.loadCache(cacheFile, files));
+         TUASSERTE(int, 0, stale.ndata());
+      }
+      catch(Exception& e)
+      {
+         cerr << e << endl;
+         TUFAIL("Unexpected exception");
+      }
+
+      std::remove(cacheFile.c_str());
+      std::remove(copyFile.c_str());
+      TURETURN();
+   }
+
+private:
+   string clockFile, copyFile, cacheFile;
+};
+
+
+int main() //Main function to initialize and run all tests above
+{
+   unsigned errorTotal = 0;
+   RinexClockStore_T testClass;
+
+   errorTotal += testClass.cacheTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; //Return the total number of errors
+}
@@ -0,0 +1,177 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file EarthOrientationCache_T.cpp  Test EarthOrientationCache against the
+/// series of EarthOrientation.
+
+#include "EarthOrientationCache.hpp"
+#include "EarthOrientation.hpp"
+#include "EphTime.hpp"
+
+#include "TestUtil.hpp"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace gpstk;
+
+class EarthOrientationCache_T
+{
+public:
+   EarthOrientationCache_T()
+         : round(1.e-14)
+   {
+      convs.push_back(IERSConvention::IERS1996);
+      convs.push_back(IERSConvention::IERS2003);
+      convs.push_back(IERSConvention::IERS2010);
+         // fractions of an interval, including both endpoints and
+         // times just either side of them
+      double f[] = { 0., 1.e-8, 0.1, 0.25, 0.5, 0.75, 0.9, 1.-1.e-8, 1. };
+      fracs.assign(f, f+sizeof(f)/sizeof(f[0]));
+   }
+
+      /** Compare the cache with the series at times spread over
+       * several intervals, and return the largest difference of the
+       * matrix elements, GAST and (IERS2010) the pole coordinates. */
+   double maxDiff(EarthOrientationCache& cache, IERSConvention conv,
+                  int nint)
+   {
+      EarthOrientation eo;
+      eo.convention = conv;
+      eo.xp = 0.1;
+      eo.yp = 0.3;
+      eo.UT1mUTC = -0.2;
+
+      double err(0.0);
+      const double stepSec(cache.getStep() * 86400.);
+      for(int k=0; k<nint; k++)
+      {
+         for(unsigned i=0; i<fracs.size(); i++)
+         {
+               // intervals start at whole multiples of the step from
+               // J2000 (MJD 51544.5 TT), and so from MJD 58000.5
+            double sec(43200. + (k+fracs[i])*stepSec);
+            int days(int(sec/86400.));
+            EphTime t(58000+days, sec-86400.*days, TimeSystem::TT);
+
+            SmallMatrix<double,3,3> cm(cache.ECEFtoInertial(eo,t));
+            Matrix<double> sm(eo.ECEFtoInertial(t));
+            for(int r=0; r<3; r++)
+               for(int c=0; c<3; c++)
+                  err = max(err, ::fabs(cm(r,c) - sm(r,c)));
+
+            double dg(cache.GAST(eo,t) - eo.GAST(t));
+            dg -= EarthOrientation::TWOPI * ::floor(dg/EarthOrientation::TWOPI
+                                                    + 0.5);
+            err = max(err, ::fabs(dg));
+
+            if(conv == IERSConvention::IERS2010)
+            {
+               double X,Y,s,Xs,Ys;
+               double T(EarthOrientation::CoordTransTime(t));
+               cache.PoleCoordinates(t,X,Y,s);
+               EarthOrientation::XYCIO(T,Xs,Ys);
+               err = max(err, max(::fabs(X-Xs), ::fabs(Y-Ys)));
+            }
+         }
+      }
+      return err;
+   }
+
+      /** The interpolated transformation must agree with the series
+       * to within the tolerance everywhere, including the interval
+       * endpoints. */
+   unsigned boundTest()
+   {
+      TUDEF("EarthOrientationCache", "ECEFtoInertial");
+         // the default grid, and a coarse one for which the
+         // interpolation error approaches the tolerance
+      double steps[] = { 0.25, 2.0 };
+      int orders[] = { 10, 4 };
+      double tols[] = { 1.e-12, 1.e-9 };
+      for(unsigned g=0; g<2; g++)
+      {
+         for(unsigned c=0; c<convs.size(); c++)
+         {
+            EarthOrientationCache cache(convs[c]);
+            cache.setInterpolation(steps[g], orders[g], tols[g]);
+            double err(maxDiff(cache, convs[c], 8));
+            TUASSERT(cache.size() >= 8);
+            TUASSERT(cache.getMaxError() <= tols[g]);
+            TUASSERT(err <= tols[g] + round);
+         }
+      }
+      TURETURN();
+   }
+
+      /** An interval that fails the check uses the series, which
+       * must give the series results to rounding. */
+   unsigned directTest()
+   {
+      TUDEF("EarthOrientationCache", "numDirect");
+      for(unsigned c=0; c<convs.size(); c++)
+      {
+         EarthOrientationCache cache(convs[c]);
+         cache.setInterpolation(2.0, 2, 1.e-15);
+         double err(maxDiff(cache, convs[c], 3));
+         TUASSERT(cache.size() > 0);
+         TUASSERTE(int, cache.size(), cache.numDirect());
+         TUASSERT(err <= round);
+      }
+      TURETURN();
+   }
+
+private:
+      /// allowance for rounding in the comparisons
+   double round;
+   vector<IERSConvention> convs;
+   vector<double> fracs;
+};
+
+
+int main() //Main function to initialize and run all tests above
+{
+   unsigned errorTotal = 0;
+   EarthOrientationCache_T testClass;
+
+   errorTotal += testClass.boundTest();
+   errorTotal += testClass.directTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; //Return the total number of errors
+}
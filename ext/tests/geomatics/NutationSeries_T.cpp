@@ -0,0 +1,162 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004-2019, The University of Texas at Austin
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software developed by Applied Research Laboratories at the University of
+//  Texas at Austin, under contract to an agency or agencies within the U.S. 
+//  Department of Defense. The U.S. Government retains all rights to use,
+//  duplicate, distribute, disclose, or release this software. 
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file NutationSeries_T.cpp  Test NutationSeries against the scalar
+/// series of EarthOrientation.
+
+#include "NutationSeries.hpp"
+#include "EarthOrientation.hpp"
+
+#include "TestUtil.hpp"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace gpstk;
+
+class NutationSeries_T
+{
+public:
+      /// required agreement with EarthOrientation, radians
+   static const double tolerance;
+
+      /** Epochs in Julian centuries from J2000, spread over 1900-2100,
+       * in a list whose length is not a multiple of the block size,
+       * so that the last block is partial. */
+   NutationSeries_T()
+   {
+      const int n(20*NutationSeries::BLOCK + 5);
+      for(int i=0; i<n; i++)
+         T.push_back(-1.0 + 2.0*double(i)/double(n-1));
+         // J2000 itself, and epochs a fraction of a second apart
+      T.push_back(0.0);
+      T.push_back(0.19);
+      T.push_back(0.19 + 1.e-9);
+   }
+
+      /** Largest difference between a batch result and the scalar
+       * function, over both outputs.
+       * @param which 2003 or 2010 for the nutation angles, 0 for XYCIO */
+   double maxDiff(int which, const vector<double>& TT)
+   {
+      vector<double> a, b;
+      if(which == 2003)
+         NutationSeries::NutationAngles2003(TT, a, b);
+      else if(which == 2010)
+         NutationSeries::NutationAngles2010(TT, a, b);
+      else
+         NutationSeries::XYCIO(TT, a, b);
+      if(a.size() != TT.size() || b.size() != TT.size())
+         return 1.0;
+
+      double err(0.0);
+      for(size_t i=0; i<TT.size(); i++)
+      {
+         double t(TT[i]), x, y;
+         if(which == 2003)
+            EarthOrientation::NutationAngles2003(t, x, y);
+         else if(which == 2010)
+            EarthOrientation::NutationAngles2010(t, x, y);
+         else
+            EarthOrientation::XYCIO(t, x, y);
+         err = max(err, max(::fabs(a[i]-x), ::fabs(b[i]-y)));
+      }
+      return err;
+   }
+
+      /// The nutation angles of IERS 2003 and 2010.
+   unsigned anglesTest()
+   {
+      TUDEF("NutationSeries", "NutationAngles2003");
+      double err(maxDiff(2003, T));
+      TUASSERT(err <= tolerance);
+      TUCSM("NutationAngles2010");
+      err = maxDiff(2010, T);
+      TUASSERT(err <= tolerance);
+      TURETURN();
+   }
+
+      /// The coordinates of the CIP, IERS 2010.
+   unsigned xyTest()
+   {
+      TUDEF("NutationSeries", "XYCIO");
+      double err(maxDiff(0, T));
+      TUASSERT(err <= tolerance);
+      TURETURN();
+   }
+
+      /** Lists shorter than a block, of exactly one block, and empty
+       * lists, whose outputs must be resized to match. */
+   unsigned sizeTest()
+   {
+      TUDEF("NutationSeries", "XYCIO");
+      int sizes[] = { 1, NutationSeries::BLOCK-1, NutationSeries::BLOCK,
+                      NutationSeries::BLOCK+1 };
+      for(unsigned k=0; k<sizeof(sizes)/sizeof(sizes[0]); k++)
+      {
+         vector<double> TT(T.end()-sizes[k], T.end());
+         TUASSERT(maxDiff(2003, TT) <= tolerance);
+         TUASSERT(maxDiff(2010, TT) <= tolerance);
+         TUASSERT(maxDiff(0, TT) <= tolerance);
+      }
+      vector<double> none, X(3, 1.0), Y(3, 1.0);
+      NutationSeries::XYCIO(none, X, Y);
+      TUASSERTE(size_t, 0, X.size());
+      TUASSERTE(size_t, 0, Y.size());
+      TURETURN();
+   }
+
+private:
+   vector<double> T;
+};
+
+const double NutationSeries_T::tolerance = 1.e-12;
+
+
+int main() //Main function to initialize and run all tests above
+{
+   unsigned errorTotal = 0;
+   NutationSeries_T testClass;
+
+   errorTotal += testClass.anglesTest();
+   errorTotal += testClass.xyTest();
+   errorTotal += testClass.sizeTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; //Return the total number of errors
+}
@@ -0,0 +1,88 @@
+# Test that a program writes the same output on one thread as on
+# several.
+#
+# Expected variables:
+# TEST_PROG: the program under test
+# ARGS: a space-separated argument list, in which @N@ is replaced by
+#    the number of threads
+# THREADS: the number of threads to compare with one thread
+# TARGETDIR: the directory the program writes its output to
+# TESTBASE: the name of the test; ARGS must have the program write
+#    its output to ${TARGETDIR}/${TESTBASE}_@N@.out
+#
+# Optional variables:
+# RINEX: if TRUE, ARGS also has the program write a RINEX file to
+#    ${TARGETDIR}/${TESTBASE}_@N@.rnx, which is compared except for
+#    the PGM / RUN BY / DATE header record
+# LOG: if TRUE, ARGS also has the program write a log to
+#    ${TARGETDIR}/${TESTBASE}_@N@.log, which is compared after the
+#    number of threads in file names is replaced by @N@
+# LOG_IGNORE: a regular expression; lines of the log that match it,
+#    such as time stamps, are not compared
+
+# keep @N@ literal in quoted arguments
+if(POLICY CMP0053)
+    cmake_policy(SET CMP0053 NEW)
+endif()
+
+foreach(N 1 ${THREADS})
+    string(REPLACE "@N@" ${N} RUN_ARGS ${ARGS})
+    string(REPLACE " " ";" ARG_LIST ${RUN_ARGS})
+    message(STATUS "${TEST_PROG} ${RUN_ARGS}")
+    execute_process(COMMAND ${TEST_PROG} ${ARG_LIST}
+        OUTPUT_QUIET
+        RESULT_VARIABLE RC)
+    if(RC)
+        message(FATAL_ERROR "Test failed with ${N} threads, rc ${RC}")
+    endif()
+endforeach()
+
+set(out1 "${TARGETDIR}/${TESTBASE}_1.out")
+set(outN "${TARGETDIR}/${TESTBASE}_${THREADS}.out")
+message(STATUS "diff ${out1} ${outN}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${out1} ${outN}
+    RESULT_VARIABLE DIFFERENT)
+if(DIFFERENT)
+    message(FATAL_ERROR "Test failed - output differs with ${THREADS} threads")
+endif()
+
+if(RINEX)
+    # the header records the time of the run
+    set(rnx1 "${TARGETDIR}/${TESTBASE}_1.rnx")
+    set(rnxN "${TARGETDIR}/${TESTBASE}_${THREADS}.rnx")
+    message(STATUS "diff ${rnx1} ${rnxN}")
+    file(READ ${rnx1} text1)
+    file(READ ${rnxN} textN)
+    set(dateRecord "[^\n]*PGM / RUN BY / DATE[^\n]*\n")
+    string(REGEX REPLACE "${dateRecord}" "" text1 "${text1}")
+    string(REGEX REPLACE "${dateRecord}" "" textN "${textN}")
+    if(NOT text1 STREQUAL textN)
+        message(FATAL_ERROR
+            "Test failed - RINEX output differs with ${THREADS} threads")
+    endif()
+endif()
+
+if(LOG)
+    set(log1 "${TARGETDIR}/${TESTBASE}_1.log")
+    set(logN "${TARGETDIR}/${TESTBASE}_${THREADS}.log")
+    message(STATUS "diff ${log1} ${logN}")
+    file(STRINGS ${log1} lines1)
+    file(STRINGS ${logN} lines${THREADS})
+    foreach(N 1 ${THREADS})
+        set(text${N} "")
+        foreach(line IN LISTS lines${N})
+            if(LOG_IGNORE AND line MATCHES "${LOG_IGNORE}")
+                continue()
+            endif()
+            string(REPLACE "${TESTBASE}_${N}." "${TESTBASE}_@N@." line
+                "${line}")
+            string(APPEND text${N} "${line}\n")
+        endforeach()
+    endforeach()
+    if(NOT text1 STREQUAL text${THREADS})
+        message(FATAL_ERROR
+            "Test failed - log differs with ${THREADS} threads")
+    endif()
+endif()
+
+message(STATUS "Test passed")